@@ -0,0 +1,518 @@
+// --- Microbenchmarks for the per-tick hot paths ---
+// Built and run by "make bench" (see Makefile). Each case replays positions recorded
+// from autopilot laps on the real tracks, so branch patterns match actual driving
+// (mostly on track, occasionally close to a wall) instead of synthetic random points.
+//
+// Options (key=value):
+//   reps=N          timed repetitions per case (default 15); variance is across repetitions
+//   filter=TEXT     only run cases whose name contains TEXT
+//   save=FILE       write the median ns/op of every case as a baseline
+//   compare=FILE    compare against a saved baseline; exit code 1 on a regression
+//
+// Also checks that a rollback (restore + resimulate) reproduces the live race state; exit code 1 if not.
+//   threshold=PCT   slowdown (percent of the baseline) reported as a regression (default 10)
+
+#include "game.h"        // selectedTrackType, FRAME_TIME_SEC
+#include "car.h"         // initCar(), updateCar(), calculateCarCorners()
+#include "track.h"       // isPositionOnTrack()
+#include "track_rect.h"  // isPositionOnRectTrack()
+#include "track_round.h" // isPositionOnRoundTrack()
+#include "surface.h"     // getSurfaceMaterial(), getWheelSurfaces(), isCarOnAsphalt()
+#include "lap.h"         // updateLapTimer()
+#include "ai.h"          // Autopilot drives the recorded laps
+#include "timing.h"      // getTimeSeconds()
+#include "particles.h"   // Particle pool update and batch sort
+#include "snapshot.h"    // Rollback ring save / restore / resimulation
+#include "protocol.h"    // Server snapshot encoding / decoding
+#include "telemetry.h"   // Telemetry records
+#include "ring.h"        // Sim -> writer ring
+#include <math.h>        // For sqrt
+#include <stdio.h>       // For printf, fopen
+#include <stdlib.h>      // For malloc, qsort, atoi, strtod
+#include <string.h>      // For strstr, strncmp, strcmp, memcmp
+
+#define BENCH_RECORD_LAPS 3             // Autopilot laps recorded per track
+#define BENCH_RECORD_MAX_TICKS 20000    // Safety limit while recording
+#define BENCH_DEFAULT_REPS 15
+#define BENCH_DEFAULT_THRESHOLD 10.0
+#define BENCH_TARGET_SECONDS 0.02       // Approximate duration of one timed repetition
+#define BENCH_MAX_CASES 24
+
+// --- Recorded Workload ---
+// One Car snapshot per tick (taken *before* updateCar) for each track, and the four
+// corner positions of every snapshot for the track queries.
+typedef struct {
+    TrackType track;
+    Car* states;
+    int numStates;
+    float* cornerXZ;     // x,z pairs: 4 corners per state
+    int numCorners;
+} Recording;
+
+static Recording recordings[NUM_TRACK_OPTIONS];
+static volatile float benchSink; // Results are folded in here so the compiler can't drop the work
+
+static void recordTrack(Recording* rec, TrackType track) {
+    selectedTrackType = track;
+    rec->track = track;
+    rec->states = (Car*)malloc(BENCH_RECORD_MAX_TICKS * sizeof(Car));
+    rec->numStates = 0;
+
+    Car car;
+    initCar(&car);
+    LapTimer timer;
+    initLapTimer(&timer, &car, 0);
+    for (long tick = 1; tick <= BENCH_RECORD_MAX_TICKS && timer.lapsCompleted < BENCH_RECORD_LAPS; ++tick) {
+        updateAIControls(&car);
+        rec->states[rec->numStates++] = car;
+        updateCar(&car, FRAME_TIME_SEC);
+        updateLapTimer(&timer, &car, tick);
+    }
+
+    rec->numCorners = rec->numStates * 4;
+    rec->cornerXZ = (float*)malloc((size_t)rec->numCorners * 2 * sizeof(float));
+    for (int i = 0; i < rec->numStates; ++i) {
+        const Car* c = &rec->states[i];
+        float* out = &rec->cornerXZ[i * 8];
+        calculateCarCorners(c->x, c->z, c->angle, c->width, c->length,
+                            &out[0], &out[1], &out[2], &out[3], &out[4], &out[5], &out[6], &out[7]);
+    }
+}
+
+
+// --- Benchmark Cases ---
+// Each case runs one pass over its recording and returns the number of operations done.
+typedef int (*BenchPass)(const Recording* rec);
+
+static int passCorners(const Recording* rec) {
+    float acc = 0.0f;
+    for (int i = 0; i < rec->numStates; ++i) {
+        const Car* c = &rec->states[i];
+        float fl_x, fl_z, fr_x, fr_z, rl_x, rl_z, rr_x, rr_z;
+        calculateCarCorners(c->x, c->z, c->angle, c->width, c->length,
+                            &fl_x, &fl_z, &fr_x, &fr_z, &rl_x, &rl_z, &rr_x, &rr_z);
+        acc += fl_x + fr_z + rl_x + rr_z;
+    }
+    benchSink = acc;
+    return rec->numStates;
+}
+
+static int passOnRectTrack(const Recording* rec) {
+    int hits = 0;
+    for (int i = 0; i < rec->numCorners; ++i) hits += isPositionOnRectTrack(rec->cornerXZ[i * 2], rec->cornerXZ[i * 2 + 1]);
+    benchSink = (float)hits;
+    return rec->numCorners;
+}
+
+static int passOnRoundTrack(const Recording* rec) {
+    int hits = 0;
+    for (int i = 0; i < rec->numCorners; ++i) hits += isPositionOnRoundTrack(rec->cornerXZ[i * 2], rec->cornerXZ[i * 2 + 1]);
+    benchSink = (float)hits;
+    return rec->numCorners;
+}
+
+static int passOnTrack(const Recording* rec) {
+    int hits = 0;
+    for (int i = 0; i < rec->numCorners; ++i) hits += isPositionOnTrack(rec->cornerXZ[i * 2], rec->cornerXZ[i * 2 + 1]);
+    benchSink = (float)hits;
+    return rec->numCorners;
+}
+
+// The lookup updateCar() makes per wheel instead of isPositionOnTrack()
+static int passSurface(const Recording* rec) {
+    int sum = 0;
+    for (int i = 0; i < rec->numCorners; ++i) sum += (int)getSurfaceMaterial(rec->cornerXZ[i * 2], rec->cornerXZ[i * 2 + 1]);
+    benchSink = (float)sum;
+    return rec->numCorners;
+}
+
+static int passWheelSurfaces(const Recording* rec) {
+    int sum = 0;
+    for (int i = 0; i < rec->numStates; ++i) { // The four corners of a tick in one call, as updateCar() does
+        unsigned int surfaces = getWheelSurfaces(&rec->cornerXZ[i * 8]);
+        sum += (int)((surfaces & 0xFFu) + (surfaces >> 8 & 0xFFu) + (surfaces >> 16 & 0xFFu) + (surfaces >> 24));
+    }
+    benchSink = (float)sum;
+    return rec->numCorners;
+}
+
+// What updateCar() does per tick: the centre test, and the four lookups only when it fails.
+// Counted per wheel, like isPositionOnTrack() which it replaces.
+static int passCarSurfaces(const Recording* rec) {
+    unsigned int sum = 0;
+    for (int i = 0; i < rec->numStates; ++i) {
+        const Car* c = &rec->states[i];
+        float halfDiagonal = 0.5f * sqrtf(c->width * c->width + c->length * c->length);
+        if (!isCarOnAsphalt(c->x, c->z, halfDiagonal)) sum += getWheelSurfaces(&rec->cornerXZ[i * 8]);
+    }
+    benchSink = (float)sum;
+    return rec->numCorners;
+}
+
+static int passUpdateCar(const Recording* rec) {
+    float acc = 0.0f;
+    for (int i = 0; i < rec->numStates; ++i) {
+        Car car = rec->states[i]; // Replay each recorded tick from its exact starting state
+        updateCar(&car, FRAME_TIME_SEC);
+        acc += car.x + car.z;
+    }
+    benchSink = acc;
+    return rec->numStates;
+}
+
+static int passLapTimer(const Recording* rec) {
+    LapTimer timer;
+    initLapTimer(&timer, &rec->states[0], 0);
+    int laps = 0;
+    // states[i] is the car after i ticks; its prev_x/prev_z hold the position one tick earlier
+    for (int i = 1; i < rec->numStates; ++i) laps += updateLapTimer(&timer, &rec->states[i], i);
+    benchSink = (float)laps;
+    return rec->numStates - 1;
+}
+
+// Particles: a full pool (PARTICLE_MAX) of smoke and sparks emitted along the recorded lap.
+// The update runs with a zero time step so the pool stays full across passes; the loop is
+// branch-free, so the work per particle is the same as in a real tick.
+static void fillParticlePool(const Recording* rec) {
+    if (particleStats.live == PARTICLE_MAX) return;
+    clearParticles();
+    for (int i = 0; particleStats.spawned < PARTICLE_MAX; i = (i + 7) % rec->numStates) {
+        const Car* c = &rec->states[i];
+        emitTireSmoke(c->x, c->z, 0.0f, 0.0f, 8);
+        emitSparks(c->x, 0.2f, c->z, 1.0f, 0.0f, 10.0f, 8);
+    }
+    updateParticles(0.0f); // Sets particleStats.live
+}
+
+static int passUpdateParticles(const Recording* rec) {
+    fillParticlePool(rec);
+    updateParticles(0.0f);
+    return particleStats.live;
+}
+
+// Chase camera behind the first recorded state, looking along +Z (the start straight)
+static int passParticleBatch(const Recording* rec) {
+    fillParticlePool(rec);
+    const Car* c = &rec->states[0];
+    const float eye[3] = { c->x, 5.25f, c->z - 10.0f };
+    const float right[3] = { -1.0f, 0.0f, 0.0f }, up[3] = { 0.0f, 1.0f, 0.0f };
+    benchSink = (float)buildParticleBatch(eye, right, up);
+    return particleStats.live;
+}
+
+// Rollback snapshots of a full MAX_RACE_CARS grid, filled from states spread along the lap.
+// Each op saves (or restores) one tick's state; consecutive ticks walk the whole ring.
+#define BENCH_SNAPSHOT_OPS 4096
+#define BENCH_RESIM_TICKS 8   // Typical rollback: a few ticks of input delay
+
+static void fillRaceState(const Recording* rec) {
+    for (int i = 0; i < MAX_RACE_CARS; ++i) {
+        raceState.cars[i] = rec->states[(long)i * rec->numStates / MAX_RACE_CARS];
+        initLapTimer(&raceState.lapTimers[i], &raceState.cars[i], 0);
+    }
+}
+
+static int passSaveSnapshot(const Recording* rec) {
+    fillRaceState(rec);
+    for (simTickCount = 0; simTickCount < BENCH_SNAPSHOT_OPS; ++simTickCount) saveSnapshot();
+    return BENCH_SNAPSHOT_OPS;
+}
+
+static int passRestoreSnapshot(const Recording* rec) {
+    fillRaceState(rec);
+    clearSnapshots();
+    for (simTickCount = 0; simTickCount < SNAPSHOT_FRAMES; ++simTickCount) saveSnapshot();
+    float acc = 0.0f;
+    for (int i = 0; i < BENCH_SNAPSHOT_OPS; ++i) {
+        restoreSnapshot(i % SNAPSHOT_FRAMES);
+        acc += raceState.cars[i % MAX_RACE_CARS].x;
+    }
+    benchSink = acc;
+    return BENCH_SNAPSHOT_OPS;
+}
+
+// One rollback of a 4-player race: restore, then resimulate BENCH_RESIM_TICKS ticks (ns per rollback)
+static int passResimulate(const Recording* rec) {
+    int savedPlayers = numPlayers;
+    numPlayers = MAX_PLAYERS;
+    fillRaceState(rec);
+    clearSnapshots();
+    for (simTickCount = 0; simTickCount <= BENCH_RESIM_TICKS; ++simTickCount) saveSnapshot();
+    simTickCount = BENCH_RESIM_TICKS;
+    const int rollbacks = 64;
+    for (int i = 0; i < rollbacks; ++i) resimulateFrom(0, NULL, NULL);
+    benchSink = raceState.cars[0].x;
+    numPlayers = savedPlayers;
+    return rollbacks;
+}
+
+// Rollback correctness, checked once before the cases: drive a 4-player race live (with effects)
+// on autopilot controls, recording each tick's controls, then restore the first tick and
+// resimulate over the recorded controls. The result must be byte for byte the live state.
+#define BENCH_CHECK_TICKS (SNAPSHOT_FRAMES - 1)
+
+typedef struct {
+    unsigned char bits[BENCH_CHECK_TICKS][MAX_PLAYERS];
+} RecordedControls;
+
+static void applyRecordedControls(long tick, void* user) {
+    const RecordedControls* controls = (const RecordedControls*)user;
+    for (int p = 0; p < numPlayers; ++p) setCarControlBits(&playerCars[p], controls->bits[tick][p]);
+}
+
+static int checkResimulation(const Recording* rec) {
+    static RecordedControls controls;
+    static RaceState live;
+    int savedPlayers = numPlayers;
+    numPlayers = MAX_PLAYERS;
+    selectedTrackType = rec->track;
+    fillRaceState(rec);
+    clearSnapshots();
+    for (simTickCount = 0; simTickCount < BENCH_CHECK_TICKS; ) {
+        saveSnapshot();
+        for (int p = 0; p < numPlayers; ++p) {
+            updateAIControls(&playerCars[p]);
+            controls.bits[simTickCount][p] = getCarControlBits(&playerCars[p]);
+        }
+        simulateRaceTick(1); // Advances simTickCount
+    }
+    saveSnapshot();
+    memcpy(&live, &raceState, sizeof(RaceState));
+
+    for (int p = 0; p < numPlayers; ++p) setCarControlBits(&playerCars[p], 0); // Mispredicted: all released
+    int resimulated = resimulateFrom(0, applyRecordedControls, &controls);
+    int same = resimulated == BENCH_CHECK_TICKS && memcmp(&live, &raceState, sizeof(RaceState)) == 0;
+    numPlayers = savedPlayers;
+    return same;
+}
+
+// Server snapshots of a 4-car session along the recorded laps, each encoded against the one
+// before (ns per snapshot); the decode case reads the same packets back. Both are prepared once.
+#define BENCH_NET_SNAPSHOTS 64
+#define BENCH_NET_CARS 4
+
+static NetSnapshot netSnapshots[BENCH_NET_SNAPSHOTS];
+static unsigned char netPackets[BENCH_NET_SNAPSHOTS][PROTOCOL_MAX_SNAPSHOT_BYTES];
+static int netPacketLengths[BENCH_NET_SNAPSHOTS];
+static const Recording* netPrepared = NULL;
+
+static void prepareNetSnapshots(const Recording* rec) {
+    if (netPrepared == rec) return;
+    for (int i = 0; i < BENCH_NET_SNAPSHOTS; ++i) {
+        NetSnapshot* snapshot = &netSnapshots[i];
+        snapshot->tick = (long)(i + 1) * PROTOCOL_SNAPSHOT_INTERVAL;
+        snapshot->present = (1u << BENCH_NET_CARS) - 1u;
+        for (int c = 0; c < BENCH_NET_CARS; ++c) {
+            long state = ((long)c * rec->numStates / BENCH_NET_CARS + snapshot->tick) % rec->numStates;
+            packCarState(&rec->states[state], c, &snapshot->cars[c]);
+        }
+        if (i > 0) netPacketLengths[i] = encodeSnapshot(snapshot, &netSnapshots[i - 1], netPackets[i]);
+    }
+    netPrepared = rec;
+}
+
+static int passEncodeSnapshot(const Recording* rec) {
+    unsigned char packet[PROTOCOL_MAX_SNAPSHOT_BYTES];
+    prepareNetSnapshots(rec);
+    long bytes = 0;
+    for (int i = 1; i < BENCH_NET_SNAPSHOTS; ++i) bytes += encodeSnapshot(&netSnapshots[i], &netSnapshots[i - 1], packet);
+    benchSink = (float)bytes;
+    return BENCH_NET_SNAPSHOTS - 1;
+}
+
+static int passDecodeSnapshot(const Recording* rec) {
+    static NetSnapshot history[PROTOCOL_SNAPSHOT_HISTORY];
+    prepareNetSnapshots(rec);
+    history[getSnapshotSlot(netSnapshots[0].tick)] = netSnapshots[0];
+    int decoded = 0;
+    for (int i = 1; i < BENCH_NET_SNAPSHOTS; ++i) {
+        NetSnapshot* slot = &history[getSnapshotSlot(netSnapshots[i].tick)];
+        decoded += decodeSnapshot(netPackets[i], netPacketLengths[i], history, slot); // Becomes the next base
+    }
+    benchSink = (float)decoded;
+    return BENCH_NET_SNAPSHOTS - 1;
+}
+
+// What --telemetry costs the sim thread per car and tick: sample the car, push the record. The
+// writer's pop runs right after on this thread (uncontended), keeping the ring from filling.
+#define BENCH_TELEMETRY_OPS 4096
+
+static int passTelemetryRecord(const Recording* rec) {
+    static SpscRing ring;
+    if (!ring.records) initSpscRing(&ring, sizeof(TelemetrySample), TELEMETRY_RING_RECORDS);
+    LapTimer timer;
+    memset(&timer, 0, sizeof(timer));
+    TelemetrySample sample, drained;
+    int popped = 0;
+    for (int i = 0; i < BENCH_TELEMETRY_OPS; ++i) {
+        sampleCarTelemetry(&rec->states[i % rec->numStates], &timer, i & 3, i, &sample);
+        pushSpscRing(&ring, &sample);
+        popped += popSpscRing(&ring, &drained);
+    }
+    benchSink = drained.speed + (float)popped;
+    return BENCH_TELEMETRY_OPS;
+}
+
+typedef struct {
+    const char* name;
+    BenchPass pass;
+    TrackType track; // Recording used (and selectedTrackType while running)
+} BenchCase;
+
+static const BenchCase benchCases[] = {
+    { "calculateCarCorners",          passCorners,      TRACK_ROUNDED },
+    { "isPositionOnRectTrack",        passOnRectTrack,  TRACK_RECT },
+    { "isPositionOnRoundTrack",       passOnRoundTrack, TRACK_ROUNDED },
+    { "isPositionOnTrack/rect",       passOnTrack,      TRACK_RECT },
+    { "isPositionOnTrack/round",      passOnTrack,      TRACK_ROUNDED },
+    { "getSurfaceMaterial/rect",      passSurface,      TRACK_RECT },
+    { "getSurfaceMaterial/round",     passSurface,      TRACK_ROUNDED },
+    { "getWheelSurfaces/round",       passWheelSurfaces, TRACK_ROUNDED },
+    { "isCarOnAsphalt/rect",          passCarSurfaces,  TRACK_RECT },
+    { "isCarOnAsphalt/round",         passCarSurfaces,  TRACK_ROUNDED },
+    { "updateCar/rect",               passUpdateCar,    TRACK_RECT },
+    { "updateCar/round",              passUpdateCar,    TRACK_ROUNDED },
+    { "updateLapTimer/round",         passLapTimer,     TRACK_ROUNDED },
+    { "updateParticles/pool",         passUpdateParticles, TRACK_ROUNDED },
+    { "buildParticleBatch/pool",      passParticleBatch,   TRACK_ROUNDED },
+    { "saveSnapshot/20cars",          passSaveSnapshot,    TRACK_ROUNDED },
+    { "restoreSnapshot/20cars",       passRestoreSnapshot, TRACK_ROUNDED },
+    { "resimulateFrom/4cars-8ticks",  passResimulate,      TRACK_ROUNDED },
+    { "encodeSnapshot/4cars",         passEncodeSnapshot,  TRACK_ROUNDED },
+    { "decodeSnapshot/4cars",         passDecodeSnapshot,  TRACK_ROUNDED },
+    { "recordTelemetry/push+pop",     passTelemetryRecord, TRACK_ROUNDED },
+};
+#define NUM_BENCH_CASES ((int)(sizeof(benchCases) / sizeof(benchCases[0])))
+
+
+// --- Measurement ---
+typedef struct {
+    const char* name;
+    double medianNs, meanNs, stddevNs; // Per operation, across repetitions
+    double opsPerSec;
+} BenchResult;
+
+static int compareDoubles(const void* a, const void* b) {
+    double da = *(const double*)a, db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+static void runBenchCase(const BenchCase* bc, int reps, BenchResult* result) {
+    const Recording* rec = &recordings[bc->track];
+    selectedTrackType = bc->track;
+
+    // Calibrate: enough passes per repetition to last about BENCH_TARGET_SECONDS
+    double start = getTimeSeconds();
+    bc->pass(rec); // Also warms the caches
+    double once = getTimeSeconds() - start;
+    int passes = once > 0.0 ? (int)(BENCH_TARGET_SECONDS / once) : 1000;
+    if (passes < 1) passes = 1;
+
+    double samples[256];
+    if (reps > 256) reps = 256;
+    for (int r = 0; r < reps; ++r) {
+        long ops = 0;
+        start = getTimeSeconds();
+        for (int p = 0; p < passes; ++p) ops += bc->pass(rec);
+        samples[r] = (getTimeSeconds() - start) * 1e9 / (double)ops;
+    }
+
+    double sum = 0.0, sumSq = 0.0;
+    for (int r = 0; r < reps; ++r) { sum += samples[r]; sumSq += samples[r] * samples[r]; }
+    qsort(samples, (size_t)reps, sizeof(double), compareDoubles);
+    result->name = bc->name;
+    result->meanNs = sum / reps;
+    result->stddevNs = sqrt(fmax(0.0, sumSq / reps - result->meanNs * result->meanNs));
+    result->medianNs = samples[reps / 2];
+    result->opsPerSec = result->medianNs > 0.0 ? 1e9 / result->medianNs : 0.0;
+}
+
+
+// --- Baseline Files ---
+// One "name median_ns" pair per line.
+static int saveBaseline(const char* path, const BenchResult* results, int count) {
+    FILE* file = fopen(path, "w");
+    if (!file) { fprintf(stderr, "Bench: cannot write baseline '%s'\n", path); return 0; }
+    for (int i = 0; i < count; ++i) fprintf(file, "%s %.4f\n", results[i].name, results[i].medianNs);
+    fclose(file);
+    return 1;
+}
+
+// Returns the number of regressions, or -1 if the baseline can't be read.
+static int compareBaseline(const char* path, const BenchResult* results, int count, double thresholdPct) {
+    FILE* file = fopen(path, "r");
+    if (!file) { fprintf(stderr, "Bench: cannot read baseline '%s'\n", path); return -1; }
+
+    printf("\n%-26s %12s %12s %9s\n", "vs baseline", "base ns/op", "now ns/op", "change");
+    int regressions = 0;
+    char name[64];
+    double baseNs;
+    while (fscanf(file, "%63s %lf", name, &baseNs) == 2) {
+        for (int i = 0; i < count; ++i) {
+            if (strcmp(results[i].name, name) != 0) continue;
+            double change = baseNs > 0.0 ? (results[i].medianNs / baseNs - 1.0) * 100.0 : 0.0;
+            int regressed = change > thresholdPct;
+            regressions += regressed;
+            printf("%-26s %12.2f %12.2f %+8.1f%%%s\n", name, baseNs, results[i].medianNs, change,
+                   regressed ? "  REGRESSION" : "");
+        }
+    }
+    fclose(file);
+    return regressions;
+}
+
+
+// --- Entry Point ---
+int main(int argc, char** argv) {
+    int reps = BENCH_DEFAULT_REPS;
+    double thresholdPct = BENCH_DEFAULT_THRESHOLD;
+    const char* filter = NULL;
+    const char* savePath = NULL;
+    const char* comparePath = NULL;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "reps=", 5) == 0) reps = atoi(arg + 5);
+        else if (strncmp(arg, "filter=", 7) == 0) filter = arg + 7;
+        else if (strncmp(arg, "save=", 5) == 0) savePath = arg + 5;
+        else if (strncmp(arg, "compare=", 8) == 0) comparePath = arg + 8;
+        else if (strncmp(arg, "threshold=", 10) == 0) thresholdPct = strtod(arg + 10, NULL);
+        else { fprintf(stderr, "Bench: unknown option '%s'\n", arg); return 2; }
+    }
+    if (reps < 3) reps = 3;
+
+    recordTrack(&recordings[TRACK_RECT], TRACK_RECT);
+    recordTrack(&recordings[TRACK_ROUNDED], TRACK_ROUNDED);
+    printf("Recorded %d ticks (rect) and %d ticks (round) of autopilot driving, %d reps per case\n",
+           recordings[TRACK_RECT].numStates, recordings[TRACK_ROUNDED].numStates, reps);
+    int rectTiles, roundTiles;
+    long rectBytes = getSurfaceMapBytes(TRACK_RECT, &rectTiles), roundBytes = getSurfaceMapBytes(TRACK_ROUNDED, &roundTiles);
+    printf("Surface maps: %d tiles, %.1f KB (rect); %d tiles, %.1f KB (round)\n\n",
+           rectTiles, rectBytes / 1024.0, roundTiles, roundBytes / 1024.0);
+
+    printf("%-26s %10s %10s %8s %12s\n", "case", "ns/op", "mean", "stddev", "Mops/s");
+    BenchResult results[BENCH_MAX_CASES];
+    int count = 0;
+    for (int c = 0; c < NUM_BENCH_CASES; ++c) {
+        if (filter && !strstr(benchCases[c].name, filter)) continue;
+        BenchResult* r = &results[count++];
+        runBenchCase(&benchCases[c], reps, r);
+        printf("%-26s %10.2f %10.2f %7.1f%% %12.2f\n", r->name, r->medianNs, r->meanNs,
+               r->meanNs > 0.0 ? r->stddevNs / r->meanNs * 100.0 : 0.0, r->opsPerSec / 1e6);
+    }
+
+    int status = 0;
+    if (checkResimulation(&recordings[TRACK_ROUNDED])) {
+        printf("\nRollback check: resimulating %d ticks reproduces the live race state\n", BENCH_CHECK_TICKS);
+    } else {
+        fprintf(stderr, "\nBench: restore + resimulate does not reproduce the live race state\n");
+        status = 1;
+    }
+    if (savePath && saveBaseline(savePath, results, count)) printf("\nBaseline written to %s\n", savePath);
+    if (comparePath) {
+        int regressions = compareBaseline(comparePath, results, count, thresholdPct);
+        if (regressions < 0) status = 2;
+        else if (regressions > 0) { printf("%d case(s) slower than the baseline by more than %.0f%%\n", regressions, thresholdPct); status = 1; }
+        else printf("No regressions above %.0f%%\n", thresholdPct);
+    }
+    return status;
+}
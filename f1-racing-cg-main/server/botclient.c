@@ -0,0 +1,180 @@
+#include "botclient.h"
+#include "protocol.h" // Packets, snapshot decoding
+#include "net.h"      // One UDP socket per bot, network simulator
+#include "game.h"     // TrackType, selectedTrackType, FRAME_RATE
+#include "ai.h"       // updateAIControls() drives each bot's car
+#include "timing.h"   // Pacing and join retries
+#include <stdio.h>    // For printf, fprintf
+#include <stdlib.h>   // For calloc, free, atoi, atof
+#include <string.h>   // For memset, strcmp, strncmp
+
+typedef struct {
+    UdpSocket sock;
+    int joined;               // WELCOME received
+    int full;                 // Server answered FULL: the bot gives up
+    int car;                  // Grid slot in its session
+    TrackType track;
+    Car driven;               // Own car as last received, for the autopilot
+    NetSnapshot history[PROTOCOL_SNAPSHOT_HISTORY]; // Decoded snapshots, the delta bases
+    long latestTick;          // Newest decoded snapshot, -1 = none
+    double lastJoinTime;
+    long snapshots, snapshotBytes, snapshotCars, deltaSnapshots, decodeFailures;
+    int laps;
+} Bot;
+
+static void sendJoin(Bot* bot, const NetAddress* server, int trackWish, double now) {
+    unsigned char packet[3] = { PACKET_JOIN, PROTOCOL_VERSION, (unsigned char)trackWish };
+    sendDatagram(&bot->sock, server, packet, sizeof(packet));
+    bot->lastJoinTime = now;
+}
+
+static void sendInput(Bot* bot, const NetAddress* server) {
+    unsigned int ack = bot->latestTick >= 0 ? (unsigned int)bot->latestTick : PROTOCOL_NO_TICK;
+    unsigned char packet[6] = { PACKET_INPUT, getCarControlBits(&bot->driven),
+                                (unsigned char)ack, (unsigned char)(ack >> 8), (unsigned char)(ack >> 16), (unsigned char)(ack >> 24) };
+    sendDatagram(&bot->sock, server, packet, sizeof(packet));
+}
+
+static void receivePackets(Bot* bot) {
+    unsigned char buffer[NET_MAX_DATAGRAM];
+    int length;
+    while ((length = receiveDatagram(&bot->sock, NULL, buffer, sizeof(buffer))) >= 0) {
+        if (length < 1) continue;
+        if (buffer[0] == PACKET_WELCOME && length >= 6 && !bot->joined) {
+            bot->joined = 1;
+            bot->track = (TrackType)buffer[2];
+            bot->car = buffer[3];
+            selectedTrackType = bot->track;
+            initCar(&bot->driven); // Physics parameters and dimensions for the autopilot
+        } else if (buffer[0] == PACKET_FULL && !bot->joined) {
+            bot->full = 1;
+        } else if (buffer[0] == PACKET_SNAPSHOT && bot->joined) {
+            NetSnapshot snapshot;
+            if (!decodeSnapshot(buffer, length, bot->history, &snapshot)) { bot->decodeFailures++; continue; }
+            if (buffer[5] != 0) bot->deltaSnapshots++;
+            bot->snapshots++;
+            bot->snapshotBytes += length;
+            for (unsigned int present = snapshot.present; present; present &= present - 1) bot->snapshotCars++;
+            bot->history[getSnapshotSlot(snapshot.tick)] = snapshot;
+            if (snapshot.tick <= bot->latestTick) continue; // Late (reordered): only kept as a base
+            bot->latestTick = snapshot.tick;
+            if (snapshot.present & (1u << bot->car)) {
+                unpackCarState(&snapshot.cars[bot->car], &bot->driven);
+                bot->laps = snapshot.cars[bot->car].laps;
+            }
+        }
+    }
+}
+
+static void printBotStats(const Bot* bots, int count, double seconds) {
+    long joined = 0, full = 0, snapshots = 0, bytes = 0, cars = 0, deltas = 0, failures = 0, laps = 0;
+    int maxLaps = 0;
+    for (int i = 0; i < count; ++i) {
+        const Bot* bot = &bots[i];
+        joined += bot->joined;
+        full += bot->full;
+        snapshots += bot->snapshots;
+        bytes += bot->snapshotBytes;
+        cars += bot->snapshotCars;
+        deltas += bot->deltaSnapshots;
+        failures += bot->decodeFailures;
+        laps += bot->laps;
+        if (bot->laps > maxLaps) maxLaps = bot->laps;
+    }
+    printf("Bots: %ld/%d joined (%ld refused), %.1f snapshots/s per bot, %.1f bytes/snapshot (%.2f per car "
+           "after the header, %.1f%% deltas), %ld undecodable, %ld laps (best bot %d)\n",
+           joined, count, full, joined > 0 ? snapshots / seconds / joined : 0.0,
+           snapshots > 0 ? (double)bytes / snapshots : 0.0,
+           cars > 0 ? (double)(bytes - snapshots * PROTOCOL_SNAPSHOT_HEADER_BYTES) / cars : 0.0,
+           snapshots > 0 ? 100.0 * deltas / snapshots : 0.0, failures, laps, maxLaps);
+    fflush(stdout);
+}
+
+int runBotsFromArgs(int argc, char** argv) {
+    int count = 4, trackWish = PROTOCOL_ANY_TRACK;
+    double seconds = 30.0;
+    const char* serverText = "127.0.0.1";
+    NetConditions conditions = { 0.0f, 0, 0 };
+    for (int i = 0; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "count=", 6) == 0) count = atoi(arg + 6);
+        else if (strncmp(arg, "server=", 7) == 0) serverText = arg + 7;
+        else if (strncmp(arg, "seconds=", 8) == 0) seconds = atof(arg + 8);
+        else if (strncmp(arg, "track=", 6) == 0) {
+            if (strcmp(arg + 6, "rect") == 0) trackWish = TRACK_RECT;
+            else if (strcmp(arg + 6, "round") == 0) trackWish = TRACK_ROUNDED;
+            else if (strcmp(arg + 6, "any") == 0) trackWish = PROTOCOL_ANY_TRACK;
+            else { fprintf(stderr, "Bots: unknown track '%s' (rect|round|any)\n", arg + 6); return 1; }
+        }
+        else if (strncmp(arg, "loss=", 5) == 0) conditions.lossPercent = (float)atof(arg + 5);
+        else if (strncmp(arg, "latency=", 8) == 0) conditions.latencyMs = atoi(arg + 8);
+        else if (strncmp(arg, "jitter=", 7) == 0) conditions.jitterMs = atoi(arg + 7);
+        else { fprintf(stderr, "Bots: unknown option '%s'\n", arg); return 1; }
+    }
+    if (count < 1 || count > BOT_MAX_COUNT) { fprintf(stderr, "Bots: count must be 1..%d\n", BOT_MAX_COUNT); return 1; }
+
+    if (!initNetwork()) return 1;
+    NetAddress server;
+    if (!parseNetAddress(serverText, PROTOCOL_DEFAULT_PORT, &server)) {
+        fprintf(stderr, "Bots: bad server address '%s'\n", serverText);
+        shutdownNetwork();
+        return 1;
+    }
+    Bot* bots = (Bot*)calloc((size_t)count, sizeof(Bot));
+    if (!bots) { fprintf(stderr, "Bots: out of memory for %d bots\n", count); shutdownNetwork(); return 1; }
+    int opened = 0;
+    for (; opened < count; ++opened) {
+        Bot* bot = &bots[opened];
+        if (!openUdpSocket(&bot->sock, 0)) break;
+        setNetConditions(&bot->sock, &conditions, 12345u + (unsigned int)opened);
+        for (int h = 0; h < PROTOCOL_SNAPSHOT_HISTORY; ++h) bot->history[h].tick = -1;
+        bot->latestTick = -1;
+        bot->lastJoinTime = -BOT_JOIN_RETRY_SECONDS;
+    }
+    if (opened < count) fprintf(stderr, "Bots: only %d of %d sockets opened\n", opened, count);
+    printf("Bots: %d clients for %s, %.0f s\n", opened, serverText, seconds);
+
+    double startTime = getTimeSeconds(), nextTickTime = startTime, lastStatsTime = startTime;
+    for (long tick = 0; getTimeSeconds() - startTime < seconds; ++tick) {
+        double now = getTimeSeconds();
+        for (int i = 0; i < opened; ++i) {
+            Bot* bot = &bots[i];
+            receivePackets(bot);
+            if (bot->full) continue;
+            if (!bot->joined) {
+                if (now - bot->lastJoinTime >= BOT_JOIN_RETRY_SECONDS) sendJoin(bot, &server, trackWish, now);
+                continue;
+            }
+            if ((tick + i) % BOT_INPUT_INTERVAL != 0) continue; // Staggered, so sends spread over the ticks
+            selectedTrackType = bot->track;
+            updateAIControls(&bot->driven); // Drives from the last snapshot's pose
+            sendInput(bot, &server);
+        }
+        if (now - lastStatsTime >= 5.0) {
+            printBotStats(bots, opened, now - startTime);
+            lastStatsTime = now;
+        }
+        nextTickTime += FRAME_TIME_SEC;
+        now = getTimeSeconds();
+        if (now - nextTickTime > 0.25) nextTickTime = now; // Fell far behind: reset the schedule
+        sleepSeconds(nextTickTime - now);
+    }
+
+    for (int i = 0; i < opened; ++i) {
+        if (bots[i].joined) {
+            unsigned char leave = PACKET_LEAVE;
+            bots[i].sock.conditions = (NetConditions){ 0.0f, 0, 0 }; // Goes out now, not through the simulator
+            sendDatagram(&bots[i].sock, &server, &leave, 1);
+        }
+    }
+    printf("Bots: finished\n");
+    printBotStats(bots, opened, getTimeSeconds() - startTime);
+    long failures = 0;
+    for (int i = 0; i < opened; ++i) {
+        failures += bots[i].decodeFailures;
+        closeUdpSocket(&bots[i].sock);
+    }
+    free(bots);
+    shutdownNetwork();
+    return failures > 0 && conditions.lossPercent <= 0.0f ? 1 : 0;
+}
@@ -0,0 +1,18 @@
+#ifndef BOTCLIENT_H
+#define BOTCLIENT_H
+
+// --- Test Client ---
+// Stands in for real players when load-testing the server: each bot has its own UDP socket
+// (so the server sees a separate client), joins a session, drives its car with the autopilot
+// from the snapshots it receives, and acknowledges them as a real client would. The network
+// simulator (net.h) can add loss, latency and jitter to the bots' packets, which makes the
+// server fall back to older delta bases. Prints snapshot sizes, decode failures and laps.
+
+#define BOT_MAX_COUNT 1000
+#define BOT_JOIN_RETRY_SECONDS 0.5
+#define BOT_INPUT_INTERVAL 3    // Ticks between INPUT packets (20 per second), staggered per bot
+
+// count=, server=host[:port], seconds=, track=rect|round|any, loss=, latency=, jitter=. Exit code.
+int runBotsFromArgs(int argc, char** argv);
+
+#endif // BOTCLIENT_H
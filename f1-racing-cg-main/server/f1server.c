@@ -0,0 +1,17 @@
+// --- Dedicated Race Server ---
+// Built by "make f1server" (see Makefile and README). No window and no GL: links only the
+// simulation (car physics, track bounds, lap timing, autopilot) and the network code.
+//
+//   f1server.exe [port=27016] [sessions=256] [cars=4] [workers=N] [seconds=S]
+//   f1server.exe --bots [count=4] [server=host[:port]] [seconds=30] [track=any] [loss=%] [latency=ms] [jitter=ms]
+
+#include "server.h"    // runServerFromArgs()
+#include "botclient.h" // runBotsFromArgs()
+#include <string.h>    // For strcmp
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--bots") == 0) {
+        return runBotsFromArgs(argc - 2, argv + 2); // Test clients driven by the autopilot (see botclient.h)
+    }
+    return runServerFromArgs(argc - 1, argv + 1);
+}
@@ -0,0 +1,611 @@
+// epoll, timerfd and read() are POSIX / Linux, not C99
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "server.h"
+#include "net.h"     // UDP socket, byte packing
+#include "thread.h"  // Worker pool
+#include "timing.h"  // Stats, timeouts, select() fallback pacing
+#include "car.h"     // initCar(), updateCar()
+#include "lap.h"     // Lap timers per car
+#include "surface.h" // bakeSurfaceMaps() before the workers start
+#include <stdio.h>   // For printf, fprintf
+#include <stdlib.h>  // For calloc, free, atoi, atof
+#include <string.h>  // For memset, strncmp
+#include <signal.h>  // Ctrl+C stops the server cleanly
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/timerfd.h> // 60 Hz tick timer as a file descriptor
+#include <unistd.h>      // read, close
+#include <stdint.h>      // uint64_t (timer expirations)
+#elif defined(_WIN32)
+#include <winsock2.h>    // select
+#else
+#include <sys/select.h>
+#endif
+
+#define SESSIONS_PER_PULL 4 // Sessions a worker takes from the shared counter at a time
+#define MAX_PACKETS_PER_DRAIN 4096 // Received between two ticks at most, so ticks can't starve
+#define SERVER_SOCKET_BUFFER_BYTES (4 * 1024 * 1024)
+
+// --- Sessions and Clients ---
+typedef struct {
+    int active;
+    TrackType track;
+    long tick;                          // Ticks simulated since the session started
+    int numClients;                     // Drivers
+    int carClient[PROTOCOL_MAX_CARS];   // Client driving each grid slot, -1 = free
+    int numSpectators;
+    int spectatorClients[SERVER_MAX_SPECTATORS];
+    Car cars[PROTOCOL_MAX_CARS];
+    LapTimer lapTimers[PROTOCOL_MAX_CARS];
+    NetSnapshot history[PROTOCOL_SNAPSHOT_HISTORY]; // Snapshots sent, by getSnapshotSlot()
+} ServerSession;
+
+typedef struct {
+    int active;
+    NetAddress address;
+    int session, car;   // car = PROTOCOL_NO_CAR for spectators
+    long ackTick;       // Newest snapshot the client has confirmed, -1 = none yet
+    double lastHeard;   // getTimeSeconds() of its last packet
+    int next;           // Next client in the same address bucket, -1 = end
+} ServerClient;
+
+// Send counters per worker, summed for the status line (padded to a cache line each)
+typedef struct {
+    long packetsSent, bytesSent, snapshots, fullSnapshots, snapshotCars;
+    char padding[64 - 5 * sizeof(long)];
+} WorkerCounters;
+
+static ServerConfig config;
+static ServerStats stats;
+static ServerSession* sessions;
+static ServerClient* clients;
+static int maxClients;
+static int* freeClients;   // Stack of unused client indices
+static int numFreeClients;
+static int* buckets;       // Address hash -> first client, -1 = none
+static int numBuckets;     // Power of two
+static UdpSocket serverSocket;
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onInterrupt(int signalNumber) {
+    (void)signalNumber;
+    stopRequested = 1;
+}
+
+
+// --- Client Lookup ---
+static int getBucket(const NetAddress* address) {
+    unsigned int hash = address->host * 2654435761u ^ (unsigned int)address->port * 40503u;
+    return (int)((hash ^ (hash >> 16)) & (unsigned int)(numBuckets - 1));
+}
+
+static int findClient(const NetAddress* address) {
+    for (int i = buckets[getBucket(address)]; i >= 0; i = clients[i].next) {
+        if (clients[i].address.host == address->host && clients[i].address.port == address->port) return i;
+    }
+    return -1;
+}
+
+// A session on the wished-for track with a free grid slot, or a new one. -1 = server full.
+static int findSessionFor(int trackWish) {
+    int unused = -1;
+    for (int s = 0; s < config.maxSessions; ++s) {
+        const ServerSession* session = &sessions[s];
+        if (!session->active) { if (unused < 0) unused = s; continue; }
+        if (session->numClients < config.carsPerSession &&
+            (trackWish == PROTOCOL_ANY_TRACK || (int)session->track == trackWish)) return s;
+    }
+    if (unused < 0) return -1;
+    ServerSession* session = &sessions[unused];
+    memset(session, 0, sizeof(*session));
+    session->active = 1;
+    session->track = trackWish == PROTOCOL_ANY_TRACK ? (TrackType)(unused % NUM_TRACK_OPTIONS) : (TrackType)trackWish;
+    for (int c = 0; c < PROTOCOL_MAX_CARS; ++c) session->carClient[c] = -1;
+    for (int h = 0; h < PROTOCOL_SNAPSHOT_HISTORY; ++h) session->history[h].tick = -1;
+    stats.sessions++;
+    return unused;
+}
+
+// A running session on the wished-for track with room for another spectator. -1 = none.
+static int findSessionToWatch(int trackWish) {
+    for (int s = 0; s < config.maxSessions; ++s) {
+        const ServerSession* session = &sessions[s];
+        if (session->active && session->numSpectators < config.spectatorsPerSession &&
+            (trackWish == PROTOCOL_ANY_TRACK || (int)session->track == trackWish)) return s;
+    }
+    return -1;
+}
+
+static int allocClient(const NetAddress* address, int session, int car, double now) {
+    int index = freeClients[--numFreeClients];
+    ServerClient* client = &clients[index];
+    client->active = 1;
+    client->address = *address;
+    client->session = session;
+    client->car = car;
+    client->ackTick = -1;
+    client->lastHeard = now;
+    int bucket = getBucket(address);
+    client->next = buckets[bucket];
+    buckets[bucket] = index;
+    stats.clients++;
+    return index;
+}
+
+static void freeClient(int index) {
+    ServerClient* client = &clients[index];
+    int* link = &buckets[getBucket(&client->address)];
+    while (*link != index) link = &clients[*link].next;
+    *link = client->next;
+    client->active = 0;
+    freeClients[numFreeClients++] = index;
+    stats.clients--;
+}
+
+static int addSpectator(const NetAddress* address, int trackWish, double now) {
+    if (numFreeClients == 0) return -1;
+    int s = findSessionToWatch(trackWish);
+    if (s < 0) return -1;
+    ServerSession* session = &sessions[s];
+    int index = allocClient(address, s, PROTOCOL_NO_CAR, now);
+    session->spectatorClients[session->numSpectators++] = index;
+    stats.spectators++;
+    return index;
+}
+
+static int addClient(const NetAddress* address, int trackWish, double now) {
+    if (numFreeClients == 0) return -1;
+    if (trackWish != PROTOCOL_ANY_TRACK && (trackWish < 0 || trackWish >= NUM_TRACK_OPTIONS)) return -1;
+    int s = findSessionFor(trackWish);
+    if (s < 0) return -1;
+    ServerSession* session = &sessions[s];
+    int slot = 0;
+    while (session->carClient[slot] >= 0) slot++;
+    int index = allocClient(address, s, slot, now);
+
+    // Grid position as in a local split-screen race (initGame), timed from the session's clock
+    Car* car = &session->cars[slot];
+    selectedTrackType = session->track;
+    initCar(car);
+    car->x += (slot % 2 == 0 ? -1.0f : 1.0f) * GRID_LANE_OFFSET;
+    car->z -= (slot / 2) * GRID_ROW_SPACING;
+    car->prev_x = car->x;
+    car->prev_z = car->z;
+    initLapTimer(&session->lapTimers[slot], car, session->tick);
+    session->carClient[slot] = index;
+    session->numClients++;
+    return index;
+}
+
+static void removeClient(int index) {
+    ServerClient* client = &clients[index];
+    ServerSession* session = &sessions[client->session];
+    if (client->car == PROTOCOL_NO_CAR) {
+        for (int i = 0; i < session->numSpectators; ++i) {
+            if (session->spectatorClients[i] == index) session->spectatorClients[i] = session->spectatorClients[--session->numSpectators];
+        }
+        stats.spectators--;
+        freeClient(index);
+        return;
+    }
+    session->carClient[client->car] = -1;
+    freeClient(index);
+    if (--session->numClients > 0) return;
+    // Last driver gone: the session ends, and its spectators are told there's nothing left to watch
+    unsigned char full = PACKET_FULL;
+    for (int i = 0; i < session->numSpectators; ++i) {
+        sendDatagram(&serverSocket, &clients[session->spectatorClients[i]].address, &full, 1);
+        freeClient(session->spectatorClients[i]);
+        stats.spectators--;
+    }
+    session->numSpectators = 0;
+    session->active = 0;
+    stats.sessions--;
+}
+
+
+// --- Packets In ---
+static void sendWelcome(const ServerClient* client) {
+    const ServerSession* session = &sessions[client->session];
+    unsigned char packet[6] = { PACKET_WELCOME, PROTOCOL_VERSION, (unsigned char)session->track, (unsigned char)client->car, 0, 0 };
+    putU16(packet + 4, (unsigned int)client->session);
+    sendDatagram(&serverSocket, &client->address, packet, sizeof(packet));
+}
+
+static void handlePacket(const NetAddress* from, const unsigned char* data, int length, double now) {
+    int index = findClient(from);
+    if (length < 1) return;
+    switch (data[0]) {
+        case PACKET_JOIN: {
+            if (length < 3 || data[1] != PROTOCOL_VERSION) return;
+            int spectate = length >= 4 && (data[3] & PROTOCOL_JOIN_SPECTATE);
+            if (index < 0) index = spectate ? addSpectator(from, data[2], now) : addClient(from, data[2], now);
+            if (index < 0) {
+                unsigned char full = PACKET_FULL;
+                sendDatagram(&serverSocket, from, &full, 1);
+                return;
+            }
+            clients[index].lastHeard = now;
+            sendWelcome(&clients[index]); // Again for a repeated JOIN: the first WELCOME was lost
+            break;
+        }
+        case PACKET_INPUT: {
+            if (index < 0 || length < 6) return; // Unknown (e.g. timed out): the client joins again
+            ServerClient* client = &clients[index];
+            ServerSession* session = &sessions[client->session];
+            client->lastHeard = now;
+            if (client->car != PROTOCOL_NO_CAR) setCarControlBits(&session->cars[client->car], data[1]); // Applied from the next tick
+            unsigned int ack = getU32(data + 2);
+            if (ack != PROTOCOL_NO_TICK && (long)ack > client->ackTick && (long)ack <= session->tick) client->ackTick = (long)ack;
+            break;
+        }
+        case PACKET_LEAVE:
+            if (index >= 0) removeClient(index);
+            break;
+        default:
+            break;
+    }
+}
+
+static void drainSocket(void) {
+    unsigned char buffer[NET_MAX_DATAGRAM];
+    NetAddress from;
+    double now = getTimeSeconds();
+    for (int i = 0; i < MAX_PACKETS_PER_DRAIN; ++i) {
+        int length = receiveDatagram(&serverSocket, &from, buffer, sizeof(buffer));
+        if (length < 0) break;
+        stats.packetsReceived++;
+        handlePacket(&from, buffer, length, now);
+    }
+}
+
+static void dropSilentClients(double now) {
+    for (int i = 0; i < maxClients; ++i) {
+        if (clients[i].active && now - clients[i].lastHeard > SERVER_CLIENT_TIMEOUT_SECONDS) removeClient(i);
+    }
+}
+
+
+// --- Session Step (worker threads) ---
+static void sendSnapshot(const ServerSession* session, const NetSnapshot* snapshot, const ServerClient* client,
+                         int numCars, WorkerCounters* counters) {
+    unsigned char packet[PROTOCOL_MAX_SNAPSHOT_BYTES];
+    const NetSnapshot* base = NULL;
+    if (client->ackTick >= 0) {
+        base = &session->history[getSnapshotSlot(client->ackTick)];
+        if (base->tick != client->ackTick) base = NULL; // Acknowledged too long ago: send it all
+    }
+    int length = encodeSnapshot(snapshot, base, packet);
+    if (!sendDatagram(&serverSocket, &client->address, packet, length)) return;
+    counters->packetsSent++;
+    counters->bytesSent += length;
+    counters->snapshots++;
+    counters->snapshotCars += numCars;
+    if (!base) counters->fullSnapshots++;
+}
+
+// Only touches its own session and the worker's counters; sendto() on the shared socket is
+// thread-safe, and the server never sets network conditions, so sendDatagram() goes straight out.
+static void stepSession(ServerSession* session, WorkerCounters* counters) {
+    selectedTrackType = session->track; // Thread-local (thread.h): workers may be on different tracks
+    for (int c = 0; c < PROTOCOL_MAX_CARS; ++c) {
+        if (session->carClient[c] >= 0) updateCar(&session->cars[c], FRAME_TIME_SEC);
+    }
+    session->tick++;
+    for (int c = 0; c < PROTOCOL_MAX_CARS; ++c) {
+        if (session->carClient[c] >= 0) updateLapTimer(&session->lapTimers[c], &session->cars[c], session->tick);
+    }
+    if (session->tick % PROTOCOL_SNAPSHOT_INTERVAL != 0) return;
+
+    NetSnapshot* snapshot = &session->history[getSnapshotSlot(session->tick)];
+    snapshot->tick = session->tick;
+    snapshot->present = 0;
+    for (int c = 0; c < PROTOCOL_MAX_CARS; ++c) {
+        if (session->carClient[c] < 0) continue;
+        snapshot->present |= 1u << c;
+        packCarState(&session->cars[c], session->lapTimers[c].lapsCompleted, &snapshot->cars[c]);
+    }
+    int numCars = 0;
+    for (unsigned int present = snapshot->present; present; present &= present - 1) numCars++;
+    for (int c = 0; c < PROTOCOL_MAX_CARS; ++c) {
+        if (session->carClient[c] >= 0) sendSnapshot(session, snapshot, &clients[session->carClient[c]], numCars, counters);
+    }
+    for (int i = 0; i < session->numSpectators; ++i) {
+        sendSnapshot(session, snapshot, &clients[session->spectatorClients[i]], numCars, counters);
+    }
+}
+
+
+// --- Worker Pool ---
+// Threads sleep on poolStart between ticks. Each tick bumps poolGeneration, and every worker
+// (the event loop thread included, as worker 0) pulls sessions until none are left.
+static Thread workerThreads[SERVER_MAX_WORKERS];
+static int workerIndices[SERVER_MAX_WORKERS];
+static WorkerCounters workerCounters[SERVER_MAX_WORKERS];
+static int numWorkerThreads = 0; // Started threads (workers 1..n)
+static Mutex poolMutex;
+static CondVar poolStart, poolDone;
+static long poolGeneration = 0;
+static int poolBusy = 0;
+static int poolQuit = 0;
+static volatile int nextSession = 0; // Only touched through __sync_fetch_and_add while stepping
+
+static void stepSessions(int worker) {
+    for (;;) {
+        int first = __sync_fetch_and_add(&nextSession, SESSIONS_PER_PULL);
+        if (first >= config.maxSessions) break;
+        for (int s = first; s < first + SESSIONS_PER_PULL && s < config.maxSessions; ++s) {
+            if (sessions[s].active) stepSession(&sessions[s], &workerCounters[worker]);
+        }
+    }
+}
+
+static void workerMain(void* arg) {
+    int worker = *(const int*)arg;
+    long seen = 0;
+    for (;;) {
+        lockMutex(&poolMutex);
+        while (poolGeneration == seen && !poolQuit) waitCondVar(&poolStart, &poolMutex);
+        int quit = poolQuit;
+        seen = poolGeneration;
+        unlockMutex(&poolMutex);
+        if (quit) return;
+        stepSessions(worker);
+        lockMutex(&poolMutex);
+        if (--poolBusy == 0) signalCondVar(&poolDone);
+        unlockMutex(&poolMutex);
+    }
+}
+
+static void startWorkers(int count) {
+    initMutex(&poolMutex);
+    initCondVar(&poolStart);
+    initCondVar(&poolDone);
+    for (int w = 1; w < count; ++w) {
+        workerIndices[w] = numWorkerThreads + 1;
+        if (startThread(&workerThreads[numWorkerThreads], workerMain, &workerIndices[w])) numWorkerThreads++;
+    }
+}
+
+static void stopWorkers(void) {
+    lockMutex(&poolMutex);
+    poolQuit = 1;
+    broadcastCondVar(&poolStart);
+    unlockMutex(&poolMutex);
+    for (int w = 0; w < numWorkerThreads; ++w) joinThread(&workerThreads[w]);
+    destroyCondVar(&poolStart);
+    destroyCondVar(&poolDone);
+    destroyMutex(&poolMutex);
+}
+
+// One tick of every active session, spread over the pool. Returns when all are done.
+static void runTick(void) {
+    double start = getTimeSeconds();
+    nextSession = 0;
+    lockMutex(&poolMutex);
+    poolBusy = numWorkerThreads;
+    poolGeneration++;
+    broadcastCondVar(&poolStart);
+    unlockMutex(&poolMutex);
+    stepSessions(0);
+    lockMutex(&poolMutex);
+    while (poolBusy > 0) waitCondVar(&poolDone, &poolMutex);
+    unlockMutex(&poolMutex);
+    stats.ticks++;
+    stats.stepSeconds += getTimeSeconds() - start;
+}
+
+
+// --- Event Loop ---
+// Waits for packets or the next tick, handles the packets, and returns how many ticks are due.
+#ifdef __linux__
+static int epollFd = -1, timerFd = -1;
+
+static int openEventLoop(void) {
+    epollFd = epoll_create1(0);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, 0);
+    if (epollFd < 0 || timerFd < 0) return 0;
+    struct itimerspec period;
+    period.it_interval.tv_sec = 0;
+    period.it_interval.tv_nsec = 1000000000L / FRAME_RATE;
+    period.it_value = period.it_interval;
+    struct epoll_event socketEvent, timerEvent;
+    memset(&socketEvent, 0, sizeof(socketEvent));
+    memset(&timerEvent, 0, sizeof(timerEvent));
+    socketEvent.events = EPOLLIN;
+    socketEvent.data.fd = (int)serverSocket.handle;
+    timerEvent.events = EPOLLIN;
+    timerEvent.data.fd = timerFd;
+    return timerfd_settime(timerFd, 0, &period, NULL) == 0 &&
+           epoll_ctl(epollFd, EPOLL_CTL_ADD, socketEvent.data.fd, &socketEvent) == 0 &&
+           epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &timerEvent) == 0;
+}
+
+static void closeEventLoop(void) {
+    if (timerFd >= 0) close(timerFd);
+    if (epollFd >= 0) close(epollFd);
+}
+
+static long waitForEvents(void) {
+    struct epoll_event events[2];
+    int count = epoll_wait(epollFd, events, 2, 1000);
+    long ticksDue = 0;
+    for (int i = 0; i < count; ++i) {
+        if (events[i].data.fd == timerFd) {
+            uint64_t expirations = 0;
+            if (read(timerFd, &expirations, sizeof(expirations)) == (ssize_t)sizeof(expirations)) ticksDue = (long)expirations;
+        } else {
+            drainSocket();
+        }
+    }
+    return ticksDue;
+}
+#else
+static double nextTickTime = 0.0;
+
+static int openEventLoop(void) {
+    nextTickTime = getTimeSeconds() + FRAME_TIME_SEC;
+    return 1;
+}
+
+static void closeEventLoop(void) {}
+
+static long waitForEvents(void) {
+    double now = getTimeSeconds();
+    if (now < nextTickTime) {
+        double wait = nextTickTime - now;
+        fd_set readable;
+        FD_ZERO(&readable);
+#ifdef _WIN32
+        FD_SET((SOCKET)serverSocket.handle, &readable);
+#else
+        FD_SET((int)serverSocket.handle, &readable);
+#endif
+        struct timeval timeout;
+        timeout.tv_sec = (long)wait;
+        timeout.tv_usec = (long)((wait - (double)timeout.tv_sec) * 1e6);
+        if (select((int)serverSocket.handle + 1, &readable, NULL, NULL, &timeout) > 0) drainSocket();
+        now = getTimeSeconds();
+    }
+    long ticksDue = 0;
+    while (nextTickTime <= now) {
+        ticksDue++;
+        nextTickTime += FRAME_TIME_SEC;
+    }
+    return ticksDue;
+}
+#endif
+
+
+// --- Status ---
+static void collectCounters(void) {
+    for (int w = 0; w < SERVER_MAX_WORKERS; ++w) {
+        WorkerCounters* counters = &workerCounters[w];
+        stats.packetsSent += counters->packetsSent;
+        stats.bytesSent += counters->bytesSent;
+        stats.snapshots += counters->snapshots;
+        stats.fullSnapshots += counters->fullSnapshots;
+        stats.snapshotCars += counters->snapshotCars;
+        memset(counters, 0, sizeof(*counters));
+    }
+}
+
+static void printServerStats(const ServerStats* last, double seconds) {
+    long ticks = stats.ticks - last->ticks;
+    long snapshots = stats.snapshots - last->snapshots;
+    long bytes = stats.bytesSent - last->bytesSent;
+    long cars = stats.snapshotCars - last->snapshotCars;
+    printf("Server: %d sessions, %d clients (%d spectating) | %.1f ticks/s (%ld skipped), step %.3f ms/tick | "
+           "out %.0f packets/s, %.1f KB/s, %.1f bytes/snapshot (%.2f per car, %.1f%% full) | in %.0f packets/s\n",
+           stats.sessions, stats.clients, stats.spectators, ticks / seconds, stats.skippedTicks - last->skippedTicks,
+           ticks > 0 ? (stats.stepSeconds - last->stepSeconds) * 1000.0 / ticks : 0.0,
+           (stats.packetsSent - last->packetsSent) / seconds, bytes / seconds / 1024.0,
+           snapshots > 0 ? (double)bytes / snapshots : 0.0,
+           cars > 0 ? (double)(bytes - snapshots * PROTOCOL_SNAPSHOT_HEADER_BYTES) / cars : 0.0,
+           snapshots > 0 ? 100.0 * (stats.fullSnapshots - last->fullSnapshots) / snapshots : 0.0,
+           (stats.packetsReceived - last->packetsReceived) / seconds);
+    fflush(stdout);
+}
+
+
+// --- Entry Points ---
+int runServer(const ServerConfig* serverConfig) {
+    config = *serverConfig;
+    if (config.maxSessions < 1) config.maxSessions = 1;
+    if (config.carsPerSession < 1 || config.carsPerSession > PROTOCOL_MAX_CARS) config.carsPerSession = SERVER_DEFAULT_CARS;
+    if (config.spectatorsPerSession < 0) config.spectatorsPerSession = 0;
+    if (config.spectatorsPerSession > SERVER_MAX_SPECTATORS) config.spectatorsPerSession = SERVER_MAX_SPECTATORS;
+    int workers = config.workers > 0 ? config.workers : getCpuCount();
+    if (workers > SERVER_MAX_WORKERS) workers = SERVER_MAX_WORKERS;
+
+    maxClients = config.maxSessions * (config.carsPerSession + config.spectatorsPerSession);
+    for (numBuckets = 1; numBuckets < maxClients; numBuckets *= 2) {}
+    sessions = (ServerSession*)calloc((size_t)config.maxSessions, sizeof(ServerSession));
+    clients = (ServerClient*)calloc((size_t)maxClients, sizeof(ServerClient));
+    freeClients = (int*)malloc((size_t)maxClients * sizeof(int));
+    buckets = (int*)malloc((size_t)numBuckets * sizeof(int));
+    if (!sessions || !clients || !freeClients || !buckets) {
+        fprintf(stderr, "Server: out of memory for %d sessions\n", config.maxSessions);
+        return 1;
+    }
+    for (int i = 0; i < maxClients; ++i) freeClients[i] = maxClients - 1 - i; // Lowest index first
+    numFreeClients = maxClients;
+    for (int b = 0; b < numBuckets; ++b) buckets[b] = -1;
+    memset(&stats, 0, sizeof(stats));
+
+    if (!initNetwork()) return 1;
+    if (!openUdpSocket(&serverSocket, config.port) || !openEventLoop()) {
+        fprintf(stderr, "Server: could not set up UDP port %d\n", config.port);
+        closeUdpSocket(&serverSocket);
+        shutdownNetwork();
+        return 1;
+    }
+    setUdpBufferSize(&serverSocket, SERVER_SOCKET_BUFFER_BYTES); // Bursts from hundreds of clients between ticks
+    bakeSurfaceMaps(); // Here rather than in the first session's initCar() on some worker
+    startWorkers(workers);
+    signal(SIGINT, onInterrupt);
+    printf("Server: UDP port %d, up to %d sessions x %d cars (+%d spectators), %d worker threads, %d Hz\n",
+           config.port, config.maxSessions, config.carsPerSession, config.spectatorsPerSession, numWorkerThreads + 1, FRAME_RATE);
+    fflush(stdout);
+
+    double startTime = getTimeSeconds();
+    double lastStatsTime = startTime, lastTimeoutCheck = startTime;
+    ServerStats lastStats = stats;
+    while (!stopRequested) {
+        long ticksDue = waitForEvents();
+        if (ticksDue > SERVER_MAX_CATCHUP_TICKS) {
+            stats.skippedTicks += ticksDue - SERVER_MAX_CATCHUP_TICKS;
+            ticksDue = SERVER_MAX_CATCHUP_TICKS;
+        }
+        for (long t = 0; t < ticksDue; ++t) runTick();
+
+        double now = getTimeSeconds();
+        if (now - lastTimeoutCheck >= 1.0) {
+            dropSilentClients(now);
+            lastTimeoutCheck = now;
+        }
+        if (now - lastStatsTime >= SERVER_STATS_INTERVAL) {
+            collectCounters();
+            printServerStats(&lastStats, now - lastStatsTime);
+            lastStats = stats;
+            lastStatsTime = now;
+        }
+        if (config.seconds > 0.0 && now - startTime >= config.seconds) break;
+    }
+
+    collectCounters();
+    double elapsed = getTimeSeconds() - startTime;
+    ServerStats none;
+    memset(&none, 0, sizeof(none));
+    printf("Server: stopped after %.1f s, totals:\n", elapsed);
+    printServerStats(&none, elapsed > 0.0 ? elapsed : 1.0);
+
+    stopWorkers();
+    closeEventLoop();
+    closeUdpSocket(&serverSocket);
+    shutdownNetwork();
+    free(sessions);
+    free(clients);
+    free(freeClients);
+    free(buckets);
+    return 0;
+}
+
+int runServerFromArgs(int argc, char** argv) {
+    ServerConfig serverConfig = { PROTOCOL_DEFAULT_PORT, SERVER_DEFAULT_SESSIONS, SERVER_DEFAULT_CARS, SERVER_DEFAULT_SPECTATORS, 0, 0.0 };
+    for (int i = 0; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "port=", 5) == 0) serverConfig.port = atoi(arg + 5);
+        else if (strncmp(arg, "sessions=", 9) == 0) serverConfig.maxSessions = atoi(arg + 9);
+        else if (strncmp(arg, "cars=", 5) == 0) serverConfig.carsPerSession = atoi(arg + 5);
+        else if (strncmp(arg, "spectators=", 11) == 0) serverConfig.spectatorsPerSession = atoi(arg + 11);
+        else if (strncmp(arg, "workers=", 8) == 0) serverConfig.workers = atoi(arg + 8);
+        else if (strncmp(arg, "seconds=", 8) == 0) serverConfig.seconds = atof(arg + 8);
+        else { fprintf(stderr, "Server: unknown option '%s'\n", arg); return 1; }
+    }
+    return runServer(&serverConfig);
+}
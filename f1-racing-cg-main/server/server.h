@@ -0,0 +1,56 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "protocol.h" // Packets, snapshots
+#include "game.h"     // TrackType, FRAME_RATE
+
+// --- Dedicated Race Server ---
+// Hosts many independent races (sessions) in one process, without any GL. The main thread runs
+// the event loop (epoll on Linux, select() elsewhere) over the UDP socket and a 60 Hz tick timer:
+// packets are handled between ticks, and on every tick a fixed pool of worker threads steps all
+// active sessions (sessions are pulled from a shared counter, so one slow session doesn't hold
+// up a whole slice). Every PROTOCOL_SNAPSHOT_INTERVAL ticks each session sends its clients a
+// snapshot delta-encoded against the newest one they acknowledged (see protocol.h).
+//
+// Clients are keyed by their address. A JOIN puts the client's car into the first session on the
+// wished-for track with a free grid slot, starting a new session if none has one; a session
+// ends when its last driver leaves or times out. A spectator's JOIN attaches it to the first
+// running session on the track instead, which then sends it the same snapshots as its drivers;
+// when that session ends its spectators are sent FULL.
+
+#define SERVER_DEFAULT_SESSIONS 256     // Sessions hosted at most
+#define SERVER_DEFAULT_CARS 4           // Cars per session (up to PROTOCOL_MAX_CARS)
+#define SERVER_DEFAULT_SPECTATORS 2     // Spectators per session
+#define SERVER_MAX_SPECTATORS 16
+#define SERVER_MAX_WORKERS 64
+#define SERVER_CLIENT_TIMEOUT_SECONDS 5.0
+#define SERVER_MAX_CATCHUP_TICKS 5      // Ticks run back to back after a stall; the rest are skipped
+#define SERVER_STATS_INTERVAL 5.0       // Seconds between status lines
+
+typedef struct {
+    int port;
+    int maxSessions;
+    int carsPerSession;
+    int spectatorsPerSession;
+    int workers;       // Threads stepping sessions (the event loop thread is one of them), 0 = one per CPU
+    double seconds;    // Run time, 0 = until Ctrl+C
+} ServerConfig;
+
+// --- Statistics ---
+typedef struct {
+    long ticks;            // Server ticks run
+    long skippedTicks;     // Ticks dropped because the server fell more than SERVER_MAX_CATCHUP_TICKS behind
+    long packetsReceived, packetsSent;
+    long bytesSent;        // UDP payload only
+    long snapshots, fullSnapshots; // Snapshot packets sent, and how many had no delta base
+    long snapshotCars;     // Cars in those snapshots (bytes per car = (bytes - headers) / cars)
+    double stepSeconds;    // Wall time spent stepping sessions (all workers busy or waiting)
+    int sessions, clients; // Active now (clients includes spectators)
+    int spectators;
+} ServerStats;
+
+// --- Function Declarations ---
+int runServer(const ServerConfig* config);     // Exit code
+int runServerFromArgs(int argc, char** argv);  // port=, sessions=, cars=, spectators=, workers=, seconds=
+
+#endif // SERVER_H
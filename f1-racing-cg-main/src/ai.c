@@ -0,0 +1,40 @@
+#include "ai.h"       // Autopilot prototype and tuning constants
+#include "sensors.h"  // castTrackRays(), makeSensorFan()
+
+// --- Autopilot ---
+// A simple reactive driver: steer towards the side with more free space and
+// brake when the wall ahead is closer than the stopping distance at the current speed.
+void updateAIControls(Car* car) {
+    float angles[AI_NUM_RAYS];
+    float dist[AI_NUM_RAYS];
+    makeSensorFan(AI_SENSOR_FOV, AI_NUM_RAYS, angles);
+    castTrackRays(car, 1, angles, AI_NUM_RAYS, SENSOR_MAX_DISTANCE, dist);
+
+    // --- Steering ---
+    // Rays are ordered left-most first (see makeSensorFan), so the first half looks left.
+    // Rays closer to the heading get more weight: they decide where the road goes next.
+    int mid = AI_NUM_RAYS / 2;
+    float left = 0.0f, right = 0.0f;
+    for (int i = 0; i < mid; ++i) {
+        float weight = (float)(i + 1);
+        left += dist[i] * weight;
+        right += dist[AI_NUM_RAYS - 1 - i] * weight;
+    }
+    float imbalance = (left - right) / (left + right + 0.001f);
+    car->turning_left = (imbalance > AI_STEER_DEADBAND);
+    car->turning_right = (imbalance < -AI_STEER_DEADBAND);
+
+    // --- Throttle / Brake ---
+    // Distance needed to stop from the current speed: v^2 / (2 * deceleration)
+    float forward = dist[mid];
+    float speed = car->speed > 0.0f ? car->speed : 0.0f;
+    float stopping = speed * speed / (2.0f * car->braking_rate) + car->length + AI_BRAKE_MARGIN;
+    if (forward < stopping) {
+        car->accelerating = 0;
+        car->braking = (speed > 1.0f); // Never brake into reverse
+        if (speed <= 1.0f) car->accelerating = 1; // Creep forward so the steering can take effect
+    } else {
+        car->accelerating = 1;
+        car->braking = 0;
+    }
+}
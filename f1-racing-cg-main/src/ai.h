@@ -0,0 +1,17 @@
+#ifndef AI_H
+#define AI_H
+
+#include "car.h" // The autopilot writes the car's control flags
+
+// --- Autopilot Tuning ---
+#define AI_NUM_RAYS 7            // Sensor rays per car (odd, so one ray looks straight ahead)
+#define AI_SENSOR_FOV 120.0f     // Total spread of the sensor fan in degrees
+#define AI_STEER_DEADBAND 0.08f  // Relative left/right imbalance ignored to avoid weaving on straights
+#define AI_BRAKE_MARGIN 4.0f     // Extra distance (units) kept in front of the car when braking
+
+// --- Function Declarations ---
+// Sets accelerating/braking/turning_* on the car from distance-to-wall sensors.
+// Works on the *selected* track and is deterministic, so it can drive headless runs.
+void updateAIControls(Car* car);
+
+#endif // AI_H
@@ -0,0 +1,178 @@
+#include "benchmark.h"    // BenchConfig and prototypes
+#include "input_script.h" // Scripted input playback
+#include "ai.h"           // Autopilot when no script is given
+#include "timing.h"       // getTimeSeconds() for frame and tick timing
+#include <GL/freeglut.h>  // glutIdleFunc, glutLeaveMainLoop
+#include <stdio.h>        // For printf, fprintf
+#include <stdlib.h>       // For malloc, free, qsort, atoi, strtod
+#include <string.h>       // For strcmp, strncmp
+
+// --- Benchmark State ---
+// One run per entry in config.tracks; the arrays hold one sample per tick of the current run.
+static BenchConfig benchConfig;
+static void (*benchRenderFrame)(void) = NULL;
+static InputScript benchScript;
+static int benchUseScript = 0;
+static int benchTrackIndex = 0;    // Index into benchConfig.tracks of the run in progress
+static long benchTicks = 0;        // Ticks (= frames) in the current run
+static long benchMaxTicks = 0;
+static double* benchFrameTimes = NULL; // Seconds spent rendering each frame
+static double* benchTickTimes = NULL;  // Seconds spent on input + stepGame() each tick
+static double* benchLapTimes = NULL;   // Completed lap times (seconds) in the current run
+static int benchLapsSeen = 0;
+static int benchFailedTracks = 0;
+
+static const char* benchTrackNames[NUM_TRACK_OPTIONS] = { "rect", "round" };
+
+
+// --- Statistics Helpers ---
+static int compareDoubles(const void* a, const void* b) {
+    double da = *(const double*)a, db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+// Prints mean, median, 99th percentile and max of 'count' samples (sorted in place), scaled by 'scale'.
+static void printSampleStats(const char* label, double* samples, long count, double scale) {
+    if (count <= 0) { printf("  %-9s: no samples\n", label); return; }
+    double sum = 0.0;
+    for (long i = 0; i < count; ++i) sum += samples[i];
+    qsort(samples, (size_t)count, sizeof(double), compareDoubles);
+    printf("  %-9s: mean %8.3f  p50 %8.3f  p99 %8.3f  max %8.3f\n", label,
+           sum / count * scale, samples[count / 2] * scale,
+           samples[(long)((count - 1) * 0.99)] * scale, samples[count - 1] * scale);
+}
+
+
+// --- Run Control ---
+static void beginBenchTrack(void) {
+    TrackType track = benchConfig.tracks[benchTrackIndex];
+    startGame(track); // Same path as selecting the track in the menu
+    benchTicks = 0;
+    benchLapsSeen = 0;
+    if (benchUseScript) rewindInputScript(&benchScript);
+    printf("Bench: running %d laps on %s (%s)\n", benchConfig.laps, benchTrackNames[track],
+           benchUseScript ? benchConfig.scriptPath : "autopilot");
+}
+
+static void finishBenchTrack(void) {
+    TrackType track = benchConfig.tracks[benchTrackIndex];
+    int completed = (benchLapsSeen >= benchConfig.laps);
+    if (!completed) benchFailedTracks++;
+
+    printf("Bench [%s]: %d/%d laps, %ld ticks (%.1f s simulated)%s\n", benchTrackNames[track],
+           benchLapsSeen, benchConfig.laps, benchTicks, (double)benchTicks / FRAME_RATE,
+           completed ? "" : " - DID NOT FINISH");
+    printSampleStats("frame ms", benchFrameTimes, benchTicks, 1000.0);
+    printSampleStats("tick us", benchTickTimes, benchTicks, 1000000.0);
+    if (benchLapsSeen > 0) {
+        double best = benchLapTimes[0], sum = 0.0;
+        for (int i = 0; i < benchLapsSeen; ++i) {
+            sum += benchLapTimes[i];
+            if (benchLapTimes[i] < best) best = benchLapTimes[i];
+        }
+        printf("  %-9s: best %8.3f  mean %8.3f  last %8.3f\n", "lap s",
+               best, sum / benchLapsSeen, benchLapTimes[benchLapsSeen - 1]);
+    }
+}
+
+// --- Idle Callback: One Benchmark Frame ---
+static void benchIdle(void) {
+    double tickStart = getTimeSeconds();
+    if (benchUseScript) {
+        playInputScript(&benchScript, simTickCount - raceStartTick);
+    } else if (currentGameState == STATE_RACING) {
+        for (int p = 0; p < numPlayers; ++p) updateAIControls(&playerCars[p]);
+    }
+    stepGame();
+    double frameStart = getTimeSeconds();
+    benchRenderFrame();
+    double frameEnd = getTimeSeconds();
+
+    benchTickTimes[benchTicks] = frameStart - tickStart;
+    benchFrameTimes[benchTicks] = frameEnd - frameStart;
+    benchTicks++;
+
+    // Collect newly completed laps (stepGame() updates the timers; player 1's are reported)
+    while (benchLapsSeen < playerLapTimers[0].lapsCompleted && benchLapsSeen < benchConfig.laps) {
+        benchLapTimes[benchLapsSeen++] = playerLapTimers[0].lastLapTimeMs / 1000.0;
+    }
+
+    // A run ends when its laps are done, the time limit is hit, or the script left the race (ESC)
+    if (benchLapsSeen >= benchConfig.laps || benchTicks >= benchMaxTicks || currentGameState != STATE_RACING) {
+        finishBenchTrack();
+        benchTrackIndex++;
+        if (benchTrackIndex < benchConfig.numTracks) {
+            beginBenchTrack();
+        } else {
+            glutIdleFunc(NULL);
+            free(benchFrameTimes); free(benchTickTimes); free(benchLapTimes);
+            benchFrameTimes = benchTickTimes = benchLapTimes = NULL;
+            if (benchUseScript) freeInputScript(&benchScript);
+            glutLeaveMainLoop();
+        }
+    }
+}
+
+
+// --- Benchmark Start ---
+int startBenchmark(const BenchConfig* config, void (*renderFrame)(void)) {
+    benchConfig = *config;
+    benchRenderFrame = renderFrame;
+    benchUseScript = (config->scriptPath != NULL);
+    if (benchUseScript && !loadInputScript(&benchScript, config->scriptPath)) return 0;
+
+    benchMaxTicks = (long)(config->maxSimSeconds * FRAME_RATE);
+    if (benchMaxTicks < 1) benchMaxTicks = 1;
+    benchFrameTimes = (double*)malloc((size_t)benchMaxTicks * sizeof(double));
+    benchTickTimes = (double*)malloc((size_t)benchMaxTicks * sizeof(double));
+    benchLapTimes = (double*)malloc((size_t)config->laps * sizeof(double));
+    if (!benchFrameTimes || !benchTickTimes || !benchLapTimes) {
+        fprintf(stderr, "Bench: out of memory for %ld samples\n", benchMaxTicks);
+        return 0;
+    }
+
+    benchTrackIndex = 0;
+    benchFailedTracks = 0;
+    beginBenchTrack();
+    glutIdleFunc(benchIdle);
+    return 1;
+}
+
+int getBenchmarkExitCode(void) {
+    return benchFailedTracks > 0 || benchTrackIndex < benchConfig.numTracks ? 1 : 0;
+}
+
+
+// --- Command Line Parsing ---
+int parseBenchArgs(int argc, char** argv, BenchConfig* config) {
+    config->tracks[0] = TRACK_RECT;
+    config->tracks[1] = TRACK_ROUNDED;
+    config->numTracks = 2;
+    config->laps = BENCH_DEFAULT_LAPS;
+    config->maxSimSeconds = BENCH_DEFAULT_MAX_SECONDS;
+    config->scriptPath = NULL;
+
+    for (int i = 0; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "track=", 6) == 0) {
+            const char* value = arg + 6;
+            config->numTracks = 1;
+            if (strcmp(value, "rect") == 0) config->tracks[0] = TRACK_RECT;
+            else if (strcmp(value, "round") == 0) config->tracks[0] = TRACK_ROUNDED;
+            else if (strcmp(value, "both") == 0) { config->tracks[0] = TRACK_RECT; config->tracks[1] = TRACK_ROUNDED; config->numTracks = 2; }
+            else { fprintf(stderr, "Bench: unknown track '%s' (rect|round|both)\n", value); return 0; }
+        } else if (strncmp(arg, "laps=", 5) == 0) {
+            config->laps = atoi(arg + 5);
+        } else if (strncmp(arg, "time=", 5) == 0) {
+            config->maxSimSeconds = (float)strtod(arg + 5, NULL);
+        } else if (strncmp(arg, "script=", 7) == 0) {
+            config->scriptPath = arg + 7;
+        } else {
+            fprintf(stderr, "Bench: unknown option '%s'\n", arg);
+            return 0;
+        }
+    }
+
+    if (config->laps < 1) config->laps = 1;
+    return 1;
+}
@@ -0,0 +1,34 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "game.h" // TrackType, NUM_TRACK_OPTIONS
+
+// --- Benchmark Defaults ---
+#define BENCH_DEFAULT_LAPS 3            // Timed laps per track
+#define BENCH_DEFAULT_MAX_SECONDS 300.0f // Simulated time limit per track (a stuck script counts as a DNF)
+
+// --- Benchmark Configuration ---
+// Filled from "--bench key=value ..." (see parseBenchArgs).
+typedef struct {
+    TrackType tracks[NUM_TRACK_OPTIONS]; // Tracks to run, in order
+    int numTracks;
+    int laps;                            // Timed laps to complete on each track
+    float maxSimSeconds;                 // Per-track limit in simulated seconds
+    const char* scriptPath;              // Input script replayed on each track; NULL = autopilot (ai.c)
+} BenchConfig;
+
+// --- Function Declarations ---
+// Parses "track=rect|round|both laps=N time=S script=path". Returns 1 on success.
+int parseBenchArgs(int argc, char** argv, BenchConfig* config);
+
+// Takes over the GLUT idle loop: each iteration applies the scripted input, runs one
+// fixed tick (stepGame) and renders one frame with 'renderFrame', timing both. Frames
+// run back to back (no timer wait), so the workload is identical on every run.
+// Prints statistics per track and leaves the GLUT main loop when done.
+// Returns 1 if the benchmark was started (the script loaded).
+int startBenchmark(const BenchConfig* config, void (*renderFrame)(void));
+
+// 0 once every track completed its laps, 1 otherwise.
+int getBenchmarkExitCode(void);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,255 @@
+#include "capture.h" // CaptureStats and prototypes
+#include "thread.h"  // Writer thread, queue lock
+#include "image.h"   // PNG sequence output
+#include <GL/glew.h> // Pixel buffer objects
+#include <stdio.h>   // For printf, fprintf, snprintf, FILE
+#include <stdlib.h>  // For malloc, free
+#include <string.h>  // For strlen, strcmp, memcpy
+
+CaptureStats captureStats = { 0, 0, 0 };
+
+// --- Readback Ring (render thread only) ---
+static int capturing = 0;
+static int usePixelBuffers = 0;             // 0: synchronous glReadPixels straight into the queue
+static GLuint pixelBuffers[CAPTURE_PBO_COUNT];
+static int pixelBufferPending[CAPTURE_PBO_COUNT]; // Holds a frame that has not been mapped yet
+static long pixelBufferFrame[CAPTURE_PBO_COUNT];  // Frame number it holds
+static long nextFrameNumber = 0;            // Counts every frame offered, dropped or not
+static int nextPixelBuffer = 0;
+static int frameWidth = 0, frameHeight = 0; // Fixed by the first frame (0 = none yet)
+static size_t frameBytes = 0;               // RGBA, rows bottom to top as read
+
+// --- Writer Queue (shared, guarded by queueLock) ---
+// Slots are handed over by index: the render thread fills slot (head + count) % N outside the
+// lock and then publishes it, the writer encodes slot 'head' and then releases it.
+static unsigned char* queueFrames[CAPTURE_QUEUE_FRAMES];
+static long queueFrameNumbers[CAPTURE_QUEUE_FRAMES]; // PNG names keep gaps where frames were dropped
+static int queueHead = 0, queueCount = 0;
+static int writerStopping = 0;
+static Mutex queueLock;
+static CondVar queueNotEmpty, queueNotFull;
+static Thread writerThread;
+static int writerRunning = 0;
+
+// --- Output (writer thread only) ---
+static const char* outputPath = NULL;
+static FILE* yuvFile = NULL;                // NULL: PNG sequence
+static unsigned char* encodeBuffer = NULL;  // RGB for PNG, I420 for YUV
+static int writeFailed = 0;
+
+// Converts one bottom-up RGBA frame to I420 (BT.601, studio range), top row first.
+// Chroma is the average of each 2x2 block; odd edges reuse the last row/column.
+static void rgbaToI420(const unsigned char* rgba, int width, int height, unsigned char* yuv) {
+    int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+    unsigned char* planeY = yuv;
+    unsigned char* planeU = yuv + (size_t)width * height;
+    unsigned char* planeV = planeU + (size_t)chromaWidth * chromaHeight;
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* row = rgba + (size_t)(height - 1 - y) * width * 4;
+        for (int x = 0; x < width; ++x) {
+            const unsigned char* p = row + x * 4;
+            planeY[(size_t)y * width + x] = (unsigned char)((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) / 256 + 16);
+        }
+    }
+    for (int cy = 0; cy < chromaHeight; ++cy) {
+        int y0 = cy * 2, y1 = (y0 + 1 < height) ? y0 + 1 : y0;
+        const unsigned char* row0 = rgba + (size_t)(height - 1 - y0) * width * 4;
+        const unsigned char* row1 = rgba + (size_t)(height - 1 - y1) * width * 4;
+        for (int cx = 0; cx < chromaWidth; ++cx) {
+            int x0 = cx * 2, x1 = (x0 + 1 < width) ? x0 + 1 : x0;
+            int r = row0[x0 * 4] + row0[x1 * 4] + row1[x0 * 4] + row1[x1 * 4];
+            int g = row0[x0 * 4 + 1] + row0[x1 * 4 + 1] + row1[x0 * 4 + 1] + row1[x1 * 4 + 1];
+            int b = row0[x0 * 4 + 2] + row0[x1 * 4 + 2] + row1[x0 * 4 + 2] + row1[x1 * 4 + 2];
+            size_t i = (size_t)cy * chromaWidth + cx;
+            planeU[i] = (unsigned char)((-38 * r - 74 * g + 112 * b + 512) / 1024 + 128);
+            planeV[i] = (unsigned char)((112 * r - 94 * g - 18 * b + 512) / 1024 + 128);
+        }
+    }
+}
+
+// Encodes and writes one frame. Returns 1 on success.
+static int writeFrame(const unsigned char* rgba, long index) {
+    if (yuvFile) {
+        size_t yuvBytes = (size_t)frameWidth * frameHeight + 2 * (size_t)((frameWidth + 1) / 2) * ((frameHeight + 1) / 2);
+        rgbaToI420(rgba, frameWidth, frameHeight, encodeBuffer);
+        return fwrite(encodeBuffer, 1, yuvBytes, yuvFile) == yuvBytes;
+    }
+    size_t pixels = (size_t)frameWidth * frameHeight;
+    for (size_t i = 0; i < pixels; ++i) memcpy(encodeBuffer + i * 3, rgba + i * 4, 3); // Drop alpha
+    char path[512];
+    snprintf(path, sizeof(path), "%s_%05ld.png", outputPath, index);
+    return writePNGFlipped(path, frameWidth, frameHeight, encodeBuffer);
+}
+
+static void captureWriter(void* arg) {
+    (void)arg;
+    for (;;) {
+        lockMutex(&queueLock);
+        while (queueCount == 0 && !writerStopping) waitCondVar(&queueNotEmpty, &queueLock);
+        if (queueCount == 0) { unlockMutex(&queueLock); break; } // Stopping and drained
+        unsigned char* frame = queueFrames[queueHead];
+        long number = queueFrameNumbers[queueHead];
+        unlockMutex(&queueLock);
+
+        if (!writeFailed) {
+            if (writeFrame(frame, number)) captureStats.framesWritten++;
+            else { writeFailed = 1; fprintf(stderr, "Capture: cannot write to %s, discarding the rest\n", outputPath); }
+        }
+
+        lockMutex(&queueLock);
+        queueHead = (queueHead + 1) % CAPTURE_QUEUE_FRAMES;
+        queueCount--;
+        signalCondVar(&queueNotFull);
+        unlockMutex(&queueLock);
+    }
+}
+
+
+// --- Queue Hand-Off (render thread) ---
+// Returns the slot index to fill next, or -1 if the queue is full (and 'wait' is 0).
+static int acquireQueueSlot(int wait) {
+    lockMutex(&queueLock);
+    while (wait && queueCount == CAPTURE_QUEUE_FRAMES) waitCondVar(&queueNotFull, &queueLock);
+    int slot = queueCount < CAPTURE_QUEUE_FRAMES ? (queueHead + queueCount) % CAPTURE_QUEUE_FRAMES : -1;
+    unlockMutex(&queueLock);
+    return slot;
+}
+
+static void publishQueueSlot(int slot, long frameNumber) {
+    lockMutex(&queueLock);
+    queueFrameNumbers[slot] = frameNumber;
+    queueCount++;
+    signalCondVar(&queueNotEmpty);
+    unlockMutex(&queueLock);
+    captureStats.framesCaptured++;
+}
+
+// Maps a filled pixel buffer and queues its frame ('wait': block on a full queue instead of dropping).
+static void collectPixelBuffer(int index, int wait) {
+    if (!pixelBufferPending[index]) return;
+    pixelBufferPending[index] = 0;
+    int slot = acquireQueueSlot(wait);
+    if (slot < 0) { captureStats.framesDropped++; return; } // Writer behind: don't even map it
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[index]);
+    const void* pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (pixels) {
+        memcpy(queueFrames[slot], pixels, frameBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        publishQueueSlot(slot, pixelBufferFrame[index]);
+    } else {
+        captureStats.framesDropped++;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+
+// --- Public Interface ---
+int isCapturing(void) { return capturing; }
+
+int startCapture(const char* path) {
+    size_t length = strlen(path);
+    outputPath = path;
+    yuvFile = NULL;
+    if (length > 4 && strcmp(path + length - 4, ".yuv") == 0) {
+        yuvFile = fopen(path, "wb");
+        if (!yuvFile) { fprintf(stderr, "Capture: cannot open %s\n", path); return 0; }
+    }
+
+    usePixelBuffers = GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object;
+    if (usePixelBuffers) glGenBuffers(CAPTURE_PBO_COUNT, pixelBuffers);
+    else fprintf(stderr, "Capture: pixel buffer objects not available, reading back synchronously\n");
+    for (int i = 0; i < CAPTURE_PBO_COUNT; ++i) pixelBufferPending[i] = 0;
+    nextPixelBuffer = 0;
+    nextFrameNumber = 0;
+    frameWidth = frameHeight = 0;
+    captureStats.framesCaptured = captureStats.framesWritten = captureStats.framesDropped = 0;
+    writeFailed = 0;
+
+    queueHead = queueCount = 0;
+    writerStopping = 0;
+    initMutex(&queueLock);
+    initCondVar(&queueNotEmpty);
+    initCondVar(&queueNotFull);
+    capturing = 1; // Buffers are allocated with the first frame, once its size is known
+    printf("Status: Capturing frames to %s (%s)\n", path, yuvFile ? "raw I420" : "PNG sequence");
+    return 1;
+}
+
+// Allocates the queue and encode buffers for the first frame's size and starts the writer.
+static int allocateCapture(int width, int height) {
+    frameWidth = width;
+    frameHeight = height;
+    frameBytes = (size_t)width * height * 4;
+    for (int i = 0; i < CAPTURE_QUEUE_FRAMES; ++i) queueFrames[i] = (unsigned char*)malloc(frameBytes);
+    encodeBuffer = (unsigned char*)malloc((size_t)width * height * 3); // Enough for RGB and for I420 (1.5 B/px)
+    int ok = encodeBuffer != NULL;
+    for (int i = 0; i < CAPTURE_QUEUE_FRAMES; ++i) ok = ok && queueFrames[i] != NULL;
+    if (ok && usePixelBuffers) {
+        for (int i = 0; i < CAPTURE_PBO_COUNT; ++i) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)frameBytes, NULL, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    if (ok) ok = writerRunning = startThread(&writerThread, captureWriter, NULL);
+    if (!ok) fprintf(stderr, "Capture: cannot allocate %dx%d frame buffers or start the writer\n", width, height);
+    return ok;
+}
+
+void captureFrame(int width, int height) {
+    if (!capturing) return;
+    if (frameWidth == 0 && !allocateCapture(width, height)) { stopCapture(); return; }
+    long frameNumber = nextFrameNumber++;
+    if (width != frameWidth || height != frameHeight) { captureStats.framesDropped++; return; }
+
+    if (!usePixelBuffers) {
+        int slot = acquireQueueSlot(0);
+        if (slot < 0) { captureStats.framesDropped++; return; }
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, queueFrames[slot]);
+        publishQueueSlot(slot, frameNumber);
+        return;
+    }
+
+    // Start this frame's copy (asynchronous: the pack buffer is the destination)...
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[nextPixelBuffer]);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    pixelBufferPending[nextPixelBuffer] = 1;
+    pixelBufferFrame[nextPixelBuffer] = frameNumber;
+    nextPixelBuffer = (nextPixelBuffer + 1) % CAPTURE_PBO_COUNT;
+    // ...and collect the oldest one, read CAPTURE_PBO_COUNT - 1 frames ago
+    collectPixelBuffer(nextPixelBuffer, 0);
+}
+
+void stopCapture(void) {
+    if (!capturing) return;
+    capturing = 0;
+    if (writerRunning) {
+        // The last frames are still in the ring: queue them, waiting for room this time
+        for (int i = 0; i < CAPTURE_PBO_COUNT; ++i) {
+            collectPixelBuffer((nextPixelBuffer + i) % CAPTURE_PBO_COUNT, 1);
+        }
+        lockMutex(&queueLock);
+        writerStopping = 1;
+        signalCondVar(&queueNotEmpty);
+        unlockMutex(&queueLock);
+        joinThread(&writerThread);
+        writerRunning = 0;
+    }
+    if (usePixelBuffers) glDeleteBuffers(CAPTURE_PBO_COUNT, pixelBuffers);
+    for (int i = 0; i < CAPTURE_QUEUE_FRAMES; ++i) { free(queueFrames[i]); queueFrames[i] = NULL; }
+    free(encodeBuffer);
+    encodeBuffer = NULL;
+    if (yuvFile) {
+        if (fclose(yuvFile) != 0 && !writeFailed) fprintf(stderr, "Capture: error closing %s\n", outputPath);
+        yuvFile = NULL;
+    }
+    destroyCondVar(&queueNotEmpty);
+    destroyCondVar(&queueNotFull);
+    destroyMutex(&queueLock);
+
+    printf("Capture: %ld frames captured, %ld written to %s, %ld dropped",
+           captureStats.framesCaptured, captureStats.framesWritten, outputPath, captureStats.framesDropped);
+    if (frameWidth > 0) printf(" (%dx%d)", frameWidth, frameHeight);
+    printf("\n");
+}
@@ -0,0 +1,33 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+// --- Frame Capture ---
+// Records the rendered frames to disk without stalling the render loop. Each frame is read
+// back into one of CAPTURE_PBO_COUNT pixel buffer objects (glReadPixels returns immediately)
+// and mapped CAPTURE_PBO_COUNT - 1 frames later, when the copy has long finished. The mapped
+// pixels are copied into a queue that a worker thread encodes and writes. If the worker falls
+// behind and the queue is full, the frame is dropped instead of waiting for it.
+//
+// Output: a path ending in ".yuv" is one raw I420 (yuv420p) stream, e.g.
+//   ffplay -f rawvideo -pixel_format yuv420p -video_size 1280x720 -framerate 60 capture.yuv
+// anything else is a prefix for a PNG sequence (<prefix>_00000.png, ...).
+// The capture size is fixed by the first captured frame; frames of another size are dropped.
+
+#define CAPTURE_PBO_COUNT 3    // Readback ring: frames are mapped two frames after the read
+#define CAPTURE_QUEUE_FRAMES 8 // Frames waiting for the writer before new ones are dropped
+
+typedef struct {
+    long framesCaptured; // Read back and handed to the writer
+    long framesWritten;  // Encoded and written by the worker
+    long framesDropped;  // Queue full (writer behind) or wrong size
+} CaptureStats;
+
+extern CaptureStats captureStats;
+
+// --- Function Declarations ---
+int startCapture(const char* path); // Starts the writer thread; needs a current GL context. Returns 1 on success.
+void captureFrame(int width, int height); // After drawing, before the buffer swap (no-op when not capturing)
+void stopCapture(void);             // Flushes pending frames, joins the writer and prints the counts
+int isCapturing(void);
+
+#endif // CAPTURE_H
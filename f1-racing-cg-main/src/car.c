@@ -1,11 +1,10 @@
+// Car physics only (no GL): also linked into the dedicated server. Drawing is in car_render.c.
 #include "car.h"      // Defines the Car struct and function prototypes
-#include "track.h"    // Defines track boundaries and isPositionOnTrack()
+#include "track.h"    // Defines track boundaries
 #include "game.h"     // Defines selectedTrackType and TrackType enum (assuming this exists in game.h)
+#include "surface.h"  // Surface materials under the wheels
 
-#include <GL/glew.h>     // For OpenGL types (indirectly used via GLUT)
-#include <GL/freeglut.h> // For rendering primitives like glutSolidCube
 #include <math.h>        // For sinf, cosf, fabsf, fmodf, fmaxf, fminf, powf, sqrtf
-#include <stdio.h>       // For optional debugging printf statements
 
 // Define M_PI if not already defined by math.h
 #ifndef M_PI
@@ -62,6 +61,19 @@ void initCar(Car* car) {
     car->width = 1.0f;
     car->height = 0.5f;
     car->length = 2.2f;
+
+    // --- Statistics ---
+    car->collisions = 0;
+    car->hitWall = 0;
+    car->ticksOffWall = CAR_WALL_CONTACT_GAP + 1;
+
+    // --- Surface ---
+    // The start position is on the asphalt. The maps are baked by the first car of the process.
+    bakeSurfaceMaps();
+    for (int i = 0; i < 4; ++i) car->wheelSurface[i] = SURFACE_ASPHALT;
+
+    // --- Appearance ---
+    car->color[0] = 1.0f; car->color[1] = 0.0f; car->color[2] = 0.0f; // Red (other players: see initGame)
 }
 
 
@@ -126,6 +138,16 @@ void updateCar(Car* car, float deltaTime) {
     if (car->turning_right && fabsf(car->speed) > 0.1f) car->angle -= current_turn_speed * deltaTime;
     car->angle = fmodf(car->angle + 360.0f, 360.0f);
 
+    // Grip and drag of the surface, averaged over the four wheels (as they stood after the last move).
+    // All four on asphalt (SURFACE_ASPHALT is 0) is nearly every tick: that needs no table at all.
+    float grip = 1.0f, drag = 0.0f;
+    if (car->wheelSurface[0] | car->wheelSurface[1] | car->wheelSurface[2] | car->wheelSurface[3]) {
+        grip = 0.25f * (surfaceGrip[car->wheelSurface[0]].grip + surfaceGrip[car->wheelSurface[1]].grip
+                      + surfaceGrip[car->wheelSurface[2]].grip + surfaceGrip[car->wheelSurface[3]].grip);
+        drag = 0.25f * (surfaceGrip[car->wheelSurface[0]].drag + surfaceGrip[car->wheelSurface[1]].drag
+                      + surfaceGrip[car->wheelSurface[2]].drag + surfaceGrip[car->wheelSurface[3]].drag);
+    }
+
     // --- 2. Apply Acceleration/Braking --- (Code as provided by user)
     float effective_accel = 0.0f;
     if (car->accelerating) effective_accel = car->acceleration_rate;
@@ -133,7 +155,8 @@ void updateCar(Car* car, float deltaTime) {
         if (car->speed > 0.01f) effective_accel -= car->braking_rate;
         else if (car->speed < -0.01f) effective_accel += car->braking_rate;
     }
-    car->speed += effective_accel * deltaTime;
+    car->speed += effective_accel * grip * deltaTime; // grip is exactly 1 on asphalt
+    if (drag > 0.0f) car->speed -= car->speed * drag * deltaTime; // Off the asphalt: rolling resistance
 
     // --- 3. Apply Friction --- (Code as provided by user)
     if (!car->accelerating && !car->braking && fabsf(car->speed) > 0.01f) {
@@ -158,118 +181,80 @@ void updateCar(Car* car, float deltaTime) {
         float potential_x = car->x + dx;
         float potential_z = car->z + dz;
 
-        // Calculate potential CORNER positions based on the potential center
-        float pot_fl_x, pot_fl_z, pot_fr_x, pot_fr_z; // Front corners
-        float pot_rl_x, pot_rl_z, pot_rr_x, pot_rr_z; // Rear corners
-        calculateCarCorners(potential_x, potential_z, car->angle,
-                            car->width, car->length,
-                            &pot_fl_x, &pot_fl_z, &pot_fr_x, &pot_fr_z,
-                            &pot_rl_x, &pot_rl_z, &pot_rr_x, &pot_rr_z);
-
-        // Check if ANY potential corner is off the track
-        int collisionDetected = 0; // Use int for boolean (0 = false, 1 = true)
-        if (!isPositionOnTrack(pot_fl_x, pot_fl_z)) collisionDetected = 1;
-        if (!isPositionOnTrack(pot_fr_x, pot_fr_z)) collisionDetected = 1;
-        if (!isPositionOnTrack(pot_rl_x, pot_rl_z)) collisionDetected = 1;
-        if (!isPositionOnTrack(pot_rr_x, pot_rr_z)) collisionDetected = 1;
+        // Surface under each potential corner: off the asphalt is allowed (with less grip), only a
+        // corner reaching the guardrails is a collision. Well inside the road edges, all four are
+        // asphalt without computing the corners at all.
+        unsigned int surfaces = 0; // SURFACE_ASPHALT for all four
+        float half_diagonal = 0.5f * sqrtf(car->width * car->width + car->length * car->length);
+        if (!isCarOnAsphalt(potential_x, potential_z, half_diagonal)) {
+            // Calculate potential CORNER positions based on the potential center
+            float pot[8]; // x, z of the front-left, front-right, rear-left and rear-right corners
+            calculateCarCorners(potential_x, potential_z, car->angle,
+                                car->width, car->length,
+                                &pot[0], &pot[1], &pot[2], &pot[3],
+                                &pot[4], &pot[5], &pot[6], &pot[7]);
+            surfaces = getWheelSurfaces(pot);
+        }
+        int collisionDetected = (surfaces & SURFACE_WHEELS_BARRIER) != 0;
 
         // --- 6. Collision Detection and Response ---
         if (!collisionDetected) { // If collisionDetected is 0 (false)
             // Position is valid: Update the car's actual position.
             car->x = potential_x;
             car->z = potential_z;
+            for (int i = 0; i < 4; ++i) car->wheelSurface[i] = (unsigned char)(surfaces >> (8 * i));
+            car->hitWall = 0;
+            if (car->ticksOffWall <= CAR_WALL_CONTACT_GAP) car->ticksOffWall++;
         } else { // If collisionDetected is 1 (true)
             // Collision Occurred!
             // Simple Response: Revert to the last known valid position and stop the car.
             car->x = car->prev_x;
             car->z = car->prev_z;
             car->speed = 0.0f; // Bring car to a complete halt
-
-            // Optional: Add sound effect or visual feedback here later.
-            // printf("Corner Collision! Pos:(%.2f, %.2f) Speed set to 0.\n", car->x, car->z); // Debug output
+            // Counted for headless runs (sweep results, AI evaluation): once per contact, not per
+            // tick, so a car held against a rail for a second is one collision rather than 60. A
+            // car pushing into a wall creeps up to it between blocked ticks; that is still one.
+            if (car->ticksOffWall > CAR_WALL_CONTACT_GAP) car->collisions++;
+            car->hitWall = 1;
+            car->ticksOffWall = 0;
+
+            // No printing here (this runs every tick): wall contacts show up in --telemetry logs
+            // as surface = SURFACE_BARRIER, from 'hitWall', without any I/O on the sim thread.
         }
     } else {
          // If speed is near zero, explicitly set it to zero to prevent potential drift.
          car->speed = 0.0f;
+         car->hitWall = 0; // Not pushing against anything this tick
+         if (car->ticksOffWall <= CAR_WALL_CONTACT_GAP) car->ticksOffWall++;
     }
 }
 
 
-// --- Car Rendering --- (Code as provided by user)
-// Draws the car model (currently a composite cube structure) at its current position and orientation.
-void renderCar(const Car* car) {
-    glPushMatrix(); // Save the current OpenGL matrix state
-
-    // Apply transformations: Move to car's position and rotate to its angle.
-    glTranslatef(car->x, car->y, car->z);
-    glRotatef(car->angle, 0.0f, 1.0f, 0.0f); // Rotate around the Y-axis (vertical)
-
-    // --- Car Body (Red) ---
-    glPushMatrix();
-    glScalef(car->width, car->height, car->length);
-    glColor3f(1.0f, 0.0f, 0.0f); // Red color
-    glutSolidCube(1.0f);
-    glPopMatrix();
-
-    // --- Wheels (Dark Grey Cubes) ---
-    float wheelRadius = 0.35f * car->height;
-    float wheelWidth = 0.15f * car->width;
-    float wheelDistX = (car->width / 2.0f) + wheelWidth * 0.5f;
-    float wheelDistZ = (car->length / 2.0f) * 0.7f;
-    glColor3f(0.1f, 0.1f, 0.1f);
-    // FL
-    glPushMatrix();
-    glTranslatef(-wheelDistX, 0.0f, wheelDistZ);
-    glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
-    glScalef(wheelWidth, wheelRadius * 2.0f, wheelRadius * 2.0f);
-    glutSolidCube(1.0f);
-    glPopMatrix();
-    // FR
-    glPushMatrix();
-    glTranslatef(wheelDistX, 0.0f, wheelDistZ);
-    glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
-    glScalef(wheelWidth, wheelRadius * 2.0f, wheelRadius * 2.0f);
-    glutSolidCube(1.0f);
-    glPopMatrix();
-    // RL
-    glPushMatrix();
-    glTranslatef(-wheelDistX, 0.0f, -wheelDistZ);
-    glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
-    glScalef(wheelWidth, wheelRadius * 2.0f, wheelRadius * 2.0f);
-    glutSolidCube(1.0f);
-    glPopMatrix();
-    // RR
-    glPushMatrix();
-    glTranslatef(wheelDistX, 0.0f, -wheelDistZ);
-    glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
-    glScalef(wheelWidth, wheelRadius * 2.0f, wheelRadius * 2.0f);
-    glutSolidCube(1.0f);
-    glPopMatrix();
-
-    // --- Driver Helmet Indicator (White Cube) ---
-    glPushMatrix();
-    glTranslatef(0.0f, car->height * 0.6f, -car->length * 0.1f);
-    float helmetSize = 0.15f;
-    glScalef(helmetSize, helmetSize, helmetSize);
-    glColor3f(1.0f, 1.0f, 1.0f); // White color
-    glutSolidCube(1.0f);
-    glPopMatrix();
-
-    glPopMatrix(); // Restore the matrix state from before car transformations
-}
-
-
 // --- Car Control Input --- (Code as provided by user)
-// Updates the car's control state flags based on keyboard input.
-void setCarControls(Car* car, int key, int state) {
-    switch (key) {
-        case 'w': case 'W':
+// Updates the car's control state flags. Keys are mapped to controls per player in game.c.
+void setCarControl(Car* car, CarControl control, int state) {
+    switch (control) {
+        case CAR_CONTROL_ACCELERATE:
             car->accelerating = state; if(state) car->braking = 0; break;
-        case 's': case 'S':
+        case CAR_CONTROL_BRAKE:
             car->braking = state; if(state) car->accelerating = 0; break;
-        case 'a': case 'A':
+        case CAR_CONTROL_LEFT:
             car->turning_left = state; break;
-        case 'd': case 'D':
+        case CAR_CONTROL_RIGHT:
             car->turning_right = state; break;
+        default: break;
     }
-}
\ No newline at end of file
+}
+
+// Controls as a bit set (1 << CarControl), the form they travel in over the network
+unsigned char getCarControlBits(const Car* car) {
+    return (unsigned char)((car->accelerating ? 1 << CAR_CONTROL_ACCELERATE : 0) | (car->braking ? 1 << CAR_CONTROL_BRAKE : 0) |
+                           (car->turning_left ? 1 << CAR_CONTROL_LEFT : 0) | (car->turning_right ? 1 << CAR_CONTROL_RIGHT : 0));
+}
+
+void setCarControlBits(Car* car, unsigned char bits) {
+    car->accelerating = (bits >> CAR_CONTROL_ACCELERATE) & 1;
+    car->braking = (bits >> CAR_CONTROL_BRAKE) & 1;
+    car->turning_left = (bits >> CAR_CONTROL_LEFT) & 1;
+    car->turning_right = (bits >> CAR_CONTROL_RIGHT) & 1;
+}
@@ -1,6 +1,8 @@
 #ifndef CAR_H
 #define CAR_H
 
+#define CAR_WALL_CONTACT_GAP 30 // Ticks clear of the walls before the next blocked tick is a new contact
+
 // Basic struct to hold car state
 typedef struct {
     // Position
@@ -35,13 +37,35 @@ typedef struct {
     float height;
     float length;
 
+    // Statistics
+    int collisions;     // Number of wall contacts since initCar() (not ticks against a wall)
+    int hitWall;        // 1 if updateCar() undid this tick's move (the car is against a wall)
+    int ticksOffWall;   // Ticks since hitWall was last set, up to CAR_WALL_CONTACT_GAP + 1
+
+    // Surface
+    unsigned char wheelSurface[4]; // SurfaceMaterial under each corner (FL, FR, RL, RR) after the last move
+
+    // Appearance
+    float color[3]; // Body RGB
+
 } Car;
 
+// Driving controls, each held down or released (see setCarControl)
+typedef enum {
+    CAR_CONTROL_ACCELERATE,
+    CAR_CONTROL_BRAKE,
+    CAR_CONTROL_LEFT,
+    CAR_CONTROL_RIGHT,
+    NUM_CAR_CONTROLS
+} CarControl;
+
 // Function declarations
 void initCar(Car* car);
 void updateCar(Car* car, float deltaTime);
 void renderCar(const Car* car);
-void setCarControls(Car* car, int key, int state); // 1 for down, 0 for up
+void setCarControl(Car* car, CarControl control, int state); // 1 for down, 0 for up
+unsigned char getCarControlBits(const Car* car);             // Held controls as bits (1 << CarControl)
+void setCarControlBits(Car* car, unsigned char bits);        // For controls received over the network
 
 // --- New Helper Function Prototype ---
 // Calculates the world X, Z coordinates of the car's four corners
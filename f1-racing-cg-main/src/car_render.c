@@ -0,0 +1,130 @@
+#include "car.h"      // Car struct and renderCar() prototype
+#include "renderer.h" // Shader path car submission
+#include "matrix.h"   // Car part transforms for the shader path
+
+#include <GL/glew.h>  // For OpenGL types and immediate-mode calls
+
+
+// --- Unit Cube ---
+// Same geometry as glutSolidCube(1.0f) (centred, outward normals, CCW faces), drawn
+// directly so renderCar() also works without glutInit (offscreen rendering, offscreen.c).
+static const float cubeNormals[6][3] = {
+    { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+};
+static const float cubeFaces[6][4][3] = {
+    { {  0.5f, -0.5f,  0.5f }, {  0.5f, -0.5f, -0.5f }, {  0.5f,  0.5f, -0.5f }, {  0.5f,  0.5f,  0.5f } }, // +X
+    { { -0.5f, -0.5f, -0.5f }, { -0.5f, -0.5f,  0.5f }, { -0.5f,  0.5f,  0.5f }, { -0.5f,  0.5f, -0.5f } }, // -X
+    { { -0.5f,  0.5f,  0.5f }, {  0.5f,  0.5f,  0.5f }, {  0.5f,  0.5f, -0.5f }, { -0.5f,  0.5f, -0.5f } }, // +Y
+    { { -0.5f, -0.5f, -0.5f }, {  0.5f, -0.5f, -0.5f }, {  0.5f, -0.5f,  0.5f }, { -0.5f, -0.5f,  0.5f } }, // -Y
+    { { -0.5f, -0.5f,  0.5f }, {  0.5f, -0.5f,  0.5f }, {  0.5f,  0.5f,  0.5f }, { -0.5f,  0.5f,  0.5f } }, // +Z
+    { {  0.5f, -0.5f, -0.5f }, { -0.5f, -0.5f, -0.5f }, { -0.5f,  0.5f, -0.5f }, {  0.5f,  0.5f, -0.5f } }, // -Z
+};
+
+static void drawUnitCube() {
+    glBegin(GL_QUADS);
+    for (int f = 0; f < 6; ++f) {
+        glNormal3fv(cubeNormals[f]);
+        for (int v = 0; v < 4; ++v) glVertex3fv(cubeFaces[f][v]);
+    }
+    glEnd();
+}
+
+
+// Shader path: the same parts as renderCar() below, as model matrices for the solid pipeline.
+static void submitCarPart(const float carModel[16], float tx, float ty, float tz, float rotY,
+                          float sx, float sy, float sz, float r, float g, float b) {
+    float model[16];
+    for (int i = 0; i < 16; ++i) model[i] = carModel[i];
+    mat4Translate(model, tx, ty, tz);
+    if (rotY != 0.0f) mat4RotateY(model, rotY);
+    mat4Scale(model, sx, sy, sz);
+    submitSolidCube(model, r, g, b);
+}
+
+static void submitCar(const Car* car) {
+    float carModel[16];
+    mat4Identity(carModel);
+    mat4Translate(carModel, car->x, car->y, car->z);
+    mat4RotateY(carModel, car->angle);
+
+    float wheelRadius = 0.35f * car->height;
+    float wheelWidth = 0.15f * car->width;
+    float wheelDistX = (car->width / 2.0f) + wheelWidth * 0.5f;
+    float wheelDistZ = (car->length / 2.0f) * 0.7f;
+    float helmetSize = 0.15f;
+    submitCarPart(carModel, 0.0f, 0.0f, 0.0f, 0.0f, car->width, car->height, car->length,
+                  car->color[0], car->color[1], car->color[2]); // Body
+    for (int w = 0; w < 4; ++w) { // FL, FR, RL, RR
+        float x = (w % 2 == 0) ? -wheelDistX : wheelDistX;
+        float z = (w < 2) ? wheelDistZ : -wheelDistZ;
+        submitCarPart(carModel, x, 0.0f, z, 90.0f, wheelWidth, wheelRadius * 2.0f, wheelRadius * 2.0f, 0.1f, 0.1f, 0.1f);
+    }
+    submitCarPart(carModel, 0.0f, car->height * 0.6f, -car->length * 0.1f, 0.0f, helmetSize, helmetSize, helmetSize,
+                  1.0f, 1.0f, 1.0f); // Helmet
+}
+
+
+// --- Car Rendering --- (Code as provided by user)
+// Draws the car model (currently a composite cube structure) at its current position and orientation.
+void renderCar(const Car* car) {
+    if (renderPath == RENDER_PATH_SHADER) { submitCar(car); return; } // Queued, drawn at flushShaderFrame()
+
+    glPushMatrix(); // Save the current OpenGL matrix state
+
+    // Apply transformations: Move to car's position and rotate to its angle.
+    glTranslatef(car->x, car->y, car->z);
+    glRotatef(car->angle, 0.0f, 1.0f, 0.0f); // Rotate around the Y-axis (vertical)
+
+    // --- Car Body (Red for player 1) ---
+    glPushMatrix();
+    glScalef(car->width, car->height, car->length);
+    glColor3fv(car->color);
+    drawUnitCube();
+    glPopMatrix();
+
+    // --- Wheels (Dark Grey Cubes) ---
+    float wheelRadius = 0.35f * car->height;
+    float wheelWidth = 0.15f * car->width;
+    float wheelDistX = (car->width / 2.0f) + wheelWidth * 0.5f;
+    float wheelDistZ = (car->length / 2.0f) * 0.7f;
+    glColor3f(0.1f, 0.1f, 0.1f);
+    // FL
+    glPushMatrix();
+    glTranslatef(-wheelDistX, 0.0f, wheelDistZ);
+    glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
+    glScalef(wheelWidth, wheelRadius * 2.0f, wheelRadius * 2.0f);
+    drawUnitCube();
+    glPopMatrix();
+    // FR
+    glPushMatrix();
+    glTranslatef(wheelDistX, 0.0f, wheelDistZ);
+    glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
+    glScalef(wheelWidth, wheelRadius * 2.0f, wheelRadius * 2.0f);
+    drawUnitCube();
+    glPopMatrix();
+    // RL
+    glPushMatrix();
+    glTranslatef(-wheelDistX, 0.0f, -wheelDistZ);
+    glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
+    glScalef(wheelWidth, wheelRadius * 2.0f, wheelRadius * 2.0f);
+    drawUnitCube();
+    glPopMatrix();
+    // RR
+    glPushMatrix();
+    glTranslatef(wheelDistX, 0.0f, -wheelDistZ);
+    glRotatef(90.0f, 0.0f, 1.0f, 0.0f);
+    glScalef(wheelWidth, wheelRadius * 2.0f, wheelRadius * 2.0f);
+    drawUnitCube();
+    glPopMatrix();
+
+    // --- Driver Helmet Indicator (White Cube) ---
+    glPushMatrix();
+    glTranslatef(0.0f, car->height * 0.6f, -car->length * 0.1f);
+    float helmetSize = 0.15f;
+    glScalef(helmetSize, helmetSize, helmetSize);
+    glColor3f(1.0f, 1.0f, 1.0f); // White color
+    drawUnitCube();
+    glPopMatrix();
+
+    glPopMatrix(); // Restore the matrix state from before car transformations
+}
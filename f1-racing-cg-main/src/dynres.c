@@ -0,0 +1,229 @@
+#include "dynres.h"  // DynamicResolution and prototypes
+#include <GL/glew.h> // Framebuffer objects, textures
+#include "timing.h"  // getTimeSeconds() when timer queries are missing
+#include <math.h>    // For sqrt, fabs, floorf
+#include <stdio.h>   // For printf, fprintf
+
+DynamicResolution dynRes = { 0, 1.0f, DYNRES_DEFAULT_TARGET_MS, 0.0, 0, 0 };
+
+// --- Framebuffer ---
+// Allocated at the full window size; lower scales render into its lower-left corner, so
+// changing the scale never reallocates anything. Colour goes to a texture that is drawn as a
+// window-sized quad: glBlitFramebuffer with scaling is a slow path in software rasterisers
+// (17 ms vs 1 ms per 1280x720 frame on llvmpipe), the machines this is meant for.
+static GLuint framebuffer = 0, colorTexture = 0, depthBuffer = 0;
+static int bufferWidth = 0, bufferHeight = 0;
+static int redirected = 0; // This frame renders into the framebuffer (scale < 1)
+
+// --- Controller State ---
+static double accumulatedMs = 0.0;
+static int framesMeasured = 0;
+static double fullScaleMs = 0.0; // Last window average at scale 1 (0 = not measured yet)
+static int retryWindows = 0;     // Windows left before trying a reduced scale again
+static double failedFullScaleMs = 0.0; // Full-scale time when a reduced scale last failed (0 = none)
+
+// --- Frame Timing ---
+// A ring of GL_TIME_ELAPSED queries: a result is read once the GPU has it, so nothing waits for
+// the frame to finish (a glFinish per frame would stop the CPU and GPU from overlapping).
+#define DYNRES_TIMER_QUERIES 4
+static GLuint timerQueries[DYNRES_TIMER_QUERIES];
+static double frameCpuMs[DYNRES_TIMER_QUERIES]; // Frame start to swap returned, per query
+static int useTimerQueries = 0;
+static long queriesIssued = 0, queriesRead = 0;
+static double frameTimingStart = 0.0;
+
+int initDynamicResolution(double targetMs) {
+    if (!GLEW_VERSION_3_0 && !GLEW_ARB_framebuffer_object) {
+        fprintf(stderr, "Dynamic resolution: framebuffer objects not available, rendering at window size\n");
+        return 0;
+    }
+    glGenFramebuffers(1, &framebuffer);
+    glGenTextures(1, &colorTexture);
+    glGenRenderbuffers(1, &depthBuffer);
+    useTimerQueries = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (useTimerQueries) glGenQueries(DYNRES_TIMER_QUERIES, timerQueries);
+    queriesIssued = queriesRead = 0;
+    dynRes.enabled = 1;
+    dynRes.scale = DYNRES_MAX_SCALE;
+    dynRes.targetMs = targetMs > 0.0 ? targetMs : DYNRES_DEFAULT_TARGET_MS;
+    dynRes.averageMs = 0.0;
+    printf("Status: Dynamic resolution on (target %.1f ms/frame, scale %.2f-%.2f, %s)\n",
+           dynRes.targetMs, DYNRES_MIN_SCALE, DYNRES_MAX_SCALE,
+           useTimerQueries ? "GPU timer queries and swap time" : "swap time only");
+    return 1;
+}
+
+void shutdownDynamicResolution() {
+    if (!dynRes.enabled) return;
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &colorTexture);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    if (useTimerQueries) glDeleteQueries(DYNRES_TIMER_QUERIES, timerQueries);
+    useTimerQueries = 0;
+    framebuffer = colorTexture = depthBuffer = 0;
+    bufferWidth = bufferHeight = 0;
+    dynRes.enabled = 0;
+}
+
+// (Re)allocates the attachments when the window size changed. Returns 1 if the framebuffer is usable.
+static int ensureFramebufferSize(int width, int height) {
+    if (width == bufferWidth && height == bufferHeight) return 1;
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); // Bilinear upscale, no mipmaps
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "Dynamic resolution: incomplete framebuffer (0x%x), turning it off\n", status);
+        shutdownDynamicResolution();
+        return 0;
+    }
+    bufferWidth = width;
+    bufferHeight = height;
+    return 1;
+}
+
+
+// --- Per-Frame Redirect ---
+void beginDynamicResolution(int windowWidth, int windowHeight) {
+    dynRes.renderWidth = windowWidth;
+    dynRes.renderHeight = windowHeight;
+    redirected = 0;
+    // At full scale the scene goes straight to the window (no copy)
+    if (!dynRes.enabled || dynRes.scale >= DYNRES_MAX_SCALE || !ensureFramebufferSize(windowWidth, windowHeight)) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        return;
+    }
+    // Otherwise the window is not cleared at all: the upscaled quad covers every pixel
+
+    dynRes.renderWidth = (int)(windowWidth * dynRes.scale + 0.5f);
+    dynRes.renderHeight = (int)(windowHeight * dynRes.scale + 0.5f);
+    if (dynRes.renderWidth < 1) dynRes.renderWidth = 1;
+    if (dynRes.renderHeight < 1) dynRes.renderHeight = 1;
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, dynRes.renderWidth, dynRes.renderHeight);
+    glEnable(GL_SCISSOR_TEST); // Clear only the part in use
+    glScissor(0, 0, dynRes.renderWidth, dynRes.renderHeight);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
+    redirected = 1;
+}
+
+void endDynamicResolution(int windowWidth, int windowHeight) {
+    if (!redirected) return;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, windowWidth, windowHeight);
+
+    // Bilinear upscale: the used corner of the texture on a quad covering the window
+    float u = (float)dynRes.renderWidth / bufferWidth;
+    float v = (float)dynRes.renderHeight / bufferHeight;
+    glMatrixMode(GL_PROJECTION); glPushMatrix(); glLoadIdentity(); // Identity: the quad is in clip space
+    glMatrixMode(GL_MODELVIEW); glPushMatrix(); glLoadIdentity();
+    glPushAttrib(GL_DEPTH_BUFFER_BIT | GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT);
+    glDisable(GL_DEPTH_TEST); glDisable(GL_CULL_FACE); glDisable(GL_LIGHTING);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    glBegin(GL_QUADS);
+        glTexCoord2f(0.0f, 0.0f); glVertex2f(-1.0f, -1.0f);
+        glTexCoord2f(u, 0.0f);    glVertex2f( 1.0f, -1.0f);
+        glTexCoord2f(u, v);       glVertex2f( 1.0f,  1.0f);
+        glTexCoord2f(0.0f, v);    glVertex2f(-1.0f,  1.0f);
+    glEnd();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPopAttrib();
+    glMatrixMode(GL_PROJECTION); glPopMatrix();
+    glMatrixMode(GL_MODELVIEW); glPopMatrix();
+    redirected = 0;
+}
+
+
+// --- Controller ---
+void recordFrameTime(double frameMs) {
+    if (!dynRes.enabled) return;
+    accumulatedMs += frameMs;
+    if (++framesMeasured < DYNRES_ADJUST_FRAMES) return;
+    dynRes.averageMs = accumulatedMs / framesMeasured;
+    accumulatedMs = 0.0;
+    framesMeasured = 0;
+
+    float scale = dynRes.scale;
+    if (scale >= DYNRES_MAX_SCALE) {
+        fullScaleMs = dynRes.averageMs;
+        if (retryWindows > 0) { retryWindows--; return; }
+        // The same frame time as when it failed (e.g. vsync): it would fail again, and each try
+        // is a visible drop in resolution
+        if (fabs(fullScaleMs - failedFullScaleMs) < failedFullScaleMs * DYNRES_RETRY_CHANGE) return;
+        failedFullScaleMs = 0.0;
+    } else if (fullScaleMs > 0.0 && dynRes.averageMs > fullScaleMs * DYNRES_MIN_GAIN) {
+        // Not paying off: the frame is bound by something other than pixels
+        dynRes.scale = DYNRES_MAX_SCALE;
+        retryWindows = DYNRES_RETRY_WINDOWS;
+        failedFullScaleMs = fullScaleMs;
+        return;
+    }
+    if (dynRes.averageMs > dynRes.targetMs) {
+        // Rasterisation cost follows the pixel count, i.e. scale^2; round down to a step
+        scale *= (float)sqrt(dynRes.targetMs / dynRes.averageMs);
+        scale = floorf(scale / DYNRES_SCALE_STEP + 0.001f) * DYNRES_SCALE_STEP;
+    } else if (dynRes.averageMs < dynRes.targetMs * DYNRES_HEADROOM) {
+        scale += DYNRES_SCALE_STEP; // Creep back up slowly
+    }
+    if (scale < DYNRES_MIN_SCALE) scale = DYNRES_MIN_SCALE;
+    if (scale > DYNRES_MAX_SCALE) scale = DYNRES_MAX_SCALE;
+    dynRes.scale = scale;
+}
+
+
+// --- Frame Timing ---
+// A frame costs the longer of its GPU time and the CPU time until its swap returned: the swap
+// blocks while a software rasteriser draws the frame (llvmpipe's timer queries see almost none of
+// that work) or once a GPU falls frames behind, and the queries cover what the swap doesn't wait for.
+// Feeds the controller with the oldest issued frame; waits for it only if 'wait'.
+static int readTimerQuery(int wait) {
+    int slot = (int)(queriesRead % DYNRES_TIMER_QUERIES);
+    if (!wait) {
+        GLint available = 0;
+        glGetQueryObjectiv(timerQueries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return 0;
+    }
+    GLuint64 elapsedNs = 0;
+    glGetQueryObjectui64v(timerQueries[slot], GL_QUERY_RESULT, &elapsedNs);
+    queriesRead++;
+    double gpuMs = (double)elapsedNs / 1.0e6;
+    recordFrameTime(gpuMs > frameCpuMs[slot] ? gpuMs : frameCpuMs[slot]);
+    return 1;
+}
+
+void beginFrameTiming() {
+    if (!dynRes.enabled) return;
+    frameTimingStart = getTimeSeconds();
+    if (!useTimerQueries) return;
+    // The GPU is a whole ring of frames behind: that frame is long over budget, so waiting costs little
+    if (queriesIssued - queriesRead == DYNRES_TIMER_QUERIES) readTimerQuery(1);
+    glBeginQuery(GL_TIME_ELAPSED, timerQueries[queriesIssued % DYNRES_TIMER_QUERIES]);
+}
+
+void endFrameTiming() {
+    if (!dynRes.enabled) return;
+    double cpuMs = (getTimeSeconds() - frameTimingStart) * 1000.0;
+    if (!useTimerQueries) {
+        recordFrameTime(cpuMs);
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    frameCpuMs[queriesIssued % DYNRES_TIMER_QUERIES] = cpuMs;
+    queriesIssued++;
+    while (queriesRead < queriesIssued && readTimerQuery(0)) {
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef DYNRES_H
+#define DYNRES_H
+
+#include "game.h" // FRAME_RATE
+
+// --- Dynamic Resolution ---
+// The 3D scene is rendered into an offscreen framebuffer at a fraction of the window size and
+// stretched to the window; the HUD is then drawn on top at native resolution. Every
+// DYNRES_ADJUST_FRAMES frames the scale is adjusted from the average measured frame time:
+// down (proportionally, pixel cost ~ scale^2) when over the target, up one step when well under it.
+// When the frame is not bound by pixels (vsync, the CPU, or an upscale that costs more than it
+// saves), a reduced scale is no faster than full scale; the controller then goes back to full
+// scale and only tries again once the full-scale frame time has changed.
+#define DYNRES_MIN_SCALE 0.4f
+#define DYNRES_MAX_SCALE 1.0f
+#define DYNRES_SCALE_STEP 0.05f                          // Scales are multiples of this (no jitter)
+#define DYNRES_ADJUST_FRAMES 10
+#define DYNRES_DEFAULT_TARGET_MS (900.0 / FRAME_RATE)    // 90% of the frame budget
+#define DYNRES_HEADROOM 0.75                             // Scale up only below 75% of the target
+#define DYNRES_MIN_GAIN 0.95                             // A reduced scale must beat full scale by 5%...
+#define DYNRES_RETRY_WINDOWS 30                          // ...or it is dropped for at least this many windows,
+#define DYNRES_RETRY_CHANGE 0.10                         // and until full scale is 10% off its time then
+
+typedef struct {
+    int enabled;                    // 1 once initDynamicResolution() succeeded
+    float scale;                    // Fraction of the window size per axis
+    double targetMs;                // Frame time the controller aims for
+    double averageMs;               // Mean frame time of the last adjustment window
+    int renderWidth, renderHeight;  // Size the scene was rendered at this frame
+} DynamicResolution;
+
+extern DynamicResolution dynRes;
+
+// --- Function Declarations ---
+int initDynamicResolution(double targetMs);   // Needs framebuffer objects; returns 0 (stays off) otherwise
+void shutdownDynamicResolution(void);
+// Around the 3D scene: begin clears the render target, binds the framebuffer and sets the scaled
+// viewport (dynRes.renderWidth x renderHeight); end stretches it onto the window and restores
+// the window viewport. Also usable while disabled (then it only clears the window).
+void beginDynamicResolution(int windowWidth, int windowHeight);
+void endDynamicResolution(int windowWidth, int windowHeight);
+void recordFrameTime(double frameMs);          // Once per frame, with the time it took to finish
+// Windowed play measures without stalling the pipeline: begin before the first draw of a frame,
+// end after its buffer swap. Each frame reaches recordFrameTime() a frame or two late, as the
+// longer of its GPU time (timer queries, GL 3.3 / ARB_timer_query) and the time to the swap returning.
+void beginFrameTiming(void);
+void endFrameTiming(void);
+
+#endif // DYNRES_H
@@ -0,0 +1,64 @@
+#include "frustum.h"  // Frustum struct and prototypes
+#include "matrix.h"   // mat4Multiply
+#include <GL/glew.h>  // glGetFloatv
+#include <math.h>     // For sqrtf
+
+Frustum viewFrustum; // Updated once per frame by renderRaceScene()
+
+// --- Plane Extraction ---
+// Gribb/Hartmann: with clip = projection * view, each plane is a sum or difference
+// of the fourth row of 'clip' and one of the other rows. Matrices are column-major.
+void extractFrustumFromMatrices(Frustum* frustum, const float proj[16], const float view[16], int viewportHeight) {
+    float clip[16];
+    mat4Multiply(clip, proj, view);
+
+    for (int p = 0; p < 6; ++p) {
+        int row = p / 2;                      // x, x, y, y, z, z
+        float sign = (p % 2 == 0) ? 1.0f : -1.0f; // Left/bottom/near add, right/top/far subtract
+        float* plane = frustum->planes[p];
+        for (int i = 0; i < 4; ++i) plane[i] = clip[i * 4 + 3] + sign * clip[i * 4 + row];
+        float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f) {
+            for (int i = 0; i < 4; ++i) plane[i] /= length; // Normalised, so sphere radii compare directly
+        }
+    }
+
+    // Eye = -R^T * t for a rigid view matrix (rotation R in the upper 3x3, translation t in column 3)
+    for (int i = 0; i < 3; ++i) {
+        frustum->eye[i] = -(view[i * 4 + 0] * view[12] + view[i * 4 + 1] * view[13] + view[i * 4 + 2] * view[14]);
+    }
+
+    // proj[5] is cot(fovy / 2): a vertical unit at distance 1 spans proj[5] * height / 2 pixels
+    frustum->pixelScale = proj[5] * 0.5f * (float)viewportHeight;
+}
+
+void extractFrustumFromGL(Frustum* frustum) {
+    float proj[16], model[16];
+    GLint viewport[4];
+    glGetFloatv(GL_PROJECTION_MATRIX, proj);
+    glGetFloatv(GL_MODELVIEW_MATRIX, model);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    extractFrustumFromMatrices(frustum, proj, model, viewport[3]);
+}
+
+
+// --- Visibility Tests ---
+int isBoxInFrustum(const Frustum* frustum, const float boxMin[3], const float boxMax[3]) {
+    for (int p = 0; p < 6; ++p) {
+        const float* plane = frustum->planes[p];
+        // The box corner furthest along the plane normal; if even that is outside, the whole box is.
+        float x = plane[0] >= 0.0f ? boxMax[0] : boxMin[0];
+        float y = plane[1] >= 0.0f ? boxMax[1] : boxMin[1];
+        float z = plane[2] >= 0.0f ? boxMax[2] : boxMin[2];
+        if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f) return 0;
+    }
+    return 1;
+}
+
+int isSphereInFrustum(const Frustum* frustum, float x, float y, float z, float radius) {
+    for (int p = 0; p < 6; ++p) {
+        const float* plane = frustum->planes[p];
+        if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < -radius) return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,26 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+// --- View Frustum ---
+// Six planes (a, b, c, d) with normals pointing into the visible volume:
+// a point p is inside a plane when a*p.x + b*p.y + c*p.z + d >= 0.
+typedef struct {
+    float planes[6][4]; // Left, right, bottom, top, near, far
+    float eye[3];       // Camera position in world space
+    float pixelScale;   // Pixels covered by one world unit at distance 1 (for level-of-detail selection)
+} Frustum;
+
+// Frustum of the current chase camera, refreshed by renderRaceScene() after setupCamera().
+extern Frustum viewFrustum;
+
+// --- Function Declarations ---
+// Extracts the planes, eye and pixel scale from the current GL projection, modelview and viewport.
+void extractFrustumFromGL(Frustum* frustum);
+// Same from explicit column-major matrices (shader render path, no GL matrix stack).
+void extractFrustumFromMatrices(Frustum* frustum, const float proj[16], const float view[16], int viewportHeight);
+// Returns 1 if the axis-aligned box may be visible (conservative: never culls a visible box).
+int isBoxInFrustum(const Frustum* frustum, const float boxMin[3], const float boxMax[3]);
+// Returns 1 if the sphere may be visible.
+int isSphereInFrustum(const Frustum* frustum, float x, float y, float z, float radius);
+
+#endif // FRUSTUM_H
@@ -2,12 +2,27 @@
 // Include BOTH track headers - the code uses constants/functions from one based on selectedTrackType
 #include "track_rect.h"
 #include "track_round.h"
+#include "frustum.h"    // View frustum culling for the race scene
+#include "renderer.h"   // Shader or fixed-function render path
+#include "matrix.h"     // Camera matrices for the shader path
+#include "dynres.h"     // Scene scale and frame time for the HUD
+#include "minimap.h"    // Cached top-down track texture for the HUD
+#include "scenery.h"    // Instanced trackside objects
+#include "skidmarks.h"  // Tyre marks laid while braking and turning hard
+#include "particles.h"  // Tyre smoke and wall sparks
+#include "lockstep.h"   // Online races: controls go through the input delay, one view only
+#include "netclient.h"  // Dedicated server races: the cars come from the server's snapshots
+#include "snapshot.h"   // Rollback ring, cleared on every (re)start
+#include "telemetry.h"  // --telemetry: per-tick channels of every car
+#include "heatmap.h"    // --heatmap: where the sweep's cars went, drawn on the track
+#include "timing.h"     // Wall time for the menu's tick clock
 #include <GL/glew.h>    // For OpenGL types if needed (used by GLUT)
 #include <GL/freeglut.h> // For rendering text, getting time, etc.
 #include <stdio.h>      // For snprintf, printf (debugging)
 #include <string.h>     // For strlen (used implicitly by snprintf etc.)
 #include <math.h>       // For fabsf, fmaxf, fminf, sinf, cosf etc.
 #include <limits.h>     // For INT_MAX (initial best lap time)
+#include <ctype.h>      // For tolower (driving keys work with Shift / Caps Lock too)
 
 // Define M_PI if not already defined by math.h
 #ifndef M_PI
@@ -19,46 +34,103 @@
 // --- Global Variable Definitions ---
 // Declared 'extern' in game.h, defined here with initial values.
 GameState currentGameState = STATE_MENU;     // Start the game in the menu state
-TrackType selectedTrackType = TRACK_ROUNDED; // Default track type for internal logic (will be overwritten by menu)
 int menuSelectionIndex = 0;              // Index of the currently highlighted menu option (0-based)
-Car playerCar;                           // The player's car object
-int lapStartTimeMs = 0;                  // Milliseconds timestamp when the current lap started
-int currentLapTimeMs = 0;                // Milliseconds duration of the lap currently in progress
-int lastLapTimeMs = 0;                   // Milliseconds duration of the previously completed lap
-int bestLapTimeMs = INT_MAX;             // Milliseconds duration of the fastest completed lap
-int crossedFinishLineMovingForwardState = 0; // Boolean flag (0=false, 1=true) for lap detection
+int numPlayers = 1;                      // Set from the menu (LEFT/RIGHT) or --players
+RaceState raceState;                     // Cars and lap timers, set up by initGame()
+Car* const playerCars = raceState.cars;  // The players' cars (player 1 first)
+LapTimer* const playerLapTimers = raceState.lapTimers; // Each player's lap timing (see lap.h)
+long simTickCount = 0;                   // Fixed update ticks since launch (the lap clock)
+long raceStartTick = 0;                  // simTickCount when the current race was started from the menu
+static int numServerCars = 0;            // Cars in playerCars on a dedicated server (the followed one first)
+
+static void scheduleUpdate(); // Update loop scheduling, see updateGame()
+
+// --- Players ---
+static const float playerColors[MAX_PLAYERS][3] = {
+    { 1.0f, 0.0f, 0.0f },  // Red (as initCar)
+    { 0.1f, 0.4f, 1.0f },  // Blue
+    { 0.1f, 0.8f, 0.2f },  // Green
+    { 1.0f, 0.85f, 0.0f }  // Yellow
+};
+
+// Driving keys per player, in CarControl order (accelerate, brake, left, right)
+typedef struct {
+    int special;                // 1 = GLUT special keys (arrows), 0 = ASCII (lower case)
+    int keys[NUM_CAR_CONTROLS];
+} PlayerKeys;
+
+static const PlayerKeys playerKeys[MAX_PLAYERS] = {
+    { 0, { 'w', 's', 'a', 'd' } },
+    { 1, { GLUT_KEY_UP, GLUT_KEY_DOWN, GLUT_KEY_LEFT, GLUT_KEY_RIGHT } },
+    { 0, { 'i', 'k', 'j', 'l' } },
+    { 0, { '8', '5', '4', '6' } } // Numeric keypad with Num Lock on
+};
+
+// Peer-to-peer (lockstep.h) or on a dedicated server (netclient.h): one car, one view
+static int isOnlineRace(void) {
+    return isLockstepActive() || isNetClientActive();
+}
+
+// Cars on track: the players' own, or everyone in the server session
+static int getNumCarsShown(void) {
+    return isNetClientActive() ? numServerCars : numPlayers;
+}
+
+// Applies a driving key to whichever racing player it belongs to. Returns 1 if it was one.
+// Online, player 1's keys and the arrows both drive this peer's car (see lockstep.h); a
+// spectator's left and right switch the car the camera follows (see netclient.h).
+static int routeDrivingKey(int special, int key, int state) {
+    if (!special) key = tolower(key);
+    if (isOnlineRace()) {
+        for (int p = 0; p < 2; ++p) {
+            if (playerKeys[p].special != special) continue;
+            for (int c = 0; c < NUM_CAR_CONTROLS; ++c) {
+                if (playerKeys[p].keys[c] != key) continue;
+                if (isNetClientActive()) setNetClientControl((CarControl)c, state);
+                else setLocalControl((CarControl)c, state);
+                return 1;
+            }
+        }
+        return 0;
+    }
+    for (int p = 0; p < numPlayers; ++p) {
+        if (playerKeys[p].special != special) continue;
+        for (int c = 0; c < NUM_CAR_CONTROLS; ++c) {
+            if (playerKeys[p].keys[c] != key) continue;
+            setCarControl(&playerCars[p], (CarControl)c, state);
+            return 1;
+        }
+    }
+    return 0;
+}
 
 
 // --- Initialization Function (for RACING state) ---
 // Called by startGame() or when 'R' is pressed during racing.
 // Sets up the car and timers for the currently selected track.
 void initGame() {
-    // initCar() itself now checks 'selectedTrackType' for positioning etc.
-    initCar(&playerCar); // initCar is defined in car.c
-
-    // Initialize lap timing variables for the start of the race/reset.
-    lapStartTimeMs = glutGet(GLUT_ELAPSED_TIME); // Get current time since GLUT started
-    currentLapTimeMs = 0;
-    lastLapTimeMs = 0;       // No previous lap yet on reset
-    bestLapTimeMs = INT_MAX; // Reset best lap on reset (or load from save later)
-
-    // Determine initial finish line state based on the car's starting Z and X position
-    // relative to the finish line boundaries of the *selected* track.
-    float finishLineXStart, finishLineXEnd;
-    if (selectedTrackType == TRACK_RECT) {
-        finishLineXStart = RECT_FINISH_LINE_X_START;
-        finishLineXEnd = RECT_FINISH_LINE_X_END;
-    } else { // TRACK_ROUNDED
-        finishLineXStart = ROUND_FINISH_LINE_X_START;
-        finishLineXEnd = ROUND_FINISH_LINE_X_END;
+    for (int p = 0; p < numPlayers; ++p) {
+        Car* car = &playerCars[p];
+        // initCar() itself now checks 'selectedTrackType' for positioning etc.
+        initCar(car); // initCar is defined in car.c
+        if (numPlayers > 1) { // Grid: odd players on the left, even on the right, rows further back
+            car->x += (p % 2 == 0 ? -1.0f : 1.0f) * GRID_LANE_OFFSET;
+            car->z -= (p / 2) * GRID_ROW_SPACING;
+            car->prev_x = car->x;
+            car->prev_z = car->z;
+        }
+        for (int i = 0; i < 3; ++i) car->color[i] = playerColors[p][i];
+
+        // Initialize lap timing (and the finish line state) for the start of the race/reset.
+        initLapTimer(&playerLapTimers[p], car, simTickCount); // Simulation ticks, not wall time
     }
-    // Set flag to true (1) only if starting exactly on or past the line (unlikely with current setup)
-    crossedFinishLineMovingForwardState = (playerCar.z >= FINISH_LINE_Z &&
-                                           playerCar.x >= finishLineXStart &&
-                                           playerCar.x <= finishLineXEnd);
+    clearSkidMarks(); // A fresh start leaves no marks behind
+    clearParticles();
+    clearSnapshots(); // Nothing before this start can be rewound to
+    saveSnapshot();   // ...but the start itself can
 
-    printf("Game Initialized for Track Type %d. Start time: %dms. Crossed Flag: %d\n",
-           selectedTrackType, lapStartTimeMs, crossedFinishLineMovingForwardState);
+    printf("Game Initialized for Track Type %d, %d player(s). Start tick: %ld. Crossed Flag: %d\n",
+           selectedTrackType, numPlayers, simTickCount, playerLapTimers[0].crossedFinishLineMovingForwardState);
 }
 
 
@@ -67,126 +139,291 @@ void initGame() {
 void startGame(TrackType type) {
     printf("Starting game with Track Type %d\n", type);
     selectedTrackType = type;       // Store the chosen track type globally
+    raceStartTick = simTickCount;   // Input scripts are timed from here
     initGame();                     // Initialize car position, timers for this track
+    startRaceTelemetry(type);       // --telemetry: the log starts again with each race
+    buildScenery(type);             // Place the trackside objects for this track
+    buildMinimap(type);             // Render the track's top-down view once for the HUD
     currentGameState = STATE_RACING; // Change the game state to racing mode
     glutPostRedisplay();            // Ensure screen updates immediately
+    scheduleUpdate();               // Restart the fixed-update timer (stopped in the menu)
 }
 
 
 // --- Camera Setup Function ---
-// Configures the view matrix to follow the car (third-person view).
-void setupCamera() {
+// Chase camera behind and above a car, looking at its centre.
+static void getCameraLookAt(const Car* car, float eye[3], float center[3]) {
     // Camera parameters (adjust for desired view)
     float followDistance = 10.0f; // How far behind
     float followHeight = 5.0f;    // How high up
     float lookAtHeightOffset = 0.5f; // Point slightly above car's center Y
 
     // Calculate camera position using car's angle and position
-    float carAngleRad = DEG_TO_RAD(playerCar.angle);
-    float camX = playerCar.x - followDistance * sinf(carAngleRad);
-    float camY = playerCar.y + followHeight; // Use car's actual y + offset
-    float camZ = playerCar.z - followDistance * cosf(carAngleRad);
+    float carAngleRad = DEG_TO_RAD(car->angle);
+    eye[0] = car->x - followDistance * sinf(carAngleRad);
+    eye[1] = car->y + followHeight; // Use car's actual y + offset
+    eye[2] = car->z - followDistance * cosf(carAngleRad);
 
     // Calculate look-at point (center of the car)
-    float lookAtX = playerCar.x;
-    float lookAtY = playerCar.y + lookAtHeightOffset;
-    float lookAtZ = playerCar.z;
+    center[0] = car->x;
+    center[1] = car->y + lookAtHeightOffset;
+    center[2] = car->z;
+}
+
+// Configures the view matrix to follow the car (third-person view).
+void setupCamera(const Car* car) {
+    float eye[3], center[3];
+    getCameraLookAt(car, eye, center);
 
     // Set the Modelview matrix using gluLookAt
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity(); // Reset matrix before setting camera
-    gluLookAt(camX, camY, camZ,           // Camera position (eye)
-              lookAtX, lookAtY, lookAtZ,  // Point to look at (center)
-              0.0f, 1.0f, 0.0f);         // Up vector (positive Y)
+    gluLookAt(eye[0], eye[1], eye[2],          // Camera position (eye)
+              center[0], center[1], center[2], // Point to look at (center)
+              0.0f, 1.0f, 0.0f);               // Up vector (positive Y)
 }
 
 
-// --- Fixed Timestep Update Function ---
-// Contains the main game loop logic, called repeatedly by GLUT timer.
-void updateGame(int value) {
+// --- Render State Setup ---
+// Fixed-function state shared by the window and the offscreen renderer (offscreen.c).
+void initRenderState() {
+    glEnable(GL_DEPTH_TEST); // Enable depth testing
+    glDepthFunc(GL_LEQUAL);  // Pixels with equal or lesser depth pass
+    glClearColor(0.1f, 0.3f, 0.7f, 1.0f); // Background clear color (sky blue)
+    glEnable(GL_CULL_FACE); // Enable face culling
+    glCullFace(GL_BACK);    // Cull back-facing polygons
+}
+
+
+// --- Split-Screen Layout ---
+// One player: the whole target. Two: stacked halves (player 1 on top), each as wide as the window.
+// Three or four: quadrants in reading order (with three, the bottom-right one stays empty).
+// Online races show only this peer's car, full screen.
+static int isPlayerOnScreen(int player) {
+    return !isLockstepActive() || player == getLockstepPlayer();
+}
+
+void getPlayerViewport(int player, int width, int height, int viewport[4]) {
+    int views = isLockstepActive() ? 1 : numPlayers;
+    if (isLockstepActive()) player = 0;
+    int columns = views > 2 ? 2 : 1;
+    int rows = views > 1 ? 2 : 1;
+    int column = player % columns, row = player / columns;
+    int cellWidth = width / columns, cellHeight = height / rows;
+    viewport[0] = column * cellWidth;
+    viewport[1] = height - (row + 1) * cellHeight; // GL's origin is the bottom-left corner
+    viewport[2] = column == columns - 1 ? width - viewport[0] : cellWidth; // Odd pixels go to the last cell
+    viewport[3] = row == 0 ? height - (rows - 1) * cellHeight : cellHeight;
+}
+
+// --- 3D Race View ---
+// Projection, chase camera behind one car, the selected track with its guardrails, and every car.
+// The track meshes and scenery models live on the GPU already; a view only sets its camera
+// (one uniform buffer update on the shader path) and culls against its own frustum.
+static void renderPlayerView(const Car* car, int viewWidth, int viewHeight) {
+    if (viewHeight <= 0) viewHeight = 1; // Avoid divide by zero
+    float aspect = (float)viewWidth / (float)viewHeight;
+    float eye[3], center[3];
+    getCameraLookAt(car, eye, center);
+    if (renderPath == RENDER_PATH_SHADER) {
+        // Same camera as below, as explicit matrices for the Camera uniform buffer
+        float proj[16], view[16], viewProj[16];
+        const float up[3] = { 0.0f, 1.0f, 0.0f };
+        mat4Perspective(proj, 50.0f, aspect, 0.1f, 600.0f);
+        mat4LookAt(view, eye, center, up);
+        mat4Multiply(viewProj, proj, view);
+        extractFrustumFromMatrices(&viewFrustum, proj, view, viewHeight);
+        beginShaderFrame(viewProj); // Everything below is queued until flushShaderFrame()
+    } else {
+        glMatrixMode(GL_PROJECTION); glLoadIdentity();
+        gluPerspective(50.0f, aspect, 0.1f, 600.0f); // Set perspective
+        glMatrixMode(GL_MODELVIEW); glLoadIdentity();
+        setupCamera(car); // Position the camera
+        extractFrustumFromGL(&viewFrustum); // Track chunks and cars outside this are skipped
+    }
+
+    // Render the appropriate track based on selection
+    if (selectedTrackType == TRACK_RECT) {
+        renderRectTrack();
+        renderRectGuardrails();
+    } else { // TRACK_ROUNDED
+        renderRoundTrack();
+        renderRoundGuardrails();
+    }
+    renderScenery(&viewFrustum); // One instanced draw per object type
+    renderHeatmapOverlay(); // One textured quad over the track, if loaded and shown
+    renderSkidMarks(simTickCount); // Every live mark in one blended draw (queued last on the shader path)
+
+    // Draw each car whose bounding sphere is in view
+    for (int p = 0; p < getNumCarsShown(); ++p) {
+        const Car* other = &playerCars[p];
+        float carRadius = 0.5f * sqrtf(other->width * other->width + other->height * other->height +
+                                       other->length * other->length);
+        if (isSphereInFrustum(&viewFrustum, other->x, other->y, other->z, carRadius)) {
+            renderCar(other);
+        }
+    }
+
+    // Smoke and sparks face the camera: its right and up axes (as gluLookAt builds them)
+    float forward[3] = { center[0] - eye[0], center[1] - eye[1], center[2] - eye[2] };
+    float right[3] = { -forward[2], 0.0f, forward[0] }; // forward x (0, 1, 0)
+    float rightLength = sqrtf(right[0] * right[0] + right[2] * right[2]);
+    if (rightLength > 0.0f) { right[0] /= rightLength; right[2] /= rightLength; }
+    float forwardLength = sqrtf(forward[0] * forward[0] + forward[1] * forward[1] + forward[2] * forward[2]);
+    for (int i = 0; i < 3; ++i) forward[i] /= forwardLength;
+    float cameraUp[3] = { right[1] * forward[2] - right[2] * forward[1],   // right x forward
+                          right[2] * forward[0] - right[0] * forward[2],
+                          right[0] * forward[1] - right[1] * forward[0] };
+    renderParticles(eye, right, cameraUp); // Back to front, one batch, drawn last
+
+    if (renderPath == RENDER_PATH_SHADER) flushShaderFrame(); // Sorted by pipeline and buffer, then drawn
+}
+
+// --- 3D Race Scene ---
+// Every player's view in its viewport of the current target (window or dynamic resolution buffer).
+// The HUD is drawn separately (renderHUD needs GLUT's bitmap fonts, i.e. a window).
+void renderRaceScene(int windowWidth, int windowHeight) {
+    for (int p = 0; p < numPlayers; ++p) {
+        int viewport[4];
+        if (!isPlayerOnScreen(p)) continue;
+        getPlayerViewport(p, windowWidth, windowHeight, viewport);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        renderPlayerView(&playerCars[p], viewport[2], viewport[3]);
+    }
+    glViewport(0, 0, windowWidth, windowHeight);
+}
+
+
+// --- One Fixed Simulation Tick ---
+// Advances the game by exactly one FRAME_TIME_SEC step. Shared by the GLUT timer below
+// and the benchmark (benchmark.c), which runs ticks back to back instead of waiting.
+void stepGame() {
     // --- Only update game logic if in RACING state ---
     if (currentGameState != STATE_RACING) {
-        // Still need to reschedule the timer to keep the loop running for the menu
-        glutTimerFunc(FRAME_TIME_MS, updateGame, 0);
-        // Request redraw in case menu needs updating (e.g., animations, though none currently)
-        glutPostRedisplay();
+        simTickCount++; // The benchmark ticks through the menu too (windowed play: see advanceMenuClock())
         return; // Skip physics, lap timing, etc., when in menu
     }
     // --- End of state check ---
+    simulateRaceTick(1);
+    saveSnapshot(); // Rewind point for this tick (one memcpy, see snapshot.h)
+    recordRaceTelemetry(); // No-op unless --telemetry
+}
 
-    (void)value; // Mark the GLUT timer parameter as unused
-
-    int timeNowMs = glutGet(GLUT_ELAPSED_TIME);
-
+// The racing part of a tick. Everything it changes is in raceState (plus simTickCount), so
+// resimulating from a snapshot (snapshot.c) passes withEffects = 0: skid marks and particles
+// are purely visual and were already produced the first time those ticks ran.
+void simulateRaceTick(int withEffects) {
     // Update car physics, movement, and collision detection/response.
     // This function (in car.c) now internally calls the correct isPositionOn*Track
-    updateCar(&playerCar, FRAME_TIME_SEC);
+    // Cars don't collide with each other, only with the track edges.
+    float speedBeforeTick[MAX_PLAYERS];
+    for (int p = 0; p < numPlayers; ++p) {
+        speedBeforeTick[p] = playerCars[p].speed;
+        updateCar(&playerCars[p], FRAME_TIME_SEC);
+    }
+    simTickCount++; // One fixed FRAME_TIME_SEC step has been simulated
+
+    for (int p = 0; p < numPlayers; ++p) {
+        Car* car = &playerCars[p];
+        if (withEffects) {
+            // Visual only: never feed back into the physics. A wall contact is updateCar()'s revert branch.
+            updateSkidMarks(p, car, simTickCount);
+            emitCarParticles(car, speedBeforeTick[p], car->hitWall);
+        }
 
-    // Update Lap Timers based on elapsed time.
-    if (timeNowMs >= lapStartTimeMs) {
-        currentLapTimeMs = timeNowMs - lapStartTimeMs;
-    } else {
-        // Handle potential timer wrap-around or reset during gameplay.
-        lapStartTimeMs = timeNowMs;
-        currentLapTimeMs = 0;
+        // Update lap timers and detect finish line crossings (see lap.c).
+        // Laps are timed in ticks, so a late or dropped timer callback can't change a lap time.
+        updateLapTimer(&playerLapTimers[p], car, simTickCount);
     }
+    if (withEffects) updateParticles(FRAME_TIME_SEC);
+}
 
-    // --- Lap Completion Logic ---
-    // Check if the car has crossed the finish line in the forward direction.
-    float carZ = playerCar.z;
-    float carPrevZ = playerCar.prev_z;
-    float carX = playerCar.x;
-    int movingForward = (playerCar.speed > 0.1f); // Check speed for direction
 
-    // Get finish line X boundaries based on the currently selected track.
-    float finishLineXStart, finishLineXEnd;
-    if (selectedTrackType == TRACK_RECT) {
-        finishLineXStart = RECT_FINISH_LINE_X_START;
-        finishLineXEnd = RECT_FINISH_LINE_X_END;
-    } else { // TRACK_ROUNDED
-        finishLineXStart = ROUND_FINISH_LINE_X_START;
-        finishLineXEnd = ROUND_FINISH_LINE_X_END;
+// --- Update Loop Scheduling ---
+// The 60 Hz timer only runs while it has work: during a race with the window visible (or in
+// BACKGROUND_RUN). The menu is event driven: it is redrawn only when a key changes it or GLUT
+// asks for a repaint (resize, expose), so an idle menu costs no CPU at all.
+BackgroundMode backgroundMode = BACKGROUND_PAUSE;
+static int updateLoopEnabled = 0;     // Set by startUpdateLoop() (windowed play only, not --bench)
+static int updateTimerScheduled = 0;  // A glutTimerFunc(updateGame) is pending
+static int windowVisible = 1;         // Cleared while minimised, hidden or fully covered
+
+static int needsUpdates() {
+    if (!updateLoopEnabled || currentGameState != STATE_RACING) return 0;
+    if (isOnlineRace()) return 1; // Pausing an online race would stall the other peer too (or time out)
+    return windowVisible || backgroundMode == BACKGROUND_RUN;
+}
+
+// Arms the timer if the loop should be running and isn't yet. Safe to call any time.
+static void scheduleUpdate() {
+    if (updateTimerScheduled || !needsUpdates()) return;
+    updateTimerScheduled = 1;
+    glutTimerFunc(FRAME_TIME_MS, updateGame, 0);
+}
+
+void startUpdateLoop() {
+    updateLoopEnabled = 1;
+    scheduleUpdate();
+}
+
+void setWindowVisible(int visible) {
+    if (visible == windowVisible) return;
+    windowVisible = visible;
+    printf("Window %s\n", visible ? "visible, resuming" : (backgroundMode == BACKGROUND_RUN ? "hidden, simulating without drawing" : "hidden, paused"));
+    if (visible) glutPostRedisplay();
+    scheduleUpdate();
+}
+
+
+// The timer is stopped in the menu, so nothing advances simTickCount there. Key handlers call
+// this first: in the menu it catches simTickCount up with the wall time since the last key (or
+// since the race was left), so recorded menu keys keep their spacing.
+static double menuClockTime = -1.0; // Wall time simTickCount last caught up to, -1 = not yet
+void advanceMenuClock() {
+    double now = getTimeSeconds();
+    if (currentGameState != STATE_MENU || menuClockTime < 0.0) {
+        menuClockTime = now; // Racing ticks come from the timer; the menu counts from here
+        return;
     }
-    // Check if the car is within the X span of the finish line.
-    int withinFinishLineX = (carX >= finishLineXStart && carX <= finishLineXEnd);
-
-
-    // --- Detect Crossing Finish Line FORWARD ---
-    // Conditions: Z crossed the FINISH_LINE_Z threshold, moving forward, within X bounds.
-    if (carPrevZ < FINISH_LINE_Z && carZ >= FINISH_LINE_Z && movingForward && withinFinishLineX) {
-        // Only count lap completion if the 'crossedForward' flag is already set (meaning
-        // we completed the previous part of the track and are genuinely finishing a lap).
-        if (crossedFinishLineMovingForwardState == 1) {
-            // --- LAP COMPLETED ---
-            lastLapTimeMs = currentLapTimeMs; // Record the time
-            // Update best lap if this one was faster (and valid).
-            if (lastLapTimeMs > 0 && lastLapTimeMs < bestLapTimeMs) {
-                bestLapTimeMs = lastLapTimeMs;
-            }
-            // Reset timer for the start of the *new* lap.
-            lapStartTimeMs = timeNowMs;
-            currentLapTimeMs = 0;
-            // The flag remains 1 as we start the next lap from past the line.
-        } else {
-            // This is the *first* time crossing forward (either started before the line
-            // or crossed backward then forward again). Set the flag and start the timer.
-            crossedFinishLineMovingForwardState = 1; // Set flag to true
-            lapStartTimeMs = timeNowMs;            // Start timing the first/next lap *now*.
-            currentLapTimeMs = 0;
+    long ticks = (long)((now - menuClockTime) * FRAME_RATE);
+    simTickCount += ticks;
+    menuClockTime += (double)ticks / FRAME_RATE; // Keep the remainder for the next key
+}
+
+
+// --- Fixed Timestep Update Function ---
+// Contains the main game loop logic, called repeatedly by GLUT timer while racing.
+void updateGame(int value) {
+    (void)value; // Mark the GLUT timer parameter as unused
+    updateTimerScheduled = 0;
+    if (!needsUpdates()) return; // Back in the menu or hidden: the loop stops until scheduleUpdate()
+
+    if (isLockstepActive()) {
+        // Online: a tick only runs once the other peer's controls for it are here
+        if (stepLockstep() == LOCKSTEP_ENDED) {
+            printLockstepStats();
+            stopLockstep();
+            glutLeaveMainLoop();
+            return;
         }
-    }
-    // --- Detect Crossing Finish Line BACKWARD ---
-    // Conditions: Z crossed the threshold backward, within X bounds.
-    else if (carPrevZ >= FINISH_LINE_Z && carZ < FINISH_LINE_Z && withinFinishLineX) {
-        // If the car goes backward over the line, reset the state flag. It will need
-        // to cross forward again to set the flag before completing the *next* lap.
-        crossedFinishLineMovingForwardState = 0; // Set flag to false
+    } else if (isNetClientActive()) {
+        // Dedicated server: nothing is simulated here, the cars are the interpolated snapshots
+        if (!updateNetClient()) {
+            printNetClientStats();
+            stopNetClient();
+            glutLeaveMainLoop();
+            return;
+        }
+        numServerCars = getNetClientCars(playerCars, playerLapTimers, MAX_RACE_CARS);
+        simTickCount++; // Skid marks and particles age on this clock
+    } else {
+        stepGame();
     }
 
-    // Request GLUT to redraw the screen.
-    glutPostRedisplay();
+    // Request GLUT to redraw the screen (only if anyone can see it).
+    if (windowVisible) glutPostRedisplay();
     // Reschedule this update function to be called again after the frame delay.
-    glutTimerFunc(FRAME_TIME_MS, updateGame, 0);
+    scheduleUpdate();
 }
 
 
@@ -247,7 +484,14 @@ void renderMenu(int windowWidth, int windowHeight) {
         }
         textY -= lineHeight; // Move down for next option
     }
-    textY -= lineHeight; // Extra space before exit prompt
+    textY -= lineHeight / 2;
+
+    // Player count (split-screen)
+    glColor3f(1.0f, 1.0f, 1.0f);
+    snprintf(menuText, sizeof(menuText), "Players: < %d >  (LEFT/RIGHT)", numPlayers);
+    glRasterPos2i(textX + 10, textY);
+    for (char* c = menuText; *c != '\0'; c++) { glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c); }
+    textY -= lineHeight * 2; // Extra space before exit prompt
 
     // Exit Instruction
     glColor3f(0.8f, 0.8f, 0.8f);
@@ -263,27 +507,23 @@ void renderMenu(int windowWidth, int windowHeight) {
 
 
 // --- Heads-Up Display (HUD) Rendering Function ---
-// Draws the lap timers during the racing state.
-void renderHUD(int windowWidth, int windowHeight) {
+// Draws one player's lap timers with the first line at (textX, textY), then line by line downwards.
+// Returns the y position of the line after them.
+static int drawLapTimers(int player, int textX, int textY, int lineHeight) {
     char hudText[100]; // Buffer for formatted strings
-
-    // --- Set up 2D Orthographic Projection ---
-    glMatrixMode(GL_PROJECTION); glPushMatrix(); glLoadIdentity();
-    gluOrtho2D(0, windowWidth, 0, windowHeight); // Pixel coordinates (0,0 bottom-left)
-    glMatrixMode(GL_MODELVIEW); glPushMatrix(); glLoadIdentity(); // Reset modelview
-
-    // --- Disable 3D effects ---
-    glPushAttrib(GL_DEPTH_BUFFER_BIT | GL_LIGHTING_BIT | GL_TEXTURE_BIT | GL_FOG_BIT);
-    glDisable(GL_DEPTH_TEST); glDisable(GL_LIGHTING);
-    glDisable(GL_TEXTURE_2D); glDisable(GL_FOG);
-
-    // --- Render Timers ---
+    const LapTimer* timer = &playerLapTimers[player];
+
+    // Player label in the car's colour, only when the screen is split
+    if (numPlayers > 1) {
+        glColor3fv(playerCars[player].color);
+        snprintf(hudText, sizeof(hudText), "P%d", player + 1);
+        glRasterPos2i(textX, textY); for (char* c = hudText; *c != '\0'; c++) { glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c); }
+        textY -= lineHeight;
+    }
     glColor3f(1.0f, 1.0f, 1.0f); // White text color
-    int textX = 10;                // X position from left edge
-    int textY = windowHeight - 30; // Y position from *bottom* edge (near top-left)
-    int lineHeight = 20;           // Vertical spacing
 
     // Current Lap Time
+    int currentLapTimeMs = timer->currentLapTimeMs;
     int cur_mins=(currentLapTimeMs/1000)/60; int cur_secs=(currentLapTimeMs/1000)%60; int cur_ms=currentLapTimeMs%1000;
     snprintf(hudText, sizeof(hudText), "Current: %02d:%02d.%03d", cur_mins, cur_secs, cur_ms);
     glRasterPos2i(textX, textY); // Set position for text drawing
@@ -291,6 +531,7 @@ void renderHUD(int windowWidth, int windowHeight) {
     textY -= lineHeight; // Move down for next line
 
     // Last Lap Time
+    int lastLapTimeMs = timer->lastLapTimeMs;
     if (lastLapTimeMs > 0) { // Only display if a lap has been completed
         int last_mins=(lastLapTimeMs/1000)/60; int last_secs=(lastLapTimeMs/1000)%60; int last_ms=lastLapTimeMs%1000;
         snprintf(hudText, sizeof(hudText), "Last:    %02d:%02d.%03d", last_mins, last_secs, last_ms);
@@ -301,6 +542,7 @@ void renderHUD(int windowWidth, int windowHeight) {
     textY -= lineHeight;
 
     // Best Lap Time
+    int bestLapTimeMs = timer->bestLapTimeMs;
     if (bestLapTimeMs != INT_MAX) { // Only display if a best lap exists
         int best_mins=(bestLapTimeMs/1000)/60; int best_secs=(bestLapTimeMs/1000)%60; int best_ms=bestLapTimeMs%1000;
         snprintf(hudText, sizeof(hudText), "Best:    %02d:%02d.%03d", best_mins, best_secs, best_ms);
@@ -308,6 +550,49 @@ void renderHUD(int windowWidth, int windowHeight) {
         snprintf(hudText, sizeof(hudText), "Best:    --:--.---"); // Placeholder if no laps recorded
     }
     glRasterPos2i(textX, textY); for (char* c = hudText; *c != '\0'; c++) { glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c); }
+    textY -= lineHeight;
+    return textY;
+}
+
+// Draws the lap timers during the racing state (each player's at the top-left of their viewport).
+void renderHUD(int windowWidth, int windowHeight) {
+    char hudText[100]; // Buffer for formatted strings
+
+    // --- Set up 2D Orthographic Projection ---
+    glMatrixMode(GL_PROJECTION); glPushMatrix(); glLoadIdentity();
+    gluOrtho2D(0, windowWidth, 0, windowHeight); // Pixel coordinates (0,0 bottom-left)
+    glMatrixMode(GL_MODELVIEW); glPushMatrix(); glLoadIdentity(); // Reset modelview
+
+    // --- Disable 3D effects ---
+    glPushAttrib(GL_DEPTH_BUFFER_BIT | GL_LIGHTING_BIT | GL_TEXTURE_BIT | GL_FOG_BIT);
+    glDisable(GL_DEPTH_TEST); glDisable(GL_LIGHTING);
+    glDisable(GL_TEXTURE_2D); glDisable(GL_FOG);
+
+    // --- Render Timers ---
+    int lineHeight = 20; // Vertical spacing
+    int textX = 10, textY = -1; // The dynres lines follow the top-left block
+    for (int p = 0; p < numPlayers; ++p) {
+        int viewport[4];
+        if (!isPlayerOnScreen(p)) continue;
+        getPlayerViewport(p, windowWidth, windowHeight, viewport);
+        int blockEnd = drawLapTimers(p, viewport[0] + 10, viewport[1] + viewport[3] - 30, lineHeight); // Near the top-left
+        if (textY < 0) textY = blockEnd;
+    }
+
+    // Dynamic resolution (scene scale and the frame time driving it)
+    if (dynRes.enabled) {
+        textY -= lineHeight / 2; // Small gap after the timers
+        glColor3f(0.8f, 0.8f, 0.8f);
+        snprintf(hudText, sizeof(hudText), "Res:     %3d%% (%dx%d)", (int)(dynRes.scale * 100.0f + 0.5f),
+                 dynRes.renderWidth, dynRes.renderHeight);
+        glRasterPos2i(textX, textY); for (char* c = hudText; *c != '\0'; c++) { glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c); }
+        textY -= lineHeight - 4;
+        snprintf(hudText, sizeof(hudText), "Frame:   %.1f ms (target %.1f)", dynRes.averageMs, dynRes.targetMs);
+        glRasterPos2i(textX, textY); for (char* c = hudText; *c != '\0'; c++) { glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c); }
+    }
+
+    // --- Minimap (cached texture + car markers, one batch) ---
+    drawMinimap(windowWidth, windowHeight, playerCars, getNumCarsShown(), !isOnlineRace() && numPlayers > 1);
 
     // --- Restore OpenGL states and matrices ---
     glPopAttrib(); // Restore states disabled earlier
@@ -316,8 +601,46 @@ void renderHUD(int windowWidth, int windowHeight) {
 }
 
 
+// --- Input Routing ---
+// Entry points for all key input, shared by the GLUT callbacks in main.c and input script
+// playback (input_script.c), so recorded sessions go through exactly the same code.
+
+// Regular Key Press (Delegates based on Game State)
+void handleKeyDown(unsigned char key) {
+    if (currentGameState == STATE_MENU) {
+        handleMenuKeyPress(key);
+    } else { // STATE_RACING
+        handleRacingKeyPress(key);
+    }
+}
+
+// Regular Key Release (Only relevant for Racing State)
+void handleKeyUp(unsigned char key) {
+    // Pass key release info to car controls only when racing
+    if (currentGameState == STATE_RACING) {
+        routeDrivingKey(0, key, 0); // 0 = key up
+    }
+}
+
+// Special Key Press (Delegates based on Game State)
+void handleSpecialKeyDown(int key) {
+    if (currentGameState == STATE_MENU) {
+        handleMenuSpecialKey(key);
+    } else { // STATE_RACING
+        handleRacingSpecialKey(key);
+    }
+}
+
+// Special Key Release (Only relevant for Racing State: player 2 drives with the arrows)
+void handleSpecialKeyUp(int key) {
+    if (currentGameState == STATE_RACING) {
+        routeDrivingKey(1, key, 0); // 0 = key up
+    }
+}
+
+
 // --- Input Handling Helper Functions ---
-// These are called by the main GLUT callbacks in main.c based on the current game state.
+// These are called by the input routing functions above based on the current game state.
 
 // Handles regular key presses when in the Menu state.
 void handleMenuKeyPress(unsigned char key) {
@@ -353,32 +676,61 @@ void handleMenuSpecialKey(int key) {
             }
             glutPostRedisplay(); // Request a redraw to show the updated highlight.
             break;
+        case GLUT_KEY_LEFT:  // Fewer players (split-screen)
+        case GLUT_KEY_RIGHT: // More players
+            numPlayers += key == GLUT_KEY_RIGHT ? 1 : -1;
+            if (numPlayers < 1) numPlayers = MAX_PLAYERS; // Wrap around like the track selection
+            if (numPlayers > MAX_PLAYERS) numPlayers = 1;
+            glutPostRedisplay();
+            break;
     }
 }
 
 // Handles regular key presses when in the Racing state.
 void handleRacingKeyPress(unsigned char key) {
-    // Pass movement keys (W, A, S, D) to the car controller.
-    // Allow case-insensitivity for movement keys.
-    if (key == 'w' || key == 'W' || key == 'a' || key == 'A' || key == 's' || key == 'S' || key == 'd' || key == 'D') {
-        setCarControls(&playerCar, key, 1); // 1 = key down
-    }
+    // Pass driving keys (see playerKeys) to the matching car's controller.
+    if (routeDrivingKey(0, key, 1)) return; // 1 = key down
 
 
     // Handle non-movement keys specific to racing.
     switch (key) {
         case 'r': // Reset key
         case 'R':
+            if (isOnlineRace()) { // Only one peer would reset: the simulations would diverge
+                printf("'R' pressed. Resetting isn't available in online races.\n");
+                break;
+            }
             printf("'R' pressed. Resetting race.\n");
             initGame(); // Re-initialize car and timers for the current track.
             break;
+        case 'h': // Heatmap overlay (--heatmap) on and off
+        case 'H':
+            toggleHeatmapOverlay();
+            break;
         case 27: // ESC key
+            if (isLockstepActive()) { // Online races start without the menu, so leave the game
+                printf("ESC pressed in online race. Leaving.\n");
+                printLockstepStats();
+                stopLockstep();
+                glutLeaveMainLoop();
+                break;
+            }
+            if (isNetClientActive()) {
+                printf("ESC pressed on the server. Leaving.\n");
+                printNetClientStats();
+                stopNetClient();
+                glutLeaveMainLoop();
+                break;
+            }
             printf("ESC pressed in racing. Returning to Menu.\n");
             currentGameState = STATE_MENU; // Change state back to menu.
             // Optionally highlight the track we just left in the menu.
             menuSelectionIndex = (int)selectedTrackType;
             // Reset timers when returning to menu to avoid confusion.
-            lastLapTimeMs = 0; bestLapTimeMs = INT_MAX; currentLapTimeMs = 0;
+            for (int p = 0; p < MAX_PLAYERS; ++p) {
+                LapTimer* timer = &playerLapTimers[p];
+                timer->lastLapTimeMs = 0; timer->bestLapTimeMs = INT_MAX; timer->currentLapTimeMs = 0;
+            }
             glutPostRedisplay(); // Request redraw to show the menu immediately.
             break;
     }
@@ -386,6 +738,6 @@ void handleRacingKeyPress(unsigned char key) {
 
 // Handles special key presses when in the Racing state.
 void handleRacingSpecialKey(int key) {
-    // Currently, no special keys are used during racing (arrows are for menu).
-    (void)key; // Mark the parameter as unused to avoid compiler warnings.
+    // The arrows drive player 2's car (when there is one).
+    routeDrivingKey(1, key, 1); // 1 = key down
 }
\ No newline at end of file
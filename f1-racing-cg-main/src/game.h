@@ -2,6 +2,8 @@
 #define GAME_H
 
 #include "car.h" // Includes Car struct definition
+#include "lap.h" // Includes LapTimer struct definition
+#include "thread.h" // THREAD_LOCAL (selectedTrackType)
 
 // --- Game States ---
 typedef enum {
@@ -22,6 +24,31 @@ typedef enum {
 // This MUST match the number of entries in the trackNames array in game.c
 #define NUM_TRACK_OPTIONS 2
 
+// --- Background Behaviour ---
+// What the race does while the window is minimised, hidden or fully covered.
+typedef enum {
+    BACKGROUND_PAUSE, // Stop simulating and drawing (near zero CPU) until visible again
+    BACKGROUND_RUN    // Keep simulating at FRAME_RATE, just skip drawing
+} BackgroundMode;
+
+// --- Local Players (split-screen) ---
+// Each player has a car, a lap timer, a viewport and a set of keys (see game.c):
+// player 1 W/A/S/D, player 2 the arrow keys, player 3 I/J/K/L, player 4 the numeric keypad 8/4/5/6.
+#define MAX_PLAYERS 4
+#define GRID_LANE_OFFSET 3.0f  // Starting grid: two abreast, either side of the start position
+#define GRID_ROW_SPACING 5.0f  // Rows behind each other
+
+// --- Race State ---
+// Everything the simulation carries from one tick to the next (cars with their controls, lap
+// timers with the finish line state), kept in one block so it can be saved and restored with a
+// single memcpy (see snapshot.h). Sized for full grids; players drive cars [0, numPlayers).
+#define MAX_RACE_CARS 20
+
+typedef struct {
+    Car cars[MAX_RACE_CARS];
+    LapTimer lapTimers[MAX_RACE_CARS];
+} RaceState;
+
 // --- Frame Timing ---
 #define FRAME_RATE 60                // Target frames per second
 #define FRAME_TIME_MS (1000 / FRAME_RATE) // Delay between updates in milliseconds
@@ -30,29 +57,44 @@ typedef enum {
 // --- Global Variables ---
 // These are defined in game.c and declared here for access in other files (like main.c).
 extern GameState currentGameState;           // Current state of the game (menu or racing)
-extern TrackType selectedTrackType;        // Track type for the *current* race (set when race starts)
+extern THREAD_LOCAL TrackType selectedTrackType; // Track for the *current* race (set when race starts; per thread)
 extern int menuSelectionIndex;           // Which track is highlighted in the menu (0-based)
-extern Car playerCar;                    // The player's car object
+extern int numPlayers;                   // Local players in the next/current race (1..MAX_PLAYERS)
+extern RaceState raceState;              // The simulation state (snapshot.h saves and restores it)
+extern Car* const playerCars;            // raceState.cars: player 1's car first; only [0, numPlayers) race
 
-// Timer variables used for lap timing in the HUD.
-extern int lapStartTimeMs;                   // Time the current lap started (ms since GLUT init)
-extern int currentLapTimeMs;                 // Duration of the current lap (ms)
-extern int lastLapTimeMs;                  // Duration of the last completed lap (ms)
-extern int bestLapTimeMs;                  // Duration of the best completed lap (ms)
-extern int crossedFinishLineMovingForwardState; // State flag for lap detection (0=false, 1=true)
+// Lap timing for each player's car, shown in its HUD (timed on the simulation tick counter).
+extern LapTimer* const playerLapTimers;  // raceState.lapTimers
+extern long simTickCount;                // Fixed update ticks since launch (advanced by stepGame)
+extern long raceStartTick;               // simTickCount when the current race was started (input script time 0)
+extern BackgroundMode backgroundMode;    // Set from the command line (--background pause|run)
 
 // --- Function Declarations ---
 // Core game functions
 void initGame();                           // Initializes car/timers for the selected track (called by startGame/reset)
-void updateGame(int value);                // Main game loop update function (timer callback)
-void setupCamera();                        // Configures the third-person camera view
+void stepGame();                           // Advances the game by one fixed tick (no GLUT scheduling)
+void simulateRaceTick(int withEffects);    // The race part of stepGame(); 0 = no skid marks or particles (resimulation)
+void updateGame(int value);                // Main game loop update function (timer callback, racing only)
+void startUpdateLoop();                    // Windowed play: run the fixed-update timer whenever a race needs it
+void setWindowVisible(int visible);        // Window status changes pause/resume the timer (see backgroundMode)
+void advanceMenuClock();                   // Key handlers: advance simTickCount by wall time while in the menu
+void setupCamera(const Car* car);          // Configures the third-person camera view behind 'car'
 void startGame(TrackType type);            // Transitions from menu to racing state with chosen track
 
 // Rendering functions
+void initRenderState();                             // Depth test, clear color, culling (after context creation)
+void renderRaceScene(int windowWidth, int windowHeight); // One chase-camera view per player (split-screen)
+void getPlayerViewport(int player, int width, int height, int viewport[4]); // x, y, width, height
 void renderMenu(int windowWidth, int windowHeight); // Draws the track selection menu
 void renderHUD(int windowWidth, int windowHeight);  // Draws the lap timer HUD
 
-// Input handling functions (called by main.c based on game state)
+// Input routing (called by the GLUT callbacks in main.c and by input script playback)
+void handleKeyDown(unsigned char key);      // Regular key pressed
+void handleKeyUp(unsigned char key);        // Regular key released
+void handleSpecialKeyDown(int key);         // Special key (arrows) pressed
+void handleSpecialKeyUp(int key);           // Special key released (player 2 drives with the arrows)
+
+// Input handling functions (called by the routing functions based on game state)
 void handleMenuKeyPress(unsigned char key);   // Handles regular keys in menu state
 void handleMenuSpecialKey(int key);         // Handles special keys (arrows) in menu state
 void handleRacingKeyPress(unsigned char key); // Handles regular keys in racing state
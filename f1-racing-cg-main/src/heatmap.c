@@ -0,0 +1,238 @@
+#include "heatmap.h" // HeatmapGrid, file layout and prototypes
+#include "surface.h" // classifySurface() for the track underlay of the images
+#include "image.h"   // writePNG()
+#include <stdio.h>   // For printf, fprintf, fopen, snprintf
+#include <stdlib.h>  // For calloc, malloc, free
+#include <string.h>  // For memcpy, memcmp, memset, strlen
+#include <math.h>    // For fabsf, logf
+
+// --- Grid ---
+int initHeatmap(HeatmapGrid* grid, TrackType track) {
+    memset(grid, 0, sizeof(*grid));
+    grid->track = track;
+    grid->visits = (unsigned int*)calloc(HEATMAP_CELLS, sizeof(unsigned int));
+    grid->collisions = (unsigned int*)calloc(HEATMAP_CELLS, sizeof(unsigned int));
+    grid->speedSum = (float*)calloc(HEATMAP_CELLS, sizeof(float));
+    if (!grid->visits || !grid->collisions || !grid->speedSum) {
+        fprintf(stderr, "Heatmap: out of memory for the grid\n");
+        freeHeatmap(grid);
+        return 0;
+    }
+    return 1;
+}
+
+void freeHeatmap(HeatmapGrid* grid) {
+    free(grid->visits);
+    free(grid->collisions);
+    free(grid->speedSum);
+    grid->visits = grid->collisions = NULL;
+    grid->speedSum = NULL;
+}
+
+// Called for every car on every tick of a batch run, so no branches beyond the bounds check
+void addHeatmapSample(HeatmapGrid* grid, float x, float z, float speed, int hitWall) {
+    int column = (int)((x - HEATMAP_MIN_X) * (1.0f / HEATMAP_CELL_SIZE));
+    int row = (int)((z - HEATMAP_MIN_Z) * (1.0f / HEATMAP_CELL_SIZE));
+    grid->samples++;
+    // One unsigned compare per axis also rejects the negatives
+    if ((unsigned int)column >= HEATMAP_WIDTH || (unsigned int)row >= HEATMAP_HEIGHT) {
+        grid->outside++;
+        return;
+    }
+    int cell = row * HEATMAP_WIDTH + column;
+    grid->visits[cell]++;
+    grid->collisions[cell] += hitWall != 0;
+    grid->speedSum[cell] += fabsf(speed);
+}
+
+void mergeHeatmap(HeatmapGrid* total, const HeatmapGrid* part) {
+    total->samples += part->samples;
+    total->outside += part->outside;
+    for (int i = 0; i < HEATMAP_CELLS; ++i) { // Three straight array sums, vectorised
+        total->visits[i] += part->visits[i];
+        total->collisions[i] += part->collisions[i];
+        total->speedSum[i] += part->speedSum[i];
+    }
+}
+
+
+// --- Colour Ramps ---
+// Linear interpolation through 'count' colour stops for t in [0, 1]
+static void rampColor(const unsigned char stops[][3], int count, float t, unsigned char* rgb) {
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    float position = t * (count - 1);
+    int i = (int)position;
+    if (i >= count - 1) i = count - 2;
+    float f = position - i;
+    for (int c = 0; c < 3; ++c) rgb[c] = (unsigned char)(stops[i][c] + (stops[i + 1][c] - stops[i][c]) * f + 0.5f);
+}
+
+static const unsigned char visitStops[4][3] = { { 20, 30, 120 }, { 0, 170, 220 }, { 250, 230, 60 }, { 255, 255, 255 } };
+static const unsigned char speedStops[4][3] = { { 30, 60, 200 }, { 40, 200, 90 }, { 250, 220, 40 }, { 230, 40, 30 } };
+
+// Time spent is spread over orders of magnitude (the racing line against one-off excursions),
+// so it is shown on a log scale relative to the busiest cell
+typedef struct {
+    unsigned int maxVisits, maxCollisions;
+    float maxMeanSpeed;
+} HeatmapRange;
+
+static void getHeatmapRange(const HeatmapGrid* grid, HeatmapRange* range) {
+    memset(range, 0, sizeof(*range));
+    for (int i = 0; i < HEATMAP_CELLS; ++i) {
+        if (grid->visits[i] > range->maxVisits) range->maxVisits = grid->visits[i];
+        if (grid->collisions[i] > range->maxCollisions) range->maxCollisions = grid->collisions[i];
+        if (grid->visits[i] > 0) {
+            float mean = grid->speedSum[i] / grid->visits[i];
+            if (mean > range->maxMeanSpeed) range->maxMeanSpeed = mean;
+        }
+    }
+}
+
+static float logFraction(unsigned int value, unsigned int max) {
+    return max > 0 ? logf(1.0f + value) / logf(1.0f + max) : 0.0f;
+}
+
+// Colour of one cell: 'speed' selects the mean speed ramp instead of time spent (with walls hit
+// in red on top). Returns 0 for cells no car visited.
+static int getCellColor(const HeatmapGrid* grid, const HeatmapRange* range, int cell, int speed, unsigned char* rgb) {
+    unsigned int visits = grid->visits[cell];
+    if (visits == 0) return 0;
+    if (speed) {
+        float mean = grid->speedSum[cell] / visits;
+        rampColor(speedStops, 4, range->maxMeanSpeed > 0.0f ? mean / range->maxMeanSpeed : 0.0f, rgb);
+        return 1;
+    }
+    rampColor(visitStops, 4, logFraction(visits, range->maxVisits), rgb);
+    if (grid->collisions[cell] > 0) {
+        float f = 0.5f + 0.5f * logFraction(grid->collisions[cell], range->maxCollisions);
+        rgb[0] = (unsigned char)(rgb[0] + (255 - rgb[0]) * f);
+        rgb[1] = (unsigned char)(rgb[1] * (1.0f - f));
+        rgb[2] = (unsigned char)(rgb[2] * (1.0f - f));
+    }
+    return 1;
+}
+
+
+// --- Export ---
+// One image, HEATMAP_PNG_SCALE pixels per cell, minimum Z at the top. Cells no car visited show
+// the track's surfaces, darkened.
+static int writeHeatmapPNG(const HeatmapGrid* grid, const HeatmapRange* range, const char* path, int speed) {
+    const int width = HEATMAP_WIDTH * HEATMAP_PNG_SCALE, height = HEATMAP_HEIGHT * HEATMAP_PNG_SCALE;
+    unsigned char* rgb = (unsigned char*)malloc((size_t)width * height * 3);
+    if (!rgb) { fprintf(stderr, "Heatmap: out of memory for the image\n"); return 0; }
+
+    static const unsigned char surfaceColors[NUM_SURFACES][3] = {
+        { 70, 70, 70 }, { 95, 50, 50 }, { 25, 55, 25 }, { 90, 80, 55 }, { 20, 30, 20 } // Asphalt, kerb, grass, gravel, barrier
+    };
+    for (int row = 0; row < HEATMAP_HEIGHT; ++row) {
+        for (int column = 0; column < HEATMAP_WIDTH; ++column) {
+            unsigned char color[3];
+            if (!getCellColor(grid, range, row * HEATMAP_WIDTH + column, speed, color)) {
+                float x = HEATMAP_MIN_X + (column + 0.5f) * HEATMAP_CELL_SIZE;
+                float z = HEATMAP_MIN_Z + (row + 0.5f) * HEATMAP_CELL_SIZE;
+                memcpy(color, surfaceColors[classifySurface(grid->track, x, z)], 3);
+            }
+            for (int dy = 0; dy < HEATMAP_PNG_SCALE; ++dy) {
+                unsigned char* pixel = rgb + (((size_t)(row * HEATMAP_PNG_SCALE + dy) * width) + column * HEATMAP_PNG_SCALE) * 3;
+                for (int dx = 0; dx < HEATMAP_PNG_SCALE; ++dx) memcpy(pixel + dx * 3, color, 3);
+            }
+        }
+    }
+
+    int ok = writePNG(path, width, height, rgb);
+    free(rgb);
+    if (!ok) fprintf(stderr, "Heatmap: cannot write '%s'\n", path);
+    return ok;
+}
+
+static int saveHeatmap(const HeatmapGrid* grid, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Heatmap: cannot open '%s' for writing\n", path);
+        return 0;
+    }
+    HeatmapFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HEATMAP_MAGIC, 4);
+    header.version = HEATMAP_VERSION;
+    header.width = HEATMAP_WIDTH;
+    header.height = HEATMAP_HEIGHT;
+    header.minX = HEATMAP_MIN_X;
+    header.minZ = HEATMAP_MIN_Z;
+    header.cellSize = HEATMAP_CELL_SIZE;
+    header.track = (unsigned int)grid->track;
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(grid->visits, sizeof(unsigned int), HEATMAP_CELLS, file) == HEATMAP_CELLS &&
+             fwrite(grid->collisions, sizeof(unsigned int), HEATMAP_CELLS, file) == HEATMAP_CELLS &&
+             fwrite(grid->speedSum, sizeof(float), HEATMAP_CELLS, file) == HEATMAP_CELLS;
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) fprintf(stderr, "Heatmap: failed writing '%s'\n", path);
+    return ok;
+}
+
+int writeHeatmapFiles(const HeatmapGrid* grid, const char* prefix) {
+    size_t length = strlen(prefix) + 16;
+    char* path = (char*)malloc(length);
+    if (!path) return 0;
+    HeatmapRange range;
+    getHeatmapRange(grid, &range);
+
+    snprintf(path, length, "%s.f1h", prefix);
+    int ok = saveHeatmap(grid, path);
+    snprintf(path, length, "%s.png", prefix);
+    ok = writeHeatmapPNG(grid, &range, path, 0) && ok;
+    snprintf(path, length, "%s_speed.png", prefix);
+    ok = writeHeatmapPNG(grid, &range, path, 1) && ok;
+    free(path);
+
+    if (ok) {
+        printf("Heatmap: %ld samples (%ld outside the grid), busiest cell %u ticks, %u wall hits at most in one cell\n",
+               grid->samples, grid->outside, range.maxVisits, range.maxCollisions);
+        printf("Heatmap: written to %s.f1h, %s.png and %s_speed.png\n", prefix, prefix, prefix);
+    }
+    return ok;
+}
+
+int loadHeatmap(HeatmapGrid* grid, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Heatmap: cannot open '%s'\n", path);
+        return 0;
+    }
+    HeatmapFileHeader header;
+    int ok = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, HEATMAP_MAGIC, 4) == 0 &&
+             header.version == HEATMAP_VERSION && header.width == HEATMAP_WIDTH && header.height == HEATMAP_HEIGHT &&
+             header.minX == HEATMAP_MIN_X && header.minZ == HEATMAP_MIN_Z && header.cellSize == HEATMAP_CELL_SIZE &&
+             header.track <= TRACK_ROUNDED;
+    if (!ok) {
+        fprintf(stderr, "Heatmap: '%s' is not a heatmap of this version and grid\n", path);
+        fclose(file);
+        return 0;
+    }
+    ok = initHeatmap(grid, (TrackType)header.track) &&
+         fread(grid->visits, sizeof(unsigned int), HEATMAP_CELLS, file) == HEATMAP_CELLS &&
+         fread(grid->collisions, sizeof(unsigned int), HEATMAP_CELLS, file) == HEATMAP_CELLS &&
+         fread(grid->speedSum, sizeof(float), HEATMAP_CELLS, file) == HEATMAP_CELLS;
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "Heatmap: '%s' is truncated\n", path);
+        freeHeatmap(grid);
+        return 0;
+    }
+    for (int i = 0; i < HEATMAP_CELLS; ++i) grid->samples += grid->visits[i];
+    return 1;
+}
+
+// Colours as in <prefix>.png; busy cells are more opaque so the track stays visible under the rest
+void getHeatmapOverlayPixels(const HeatmapGrid* grid, unsigned char* rgba) {
+    HeatmapRange range;
+    getHeatmapRange(grid, &range);
+    for (int cell = 0; cell < HEATMAP_CELLS; ++cell) {
+        unsigned char* pixel = rgba + (size_t)cell * 4;
+        if (!getCellColor(grid, &range, cell, 0, pixel)) { memset(pixel, 0, 4); continue; }
+        float alpha = grid->collisions[cell] > 0 ? 0.9f : 0.35f + 0.5f * logFraction(grid->visits[cell], range.maxVisits);
+        pixel[3] = (unsigned char)(alpha * 255.0f);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include "game.h" // TrackType
+
+// --- Driving Heatmap ---
+// A grid over the track area counting, per cell, how often a car was there, how fast it went and
+// how often it hit a wall there. Filling it is one cell index and three adds per car per tick, so
+// headless batch runs (--sweep heatmap=...) can afford it on every tick: each worker thread fills
+// its own grid and the grids are summed once at the end (mergeHeatmap), with no sharing meanwhile.
+//
+// The result is written as PNG images and as a raw grid (".f1h") that the game draws over the
+// track as a texture (--heatmap <file>, see heatmap_render.c).
+//
+// ".f1h" file layout (little-endian): HeatmapFileHeader, then the visits, collisions and speedSum
+// arrays, HEATMAP_WIDTH x HEATMAP_HEIGHT each, row by row from minimum Z.
+
+#define HEATMAP_MAGIC "F1HM"
+#define HEATMAP_VERSION 1
+#define HEATMAP_CELL_SIZE 0.5f  // World units per cell
+#define HEATMAP_MIN_X -50.0f    // Both tracks (and their guardrails) fit in this rectangle
+#define HEATMAP_MIN_Z -70.0f
+#define HEATMAP_WIDTH 200       // Cells along X: 100 units
+#define HEATMAP_HEIGHT 280      // Cells along Z: 140 units
+#define HEATMAP_CELLS (HEATMAP_WIDTH * HEATMAP_HEIGHT)
+#define HEATMAP_PNG_SCALE 3     // Pixels per cell in the exported images
+
+typedef struct {
+    char magic[4];              // HEATMAP_MAGIC
+    unsigned int version;
+    unsigned int width, height; // HEATMAP_WIDTH, HEATMAP_HEIGHT
+    float minX, minZ, cellSize;
+    unsigned int track;         // TrackType driven
+    unsigned int reserved[8];
+} HeatmapFileHeader;
+
+// One array per quantity: merging and exporting each stream through one of them
+typedef struct {
+    TrackType track;
+    long samples;               // Samples added (including those outside the grid)
+    long outside;               // Samples outside the grid (not counted in any cell)
+    unsigned int* visits;       // Ticks a car spent in the cell
+    unsigned int* collisions;   // Ticks a car hit a wall in the cell
+    float* speedSum;            // Sum of |speed| over the visits: mean speed = speedSum / visits
+} HeatmapGrid;
+
+// --- Function Declarations ---
+int initHeatmap(HeatmapGrid* grid, TrackType track); // Empty grid. Returns 1 on success.
+void freeHeatmap(HeatmapGrid* grid);
+// One car on one tick. hitWall: updateCar() undid its move this tick (Car.hitWall).
+void addHeatmapSample(HeatmapGrid* grid, float x, float z, float speed, int hitWall);
+void mergeHeatmap(HeatmapGrid* total, const HeatmapGrid* part); // total += part
+// <prefix>.f1h (raw grid), <prefix>.png (time spent, walls hit in red), <prefix>_speed.png (mean
+// speed, slow blue to fast red). Returns 1 if all three were written.
+int writeHeatmapFiles(const HeatmapGrid* grid, const char* prefix);
+int loadHeatmap(HeatmapGrid* grid, const char* path); // Allocates the grid. Returns 1 on success.
+// The RGBA colour of every cell for the in-game overlay (alpha 0 where no car went), row by row
+// from minimum Z. 'rgba' holds HEATMAP_CELLS x 4 bytes.
+void getHeatmapOverlayPixels(const HeatmapGrid* grid, unsigned char* rgba);
+
+// --- In-Game Overlay (heatmap_render.c) ---
+// The loaded grid as one texture on a ground quad over the track, under the skid marks.
+void setHeatmapOverlayPath(const char* path);   // --heatmap: loaded on the first race frame
+void toggleHeatmapOverlay(void);                // 'H' while racing
+void renderHeatmapOverlay(void);                // Within the race scene; only on the grid's own track
+void shutdownHeatmapOverlay(void);
+
+#endif // HEATMAP_H
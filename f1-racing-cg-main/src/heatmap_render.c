@@ -0,0 +1,104 @@
+#include "heatmap.h"  // HeatmapGrid, overlay prototypes
+#include "renderer.h" // Ground overlay pipeline (shader path)
+#include <GL/glew.h>  // Texture upload, client arrays (fixed-function path)
+#include <stdio.h>    // For printf
+#include <stdlib.h>   // For malloc, free
+
+#define HEATMAP_OVERLAY_Y 0.02f // Above the track surface and markings, below the skid marks (0.03)
+
+// --- Overlay State ---
+// The grid is only needed to build the texture; after the upload the texture is all that's kept.
+static const char* overlayPath = NULL;
+static int overlayLoaded = 0;   // 1 once a load was attempted (a bad file isn't retried every frame)
+static int overlayVisible = 1;
+static TrackType overlayTrack;
+static GLuint overlayTexture = 0;
+
+void setHeatmapOverlayPath(const char* path) {
+    overlayPath = path;
+    overlayLoaded = 0;
+}
+
+void toggleHeatmapOverlay() {
+    if (!overlayPath) {
+        printf("'H' pressed. No heatmap loaded (start with --heatmap <file.f1h>).\n");
+        return;
+    }
+    overlayVisible = !overlayVisible;
+    printf("'H' pressed. Heatmap overlay %s.\n", overlayVisible ? "shown" : "hidden");
+}
+
+// Needs a current context: called from the first race frame rather than from the option parsing
+static void loadHeatmapOverlay() {
+    overlayLoaded = 1;
+    HeatmapGrid grid;
+    if (!loadHeatmap(&grid, overlayPath)) return;
+    unsigned char* rgba = (unsigned char*)malloc((size_t)HEATMAP_CELLS * 4);
+    if (!rgba) { freeHeatmap(&grid); return; }
+    getHeatmapOverlayPixels(&grid, rgba);
+    overlayTrack = grid.track;
+
+    glGenTextures(1, &overlayTexture);
+    glBindTexture(GL_TEXTURE_2D, overlayTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, HEATMAP_WIDTH, HEATMAP_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); // Seen at a shallow angle: smooth, no mipmaps
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    free(rgba);
+    printf("Status: Heatmap overlay from %s (%ld samples, track type %d; 'H' toggles it)\n",
+           overlayPath, grid.samples, (int)grid.track);
+    freeHeatmap(&grid);
+}
+
+// --- Rendering ---
+// One quad over the whole grid. Blended like the skid marks (no depth writes, polygon offset), and
+// only on the track the heatmap was collected on.
+void renderHeatmapOverlay() {
+    if (!overlayPath || !overlayVisible) return;
+    if (!overlayLoaded) loadHeatmapOverlay();
+    if (!overlayTexture || overlayTrack != selectedTrackType) return;
+
+    const float rect[4] = { HEATMAP_MIN_X, HEATMAP_MIN_Z,
+                            HEATMAP_MIN_X + HEATMAP_WIDTH * HEATMAP_CELL_SIZE,
+                            HEATMAP_MIN_Z + HEATMAP_HEIGHT * HEATMAP_CELL_SIZE };
+    if (renderPath == RENDER_PATH_SHADER) {
+        submitGroundOverlay(overlayTexture, rect, HEATMAP_OVERLAY_Y);
+        return;
+    }
+
+    const float corners[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f } }; // Strip
+    float vertices[4][3];
+    for (int i = 0; i < 4; ++i) {
+        vertices[i][0] = corners[i][0] > 0.0f ? rect[2] : rect[0];
+        vertices[i][1] = HEATMAP_OVERLAY_Y;
+        vertices[i][2] = corners[i][1] > 0.0f ? rect[3] : rect[1];
+    }
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_POLYGON_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, overlayTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    glDisable(GL_LIGHTING);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(-1.0f, -1.0f);
+    glDisable(GL_CULL_FACE);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, vertices);
+    glTexCoordPointer(2, GL_FLOAT, 0, corners);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPopAttrib();
+}
+
+void shutdownHeatmapOverlay() {
+    if (overlayTexture) glDeleteTextures(1, &overlayTexture);
+    overlayTexture = 0;
+    overlayLoaded = 0;
+}
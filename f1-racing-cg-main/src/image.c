@@ -0,0 +1,151 @@
+#include "image.h"  // writePNG prototypes
+#include <stdio.h>  // For fopen, fwrite, fprintf
+#include <string.h> // For memcpy
+
+#define PNG_MAX_STORED_BLOCK 65535 // Largest uncompressed deflate block
+
+// --- Checksums ---
+// CRC-32 (PNG chunks) and Adler-32 (zlib stream), computed incrementally.
+static unsigned long crcTable[256];
+static int crcTableReady = 0;
+
+static unsigned long updateCRC(unsigned long crc, const unsigned char* data, size_t length) {
+    if (!crcTableReady) {
+        for (unsigned long n = 0; n < 256; ++n) {
+            unsigned long c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+            crcTable[n] = c;
+        }
+        crcTableReady = 1;
+    }
+    for (size_t i = 0; i < length; ++i) crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static unsigned long updateAdler(unsigned long adler, const unsigned char* data, size_t length) {
+    unsigned long a = adler & 0xFFFF, b = adler >> 16;
+    for (size_t i = 0; i < length; ++i) {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+
+// --- Chunk Writing ---
+// The IDAT chunk is streamed: its length is known up front, and the CRC is
+// accumulated while the data goes out, so no full copy of the image is needed.
+typedef struct {
+    FILE* file;
+    unsigned long crc;
+} PNGChunk;
+
+static void putBigEndian32(unsigned char* out, unsigned long value) {
+    out[0] = (unsigned char)(value >> 24);
+    out[1] = (unsigned char)(value >> 16);
+    out[2] = (unsigned char)(value >> 8);
+    out[3] = (unsigned char)value;
+}
+
+static void beginChunk(PNGChunk* chunk, const char* type, unsigned long length) {
+    unsigned char header[8];
+    putBigEndian32(header, length);
+    memcpy(header + 4, type, 4);
+    fwrite(header, 1, 8, chunk->file);
+    chunk->crc = updateCRC(0xFFFFFFFFUL, header + 4, 4);
+}
+
+static void chunkData(PNGChunk* chunk, const unsigned char* data, size_t length) {
+    fwrite(data, 1, length, chunk->file);
+    chunk->crc = updateCRC(chunk->crc, data, length);
+}
+
+static void endChunk(PNGChunk* chunk) {
+    unsigned char crc[4];
+    putBigEndian32(crc, chunk->crc ^ 0xFFFFFFFFUL);
+    fwrite(crc, 1, 4, chunk->file);
+}
+
+
+// --- PNG Writer ---
+static int writePNGRows(const char* path, int width, int height, const unsigned char* rgb, int flipped) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Image: cannot open '%s' for writing\n", path);
+        return 0;
+    }
+
+    static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    fwrite(signature, 1, 8, file);
+
+    PNGChunk chunk;
+    chunk.file = file;
+
+    // IHDR: size, 8-bit depth, colour type 2 (RGB), default compression/filter, no interlace
+    unsigned char ihdr[13];
+    putBigEndian32(ihdr, (unsigned long)width);
+    putBigEndian32(ihdr + 4, (unsigned long)height);
+    ihdr[8] = 8; ihdr[9] = 2; ihdr[10] = 0; ihdr[11] = 0; ihdr[12] = 0;
+    beginChunk(&chunk, "IHDR", 13);
+    chunkData(&chunk, ihdr, 13);
+    endChunk(&chunk);
+
+    // IDAT: zlib header, stored deflate blocks over the filtered rows (filter byte 0 per row), Adler-32
+    size_t rowBytes = (size_t)width * 3;
+    size_t rawSize = (rowBytes + 1) * (size_t)height;
+    size_t numBlocks = rawSize > 0 ? (rawSize + PNG_MAX_STORED_BLOCK - 1) / PNG_MAX_STORED_BLOCK : 1;
+    unsigned long idatLength = (unsigned long)(2 + numBlocks * 5 + rawSize + 4);
+    beginChunk(&chunk, "IDAT", idatLength);
+    static const unsigned char zlibHeader[2] = { 0x78, 0x01 };
+    chunkData(&chunk, zlibHeader, 2);
+
+    unsigned long adler = 1;
+    size_t blockLeft = 0;   // Bytes left in the current stored block
+    size_t rawWritten = 0;
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* row = rgb + rowBytes * (size_t)(flipped ? height - 1 - y : y);
+        static const unsigned char filterNone = 0;
+        // Each row is the filter byte followed by the pixels; either may straddle a block boundary
+        for (int part = 0; part < 2; ++part) {
+            const unsigned char* data = part == 0 ? &filterNone : row;
+            size_t length = part == 0 ? 1 : rowBytes;
+            while (length > 0) {
+                if (blockLeft == 0) {
+                    size_t remaining = rawSize - rawWritten;
+                    blockLeft = remaining < PNG_MAX_STORED_BLOCK ? remaining : PNG_MAX_STORED_BLOCK;
+                    unsigned char blockHeader[5];
+                    blockHeader[0] = (remaining == blockLeft) ? 1 : 0; // BFINAL on the last block, BTYPE 00
+                    blockHeader[1] = (unsigned char)(blockLeft & 0xFF);
+                    blockHeader[2] = (unsigned char)(blockLeft >> 8);
+                    blockHeader[3] = (unsigned char)(~blockLeft & 0xFF);
+                    blockHeader[4] = (unsigned char)((~blockLeft >> 8) & 0xFF);
+                    chunkData(&chunk, blockHeader, 5);
+                }
+                size_t n = length < blockLeft ? length : blockLeft;
+                chunkData(&chunk, data, n);
+                adler = updateAdler(adler, data, n);
+                data += n; length -= n; blockLeft -= n; rawWritten += n;
+            }
+        }
+    }
+
+    unsigned char adlerBytes[4];
+    putBigEndian32(adlerBytes, adler);
+    chunkData(&chunk, adlerBytes, 4);
+    endChunk(&chunk);
+
+    beginChunk(&chunk, "IEND", 0);
+    endChunk(&chunk);
+
+    int ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+int writePNG(const char* path, int width, int height, const unsigned char* rgb) {
+    return writePNGRows(path, width, height, rgb, 0);
+}
+
+int writePNGFlipped(const char* path, int width, int height, const unsigned char* rgb) {
+    return writePNGRows(path, width, height, rgb, 1);
+}
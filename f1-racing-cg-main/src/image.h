@@ -0,0 +1,14 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+// --- Image Output ---
+// Minimal PNG writer for debug output (frame dumps, heatmaps). Pixels are written
+// uncompressed (stored deflate blocks), so files are large but need no zlib.
+
+// Writes 'width' x 'height' 8-bit RGB pixels, rows top to bottom. Returns 1 on success.
+int writePNG(const char* path, int width, int height, const unsigned char* rgb);
+
+// Same, but rows are bottom to top (as returned by glReadPixels).
+int writePNGFlipped(const char* path, int width, int height, const unsigned char* rgb);
+
+#endif // IMAGE_H
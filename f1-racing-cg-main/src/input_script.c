@@ -0,0 +1,172 @@
+#include "input_script.h" // InputScript struct and prototypes
+#include "game.h"         // handleKeyDown/Up, handleSpecialKeyDown/Up
+#include <GL/freeglut.h>  // GLUT_KEY_* codes for special keys
+#include <stdio.h>        // For fopen, fgets, fprintf
+#include <stdlib.h>       // For realloc, free
+#include <string.h>       // For strcmp, strlen
+
+// --- Key Names ---
+// Names accepted for keys that aren't a single printable character.
+typedef struct {
+    const char* name;
+    int special;
+    int key;
+} KeyName;
+
+static const KeyName keyNames[] = {
+    { "ENTER", 0, 13 },
+    { "ESC",   0, 27 },
+    { "SPACE", 0, ' ' },
+    { "UP",    1, GLUT_KEY_UP },
+    { "DOWN",  1, GLUT_KEY_DOWN },
+    { "LEFT",  1, GLUT_KEY_LEFT },
+    { "RIGHT", 1, GLUT_KEY_RIGHT },
+};
+#define NUM_KEY_NAMES ((int)(sizeof(keyNames) / sizeof(keyNames[0])))
+
+// Parses a key token into (special, key). Returns 1 on success.
+static int parseKeyName(const char* text, int* special, int* key) {
+    for (int i = 0; i < NUM_KEY_NAMES; ++i) {
+        if (strcmp(text, keyNames[i].name) == 0) {
+            *special = keyNames[i].special;
+            *key = keyNames[i].key;
+            return 1;
+        }
+    }
+    if (strlen(text) == 1 && text[0] > ' ' && text[0] < 127) { // Single printable character
+        *special = 0;
+        *key = (unsigned char)text[0];
+        return 1;
+    }
+    return 0;
+}
+
+// Writes the token for a key (the inverse of parseKeyName). Unknown special keys are dropped.
+static const char* formatKeyName(int special, int key, char* buffer) {
+    for (int i = 0; i < NUM_KEY_NAMES; ++i) {
+        if (keyNames[i].special == special && keyNames[i].key == key) return keyNames[i].name;
+    }
+    if (special || key <= ' ' || key >= 127) return NULL;
+    buffer[0] = (char)key;
+    buffer[1] = '\0';
+    return buffer;
+}
+
+
+// --- Script Lifetime ---
+void initInputScript(InputScript* script) {
+    script->events = NULL;
+    script->count = 0;
+    script->capacity = 0;
+    script->next = 0;
+}
+
+void freeInputScript(InputScript* script) {
+    free(script->events);
+    initInputScript(script);
+}
+
+void recordInputEvent(InputScript* script, long tick, int down, int special, int key) {
+    if (script->count == script->capacity) {
+        int newCapacity = script->capacity > 0 ? script->capacity * 2 : 256;
+        InputEvent* grown = (InputEvent*)realloc(script->events, (size_t)newCapacity * sizeof(InputEvent));
+        if (!grown) return; // Out of memory: drop the event rather than crash mid-session
+        script->events = grown;
+        script->capacity = newCapacity;
+    }
+    InputEvent* event = &script->events[script->count++];
+    event->tick = tick;
+    event->down = down;
+    event->special = special;
+    event->key = key;
+}
+
+
+// --- File I/O ---
+int loadInputScript(InputScript* script, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Input script: cannot open '%s'\n", path);
+        return 0;
+    }
+
+    initInputScript(script);
+    char line[128];
+    int lineNumber = 0;
+    long lastTick = 0;
+    while (fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        long tick;
+        char action[8], keyText[16];
+        int fields = sscanf(line, "%ld %7s %15s", &tick, action, keyText);
+        if (fields <= 0) continue; // Blank or comment-only line
+
+        int special, key;
+        int down = (fields == 3 && strcmp(action, "down") == 0); // action is only set when all three were read
+        if (fields != 3 || (!down && strcmp(action, "up") != 0) || !parseKeyName(keyText, &special, &key)) {
+            fprintf(stderr, "Input script: %s:%d: expected '<tick> down|up <key>'\n", path, lineNumber);
+            fclose(file);
+            freeInputScript(script);
+            return 0;
+        }
+        if (tick < lastTick) {
+            fprintf(stderr, "Input script: %s:%d: ticks must not decrease\n", path, lineNumber);
+            fclose(file);
+            freeInputScript(script);
+            return 0;
+        }
+        lastTick = tick;
+        recordInputEvent(script, tick, down, special, key);
+    }
+
+    fclose(file);
+    return 1;
+}
+
+int saveInputScript(const InputScript* script, const char* path, long fromTick) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Input script: cannot open '%s' for writing\n", path);
+        return 0;
+    }
+
+    fprintf(file, "# F1 Racer input script: <tick> down|up <key>, %d ticks per second\n", FRAME_RATE);
+    for (int i = 0; i < script->count; ++i) {
+        const InputEvent* event = &script->events[i];
+        if (event->tick < fromTick) continue;
+        char buffer[2];
+        const char* name = formatKeyName(event->special, event->key, buffer);
+        if (!name) continue;
+        fprintf(file, "%ld %s %s\n", event->tick - fromTick, event->down ? "down" : "up", name);
+    }
+
+    fclose(file);
+    return 1;
+}
+
+
+// --- Playback ---
+void rewindInputScript(InputScript* script) {
+    script->next = 0;
+}
+
+void playInputScript(InputScript* script, long tick) {
+    while (script->next < script->count && script->events[script->next].tick <= tick) {
+        const InputEvent* event = &script->events[script->next++];
+        if (event->special) {
+            if (event->down) handleSpecialKeyDown(event->key);
+            else handleSpecialKeyUp(event->key); // Player 2 drives with the arrows
+        } else if (event->down) {
+            handleKeyDown((unsigned char)event->key);
+        } else {
+            handleKeyUp((unsigned char)event->key);
+        }
+    }
+}
+
+int isInputScriptFinished(const InputScript* script) {
+    return script->next >= script->count;
+}
@@ -0,0 +1,41 @@
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+// --- Input Scripts ---
+// A timed list of key down/up events, used to record a session and play it back
+// through the same handlers as the GLUT keyboard callbacks (see handleKeyDown() in game.c).
+//
+// Text format, one event per line ('#' starts a comment):
+//     <tick> down|up <key>
+// <tick> counts fixed update ticks from the start of the race. <key> is a single
+// character (w, a, s, d, r, ...) or one of ENTER, ESC, SPACE, UP, DOWN, LEFT, RIGHT.
+
+// --- Input Event ---
+typedef struct {
+    long tick;   // Update tick the event is applied on (before that tick's physics)
+    int down;    // 1 = key pressed, 0 = key released
+    int special; // 1 = GLUT special key (arrows), 0 = regular ASCII key
+    int key;     // ASCII code or GLUT_KEY_* value
+} InputEvent;
+
+// --- Input Script ---
+typedef struct {
+    InputEvent* events; // Sorted by tick (recording appends in order, loading keeps file order)
+    int count;
+    int capacity;
+    int next;           // Playback position: index of the first event not yet applied
+} InputScript;
+
+// Function declarations
+void initInputScript(InputScript* script);
+void freeInputScript(InputScript* script);
+int loadInputScript(InputScript* script, const char* path); // Returns 1 on success
+// Writes the events with tick >= 'fromTick', shifted so 'fromTick' becomes tick 0. Returns 1 on success.
+int saveInputScript(const InputScript* script, const char* path, long fromTick);
+void recordInputEvent(InputScript* script, long tick, int down, int special, int key);
+void rewindInputScript(InputScript* script);
+// Applies every event up to and including 'tick' via the game's key handlers.
+void playInputScript(InputScript* script, long tick);
+int isInputScriptFinished(const InputScript* script);
+
+#endif // INPUT_SCRIPT_H
@@ -0,0 +1,100 @@
+#include "interp.h"
+#include <math.h>   // For floor
+#include <stddef.h> // For NULL
+
+static const NetSnapshot* getSlot(const InterpBuffer* buffer, long tick) {
+    const NetSnapshot* slot = &buffer->snapshots[(tick / PROTOCOL_SNAPSHOT_INTERVAL) & (INTERP_SNAPSHOTS - 1)];
+    return slot->tick == tick ? slot : NULL;
+}
+
+void clearInterpBuffer(InterpBuffer* buffer) {
+    for (int i = 0; i < INTERP_SNAPSHOTS; ++i) buffer->snapshots[i].tick = -1;
+    buffer->newestTick = -1;
+    buffer->renderTick = 0.0;
+    buffer->underruns = 0;
+    buffer->resyncs = 0;
+}
+
+void pushInterpSnapshot(InterpBuffer* buffer, const NetSnapshot* snapshot) {
+    if (buffer->newestTick >= 0 && snapshot->tick <= buffer->newestTick - INTERP_SNAPSHOTS * PROTOCOL_SNAPSHOT_INTERVAL) return;
+    buffer->snapshots[(snapshot->tick / PROTOCOL_SNAPSHOT_INTERVAL) & (INTERP_SNAPSHOTS - 1)] = *snapshot;
+    if (buffer->newestTick < 0) buffer->renderTick = (double)(snapshot->tick - INTERP_DELAY_TICKS); // First one
+    if (snapshot->tick > buffer->newestTick) buffer->newestTick = snapshot->tick;
+}
+
+void advanceInterpBuffer(InterpBuffer* buffer, double ticks) {
+    if (buffer->newestTick < 0) return;
+    buffer->renderTick += ticks;
+    double drift = (double)(buffer->newestTick - INTERP_DELAY_TICKS) - buffer->renderTick;
+    if (drift > INTERP_SNAP_TICKS || drift < -INTERP_SNAP_TICKS) { // After a stall on either side
+        buffer->renderTick += drift;
+        buffer->resyncs++;
+    } else {
+        // The target moves in steps of one interval as snapshots arrive; a small correction
+        // per tick follows its average without making the cars speed up and slow down visibly.
+        buffer->renderTick += drift * INTERP_CORRECTION;
+    }
+    if (buffer->renderTick > (double)buffer->newestTick) buffer->underruns++;
+}
+
+// The snapshots around the render tick: 'from' at or before it and 'to' after it (NULL when
+// the render tick is past the newest snapshot). Gaps left by lost packets are skipped.
+static void findPair(const InterpBuffer* buffer, const NetSnapshot** from, const NetSnapshot** to) {
+    long tick = (long)floor(buffer->renderTick / PROTOCOL_SNAPSHOT_INTERVAL) * PROTOCOL_SNAPSHOT_INTERVAL;
+    if (tick > buffer->newestTick) tick = buffer->newestTick;
+    *from = NULL;
+    *to = NULL;
+    for (long t = tick; t > buffer->newestTick - INTERP_SNAPSHOTS * PROTOCOL_SNAPSHOT_INTERVAL; t -= PROTOCOL_SNAPSHOT_INTERVAL) {
+        if ((*from = getSlot(buffer, t)) != NULL) break;
+    }
+    for (long t = tick + PROTOCOL_SNAPSHOT_INTERVAL; t <= buffer->newestTick; t += PROTOCOL_SNAPSHOT_INTERVAL) {
+        if ((*to = getSlot(buffer, t)) != NULL) break;
+    }
+}
+
+unsigned int getInterpCars(const InterpBuffer* buffer) {
+    const NetSnapshot *from, *to;
+    if (buffer->newestTick < 0) return 0;
+    findPair(buffer, &from, &to);
+    return from ? from->present : (to ? to->present : 0);
+}
+
+int sampleInterpBuffer(const InterpBuffer* buffer, int car, Car* out, int* laps) {
+    const NetSnapshot *from, *to;
+    if (buffer->newestTick < 0) return 0;
+    findPair(buffer, &from, &to);
+    if (!from) { from = to; to = NULL; } // Render tick before the oldest snapshot: hold that one
+    if (!from || !(from->present & (1u << car))) return 0;
+    const NetCarState* a = &from->cars[car];
+    unpackCarState(a, out);
+    *laps = a->laps;
+
+    // Blend towards the next snapshot, or (underrun) run on from the one before along the same motion
+    const NetCarState* b;
+    double t;
+    if (to && (to->present & (1u << car))) {
+        b = &to->cars[car];
+        t = (buffer->renderTick - from->tick) / (double)(to->tick - from->tick);
+    } else {
+        const NetSnapshot* previous = NULL;
+        for (long tick = from->tick - PROTOCOL_SNAPSHOT_INTERVAL; !previous && tick > from->tick - INTERP_SNAPSHOTS * PROTOCOL_SNAPSHOT_INTERVAL; tick -= PROTOCOL_SNAPSHOT_INTERVAL) {
+            previous = getSlot(buffer, tick);
+        }
+        if (!previous || !(previous->present & (1u << car))) return 1;
+        double ahead = buffer->renderTick - from->tick;
+        if (ahead < 0.0) ahead = 0.0;
+        if (ahead > INTERP_MAX_EXTRAPOLATE_TICKS) ahead = INTERP_MAX_EXTRAPOLATE_TICKS;
+        // Mirror 'previous' through 'from': blending a -> b by t is then extrapolation past 'from'
+        b = &previous->cars[car];
+        t = -ahead / (double)(from->tick - previous->tick);
+    }
+    int angleDelta = (b->angle - a->angle) % NET_ANGLE_STEPS; // Shortest way round
+    if (angleDelta >= NET_ANGLE_STEPS / 2) angleDelta -= NET_ANGLE_STEPS;
+    else if (angleDelta < -NET_ANGLE_STEPS / 2) angleDelta += NET_ANGLE_STEPS;
+    out->x = (float)((a->x + (b->x - a->x) * t) / NET_POSITION_SCALE);
+    out->z = (float)((a->z + (b->z - a->z) * t) / NET_POSITION_SCALE);
+    out->speed = (float)((a->speed + (b->speed - a->speed) * t) / NET_SPEED_SCALE);
+    double angle = (a->angle + angleDelta * t) * (360.0 / NET_ANGLE_STEPS);
+    out->angle = (float)(angle - 360.0 * floor(angle / 360.0));
+    return 1;
+}
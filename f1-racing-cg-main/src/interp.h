@@ -0,0 +1,41 @@
+#ifndef INTERP_H
+#define INTERP_H
+
+#include "protocol.h" // NetSnapshot, PROTOCOL_SNAPSHOT_INTERVAL
+
+// --- Snapshot Interpolation ---
+// A client gets a snapshot every PROTOCOL_SNAPSHOT_INTERVAL ticks, and not at an even pace:
+// packets are delayed by varying amounts or lost. Drawing the newest one as it arrives would
+// make every car jump three ticks at a time and stutter with the jitter. Instead the client
+// draws INTERP_DELAY_TICKS behind the newest snapshot, blending the two snapshots around its
+// render tick, so one late or lost packet is covered by the next one arriving in time.
+//
+// The render tick advances with the client's own ticks and is nudged towards its target delay
+// when the two clocks drift apart (or snapped, after a long gap). If it overtakes the newest
+// snapshot anyway (an underrun), the cars are extrapolated along their last motion for at most
+// INTERP_MAX_EXTRAPOLATE_TICKS and then held.
+
+#define INTERP_SNAPSHOTS 16                                   // Kept (power of two), 48 ticks
+#define INTERP_DELAY_TICKS (2 * PROTOCOL_SNAPSHOT_INTERVAL)   // 100 ms behind the server at 60 Hz
+#define INTERP_MAX_EXTRAPOLATE_TICKS (2 * PROTOCOL_SNAPSHOT_INTERVAL)
+#define INTERP_SNAP_TICKS 30                                  // Drift beyond which the clock jumps
+#define INTERP_CORRECTION 0.05                                // Share of the drift removed per tick
+
+typedef struct {
+    NetSnapshot snapshots[INTERP_SNAPSHOTS]; // Slot = tick / interval % INTERP_SNAPSHOTS
+    long newestTick;                         // -1 = nothing received yet
+    double renderTick;                       // Server time being drawn
+    long underruns;                          // Ticks drawn past the newest snapshot
+    long resyncs;                            // Times the render tick was snapped to its target
+} InterpBuffer;
+
+// --- Function Declarations ---
+void clearInterpBuffer(InterpBuffer* buffer);
+void pushInterpSnapshot(InterpBuffer* buffer, const NetSnapshot* snapshot); // Any order; stale ones are ignored
+void advanceInterpBuffer(InterpBuffer* buffer, double ticks);               // Once per client tick (ticks = 1)
+unsigned int getInterpCars(const InterpBuffer* buffer);                     // Present bits at the render tick
+// Pose, speed and controls of 'car' at the render tick (the rest of *out is left alone), and its
+// lap count. Returns 0 if the car isn't in the snapshots around the render tick.
+int sampleInterpBuffer(const InterpBuffer* buffer, int car, Car* out, int* laps);
+
+#endif // INTERP_H
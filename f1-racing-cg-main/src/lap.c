@@ -0,0 +1,103 @@
+#include "lap.h"     // LapTimer struct and prototypes
+#include "track.h"   // Finish line constants for both track types
+#include "game.h"    // selectedTrackType, FRAME_RATE
+#include <limits.h>  // For INT_MAX (initial best lap time)
+#include <math.h>    // For floor
+
+// --- Tick Conversion ---
+// Ticks are fixed FRAME_TIME_SEC steps, so this is exact up to the final rounding.
+int lapTicksToMs(double ticks) {
+    return (int)floor(ticks * 1000.0 / FRAME_RATE + 0.5);
+}
+
+// --- Finish Line Bounds ---
+// X span of the finish line on the currently selected track.
+void getFinishLineXBounds(float* xStart, float* xEnd) {
+    if (selectedTrackType == TRACK_RECT) {
+        *xStart = RECT_FINISH_LINE_X_START;
+        *xEnd = RECT_FINISH_LINE_X_END;
+    } else { // TRACK_ROUNDED
+        *xStart = ROUND_FINISH_LINE_X_START;
+        *xEnd = ROUND_FINISH_LINE_X_END;
+    }
+}
+
+
+// --- Lap Timer Initialization ---
+// Resets all timing for a car at the start of a race (or after a reset).
+void initLapTimer(LapTimer* timer, const Car* car, long tick) {
+    timer->lapStartTick = (double)tick;
+    timer->currentLapTimeMs = 0;
+    timer->lastLapTimeMs = 0;       // No previous lap yet on reset
+    timer->bestLapTimeMs = INT_MAX; // Reset best lap on reset (or load from save later)
+    timer->lapsCompleted = 0;
+
+    // Determine initial finish line state based on the car's starting Z and X position
+    // relative to the finish line boundaries of the *selected* track.
+    float finishLineXStart, finishLineXEnd;
+    getFinishLineXBounds(&finishLineXStart, &finishLineXEnd);
+    // Set flag to true (1) only if starting exactly on or past the line (unlikely with current setup)
+    timer->crossedFinishLineMovingForwardState = (car->z >= FINISH_LINE_Z &&
+                                                  car->x >= finishLineXStart &&
+                                                  car->x <= finishLineXEnd);
+}
+
+
+// --- Lap Timer Update ---
+// Call once per tick *after* updateCar(). Updates the running lap time and detects
+// finish line crossings. Returns 1 if this update completed a lap.
+int updateLapTimer(LapTimer* timer, const Car* car, long tick) {
+    int lapCompleted = 0;
+
+    // Update the running lap time from the tick counter.
+    timer->currentLapTimeMs = lapTicksToMs((double)tick - timer->lapStartTick);
+
+    // --- Lap Completion Logic ---
+    // Check if the car has crossed the finish line in the forward direction.
+    int movingForward = (car->speed > 0.1f); // Check speed for direction
+    float finishLineXStart, finishLineXEnd;
+    getFinishLineXBounds(&finishLineXStart, &finishLineXEnd);
+    // Check if the car is within the X span of the finish line.
+    int withinFinishLineX = (car->x >= finishLineXStart && car->x <= finishLineXEnd);
+
+    // --- Detect Crossing Finish Line FORWARD ---
+    // Conditions: Z crossed the FINISH_LINE_Z threshold, moving forward, within X bounds.
+    if (car->prev_z < FINISH_LINE_Z && car->z >= FINISH_LINE_Z && movingForward && withinFinishLineX) {
+        // The car moved in a straight line from prev_z to z during the tick that just ended
+        // (tick - 1 -> tick), so the fraction of that tick spent before the line is exact.
+        double crossingFraction = (FINISH_LINE_Z - car->prev_z) / (car->z - car->prev_z);
+        double crossingTick = (double)(tick - 1) + crossingFraction;
+
+        // Only count lap completion if the 'crossedForward' flag is already set (meaning
+        // we completed the previous part of the track and are genuinely finishing a lap).
+        if (timer->crossedFinishLineMovingForwardState == 1) {
+            // --- LAP COMPLETED ---
+            timer->lastLapTimeMs = lapTicksToMs(crossingTick - timer->lapStartTick); // Record the time
+            // Update best lap if this one was faster (and valid).
+            if (timer->lastLapTimeMs > 0 && timer->lastLapTimeMs < timer->bestLapTimeMs) {
+                timer->bestLapTimeMs = timer->lastLapTimeMs;
+            }
+            timer->lapsCompleted++;
+            lapCompleted = 1;
+            // Reset timer for the start of the *new* lap (at the crossing point, not the tick boundary).
+            timer->lapStartTick = crossingTick;
+            timer->currentLapTimeMs = lapTicksToMs((double)tick - crossingTick);
+            // The flag remains 1 as we start the next lap from past the line.
+        } else {
+            // This is the *first* time crossing forward (either started before the line
+            // or crossed backward then forward again). Set the flag and start the timer.
+            timer->crossedFinishLineMovingForwardState = 1; // Set flag to true
+            timer->lapStartTick = crossingTick;            // Start timing the first/next lap *now*.
+            timer->currentLapTimeMs = lapTicksToMs((double)tick - crossingTick);
+        }
+    }
+    // --- Detect Crossing Finish Line BACKWARD ---
+    // Conditions: Z crossed the threshold backward, within X bounds.
+    else if (car->prev_z >= FINISH_LINE_Z && car->z < FINISH_LINE_Z && withinFinishLineX) {
+        // If the car goes backward over the line, reset the state flag. It will need
+        // to cross forward again to set the flag before completing the *next* lap.
+        timer->crossedFinishLineMovingForwardState = 0; // Set flag to false
+    }
+
+    return lapCompleted;
+}
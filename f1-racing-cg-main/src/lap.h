@@ -0,0 +1,29 @@
+#ifndef LAP_H
+#define LAP_H
+
+#include "car.h" // Lap detection reads the car's current and previous position
+
+// --- Lap Timer ---
+// Per-car lap timing and finish line state. The player's timer lives in game.c;
+// headless runs (e.g. the parameter sweep) keep one per simulated car.
+// Timing runs on the simulation tick counter (FRAME_RATE ticks per simulated second), never on the
+// wall clock, so hitches or running faster than real time cannot change a lap time. The exact moment
+// the car crosses the line is interpolated between its previous and current position within the tick.
+typedef struct {
+    double lapStartTick;                     // Tick (with sub-tick fraction) at which the current lap started
+    int currentLapTimeMs;                    // Duration of the current lap
+    int lastLapTimeMs;                       // Duration of the last completed lap (0 = none yet)
+    int bestLapTimeMs;                       // Duration of the best completed lap (INT_MAX = none yet)
+    int crossedFinishLineMovingForwardState; // State flag for lap detection (0=false, 1=true)
+    int lapsCompleted;                       // Number of laps completed since initLapTimer()
+} LapTimer;
+
+// Function declarations
+// 'tick' is the number of simulation ticks completed so far; updateLapTimer() must be called
+// once per tick, right after updateCar() moved the car from (prev_x, prev_z) to (x, z).
+void initLapTimer(LapTimer* timer, const Car* car, long tick);
+int updateLapTimer(LapTimer* timer, const Car* car, long tick);     // Returns 1 if a lap was completed
+int lapTicksToMs(double ticks);                                     // Simulated duration in ms (rounded)
+void getFinishLineXBounds(float* xStart, float* xEnd);              // Finish line span on the *selected* track
+
+#endif // LAP_H
@@ -0,0 +1,470 @@
+#include "lockstep.h" // Protocol constants, LockstepStats, prototypes
+#include "ai.h"       // Headless test races: the autopilot drives this peer's car
+#include "timing.h"   // Handshake and send timing, headless pacing
+#include <stdio.h>    // For printf, fprintf
+#include <stdlib.h>   // For atoi, atof
+#include <string.h>   // For memcpy, strcmp, strncmp
+
+#define HISTORY_MASK (LOCKSTEP_HISTORY - 1)
+#define HASH_SLOTS 8 // Checkpoints kept per side (a peer is never this far ahead)
+#define HANDSHAKE_RETRY_SECONDS 0.2
+#define HANDSHAKE_TIMEOUT_SECONDS 60.0
+#define LINGER_SECONDS 2.0 // Headless: keep answering after the last tick until the peer has everything
+
+// --- Packets ---
+// All multi-byte fields little-endian. Ticks are sent as their low 16 bits and expanded
+// around the receiver's own position (peers are never 32768 ticks apart).
+//   HELLO  (joining peer):  type, version
+//   START  (host's reply):  type, version, track, input delay
+//   INPUT  (both, racing):  type | LOCKSTEP_HAS_HASH, ack(2), first tick(2), count(1),
+//                           count control nibbles (low nibble first), [hash tick(2), hash(4)]
+//   BYE    (either):        type
+enum { PACKET_HELLO = 1, PACKET_START, PACKET_INPUT, PACKET_BYE };
+#define PACKET_TYPE_MASK 0x0F
+#define LOCKSTEP_HAS_HASH 0x10
+#define INPUT_HEADER_BYTES 6
+#define HASH_BYTES 6
+
+LockstepStats lockstepStats;
+
+// --- Session State ---
+static UdpSocket lockstepSocket;
+static NetAddress peerAddress;
+static int active = 0;
+static int peerLeft = 0;
+static int localPlayer = 0;            // Host 0, joining peer 1
+static TrackType raceTrack = TRACK_RECT;
+static int inputDelay = LOCKSTEP_DEFAULT_DELAY;
+static double lastHeardTime = 0.0;     // getTimeSeconds() of the peer's last packet
+static int callsSinceSend = 0;
+
+static long nextTick = 0;              // Lockstep tick simulated next (0 = start of the race)
+static unsigned char localControls = 0; // Current keyboard / autopilot state (CarControl bits)
+static unsigned char localInputs[LOCKSTEP_HISTORY]; // Controls per tick, indexed tick & HISTORY_MASK
+static long localQueued = 0;           // Own controls exist for ticks [0, localQueued)
+static long peerAcked = 0;             // The peer has all our controls before this tick
+static unsigned char remoteInputs[LOCKSTEP_HISTORY];
+static long remoteSlotTicks[LOCKSTEP_HISTORY]; // Tick held by each remoteInputs slot, -1 = none
+static long remoteReceived = 0;        // The peer's controls for every tick before this one are here
+
+// State hashes at checkpoints (ticks that are multiples of LOCKSTEP_HASH_INTERVAL)
+static unsigned int localHashes[HASH_SLOTS], remoteHashes[HASH_SLOTS];
+static long localHashTicks[HASH_SLOTS], remoteHashTicks[HASH_SLOTS];
+static long lastCheckpoint = -1;       // Newest local checkpoint, repeated in packets for a while
+
+
+// The full tick closest to 'reference' whose low 16 bits are 'low'
+static long expandTick(unsigned int low, long reference) {
+    long tick = (reference & ~0xFFFFL) | (long)low;
+    if (tick < reference - 32768) tick += 65536;
+    else if (tick > reference + 32768) tick -= 65536;
+    return tick;
+}
+
+static int isPeer(const NetAddress* from) {
+    return from->host == peerAddress.host && from->port == peerAddress.port;
+}
+
+static void sendSimple(int type) {
+    unsigned char packet[1] = { (unsigned char)type };
+    if (sendDatagram(&lockstepSocket, &peerAddress, packet, 1)) {
+        lockstepStats.packetsSent++;
+        lockstepStats.payloadBytesSent += 1;
+    }
+}
+
+static void sendStart(void) {
+    unsigned char packet[4] = { PACKET_START, LOCKSTEP_PROTOCOL_VERSION, (unsigned char)raceTrack, (unsigned char)inputDelay };
+    sendDatagram(&lockstepSocket, &peerAddress, packet, sizeof(packet));
+}
+
+
+// --- Controls ---
+void setLocalControl(CarControl control, int state) {
+    if ((int)control < 0 || (int)control >= NUM_CAR_CONTROLS) return;
+    if (state) localControls |= (unsigned char)(1 << control);
+    else localControls &= (unsigned char)~(1 << control);
+    // As setCarControl(): accelerating and braking exclude each other, the later press wins
+    if (state && control == CAR_CONTROL_ACCELERATE) localControls &= (unsigned char)~(1 << CAR_CONTROL_BRAKE);
+    if (state && control == CAR_CONTROL_BRAKE) localControls &= (unsigned char)~(1 << CAR_CONTROL_ACCELERATE);
+}
+
+void setLocalControlsFromCar(const Car* car) {
+    localControls = getCarControlBits(car);
+}
+
+
+// --- State Hash ---
+static unsigned int hashBytes(unsigned int hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u; // FNV prime
+    }
+    return hash;
+}
+
+// Everything the simulation carries from tick to tick. Lap timers are hashed by their
+// durations: the absolute tick a race started at differs between the peers.
+unsigned int hashRaceState(void) {
+    unsigned int hash = 2166136261u; // FNV offset basis
+    for (int p = 0; p < numPlayers; ++p) {
+        const Car* car = &playerCars[p];
+        const float pose[7] = { car->x, car->y, car->z, car->angle, car->speed, car->prev_x, car->prev_z };
+        const int flags[7] = { car->accelerating, car->braking, car->turning_left, car->turning_right,
+                               car->collisions, car->hitWall, car->ticksOffWall };
+        const LapTimer* timer = &playerLapTimers[p];
+        const int lap[5] = { timer->currentLapTimeMs, timer->lastLapTimeMs, timer->bestLapTimeMs,
+                             timer->crossedFinishLineMovingForwardState, timer->lapsCompleted };
+        hash = hashBytes(hash, pose, sizeof(pose));
+        hash = hashBytes(hash, flags, sizeof(flags));
+        hash = hashBytes(hash, car->wheelSurface, sizeof(car->wheelSurface));
+        hash = hashBytes(hash, lap, sizeof(lap));
+    }
+    return hash;
+}
+
+// Compares a checkpoint once both sides' hashes for it are known
+static void compareHashes(int slot) {
+    if (localHashTicks[slot] < 0 || localHashTicks[slot] != remoteHashTicks[slot]) return;
+    lockstepStats.hashesCompared++;
+    if (localHashes[slot] != remoteHashes[slot] && lockstepStats.desyncTick < 0) {
+        lockstepStats.desyncTick = localHashTicks[slot];
+        fprintf(stderr, "Lockstep: DESYNC at tick %ld (this peer %08x, other peer %08x)\n",
+                localHashTicks[slot], localHashes[slot], remoteHashes[slot]);
+    }
+    localHashTicks[slot] = -1; // Compared once (the peer repeats its hash in several packets)
+}
+
+
+// --- Receiving ---
+static void receiveInputPacket(const unsigned char* packet, int length) {
+    if (length < INPUT_HEADER_BYTES) return;
+    int count = packet[5];
+    int hasHash = (packet[0] & LOCKSTEP_HAS_HASH) != 0;
+    if (length != INPUT_HEADER_BYTES + (count + 1) / 2 + (hasHash ? HASH_BYTES : 0)) return; // Malformed
+
+    long ack = expandTick(getU16(packet + 1), localQueued);
+    if (ack > peerAcked && ack <= localQueued) peerAcked = ack;
+
+    long first = expandTick(getU16(packet + 3), remoteReceived);
+    for (int i = 0; i < count; ++i) {
+        long tick = first + i;
+        if (tick < remoteReceived || tick >= nextTick + LOCKSTEP_HISTORY) continue; // Old repeat, or no room yet
+        unsigned char nibble = packet[INPUT_HEADER_BYTES + i / 2];
+        remoteInputs[tick & HISTORY_MASK] = (unsigned char)((i % 2 == 0 ? nibble : nibble >> 4) & 0x0F);
+        remoteSlotTicks[tick & HISTORY_MASK] = tick;
+    }
+    while (remoteSlotTicks[remoteReceived & HISTORY_MASK] == remoteReceived) remoteReceived++;
+
+    if (hasHash) {
+        const unsigned char* hashField = packet + INPUT_HEADER_BYTES + (count + 1) / 2;
+        long hashTick = expandTick(getU16(hashField), nextTick);
+        int slot = (int)((hashTick / LOCKSTEP_HASH_INTERVAL) % HASH_SLOTS);
+        if (hashTick >= 0 && hashTick % LOCKSTEP_HASH_INTERVAL == 0 && remoteHashTicks[slot] != hashTick) {
+            remoteHashTicks[slot] = hashTick;
+            remoteHashes[slot] = getU32(hashField + 2);
+            compareHashes(slot);
+        }
+    }
+}
+
+static void pollPackets(void) {
+    unsigned char packet[NET_MAX_DATAGRAM];
+    NetAddress from;
+    int length;
+    while ((length = receiveDatagram(&lockstepSocket, &from, packet, sizeof(packet))) >= 0) {
+        if (length < 1 || !isPeer(&from)) continue; // Strangers are ignored
+        lockstepStats.packetsReceived++;
+        lastHeardTime = getTimeSeconds();
+        switch (packet[0] & PACKET_TYPE_MASK) {
+            case PACKET_HELLO: if (localPlayer == 0) sendStart(); break; // Our START was lost
+            case PACKET_INPUT: receiveInputPacket(packet, length); break;
+            case PACKET_BYE:   peerLeft = 1; break;
+            default: break;
+        }
+    }
+}
+
+
+// --- Sending ---
+// Our controls the peer hasn't acknowledged (the newest LOCKSTEP_MAX_REDUNDANT of them), our
+// receive position as the ack, and the newest checkpoint hash for half an interval after it.
+static void sendInputPacket(void) {
+    unsigned char packet[INPUT_HEADER_BYTES + LOCKSTEP_MAX_REDUNDANT / 2 + HASH_BYTES];
+    long first = peerAcked;
+    if (first < localQueued - LOCKSTEP_MAX_REDUNDANT) first = localQueued - LOCKSTEP_MAX_REDUNDANT;
+    int count = (int)(localQueued - first);
+    int hasHash = lastCheckpoint >= 0 && nextTick - lastCheckpoint < LOCKSTEP_HASH_INTERVAL / 2;
+
+    packet[0] = (unsigned char)(PACKET_INPUT | (hasHash ? LOCKSTEP_HAS_HASH : 0));
+    putU16(packet + 1, (unsigned int)(remoteReceived & 0xFFFF));
+    putU16(packet + 3, (unsigned int)(first & 0xFFFF));
+    packet[5] = (unsigned char)count;
+    int length = INPUT_HEADER_BYTES;
+    for (int i = 0; i < count; i += 2) {
+        unsigned char low = localInputs[(first + i) & HISTORY_MASK];
+        unsigned char high = i + 1 < count ? localInputs[(first + i + 1) & HISTORY_MASK] : 0;
+        packet[length++] = (unsigned char)(low | (high << 4));
+    }
+    if (hasHash) {
+        int slot = (int)((lastCheckpoint / LOCKSTEP_HASH_INTERVAL) % HASH_SLOTS);
+        putU16(packet + length, (unsigned int)(lastCheckpoint & 0xFFFF));
+        putU32(packet + length + 2, localHashes[slot]);
+        length += HASH_BYTES;
+    }
+    if (sendDatagram(&lockstepSocket, &peerAddress, packet, length)) {
+        lockstepStats.packetsSent++;
+        lockstepStats.payloadBytesSent += length;
+    }
+}
+
+// Receives, and sends every LOCKSTEP_SEND_INTERVAL calls (stalled or not, so acks keep flowing)
+static void serviceSocket(void) {
+    pollPackets();
+    if (++callsSinceSend >= LOCKSTEP_SEND_INTERVAL) {
+        sendInputPacket();
+        callsSinceSend = 0;
+    }
+}
+
+
+// --- Session Set-up ---
+static void beginRace(int player, TrackType track, int delay) {
+    localPlayer = player;
+    raceTrack = track;
+    inputDelay = delay;
+    nextTick = 0;
+    localControls = 0;
+    // Ticks before the input delay has passed run without controls on both peers
+    for (int i = 0; i < LOCKSTEP_HISTORY; ++i) {
+        localInputs[i] = remoteInputs[i] = 0;
+        remoteSlotTicks[i] = -1;
+    }
+    localQueued = peerAcked = remoteReceived = delay;
+    for (int i = 0; i < HASH_SLOTS; ++i) localHashTicks[i] = remoteHashTicks[i] = -1;
+    lastCheckpoint = -1;
+    memset(&lockstepStats, 0, sizeof(lockstepStats));
+    lockstepStats.desyncTick = -1;
+    lockstepStats.startTime = lastHeardTime = getTimeSeconds();
+    callsSinceSend = 0;
+    peerLeft = 0;
+    active = 1;
+    numPlayers = 2; // One car per peer; each screen shows its own car's view
+    char peerText[32];
+    formatNetAddress(&peerAddress, peerText, sizeof(peerText));
+    printf("Lockstep: racing with %s as player %d, track %d, input delay %d ticks\n",
+           peerText, player + 1, (int)track, delay);
+}
+
+static int openSession(int port, const NetConditions* conditions) {
+    if (!initNetwork()) return 0;
+    if (!openUdpSocket(&lockstepSocket, port)) { shutdownNetwork(); return 0; }
+    if (conditions) setNetConditions(&lockstepSocket, conditions, (unsigned int)port * 2654435761u + 1u);
+    return 1;
+}
+
+int hostLockstep(int port, TrackType track, int delay, const NetConditions* conditions) {
+    if (delay < 1 || delay > LOCKSTEP_MAX_DELAY) {
+        fprintf(stderr, "Lockstep: input delay must be 1 to %d ticks\n", LOCKSTEP_MAX_DELAY);
+        return 0;
+    }
+    if (!openSession(port, conditions)) return 0;
+    printf("Lockstep: waiting for a peer on UDP port %d...\n", port);
+    double start = getTimeSeconds();
+    unsigned char packet[NET_MAX_DATAGRAM];
+    while (getTimeSeconds() - start < HANDSHAKE_TIMEOUT_SECONDS) {
+        NetAddress from;
+        int length = receiveDatagram(&lockstepSocket, &from, packet, sizeof(packet));
+        if (length < 0) { sleepSeconds(0.01); continue; }
+        if (length != 2 || packet[0] != PACKET_HELLO) continue;
+        peerAddress = from;
+        if (packet[1] != LOCKSTEP_PROTOCOL_VERSION) {
+            fprintf(stderr, "Lockstep: peer speaks protocol %d, this build %d\n", packet[1], LOCKSTEP_PROTOCOL_VERSION);
+            continue;
+        }
+        raceTrack = track;
+        inputDelay = delay;
+        sendStart();
+        beginRace(0, track, delay);
+        return 1;
+    }
+    fprintf(stderr, "Lockstep: no peer joined within %.0f s\n", HANDSHAKE_TIMEOUT_SECONDS);
+    closeUdpSocket(&lockstepSocket);
+    shutdownNetwork();
+    return 0;
+}
+
+int joinLockstep(const char* address, const NetConditions* conditions) {
+    if (!openSession(0, conditions)) return 0;
+    if (!parseNetAddress(address, LOCKSTEP_DEFAULT_PORT, &peerAddress)) {
+        fprintf(stderr, "Lockstep: can't resolve '%s'\n", address);
+        closeUdpSocket(&lockstepSocket);
+        shutdownNetwork();
+        return 0;
+    }
+    printf("Lockstep: joining %s...\n", address);
+    double start = getTimeSeconds(), lastHello = -1.0;
+    unsigned char packet[NET_MAX_DATAGRAM];
+    while (getTimeSeconds() - start < HANDSHAKE_TIMEOUT_SECONDS) {
+        if (getTimeSeconds() - lastHello >= HANDSHAKE_RETRY_SECONDS) { // HELLOs can be lost too
+            unsigned char hello[2] = { PACKET_HELLO, LOCKSTEP_PROTOCOL_VERSION };
+            sendDatagram(&lockstepSocket, &peerAddress, hello, sizeof(hello));
+            lastHello = getTimeSeconds();
+        }
+        NetAddress from;
+        int length = receiveDatagram(&lockstepSocket, &from, packet, sizeof(packet));
+        if (length < 0) { sleepSeconds(0.01); continue; }
+        if (length != 4 || packet[0] != PACKET_START || !isPeer(&from)) continue;
+        if (packet[1] != LOCKSTEP_PROTOCOL_VERSION || packet[2] >= NUM_TRACK_OPTIONS ||
+            packet[3] < 1 || packet[3] > LOCKSTEP_MAX_DELAY) {
+            fprintf(stderr, "Lockstep: host sent an incompatible START\n");
+            break;
+        }
+        beginRace(1, (TrackType)packet[2], packet[3]);
+        return 1;
+    }
+    fprintf(stderr, "Lockstep: no answer from %s\n", address);
+    closeUdpSocket(&lockstepSocket);
+    shutdownNetwork();
+    return 0;
+}
+
+int isLockstepActive(void) { return active; }
+int getLockstepPlayer(void) { return localPlayer; }
+TrackType getLockstepTrack(void) { return raceTrack; }
+
+
+// --- One Tick ---
+LockstepStatus stepLockstep(void) {
+    if (!active) return LOCKSTEP_ENDED;
+    // This tick's own controls take effect inputDelay ticks from now (sampled once per tick)
+    if (localQueued == nextTick + inputDelay) {
+        localInputs[localQueued & HISTORY_MASK] = localControls;
+        localQueued++;
+    }
+    serviceSocket();
+    if (lockstepStats.desyncTick >= 0) return LOCKSTEP_ENDED;
+    if (remoteReceived <= nextTick) { // The peer's controls for this tick haven't arrived
+        if (peerLeft) {
+            printf("Lockstep: the other peer left the race\n");
+            return LOCKSTEP_ENDED;
+        }
+        if (getTimeSeconds() - lastHeardTime > LOCKSTEP_TIMEOUT_SECONDS) {
+            fprintf(stderr, "Lockstep: nothing heard from the other peer for %.0f s\n", LOCKSTEP_TIMEOUT_SECONDS);
+            return LOCKSTEP_ENDED;
+        }
+        lockstepStats.waits++;
+        return LOCKSTEP_WAITING;
+    }
+
+    for (int p = 0; p < numPlayers; ++p) {
+        int slot = (int)(nextTick & HISTORY_MASK);
+        setCarControlBits(&playerCars[p], p == localPlayer ? localInputs[slot] : remoteInputs[slot]);
+    }
+    stepGame();
+    nextTick++;
+    lockstepStats.ticks++;
+
+    if (nextTick % LOCKSTEP_HASH_INTERVAL == 0) {
+        int slot = (int)((nextTick / LOCKSTEP_HASH_INTERVAL) % HASH_SLOTS);
+        localHashes[slot] = hashRaceState();
+        localHashTicks[slot] = nextTick;
+        lastCheckpoint = nextTick;
+        compareHashes(slot);
+        if (lockstepStats.desyncTick >= 0) return LOCKSTEP_ENDED;
+    }
+    return LOCKSTEP_STEPPED;
+}
+
+void stopLockstep(void) {
+    if (!active) return;
+    for (int i = 0; i < 3; ++i) sendSimple(PACKET_BYE); // Unacknowledged: sent a few times against loss
+    sleepSeconds(0.001 * lockstepSocket.conditions.latencyMs + 0.001 * lockstepSocket.conditions.jitterMs + 0.05);
+    pollPackets(); // Lets the simulator release what it still holds
+    closeUdpSocket(&lockstepSocket);
+    shutdownNetwork();
+    active = 0;
+}
+
+void printLockstepStats(void) {
+    double seconds = getTimeSeconds() - lockstepStats.startTime;
+    if (seconds <= 0.0) seconds = 1.0;
+    long packets = lockstepStats.packetsSent;
+    printf("Lockstep: %ld ticks in %.1f s, %ld waits for the peer, %ld packets sent / %ld received "
+           "(%ld dropped by the simulator)\n", lockstepStats.ticks, seconds, lockstepStats.waits, packets,
+           lockstepStats.packetsReceived, lockstepSocket.simulatedDrops);
+    printf("  upload: %.1f bytes/packet, %.0f bytes/s payload, %.0f bytes/s with UDP/IP headers\n",
+           packets ? (double)lockstepStats.payloadBytesSent / packets : 0.0, lockstepStats.payloadBytesSent / seconds,
+           (lockstepStats.payloadBytesSent + (double)packets * NET_UDP_IP_OVERHEAD) / seconds);
+    printf("  %ld state hashes compared, %s\n", lockstepStats.hashesCompared,
+           lockstepStats.desyncTick < 0 ? "in sync" : "DESYNC");
+}
+
+
+// --- Headless Test Race ---
+// Options: host[=port] | join=<host[:port]>, track=rect|round (host), ticks=N, delay=N (host),
+// loss=<percent> latency=<ms> jitter=<ms> (this peer's outgoing packets), desync=<tick> (nudges
+// this peer's car on that tick, to check that the divergence is detected).
+int runLockstepFromArgs(int argc, char** argv) {
+    int host = 0, port = LOCKSTEP_DEFAULT_PORT, delay = LOCKSTEP_DEFAULT_DELAY;
+    long ticks = 30 * FRAME_RATE, desyncAt = -1;
+    const char* joinAddress = NULL;
+    TrackType track = TRACK_RECT;
+    NetConditions conditions = { 0.0f, 0, 0 };
+    for (int i = 0; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "host") == 0) host = 1;
+        else if (strncmp(arg, "host=", 5) == 0) { host = 1; port = atoi(arg + 5); }
+        else if (strncmp(arg, "join=", 5) == 0) joinAddress = arg + 5;
+        else if (strncmp(arg, "track=", 6) == 0) {
+            if (strcmp(arg + 6, "rect") == 0) track = TRACK_RECT;
+            else if (strcmp(arg + 6, "round") == 0) track = TRACK_ROUNDED;
+            else { fprintf(stderr, "Lockstep: unknown track '%s' (rect|round)\n", arg + 6); return 1; }
+        }
+        else if (strncmp(arg, "ticks=", 6) == 0) ticks = atol(arg + 6);
+        else if (strncmp(arg, "delay=", 6) == 0) delay = atoi(arg + 6);
+        else if (strncmp(arg, "loss=", 5) == 0) conditions.lossPercent = (float)atof(arg + 5);
+        else if (strncmp(arg, "latency=", 8) == 0) conditions.latencyMs = atoi(arg + 8);
+        else if (strncmp(arg, "jitter=", 7) == 0) conditions.jitterMs = atoi(arg + 7);
+        else if (strncmp(arg, "desync=", 7) == 0) desyncAt = atol(arg + 7);
+        else { fprintf(stderr, "Lockstep: unknown option '%s'\n", arg); return 1; }
+    }
+    if (host == (joinAddress != NULL)) { fprintf(stderr, "Lockstep: give either host[=port] or join=<address>\n"); return 1; }
+    if (host ? !hostLockstep(port, track, delay, &conditions) : !joinLockstep(joinAddress, &conditions)) return 1;
+
+    selectedTrackType = getLockstepTrack();
+    initGame();
+    currentGameState = STATE_RACING;
+    Car* ownCar = &playerCars[localPlayer];
+    LockstepStatus status = LOCKSTEP_WAITING;
+    double nextTickTime = getTimeSeconds();
+    while (nextTick < ticks) {
+        updateAIControls(ownCar); // Reads the car as it is now; the controls go out through the delay
+        setLocalControlsFromCar(ownCar);
+        if (nextTick == desyncAt) ownCar->x += 0.001f; // Invisible, but the hashes will differ
+        status = stepLockstep();
+        if (status == LOCKSTEP_ENDED) break;
+        if (status == LOCKSTEP_STEPPED && nextTick % (10 * FRAME_RATE) == 0) {
+            printf("Lockstep: tick %ld, state %08x, %ld waits so far\n", nextTick, hashRaceState(), lockstepStats.waits);
+        }
+        // Real-time pacing, as the windowed game's timer (falling far behind resets the schedule)
+        nextTickTime += FRAME_TIME_SEC;
+        double now = getTimeSeconds();
+        if (now - nextTickTime > 0.25) nextTickTime = now;
+        sleepSeconds(nextTickTime - now);
+    }
+
+    // Keep answering until the peer has acknowledged all our controls, so it can finish too
+    double lingerStart = getTimeSeconds();
+    while (status != LOCKSTEP_ENDED && peerAcked < localQueued && !peerLeft &&
+           getTimeSeconds() - lingerStart < LINGER_SECONDS) {
+        serviceSocket();
+        sleepSeconds(FRAME_TIME_SEC);
+    }
+    int ok = nextTick >= ticks && lockstepStats.desyncTick < 0;
+    printf("Lockstep: finished at tick %ld, state %08x\n", nextTick, hashRaceState());
+    printLockstepStats();
+    stopLockstep();
+    return ok ? 0 : 1;
+}
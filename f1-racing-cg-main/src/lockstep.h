@@ -0,0 +1,70 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include "game.h" // TrackType, CarControl (via car.h)
+#include "net.h"  // NetConditions
+
+// --- Lockstep Online Races ---
+// Two peers run the same deterministic simulation and exchange nothing but each tick's
+// controls (4 bits per tick). Controls sampled on tick t are applied on tick t + input delay,
+// which gives them that long to reach the other peer; a tick only runs once both players'
+// controls for it are known, so a late packet stalls the race instead of letting it diverge.
+//
+// Every packet repeats all of the sender's controls the peer hasn't acknowledged yet, so a
+// lost packet is covered by the next one without any resend logic. Packets go out every
+// LOCKSTEP_SEND_INTERVAL ticks (20 per second); with the repeats, acks and the occasional state
+// hash they average under 16 bytes of payload, about 900 bytes per second per player including
+// UDP/IP headers. Every LOCKSTEP_HASH_INTERVAL ticks both peers hash the cars and lap timers and
+// exchange the hash: a mismatch means the simulations diverged (desync), and the race ends.
+//
+// The simulation is only deterministic between identical builds (same compiler and maths
+// library); the handshake doesn't check this.
+
+#define LOCKSTEP_DEFAULT_PORT 27015
+#define LOCKSTEP_DEFAULT_DELAY 4       // Ticks of input delay (67 ms), enough for a LAN
+#define LOCKSTEP_MAX_DELAY 30
+#define LOCKSTEP_SEND_INTERVAL 3       // Ticks between packets
+#define LOCKSTEP_HISTORY 256           // Ticks of controls and hashes kept (power of two)
+#define LOCKSTEP_MAX_REDUNDANT 64      // Unacknowledged controls repeated per packet, at most
+#define LOCKSTEP_HASH_INTERVAL 30      // Ticks between state hashes
+#define LOCKSTEP_TIMEOUT_SECONDS 10.0  // Silence from the peer before the race is abandoned
+#define LOCKSTEP_PROTOCOL_VERSION 1
+
+// --- Step Result ---
+typedef enum {
+    LOCKSTEP_WAITING, // The peer's controls for the next tick haven't arrived: nothing simulated
+    LOCKSTEP_STEPPED, // One tick simulated (stepGame)
+    LOCKSTEP_ENDED    // Peer left or timed out, or a desync was detected
+} LockstepStatus;
+
+// --- Statistics ---
+typedef struct {
+    long ticks;             // Ticks simulated in lockstep
+    long waits;             // stepLockstep() calls that had to wait for the peer
+    long packetsSent, packetsReceived;
+    long payloadBytesSent;  // UDP payload only (add NET_UDP_IP_OVERHEAD per packet for the wire)
+    long hashesCompared;
+    long desyncTick;        // First tick whose hashes differed, -1 = none
+    double startTime;       // getTimeSeconds() when the race started
+} LockstepStats;
+
+extern LockstepStats lockstepStats;
+
+// --- Function Declarations ---
+// Both block until the handshake is done (or time out). The host decides track and input delay.
+int hostLockstep(int port, TrackType track, int inputDelay, const NetConditions* conditions);
+int joinLockstep(const char* address, const NetConditions* conditions); // "host[:port]"
+int isLockstepActive(void);
+int getLockstepPlayer(void);            // This peer's car index (host 0, joining peer 1)
+TrackType getLockstepTrack(void);       // As sent by the host
+void setLocalControl(CarControl control, int state); // Keyboard state of this peer's car
+void setLocalControlsFromCar(const Car* car);        // Autopilot: take the controls it set on the car
+LockstepStatus stepLockstep(void);      // Call once per fixed tick; also sends and receives
+void stopLockstep(void);                // Tells the peer and closes the socket
+void printLockstepStats(void);
+unsigned int hashRaceState(void);       // Cars and lap timers of all players (FNV-1a)
+
+// Headless test race with the autopilot driving this peer's car (see README). Exit code.
+int runLockstepFromArgs(int argc, char** argv);
+
+#endif // LOCKSTEP_H
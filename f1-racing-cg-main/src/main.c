@@ -1,11 +1,25 @@
 #include <stdio.h>       // Standard Input/Output functions (printf)
+#include <string.h>      // For strcmp (command line modes)
 #include <GL/glew.h>     // OpenGL Extension Wrangler Library (must be included before freeglut)
 #include <GL/freeglut.h> // FreeGLUT library for windowing, input, and basic shapes
 
 #include "game.h"       // Includes GameState, TrackType, global variables, core functions
-// Include BOTH track headers for rendering functions
-#include "track_rect.h"
-#include "track_round.h"
+#include "sweep.h"      // Headless parameter sweep mode
+#include "offscreen.h"  // Headless render benchmark
+#include "benchmark.h"  // Scripted rendering benchmark mode
+#include "input_script.h" // Session recording
+#include "renderer.h"   // Shader / fixed-function render path selection
+#include "dynres.h"     // Dynamic resolution for the 3D scene
+#include "capture.h"    // --capture: asynchronous frame recording
+#include "minimap.h"    // HUD minimap texture
+#include "scenery.h"    // --scenery: trackside object count
+#include "skidmarks.h"  // Released at exit
+#include "particles.h"
+#include "lockstep.h"   // --host / --join: online races, --lockstep: headless test race
+#include "netclient.h"  // --connect / --spectate: races on a dedicated server, --netclient: headless client
+#include "telemetry.h"  // --telemetry <file>: per-tick car channels, --telemetry-drive: headless log
+#include "heatmap.h"    // --heatmap <file>: driving heatmap overlay
+#include <stdlib.h>      // For atoi
 // car.h is included via game.h
 
 // --- Function Prototypes for GLUT Callbacks ---
@@ -14,11 +28,114 @@ void reshape(int width, int height);     // Window resize handler
 void keyboardDown(unsigned char key, int x, int y); // Regular key press handler
 void keyboardUp(unsigned char key, int x, int y);   // Regular key release handler
 void specialKeyDown(int key, int x, int y); // Special key press handler (arrows, etc.)
-// void specialKeyUp(int key, int x, int y); // Optional: Special key release handler (not needed currently)
+void specialKeyUp(int key, int x, int y);   // Special key release handler (player 2's arrows)
+void windowStatus(int state);            // Minimised / hidden / covered changes
 void cleanup();                          // Function called when the GLUT window is closed
 
+// --- Command Line Modes ---
+static int benchMode = 0;                // --bench: play a script / autopilot and print timings
+static const char* recordPath = NULL;    // --record <file>: save the last race's key events on exit
+static InputScript recording;            // Every key event of this session (absolute ticks)
+static RenderPath requestedRenderPath = RENDER_PATH_SHADER; // --fixed-function forces the legacy path
+static int fixedResolution = 0;          // --fixed-resolution: always render at window size
+static const char* capturePath = NULL;   // --capture <file.yuv|prefix>: record the race frames
+static int hostPort = 0;                 // --host <port>: wait for a peer, then race online
+static const char* joinAddress = NULL;   // --join <host[:port]>: race online against a host
+static const char* serverAddress = NULL; // --connect / --spectate <host[:port]>: dedicated server
+static int spectateServer = 0;           // --spectate: watch instead of driving
+
 // --- Main Application Entry Point ---
 int main(int argc, char** argv) {
+    // 0. Headless Modes (no window, no GL context)
+    if (argc > 1 && strcmp(argv[1], "--sweep") == 0) {
+        return runSweepFromArgs(argc - 2, argv + 2); // Physics parameter sweep (see sweep.h)
+    }
+    if (argc > 1 && strcmp(argv[1], "--offscreen") == 0) {
+        return runOffscreenFromArgs(argc - 2, argv + 2); // Render benchmark without a window (see offscreen.h)
+    }
+    if (argc > 1 && strcmp(argv[1], "--lockstep") == 0) {
+        return runLockstepFromArgs(argc - 2, argv + 2); // Online race with the autopilot (see lockstep.h)
+    }
+    if (argc > 1 && strcmp(argv[1], "--telemetry-drive") == 0) {
+        return runTelemetryDriveFromArgs(argc - 2, argv + 2); // Autopilot log for tools/tlquery (see telemetry.h)
+    }
+    if (argc > 1 && strcmp(argv[1], "--netclient") == 0) {
+        return runNetClientFromArgs(argc - 2, argv + 2); // Dedicated server client with the autopilot (see netclient.h)
+    }
+
+    // 0b. Windowed Modes (parsed before glutInit so GLUT doesn't see our options)
+    // --fixed-function, --fixed-resolution, --background, --capture, --telemetry, --heatmap, --scenery, --players and the online
+    // options may appear anywhere and combine with the modes below
+    TrackType onlineTrack = TRACK_RECT;      // --track: the host picks the track
+    int serverTrackWish = PROTOCOL_ANY_TRACK; // --track on a dedicated server: a wish, not a choice
+    int inputDelay = LOCKSTEP_DEFAULT_DELAY; // --delay: ticks, the host's setting is used
+    NetConditions netConditions = { 0.0f, 0, 0 }; // --netsim <loss %>:<latency ms>:<jitter ms>
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--fixed-function") == 0) {
+            requestedRenderPath = RENDER_PATH_FIXED;
+        } else if (strcmp(argv[i], "--fixed-resolution") == 0) {
+            fixedResolution = 1;
+        } else if (strcmp(argv[i], "--background") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            if (strcmp(mode, "pause") == 0) backgroundMode = BACKGROUND_PAUSE;
+            else if (strcmp(mode, "run") == 0) backgroundMode = BACKGROUND_RUN;
+            else { fprintf(stderr, "Unknown background mode '%s' (pause|run)\n", mode); return 1; }
+        } else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            setRaceTelemetryPath(argv[++i]); // Opened when a race starts
+        } else if (strcmp(argv[i], "--heatmap") == 0 && i + 1 < argc) {
+            setHeatmapOverlayPath(argv[++i]); // From "--sweep heatmap=PREFIX": PREFIX.f1h
+        } else if (strcmp(argv[i], "--scenery") == 0 && i + 1 < argc) {
+            sceneryObjectCount = atoi(argv[++i]); // Objects around the track (0 = none)
+        } else if (strcmp(argv[i], "--players") == 0 && i + 1 < argc) {
+            numPlayers = atoi(argv[++i]); // Split-screen, also selectable in the menu
+            if (numPlayers < 1 || numPlayers > MAX_PLAYERS) {
+                fprintf(stderr, "--players must be 1 to %d\n", MAX_PLAYERS);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            hostPort = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--join") == 0 && i + 1 < argc) {
+            joinAddress = argv[++i];
+        } else if ((strcmp(argv[i], "--connect") == 0 || strcmp(argv[i], "--spectate") == 0) && i + 1 < argc) {
+            spectateServer = strcmp(argv[i], "--spectate") == 0;
+            serverAddress = argv[++i];
+        } else if (strcmp(argv[i], "--track") == 0 && i + 1 < argc) {
+            const char* track = argv[++i];
+            if (strcmp(track, "rect") == 0) onlineTrack = TRACK_RECT;
+            else if (strcmp(track, "round") == 0) onlineTrack = TRACK_ROUNDED;
+            else { fprintf(stderr, "Unknown track '%s' (rect|round)\n", track); return 1; }
+            serverTrackWish = (int)onlineTrack;
+        } else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc) {
+            inputDelay = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--netsim") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%f:%d:%d", &netConditions.lossPercent, &netConditions.latencyMs, &netConditions.jitterMs) < 1) {
+                fprintf(stderr, "--netsim expects <loss %%>:<latency ms>:<jitter ms>\n");
+                return 1;
+            }
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    BenchConfig benchConfig;
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        if (!parseBenchArgs(argc - 2, argv + 2, &benchConfig)) return 1;
+        benchMode = 1;
+        argc = 1;
+    } else if (argc > 2 && strcmp(argv[1], "--record") == 0) {
+        recordPath = argv[2];
+        initInputScript(&recording);
+        argc = 1;
+    }
+
+    // 0c. Online Races: meet the other peer before opening the window (blocks until then)
+    if (hostPort > 0 && !hostLockstep(hostPort, onlineTrack, inputDelay, &netConditions)) return 1;
+    if (joinAddress && !joinLockstep(joinAddress, &netConditions)) return 1;
+    if (serverAddress && !connectServer(serverAddress, serverTrackWish, spectateServer, &netConditions)) return 1;
+
     // 1. Initialize GLUT
     glutInit(&argc, argv); // Initialize the GLUT library
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH); // Double buffered, RGB color, Depth buffer
@@ -37,11 +154,10 @@ int main(int argc, char** argv) {
 
 
     // 3. Basic OpenGL Setup
-    glEnable(GL_DEPTH_TEST); // Enable depth testing
-    glDepthFunc(GL_LEQUAL);  // Pixels with equal or lesser depth pass
-    glClearColor(0.1f, 0.3f, 0.7f, 1.0f); // Background clear color (sky blue)
-    glEnable(GL_CULL_FACE); // Enable face culling
-    glCullFace(GL_BACK);    // Cull back-facing polygons
+    initRenderState(); // Depth test, clear color, face culling (game.c)
+    selectRenderPath(requestedRenderPath); // GLSL pipeline if OpenGL 3.3 is available (renderer.h)
+    if (!fixedResolution) initDynamicResolution(DYNRES_DEFAULT_TARGET_MS); // Scene scale follows frame time
+    if (capturePath && !startCapture(capturePath)) return 1; // Writer thread for recorded frames (capture.h)
 
 
     // 4. Initial Game State Setup
@@ -55,29 +171,56 @@ int main(int argc, char** argv) {
     glutKeyboardFunc(keyboardDown);     // Regular key press handler
     glutKeyboardUpFunc(keyboardUp);       // Regular key release handler
     glutSpecialFunc(specialKeyDown);    // Special key press handler
+    glutSpecialUpFunc(specialKeyUp);    // Special key release handler
     glutCloseFunc(cleanup);             // Window close handler
+    glutWindowStatusFunc(windowStatus); // Pause while minimised or covered
+    // Return from glutMainLoop() on exit so recordings can be saved and benchmarks report a status.
+    glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
 
 
-    // 6. Register the Fixed-Update Timer
-    glutTimerFunc(FRAME_TIME_MS, updateGame, 0);
+    // 6. Enable the Fixed-Update Timer (the benchmark drives ticks from the idle loop instead).
+    // It only runs during a race; the menu redraws on input alone.
+    if (benchMode) {
+        if (!startBenchmark(&benchConfig, display)) return 1;
+        glutMainLoop();
+        return getBenchmarkExitCode();
+    }
+    startUpdateLoop();
+    if (isLockstepActive()) startGame(getLockstepTrack()); // Online races skip the menu
+    if (isNetClientActive()) {
+        numPlayers = 1; // One view, following one of the server's cars
+        startGame(getNetClientTrack());
+    }
 
 
     // 7. Print Controls and Enter GLUT Main Loop
      printf("\n--- CONTROLS ---\n");
      printf(" Menu:\n");
      printf("   UP/DOWN Arrows: Select Track\n");
+     printf("   LEFT/RIGHT Arrows: Number of Players (split-screen)\n");
      printf("   ENTER: Start Race\n");
-     printf(" Racing:\n");
-     printf("   W/S: Accelerate/Brake\n");
-     printf("   A/D: Turn Left/Right\n");
+     printf(" Racing (accelerate/brake/left/right):\n");
+     printf("   Player 1: W/S/A/D\n");
+     printf("   Player 2: Arrow keys\n");
+     printf("   Player 3: I/K/J/L\n");
+     printf("   Player 4: Keypad 8/5/4/6 (Num Lock on)\n");
      printf("   R: Reset Race\n");
+     printf(" Online (--host / --join): W/S/A/D or the arrow keys\n");
+     printf(" Dedicated server (--connect): the same; --spectate: LEFT/RIGHT switch cars\n");
      printf(" General:\n");
      printf("   ESC: Return to Menu / Exit\n");
      printf("-----------------\n\n");
 
-    glutMainLoop(); // Start processing events
+    glutMainLoop(); // Start processing events (returns when the window closes or ESC exits)
 
-    return 0; // Should not be reached
+    if (recordPath) {
+        // Keep the most recent race: its key events, timed from the moment it started
+        if (saveInputScript(&recording, recordPath, raceStartTick)) {
+            printf("Recorded input written to %s\n", recordPath);
+        }
+        freeInputScript(&recording);
+    }
+    return 0;
 }
 
 
@@ -85,34 +228,27 @@ int main(int argc, char** argv) {
 
 // Main Drawing Function
 void display() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Clear buffers
+    int racing = (currentGameState == STATE_RACING); // Only race frames drive dynamic resolution
+    if (racing) beginFrameTiming(); // No-op unless dynamic resolution is on
 
     // Render based on the current game state
     if (currentGameState == STATE_MENU) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Clear buffers
         renderMenu(glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT)); // Draw the 2D menu
     } else { // STATE_RACING
-        // --- Render 3D Racing Scene ---
-        glMatrixMode(GL_PROJECTION); glLoadIdentity();
-        gluPerspective(50.0f, (float)glutGet(GLUT_WINDOW_WIDTH) / (float)glutGet(GLUT_WINDOW_HEIGHT), 0.1f, 600.0f); // Set perspective
-        glMatrixMode(GL_MODELVIEW); glLoadIdentity();
-        setupCamera(); // Position the camera
-
-        // Render the appropriate track based on selection
-        if (selectedTrackType == TRACK_RECT) {
-            renderRectTrack();
-            renderRectGuardrails();
-        } else { // TRACK_ROUNDED
-            renderRoundTrack();
-            renderRoundGuardrails();
-        }
-
-        renderCar(&playerCar); // Draw the car
-
-        // --- Render 2D HUD ---
-        renderHUD(glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT)); // Draw timers
+        int windowWidth = glutGet(GLUT_WINDOW_WIDTH), windowHeight = glutGet(GLUT_WINDOW_HEIGHT);
+        // --- Render 3D Racing Scene (possibly at reduced resolution, see dynres.h) ---
+        beginDynamicResolution(windowWidth, windowHeight); // Clears whichever target the scene goes to
+        renderRaceScene(dynRes.renderWidth, dynRes.renderHeight); // Track, guardrails, car
+        endDynamicResolution(windowWidth, windowHeight);
+
+        // --- Render 2D HUD (always at window resolution) ---
+        renderHUD(windowWidth, windowHeight); // Draw timers
+        captureFrame(windowWidth, windowHeight); // Queue a readback if recording (never waits for the writer)
     }
 
     glutSwapBuffers(); // Display the rendered frame
+    if (racing) endFrameTiming(); // Feeds dynamic resolution a frame or two late, never waits for the GPU
 }
 
 
@@ -130,48 +266,61 @@ void reshape(int width, int height) {
 }
 
 
-// Regular Key Press Handler (Delegates based on Game State)
+// Regular Key Press Handler
 void keyboardDown(unsigned char key, int x, int y) {
     (void)x; (void)y; // Mark GLUT mouse coordinates as unused
-
-    // Call the appropriate state-specific handler function (defined in game.c)
-    if (currentGameState == STATE_MENU) {
-        handleMenuKeyPress(key);
-    } else { // STATE_RACING
-        handleRacingKeyPress(key);
-    }
+    advanceMenuClock(); // Menu keys get ticks too (the update timer is stopped there)
+    if (recordPath) recordInputEvent(&recording, simTickCount, 1, 0, key);
+    handleKeyDown(key); // Routed by game state in game.c
 }
 
 
-// Regular Key Release Handler (Only relevant for Racing State)
+// Regular Key Release Handler
 void keyboardUp(unsigned char key, int x, int y) {
     (void)x; (void)y; // Mark unused
-
-    // Pass key release info to car controls only when racing
-    if (currentGameState == STATE_RACING) {
-        // Allow case-insensitivity for releasing movement keys
-        if (key == 'w' || key == 'W' || key == 'a' || key == 'A' || key == 's' || key == 'S' || key == 'd' || key == 'D') {
-             setCarControls(&playerCar, key, 0); // 0 = key up
-        }
-    }
+    advanceMenuClock();
+    if (recordPath) recordInputEvent(&recording, simTickCount, 0, 0, key);
+    handleKeyUp(key);
 }
 
 
-// Special Key Press Handler (Delegates based on Game State)
+// Special Key Press Handler
 void specialKeyDown(int key, int x, int y) {
     (void)x; (void)y; // Mark unused
+    advanceMenuClock();
+    if (recordPath) recordInputEvent(&recording, simTickCount, 1, 1, key);
+    handleSpecialKeyDown(key);
+}
 
-    // Call the appropriate state-specific handler function (defined in game.c)
-    if (currentGameState == STATE_MENU) {
-        handleMenuSpecialKey(key);
-    } else { // STATE_RACING
-        handleRacingSpecialKey(key);
-    }
+
+// Special Key Release Handler
+void specialKeyUp(int key, int x, int y) {
+    (void)x; (void)y; // Mark unused
+    advanceMenuClock();
+    if (recordPath) recordInputEvent(&recording, simTickCount, 0, 1, key);
+    handleSpecialKeyUp(key);
+}
+
+
+// Window Status Handler
+// freeglut reports visibility, not keyboard focus: minimised/hidden and fully covered count as background.
+void windowStatus(int state) {
+    setWindowVisible(state != GLUT_HIDDEN && state != GLUT_FULLY_COVERED);
 }
 
 
 // Cleanup Function
 void cleanup() {
     printf("Exiting application...\n");
-    // Add any resource freeing code here if necessary in the future
+    stopLockstep(); // Tells the other peer, if racing online
+    stopNetClient(); // Tells the server
+    stopRaceTelemetry(); // Writes the last chunk
+    stopCapture(); // Writes the frames still in flight and reports captured / dropped
+    shutdownDynamicResolution();
+    shutdownMinimap();
+    shutdownHeatmapOverlay();
+    freeScenery();
+    freeSkidMarks();
+    freeParticles();
+    shutdownRenderer(); // Programs and buffers (the context is still current here)
 }
\ No newline at end of file
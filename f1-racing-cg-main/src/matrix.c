@@ -0,0 +1,80 @@
+#include "matrix.h" // Prototypes
+#include <math.h>   // For sqrtf, tanf, sinf, cosf
+#include <string.h> // For memcpy
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void mat4Identity(float out[16]) {
+    for (int i = 0; i < 16; ++i) out[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+}
+
+void mat4Multiply(float out[16], const float a[16], const float b[16]) {
+    float r[16];
+    for (int col = 0; col < 4; ++col) {
+        for (int row = 0; row < 4; ++row) {
+            r[col * 4 + row] = a[0 * 4 + row] * b[col * 4 + 0] + a[1 * 4 + row] * b[col * 4 + 1] +
+                               a[2 * 4 + row] * b[col * 4 + 2] + a[3 * 4 + row] * b[col * 4 + 3];
+        }
+    }
+    memcpy(out, r, sizeof(r));
+}
+
+void mat4Perspective(float out[16], float fovyDeg, float aspect, float zNear, float zFar) {
+    float f = 1.0f / tanf(fovyDeg * (float)M_PI / 360.0f); // cot(fovy / 2)
+    for (int i = 0; i < 16; ++i) out[i] = 0.0f;
+    out[0] = f / aspect;
+    out[5] = f;
+    out[10] = (zFar + zNear) / (zNear - zFar);
+    out[11] = -1.0f;
+    out[14] = 2.0f * zFar * zNear / (zNear - zFar);
+}
+
+void mat4Ortho(float out[16], float left, float right, float bottom, float top, float zNear, float zFar) {
+    mat4Identity(out);
+    out[0] = 2.0f / (right - left);
+    out[5] = 2.0f / (top - bottom);
+    out[10] = -2.0f / (zFar - zNear);
+    out[12] = -(right + left) / (right - left);
+    out[13] = -(top + bottom) / (top - bottom);
+    out[14] = -(zFar + zNear) / (zFar - zNear);
+}
+
+void mat4LookAt(float out[16], const float eye[3], const float center[3], const float up[3]) {
+    float f[3] = { center[0] - eye[0], center[1] - eye[1], center[2] - eye[2] };
+    float len = sqrtf(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+    for (int i = 0; i < 3; ++i) f[i] /= len;
+    float s[3] = { f[1] * up[2] - f[2] * up[1], f[2] * up[0] - f[0] * up[2], f[0] * up[1] - f[1] * up[0] }; // f x up
+    len = sqrtf(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+    for (int i = 0; i < 3; ++i) s[i] /= len;
+    float u[3] = { s[1] * f[2] - s[2] * f[1], s[2] * f[0] - s[0] * f[2], s[0] * f[1] - s[1] * f[0] }; // s x f
+
+    mat4Identity(out);
+    for (int i = 0; i < 3; ++i) {
+        out[i * 4 + 0] = s[i];
+        out[i * 4 + 1] = u[i];
+        out[i * 4 + 2] = -f[i];
+    }
+    out[12] = -(s[0] * eye[0] + s[1] * eye[1] + s[2] * eye[2]);
+    out[13] = -(u[0] * eye[0] + u[1] * eye[1] + u[2] * eye[2]);
+    out[14] = f[0] * eye[0] + f[1] * eye[1] + f[2] * eye[2];
+}
+
+void mat4Translate(float m[16], float x, float y, float z) {
+    for (int row = 0; row < 4; ++row) m[12 + row] += m[row] * x + m[4 + row] * y + m[8 + row] * z;
+}
+
+void mat4RotateY(float m[16], float angleDeg) {
+    float a = angleDeg * (float)M_PI / 180.0f;
+    float c = cosf(a), s = sinf(a);
+    for (int row = 0; row < 4; ++row) {
+        float x = m[row], z = m[8 + row];
+        m[row] = x * c - z * s;     // Column 0 = x * c + z * (-s)
+        m[8 + row] = x * s + z * c; // Column 2 = x * s + z * c
+    }
+}
+
+void mat4Scale(float m[16], float x, float y, float z) {
+    for (int row = 0; row < 4; ++row) { m[row] *= x; m[4 + row] *= y; m[8 + row] *= z; }
+}
@@ -0,0 +1,19 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+// --- 4x4 Matrices ---
+// Column-major float[16], the same layout as OpenGL (element (row, col) is m[col * 4 + row]).
+// Used by the shader render path, which cannot rely on the fixed-function matrix stack.
+
+// --- Function Declarations ---
+void mat4Identity(float out[16]);
+void mat4Multiply(float out[16], const float a[16], const float b[16]); // out = a * b (out may alias a or b)
+void mat4Perspective(float out[16], float fovyDeg, float aspect, float zNear, float zFar); // As gluPerspective
+void mat4Ortho(float out[16], float left, float right, float bottom, float top, float zNear, float zFar); // As glOrtho
+void mat4LookAt(float out[16], const float eye[3], const float center[3], const float up[3]); // As gluLookAt
+// In-place post-multiplication, like glTranslatef/glRotatef/glScalef on the current matrix
+void mat4Translate(float m[16], float x, float y, float z);
+void mat4RotateY(float m[16], float angleDeg);
+void mat4Scale(float m[16], float x, float y, float z);
+
+#endif // MATRIX_H
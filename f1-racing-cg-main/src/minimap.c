@@ -0,0 +1,185 @@
+#include "minimap.h"    // Prototypes and sizes
+#include "track_rect.h"  // Track outlines for the map extent
+#include "track_round.h"
+#include "frustum.h"    // viewFrustum is redirected while the map is rendered
+#include "renderer.h"   // Shader or fixed-function render path
+#include "matrix.h"     // Top-down orthographic camera
+#include <GL/glew.h>    // Framebuffer objects, textures
+#include <GL/freeglut.h> // gluOrtho2D (via glu.h)
+#include <math.h>       // For sinf, cosf, fmaxf
+#include <stdio.h>      // For fprintf
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define MINIMAP_WHITE_ROWS 2    // Solid white texels above the map, sampled by the markers
+#define MINIMAP_OPACITY 0.85f   // The scene shows through the map slightly
+#define MINIMAP_MARKER_SIZE 6.0f // Marker length from centre to tip, in pixels
+
+// --- Cached Map ---
+static GLuint minimapTexture = 0;
+static int mapWidth = 0, mapHeight = 0; // Texels covered by the map (= pixels on screen)
+static int textureHeight = 0;           // mapHeight + MINIMAP_WHITE_ROWS
+static float mapHalfX = 1.0f, mapHalfZ = 1.0f; // World extent around the origin
+
+// --- Map Rendering (once per race) ---
+// Draws the track from straight above with the regular track code (same meshes, same render
+// path), into a temporary framebuffer whose colour attachment is the minimap texture.
+void buildMinimap(TrackType type) {
+    if (!GLEW_VERSION_3_0 && !GLEW_ARB_framebuffer_object) {
+        if (!minimapTexture) fprintf(stderr, "Minimap: framebuffer objects not available, no minimap\n");
+        return;
+    }
+    mapHalfX = (type == TRACK_RECT ? RECT_TRACK_MAIN_WIDTH : ROUND_TRACK_MAIN_WIDTH) * 0.5f + MINIMAP_MARGIN;
+    mapHalfZ = (type == TRACK_RECT ? RECT_TRACK_MAIN_LENGTH : ROUND_TRACK_MAIN_LENGTH) * 0.5f + MINIMAP_MARGIN;
+    float texelsPerUnit = MINIMAP_TEXTURE_SIZE / (2.0f * fmaxf(mapHalfX, mapHalfZ)); // Longer axis fills the size
+    mapWidth = (int)(2.0f * mapHalfX * texelsPerUnit + 0.5f);
+    mapHeight = (int)(2.0f * mapHalfZ * texelsPerUnit + 0.5f);
+    textureHeight = mapHeight + MINIMAP_WHITE_ROWS;
+
+    if (!minimapTexture) glGenTextures(1, &minimapTexture);
+    glBindTexture(GL_TEXTURE_2D, minimapTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, mapWidth, textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // Drawn 1:1, no filtering needed
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLuint framebuffer, depthBuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mapWidth, textureHeight);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, minimapTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "Minimap: incomplete framebuffer, no minimap\n");
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &depthBuffer);
+        shutdownMinimap();
+        return;
+    }
+
+    glPushAttrib(GL_VIEWPORT_BIT | GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_SCISSOR_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE); // Seen from above, surfaces of either winding must show
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_SCISSOR_TEST); // The marker strip
+    glScissor(0, mapHeight, mapWidth, MINIMAP_WHITE_ROWS);
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
+    glViewport(0, 0, mapWidth, mapHeight);
+
+    // Looking down -Y with +Z up the map (the start direction), so +X is to the left
+    float proj[16], view[16], viewProj[16];
+    const float eye[3] = { 0.0f, 100.0f, 0.0f }, center[3] = { 0.0f, 0.0f, 0.0f }, up[3] = { 0.0f, 0.0f, 1.0f };
+    mat4Ortho(proj, -mapHalfX, mapHalfX, -mapHalfZ, mapHalfZ, 1.0f, 200.0f);
+    mat4LookAt(view, eye, center, up);
+    mat4Multiply(viewProj, proj, view);
+    Frustum chaseFrustum = viewFrustum; // The track code culls against viewFrustum
+    extractFrustumFromMatrices(&viewFrustum, proj, view, mapHeight);
+    viewFrustum.pixelScale = 1e9f; // Orthographic: no distance falloff, always the finest level of detail
+
+    if (renderPath == RENDER_PATH_SHADER) {
+        beginShaderFrame(viewProj);
+    } else {
+        glMatrixMode(GL_PROJECTION); glPushMatrix(); glLoadMatrixf(proj);
+        glMatrixMode(GL_MODELVIEW); glPushMatrix(); glLoadMatrixf(view);
+    }
+    if (type == TRACK_RECT) {
+        renderRectTrack();
+        renderRectGuardrails();
+    } else {
+        renderRoundTrack();
+        renderRoundGuardrails();
+    }
+    if (renderPath == RENDER_PATH_SHADER) {
+        flushShaderFrame();
+    } else {
+        glMatrixMode(GL_PROJECTION); glPopMatrix();
+        glMatrixMode(GL_MODELVIEW); glPopMatrix();
+    }
+    viewFrustum = chaseFrustum;
+    glPopAttrib();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer); // Only the texture is kept
+    glDeleteRenderbuffers(1, &depthBuffer);
+}
+
+void shutdownMinimap() {
+    if (minimapTexture) glDeleteTextures(1, &minimapTexture);
+    minimapTexture = 0;
+}
+
+
+// --- HUD Drawing (every frame) ---
+// One glBegin(GL_TRIANGLES): the map, then a heading arrow per car (in the car's colour) sampling
+// the white strip. The arrow is notched, i.e. concave, so it is two triangles: GL leaves a
+// non-convex quad undefined.
+void drawMinimap(int windowWidth, int windowHeight, const Car* cars, int numCars, int centered) {
+    if (!minimapTexture) return;
+    float x0 = (float)(windowWidth - MINIMAP_SCREEN_MARGIN - mapWidth);
+    float y0 = (float)(windowHeight - MINIMAP_SCREEN_MARGIN - mapHeight);
+    if (centered) { // Where the split-screen viewports meet
+        x0 = (float)((windowWidth - mapWidth) / 2);
+        y0 = (float)((windowHeight - mapHeight) / 2);
+    }
+    float vMap = (float)mapHeight / textureHeight;
+    float vWhite = (mapHeight + 1.0f) / textureHeight;
+
+    glMatrixMode(GL_PROJECTION); glPushMatrix(); glLoadIdentity();
+    gluOrtho2D(0, windowWidth, 0, windowHeight); // Pixel coordinates, as renderHUD()
+    glMatrixMode(GL_MODELVIEW); glPushMatrix(); glLoadIdentity();
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT);
+    glDisable(GL_DEPTH_TEST); glDisable(GL_CULL_FACE); glDisable(GL_LIGHTING);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, minimapTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE); // Texel x vertex colour
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glBegin(GL_TRIANGLES);
+        glColor4f(1.0f, 1.0f, 1.0f, MINIMAP_OPACITY);
+        glTexCoord2f(0.0f, 0.0f); glVertex2f(x0, y0);
+        glTexCoord2f(1.0f, 0.0f); glVertex2f(x0 + mapWidth, y0);
+        glTexCoord2f(1.0f, vMap); glVertex2f(x0 + mapWidth, y0 + mapHeight);
+        glTexCoord2f(0.0f, 0.0f); glVertex2f(x0, y0);
+        glTexCoord2f(1.0f, vMap); glVertex2f(x0 + mapWidth, y0 + mapHeight);
+        glTexCoord2f(0.0f, vMap); glVertex2f(x0, y0 + mapHeight);
+
+        glTexCoord2f(0.5f, vWhite); // Every marker vertex samples white
+        for (int i = 0; i < numCars; ++i) {
+            const Car* car = &cars[i];
+            // World to map pixels (+X is to the left), clamped to the map
+            float px = x0 + (mapHalfX - car->x) / (2.0f * mapHalfX) * mapWidth;
+            float py = y0 + (car->z + mapHalfZ) / (2.0f * mapHalfZ) * mapHeight;
+            px = fminf(fmaxf(px, x0), x0 + mapWidth);
+            py = fminf(fmaxf(py, y0), y0 + mapHeight);
+            float a = car->angle * (float)M_PI / 180.0f;
+            float fx = -sinf(a) * MINIMAP_MARKER_SIZE, fy = cosf(a) * MINIMAP_MARKER_SIZE; // Heading on the map
+            float sx = -fy * 0.6f, sy = fx * 0.6f;                                          // Perpendicular
+            float tipX = px + fx, tipY = py + fy;
+            float notchX = px - fx * 0.3f, notchY = py - fy * 0.3f;
+            glColor4f(car->color[0], car->color[1], car->color[2], 1.0f);
+            glVertex2f(tipX, tipY);                                   // One side of the notch
+            glVertex2f(px - fx * 0.7f + sx, py - fy * 0.7f + sy);     // Rear corner
+            glVertex2f(notchX, notchY);
+            glVertex2f(tipX, tipY);                                   // The other side
+            glVertex2f(notchX, notchY);
+            glVertex2f(px - fx * 0.7f - sx, py - fy * 0.7f - sy);     // Rear corner
+        }
+    glEnd();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPopAttrib();
+    glMatrixMode(GL_PROJECTION); glPopMatrix();
+    glMatrixMode(GL_MODELVIEW); glPopMatrix();
+}
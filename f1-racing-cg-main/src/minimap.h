@@ -0,0 +1,22 @@
+#ifndef MINIMAP_H
+#define MINIMAP_H
+
+#include "game.h" // TrackType, Car
+
+// --- Minimap ---
+// A top-down view of the selected track is rendered once (startGame) into a texture. Each HUD
+// frame then draws that texture plus one marker per car as a single batch of textured triangles,
+// so the minimap costs the same whatever the track's geometry. The texture has a white strip
+// above the map that the markers sample, which keeps them in the same batch.
+
+#define MINIMAP_TEXTURE_SIZE 256 // Texels along the track's longer axis (the map is drawn 1:1)
+#define MINIMAP_MARGIN 6.0f      // World units of surroundings around the track outline
+#define MINIMAP_SCREEN_MARGIN 10 // Pixels from the window's top-right corner
+
+// --- Function Declarations ---
+void buildMinimap(TrackType type); // Needs framebuffer objects; without them there is no minimap
+// Own pixel projection. Top-right corner, or the middle of the window ('centered', for split-screen)
+void drawMinimap(int windowWidth, int windowHeight, const Car* cars, int numCars, int centered);
+void shutdownMinimap(void);
+
+#endif // MINIMAP_H
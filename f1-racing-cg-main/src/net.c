@@ -0,0 +1,215 @@
+// getaddrinfo() and fcntl() are POSIX, not C99
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "net.h"
+#include "timing.h" // Release times of simulated delays
+#include <stdio.h>  // For snprintf, fprintf
+#include <stdlib.h> // For atoi
+#include <string.h> // For memcpy, memset, strchr
+#include <errno.h>  // EAGAIN (full send buffer)
+
+#ifdef _WIN32
+#include <winsock2.h> // Link with -lws2_32
+#include <ws2tcpip.h> // getaddrinfo
+typedef SOCKET NetHandle;
+#define NET_INVALID_HANDLE INVALID_SOCKET
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>  // ntohl, ntohs
+#include <netdb.h>      // getaddrinfo
+#include <fcntl.h>      // O_NONBLOCK
+#include <unistd.h>     // close
+typedef int NetHandle;
+#define NET_INVALID_HANDLE (-1)
+#endif
+
+// --- Start-up ---
+int initNetwork(void) {
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        fprintf(stderr, "Net: Winsock 2.2 not available\n");
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+void shutdownNetwork(void) {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+
+// --- Addresses ---
+int parseNetAddress(const char* text, int defaultPort, NetAddress* address) {
+    char host[256];
+    int port = defaultPort;
+    const char* colon = strchr(text, ':');
+    size_t hostLen = colon ? (size_t)(colon - text) : strlen(text);
+    if (hostLen == 0 || hostLen >= sizeof(host)) return 0;
+    memcpy(host, text, hostLen);
+    host[hostLen] = '\0';
+    if (colon) port = atoi(colon + 1);
+    if (port <= 0 || port > 65535) return 0;
+
+    struct addrinfo hints, *result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET; // IPv4 only: NetAddress is 4 bytes
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(host, NULL, &hints, &result) != 0 || !result) return 0;
+    const struct sockaddr_in* resolved = (const struct sockaddr_in*)result->ai_addr;
+    address->host = resolved->sin_addr.s_addr;
+    address->port = htons((unsigned short)port);
+    freeaddrinfo(result);
+    return 1;
+}
+
+void formatNetAddress(const NetAddress* address, char* buffer, int size) {
+    unsigned int host = ntohl(address->host);
+    snprintf(buffer, (size_t)size, "%u.%u.%u.%u:%u", (host >> 24) & 255, (host >> 16) & 255,
+             (host >> 8) & 255, host & 255, (unsigned)ntohs(address->port));
+}
+
+
+// --- Socket ---
+int openUdpSocket(UdpSocket* sock, int port) {
+    memset(sock, 0, sizeof(*sock));
+    NetHandle handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == NET_INVALID_HANDLE) {
+        fprintf(stderr, "Net: could not create a UDP socket\n");
+        return 0;
+    }
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons((unsigned short)port);
+    int nonBlocking;
+#ifdef _WIN32
+    u_long enable = 1;
+    nonBlocking = ioctlsocket(handle, FIONBIO, &enable) == 0;
+#else
+    int flags = fcntl(handle, F_GETFL, 0);
+    nonBlocking = flags >= 0 && fcntl(handle, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+    if (bind(handle, (struct sockaddr*)&local, sizeof(local)) != 0 || !nonBlocking) {
+        fprintf(stderr, "Net: could not bind UDP port %d\n", port);
+#ifdef _WIN32
+        closesocket(handle);
+#else
+        close(handle);
+#endif
+        return 0;
+    }
+    sock->handle = (size_t)handle;
+    sock->open = 1;
+    sock->random = 1;
+    return 1;
+}
+
+void closeUdpSocket(UdpSocket* sock) {
+    if (!sock->open) return;
+#ifdef _WIN32
+    closesocket((NetHandle)sock->handle);
+#else
+    close((NetHandle)sock->handle);
+#endif
+    sock->open = 0;
+    sock->numDelayed = 0; // Whatever the simulator still held is lost with the socket
+}
+
+void setUdpBufferSize(UdpSocket* sock, int bytes) {
+    if (!sock->open) return;
+    // Best effort: the system may cap it (e.g. net.core.rmem_max on Linux)
+    setsockopt((NetHandle)sock->handle, SOL_SOCKET, SO_RCVBUF, (const char*)&bytes, sizeof(bytes));
+    setsockopt((NetHandle)sock->handle, SOL_SOCKET, SO_SNDBUF, (const char*)&bytes, sizeof(bytes));
+}
+
+static int sendNow(UdpSocket* sock, const NetAddress* to, const void* data, int length) {
+    struct sockaddr_in remote;
+    memset(&remote, 0, sizeof(remote));
+    remote.sin_family = AF_INET;
+    remote.sin_addr.s_addr = to->host;
+    remote.sin_port = to->port;
+    int sent = (int)sendto((NetHandle)sock->handle, (const char*)data, length, 0,
+                           (const struct sockaddr*)&remote, sizeof(remote));
+    if (sent == length) return 1;
+    // A full socket buffer drops the datagram, exactly as the network might
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+
+// --- Network Simulator ---
+void setNetConditions(UdpSocket* sock, const NetConditions* conditions, unsigned int seed) {
+    sock->conditions = *conditions;
+    sock->random = seed ? seed : 1; // xorshift state must be non-zero
+}
+
+// xorshift32: uniform in [0, 1)
+static float nextRandom(UdpSocket* sock) {
+    unsigned int x = sock->random;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    sock->random = x;
+    return (float)(x >> 8) / 16777216.0f;
+}
+
+// Sends every held-back datagram whose time has come (in any order they became due)
+static void releaseDelayed(UdpSocket* sock) {
+    double now = getTimeSeconds();
+    int kept = 0;
+    for (int i = 0; i < sock->numDelayed; ++i) {
+        NetDelayedDatagram* datagram = &sock->delayed[i];
+        if (datagram->releaseTime <= now) sendNow(sock, &datagram->to, datagram->data, datagram->length);
+        else if (kept != i) sock->delayed[kept++] = *datagram;
+        else kept++;
+    }
+    sock->numDelayed = kept;
+}
+
+int sendDatagram(UdpSocket* sock, const NetAddress* to, const void* data, int length) {
+    if (!sock->open || length <= 0 || length > NET_MAX_DATAGRAM) return 0;
+    const NetConditions* conditions = &sock->conditions;
+    if (conditions->lossPercent <= 0.0f && conditions->latencyMs <= 0 && conditions->jitterMs <= 0) {
+        return sendNow(sock, to, data, length);
+    }
+    releaseDelayed(sock);
+    if (nextRandom(sock) * 100.0f < conditions->lossPercent || sock->numDelayed == NET_SIM_QUEUE) {
+        sock->simulatedDrops++;
+        return 1;
+    }
+    NetDelayedDatagram* datagram = &sock->delayed[sock->numDelayed++];
+    datagram->releaseTime = getTimeSeconds() + (conditions->latencyMs + nextRandom(sock) * conditions->jitterMs) / 1000.0;
+    datagram->to = *to;
+    datagram->length = length;
+    memcpy(datagram->data, data, (size_t)length);
+    return 1;
+}
+
+int receiveDatagram(UdpSocket* sock, NetAddress* from, void* buffer, int capacity) {
+    if (!sock->open) return -1;
+    releaseDelayed(sock); // Receiving is polled often, so it also drives the simulator's clock
+    struct sockaddr_in remote;
+#ifdef _WIN32
+    int remoteLen = sizeof(remote);
+#else
+    socklen_t remoteLen = sizeof(remote);
+#endif
+    int length = (int)recvfrom((NetHandle)sock->handle, (char*)buffer, capacity, 0,
+                               (struct sockaddr*)&remote, &remoteLen);
+    if (length < 0) return -1; // Nothing waiting (or an ICMP error from an earlier send: ignored)
+    if (from) {
+        from->host = remote.sin_addr.s_addr;
+        from->port = remote.sin_port;
+    }
+    return length;
+}
@@ -0,0 +1,69 @@
+#ifndef NET_H
+#define NET_H
+
+#include <stddef.h> // size_t (socket handle storage)
+
+// --- Minimal Portable UDP ---
+// Thin wrapper over Winsock / BSD sockets, just enough for peer-to-peer datagrams (IPv4,
+// non-blocking). Outgoing datagrams can pass through a network simulator that drops and
+// delays them, so online play can be tried on one machine over loopback.
+
+#define NET_MAX_DATAGRAM 512    // Largest payload sent or received (far below any path MTU)
+#define NET_SIM_QUEUE 256       // Datagrams the simulator can hold back at once
+#define NET_UDP_IP_OVERHEAD 28  // IPv4 (20) + UDP (8) header bytes per datagram, for bandwidth figures
+
+// --- Address ---
+typedef struct {
+    unsigned int host;    // IPv4 address, network byte order
+    unsigned short port;  // Network byte order
+} NetAddress;
+
+// --- Network Simulator ---
+// Applied to outgoing datagrams: each is dropped with probability lossPercent / 100, otherwise
+// delivered after latencyMs plus a uniform 0..jitterMs (so jitter also reorders datagrams).
+typedef struct {
+    float lossPercent;
+    int latencyMs;
+    int jitterMs;
+} NetConditions;
+
+typedef struct {
+    double releaseTime;   // getTimeSeconds() when the datagram goes out
+    NetAddress to;
+    int length;
+    unsigned char data[NET_MAX_DATAGRAM];
+} NetDelayedDatagram;
+
+// --- Socket ---
+typedef struct {
+    size_t handle;          // SOCKET / file descriptor (size_t holds both)
+    int open;
+    NetConditions conditions; // All zero = datagrams go straight out
+    unsigned int random;      // Simulator's own generator state (reproducible per seed)
+    NetDelayedDatagram delayed[NET_SIM_QUEUE];
+    int numDelayed;
+    long simulatedDrops;      // Datagrams the simulator dropped (loss, or its queue was full)
+} UdpSocket;
+
+// --- Byte Packing ---
+// Little-endian integers in packets, shared by the lockstep, snapshot and server protocols.
+static inline void putU16(unsigned char* p, unsigned int v) { p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8); }
+static inline void putU32(unsigned char* p, unsigned int v) { putU16(p, v & 0xFFFF); putU16(p + 2, v >> 16); }
+static inline unsigned int getU16(const unsigned char* p) { return (unsigned int)p[0] | ((unsigned int)p[1] << 8); }
+static inline unsigned int getU32(const unsigned char* p) { return getU16(p) | (getU16(p + 2) << 16); }
+
+// Function declarations
+int initNetwork(void);     // Winsock start-up (no-op elsewhere). Returns 1 on success
+void shutdownNetwork(void);
+int parseNetAddress(const char* text, int defaultPort, NetAddress* address); // "host[:port]", IPv4 or name
+void formatNetAddress(const NetAddress* address, char* buffer, int size);      // "a.b.c.d:port"
+int openUdpSocket(UdpSocket* sock, int port); // Bound to all interfaces, 0 = any port. Returns 1 on success
+void closeUdpSocket(UdpSocket* sock);
+void setUdpBufferSize(UdpSocket* sock, int bytes); // Kernel send/receive buffers (servers with many clients)
+void setNetConditions(UdpSocket* sock, const NetConditions* conditions, unsigned int seed);
+// Sends (or hands to the simulator). Returns 0 only on a local send error.
+int sendDatagram(UdpSocket* sock, const NetAddress* to, const void* data, int length);
+// Returns the payload length of the next waiting datagram, or -1 if there is none.
+int receiveDatagram(UdpSocket* sock, NetAddress* from, void* buffer, int capacity);
+
+#endif // NET_H
@@ -0,0 +1,303 @@
+#include "netclient.h" // Protocol, interpolation buffer, prototypes
+#include "ai.h"        // Headless runs: the autopilot drives the own car
+#include "lap.h"       // Display lap timers for every car
+#include "timing.h"    // Handshake retries, timeouts, headless pacing
+#include <stdio.h>     // For printf, fprintf
+#include <stdlib.h>    // For atof
+#include <string.h>    // For memset, strcmp, strncmp
+#include <math.h>      // For sqrt
+
+NetClientStats netClientStats;
+
+// Car colours by grid slot; the first four are the split-screen players' (game.c)
+static const float slotColors[PROTOCOL_MAX_CARS][3] = {
+    { 1.0f, 0.0f, 0.0f },  // Red
+    { 0.1f, 0.4f, 1.0f },  // Blue
+    { 0.1f, 0.8f, 0.2f },  // Green
+    { 1.0f, 0.85f, 0.0f }, // Yellow
+    { 1.0f, 0.5f, 0.0f },  // Orange
+    { 0.7f, 0.2f, 0.9f },  // Purple
+    { 0.0f, 0.8f, 0.8f },  // Cyan
+    { 0.95f, 0.95f, 0.95f } // White
+};
+
+static UdpSocket clientSocket;
+static NetAddress serverAddress;
+static int active = 0;
+static int spectating = 0;
+static int sessionEnded = 0;           // FULL after the WELCOME: the session we watched is over
+static int ownSlot = PROTOCOL_NO_CAR;  // Grid slot of the own car
+static TrackType raceTrack = TRACK_RECT;
+static unsigned char localControls = 0;
+static double lastHeardTime = 0.0;
+
+static NetSnapshot history[PROTOCOL_SNAPSHOT_HISTORY]; // Decoded snapshots, the delta bases
+static long latestTick = -1;           // Newest decoded snapshot, acknowledged to the server
+static InterpBuffer interp;
+
+// The drawn cars by grid slot, kept between ticks for prev_x / prev_z (lap detection)
+static Car slotCars[PROTOCOL_MAX_CARS];
+static LapTimer slotTimers[PROTOCOL_MAX_CARS];
+static unsigned int slotsShown = 0;    // Slots with a car at the render tick
+static int viewedSlot = 0;             // The car the camera follows
+
+
+// --- Packets ---
+static void sendJoin(int trackWish) {
+    unsigned char join[4] = { PACKET_JOIN, PROTOCOL_VERSION, (unsigned char)trackWish,
+                              (unsigned char)(spectating ? PROTOCOL_JOIN_SPECTATE : 0) };
+    sendDatagram(&clientSocket, &serverAddress, join, sizeof(join));
+}
+
+static void sendInput(void) {
+    unsigned int ack = latestTick >= 0 ? (unsigned int)latestTick : PROTOCOL_NO_TICK;
+    unsigned char packet[6] = { PACKET_INPUT, localControls,
+                                (unsigned char)ack, (unsigned char)(ack >> 8), (unsigned char)(ack >> 16), (unsigned char)(ack >> 24) };
+    if (sendDatagram(&clientSocket, &serverAddress, packet, sizeof(packet))) netClientStats.packetsSent++;
+}
+
+static void receiveSnapshot(const unsigned char* packet, int length) {
+    NetSnapshot snapshot;
+    if (!decodeSnapshot(packet, length, history, &snapshot)) { netClientStats.decodeFailures++; return; }
+    netClientStats.snapshots++;
+    netClientStats.snapshotBytes += length;
+    if (packet[5] != 0) netClientStats.deltaSnapshots++;
+    for (unsigned int present = snapshot.present; present; present &= present - 1) netClientStats.snapshotCars++;
+    history[getSnapshotSlot(snapshot.tick)] = snapshot;
+    pushInterpSnapshot(&interp, &snapshot); // Late (reordered) ones still fill their gap there
+    if (snapshot.tick > latestTick) latestTick = snapshot.tick;
+}
+
+static void pollPackets(void) {
+    unsigned char packet[NET_MAX_DATAGRAM];
+    NetAddress from;
+    int length;
+    while ((length = receiveDatagram(&clientSocket, &from, packet, sizeof(packet))) >= 0) {
+        if (length < 1 || from.host != serverAddress.host || from.port != serverAddress.port) continue;
+        lastHeardTime = getTimeSeconds();
+        if (packet[0] == PACKET_SNAPSHOT) receiveSnapshot(packet, length);
+        else if (packet[0] == PACKET_FULL) sessionEnded = 1;
+    }
+}
+
+
+// --- Connection ---
+int connectServer(const char* address, int trackWish, int spectate, const NetConditions* conditions) {
+    if (!initNetwork()) return 0;
+    if (!openUdpSocket(&clientSocket, 0)) { shutdownNetwork(); return 0; }
+    if (conditions) setNetConditions(&clientSocket, conditions, 4242u);
+    if (!parseNetAddress(address, PROTOCOL_DEFAULT_PORT, &serverAddress)) {
+        fprintf(stderr, "Client: can't resolve '%s'\n", address);
+        closeUdpSocket(&clientSocket);
+        shutdownNetwork();
+        return 0;
+    }
+    spectating = spectate;
+    printf("Client: %s %s...\n", spectate ? "spectating on" : "joining", address);
+    double start = getTimeSeconds(), lastJoin = -1.0;
+    unsigned char packet[NET_MAX_DATAGRAM];
+    while (getTimeSeconds() - start < NETCLIENT_HANDSHAKE_SECONDS) {
+        if (getTimeSeconds() - lastJoin >= NETCLIENT_JOIN_RETRY_SECONDS) { // JOINs can be lost too
+            sendJoin(trackWish);
+            lastJoin = getTimeSeconds();
+        }
+        NetAddress from;
+        int length = receiveDatagram(&clientSocket, &from, packet, sizeof(packet));
+        if (length < 0) { sleepSeconds(0.01); continue; }
+        if (length < 1 || from.host != serverAddress.host || from.port != serverAddress.port) continue;
+        if (packet[0] == PACKET_FULL) {
+            fprintf(stderr, "Client: %s\n", spectate ? "no race to watch on the server" : "the server is full");
+            break;
+        }
+        if (packet[0] != PACKET_WELCOME || length < 6) continue;
+        if (packet[1] != PROTOCOL_VERSION || packet[2] >= NUM_TRACK_OPTIONS) {
+            fprintf(stderr, "Client: the server sent an incompatible WELCOME\n");
+            break;
+        }
+        raceTrack = (TrackType)packet[2];
+        ownSlot = packet[3];
+        viewedSlot = ownSlot != PROTOCOL_NO_CAR ? ownSlot : 0;
+        for (int h = 0; h < PROTOCOL_SNAPSHOT_HISTORY; ++h) history[h].tick = -1;
+        latestTick = -1;
+        clearInterpBuffer(&interp);
+        slotsShown = 0;
+        localControls = 0;
+        sessionEnded = 0;
+        memset(&netClientStats, 0, sizeof(netClientStats));
+        netClientStats.startTime = getTimeSeconds();
+        lastHeardTime = netClientStats.startTime;
+        selectedTrackType = raceTrack; // initCar() below places cars for it
+        active = 1;
+        printf("Client: %s session %u on track %d\n", spectate ? "watching" : "racing in",
+               packet[4] | (packet[5] << 8), raceTrack);
+        return 1;
+    }
+    if (getTimeSeconds() - start >= NETCLIENT_HANDSHAKE_SECONDS) fprintf(stderr, "Client: no answer from %s\n", address);
+    closeUdpSocket(&clientSocket);
+    shutdownNetwork();
+    return 0;
+}
+
+int isNetClientActive(void) { return active; }
+int isNetClientSpectating(void) { return active && spectating; }
+TrackType getNetClientTrack(void) { return raceTrack; }
+
+// Next or previous car that is on track, wrapping around
+static void cycleViewedSlot(int step) {
+    for (int i = 1; i <= PROTOCOL_MAX_CARS; ++i) {
+        int slot = ((viewedSlot + step * i) % PROTOCOL_MAX_CARS + PROTOCOL_MAX_CARS) % PROTOCOL_MAX_CARS;
+        if (slotsShown & (1u << slot)) { viewedSlot = slot; return; }
+    }
+}
+
+void setNetClientControl(CarControl control, int state) {
+    if (spectating) {
+        if (state && (control == CAR_CONTROL_LEFT || control == CAR_CONTROL_RIGHT)) cycleViewedSlot(control == CAR_CONTROL_RIGHT ? 1 : -1);
+        return;
+    }
+    if ((int)control < 0 || (int)control >= NUM_CAR_CONTROLS) return;
+    if (state) localControls |= (unsigned char)(1u << control);
+    else localControls &= (unsigned char)~(1u << control);
+    // As setCarControl(): accelerating and braking exclude each other, the later press wins
+    if (state && control == CAR_CONTROL_ACCELERATE) localControls &= (unsigned char)~(1u << CAR_CONTROL_BRAKE);
+    if (state && control == CAR_CONTROL_BRAKE) localControls &= (unsigned char)~(1u << CAR_CONTROL_ACCELERATE);
+}
+
+
+// --- One Tick ---
+// Interpolated pose of every car at the new render tick; lap timers run on the client's ticks
+static void updateShownCars(void) {
+    unsigned int present = getInterpCars(&interp);
+    for (int slot = 0; slot < PROTOCOL_MAX_CARS; ++slot) {
+        Car* car = &slotCars[slot];
+        int laps;
+        if (!(present & (1u << slot))) { slotsShown &= ~(1u << slot); continue; }
+        if (!(slotsShown & (1u << slot))) { // New on the grid: dimensions and colour, then its pose
+            initCar(car);
+            for (int i = 0; i < 3; ++i) car->color[i] = slotColors[slot][i];
+            if (!sampleInterpBuffer(&interp, slot, car, &laps)) continue;
+            car->prev_x = car->x;
+            car->prev_z = car->z;
+            initLapTimer(&slotTimers[slot], car, netClientStats.ticks);
+            slotsShown |= 1u << slot;
+            continue;
+        }
+        car->prev_x = car->x;
+        car->prev_z = car->z;
+        if (!sampleInterpBuffer(&interp, slot, car, &laps)) continue;
+        updateLapTimer(&slotTimers[slot], car, netClientStats.ticks);
+        double dx = car->x - car->prev_x, dz = car->z - car->prev_z;
+        double step = sqrt(dx * dx + dz * dz);
+        if (step > netClientStats.largestStep) netClientStats.largestStep = step;
+    }
+    if (!(slotsShown & (1u << viewedSlot))) cycleViewedSlot(1); // The followed car left
+}
+
+int updateNetClient(void) {
+    if (!active) return 0;
+    pollPackets();
+    if (sessionEnded) {
+        printf("Client: the race on the server ended\n");
+        return 0;
+    }
+    if (getTimeSeconds() - lastHeardTime > NETCLIENT_TIMEOUT_SECONDS) {
+        fprintf(stderr, "Client: nothing heard from the server for %.0f s\n", NETCLIENT_TIMEOUT_SECONDS);
+        return 0;
+    }
+    // Controls and acks go out at the snapshot rate; spectators send them too, as keep-alives
+    if (netClientStats.ticks % PROTOCOL_SNAPSHOT_INTERVAL == 0) sendInput();
+    netClientStats.ticks++;
+    advanceInterpBuffer(&interp, 1.0);
+    updateShownCars();
+    return 1;
+}
+
+int getNetClientCars(Car* cars, LapTimer* timers, int maxCars) {
+    int count = 0;
+    if (maxCars > 0 && (slotsShown & (1u << viewedSlot))) {
+        cars[count] = slotCars[viewedSlot];
+        timers[count++] = slotTimers[viewedSlot];
+    }
+    for (int slot = 0; slot < PROTOCOL_MAX_CARS && count < maxCars; ++slot) {
+        if (slot == viewedSlot || !(slotsShown & (1u << slot))) continue;
+        cars[count] = slotCars[slot];
+        timers[count++] = slotTimers[slot];
+    }
+    return count;
+}
+
+void stopNetClient(void) {
+    if (!active) return;
+    unsigned char leave = PACKET_LEAVE;
+    clientSocket.conditions = (NetConditions){ 0.0f, 0, 0 }; // Goes out now, not through the simulator
+    sendDatagram(&clientSocket, &serverAddress, &leave, 1);
+    closeUdpSocket(&clientSocket);
+    shutdownNetwork();
+    active = 0;
+}
+
+void printNetClientStats(void) {
+    const NetClientStats* s = &netClientStats;
+    double seconds = getTimeSeconds() - s->startTime;
+    if (seconds <= 0.0) seconds = 1.0;
+    printf("Client: %ld ticks in %.1f s, %.1f snapshots/s, %.1f bytes/snapshot (%.2f per car after the header, "
+           "%.1f%% deltas), %ld undecodable | interpolation: %ld underrun ticks, %ld resyncs, largest step %.2f units\n",
+           s->ticks, seconds, s->snapshots / seconds, s->snapshots > 0 ? (double)s->snapshotBytes / s->snapshots : 0.0,
+           s->snapshotCars > 0 ? (double)(s->snapshotBytes - s->snapshots * PROTOCOL_SNAPSHOT_HEADER_BYTES) / s->snapshotCars : 0.0,
+           s->snapshots > 0 ? 100.0 * s->deltaSnapshots / s->snapshots : 0.0, s->decodeFailures,
+           interp.underruns, interp.resyncs, s->largestStep);
+    fflush(stdout);
+}
+
+
+// --- Headless Test Client ---
+// server=host[:port], track=rect|round|any, spectate=1, seconds=, loss=, latency=, jitter=
+int runNetClientFromArgs(int argc, char** argv) {
+    const char* serverText = "127.0.0.1";
+    int trackWish = PROTOCOL_ANY_TRACK, spectate = 0;
+    double seconds = 10.0;
+    NetConditions conditions = { 0.0f, 0, 0 };
+    for (int i = 0; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "server=", 7) == 0) serverText = arg + 7;
+        else if (strncmp(arg, "spectate=", 9) == 0) spectate = atoi(arg + 9) != 0;
+        else if (strncmp(arg, "seconds=", 8) == 0) seconds = atof(arg + 8);
+        else if (strncmp(arg, "track=", 6) == 0) {
+            if (strcmp(arg + 6, "rect") == 0) trackWish = TRACK_RECT;
+            else if (strcmp(arg + 6, "round") == 0) trackWish = TRACK_ROUNDED;
+            else if (strcmp(arg + 6, "any") == 0) trackWish = PROTOCOL_ANY_TRACK;
+            else { fprintf(stderr, "Client: unknown track '%s' (rect|round|any)\n", arg + 6); return 1; }
+        }
+        else if (strncmp(arg, "loss=", 5) == 0) conditions.lossPercent = (float)atof(arg + 5);
+        else if (strncmp(arg, "latency=", 8) == 0) conditions.latencyMs = atoi(arg + 8);
+        else if (strncmp(arg, "jitter=", 7) == 0) conditions.jitterMs = atoi(arg + 7);
+        else { fprintf(stderr, "Client: unknown option '%s'\n", arg); return 1; }
+    }
+    if (!connectServer(serverText, trackWish, spectate, &conditions)) return 1;
+
+    // The autopilot steers from the newest snapshot, not the delayed interpolated pose
+    Car driven;
+    initCar(&driven);
+    long drivenTick = -1;
+    int ended = 0;
+    double startTime = getTimeSeconds(), nextTickTime = startTime;
+    while (getTimeSeconds() - startTime < seconds) {
+        if (!updateNetClient()) { ended = 1; break; }
+        if (!spectating && latestTick > drivenTick && (history[getSnapshotSlot(latestTick)].present & (1u << ownSlot))) {
+            unpackCarState(&history[getSnapshotSlot(latestTick)].cars[ownSlot], &driven);
+            drivenTick = latestTick;
+            updateAIControls(&driven);
+            localControls = getCarControlBits(&driven);
+        }
+        if (netClientStats.ticks % (5 * FRAME_RATE) == 0) printNetClientStats();
+        nextTickTime += FRAME_TIME_SEC;
+        double now = getTimeSeconds();
+        if (now - nextTickTime > 0.25) nextTickTime = now; // Fell far behind: reset the schedule
+        sleepSeconds(nextTickTime - now);
+    }
+    printf("Client: finished%s\n", ended ? " early" : "");
+    printNetClientStats();
+    long failures = netClientStats.decodeFailures;
+    stopNetClient();
+    return ended || (failures > 0 && conditions.lossPercent <= 0.0f) ? 1 : 0;
+}
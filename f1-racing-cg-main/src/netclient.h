@@ -0,0 +1,55 @@
+#ifndef NETCLIENT_H
+#define NETCLIENT_H
+
+#include "game.h"     // TrackType, Car, LapTimer
+#include "net.h"      // NetConditions
+#include "protocol.h" // Packets and snapshot decoding
+#include "interp.h"   // Snapshots are drawn through an interpolation buffer
+
+// --- Dedicated Server Client ---
+// Races on a dedicated server (server/, see protocol.h) from the game: the server simulates
+// every car, and this client only sends its controls and draws the snapshots it receives,
+// INTERP_DELAY_TICKS behind the server so lost and late packets don't show (interp.h).
+// The own car is drawn the same way, so the controls feel the round trip plus that delay;
+// there is no client-side prediction.
+//
+// A spectator joins without a car and watches the first running session on the track; LEFT
+// and RIGHT switch between the cars. Lap times are measured here from the interpolated cars
+// (for display only; the server's lap counts are the official ones).
+
+#define NETCLIENT_JOIN_RETRY_SECONDS 0.5
+#define NETCLIENT_HANDSHAKE_SECONDS 10.0
+#define NETCLIENT_TIMEOUT_SECONDS 5.0    // Silence from the server before the race is abandoned
+
+// --- Statistics ---
+typedef struct {
+    long ticks;                        // updateNetClient() calls
+    long snapshots, snapshotBytes;     // Decoded snapshots and their packet sizes
+    long snapshotCars;                 // Cars in them
+    long deltaSnapshots;               // Encoded against an acknowledged base
+    long decodeFailures;               // Base already gone or malformed
+    long packetsSent;
+    double largestStep;                // Largest distance a drawn car moved in one tick
+    double startTime;
+} NetClientStats;
+
+extern NetClientStats netClientStats;
+
+// --- Function Declarations ---
+// Blocks until the server welcomes this client (or refuses, or doesn't answer). "host[:port]";
+// trackWish is a TrackType or PROTOCOL_ANY_TRACK.
+int connectServer(const char* address, int trackWish, int spectate, const NetConditions* conditions);
+int isNetClientActive(void);
+int isNetClientSpectating(void);
+TrackType getNetClientTrack(void);       // As chosen by the server
+void setNetClientControl(CarControl control, int state); // Keyboard; spectators: LEFT/RIGHT switch cars
+int updateNetClient(void);               // Once per tick. Returns 0 once the server is gone or the session ended
+// Copies the interpolated cars (the followed one first) and their lap timers. Returns the count.
+int getNetClientCars(Car* cars, LapTimer* timers, int maxCars);
+void stopNetClient(void);                // Tells the server and closes the socket
+void printNetClientStats(void);
+
+// Headless client with the autopilot driving (or spectating), for testing a server. Exit code.
+int runNetClientFromArgs(int argc, char** argv);
+
+#endif // NETCLIENT_H
@@ -0,0 +1,318 @@
+#include "offscreen.h" // Offscreen benchmark prototype and defaults
+#include <stdio.h>     // For printf, fprintf, snprintf
+
+#ifdef USE_EGL
+
+#include "game.h"      // renderRaceScene(), stepGame(), playerCars
+#include "ai.h"        // Autopilot drives the camera path
+#include "image.h"     // PNG frame dumps
+#include "timing.h"    // Wall-clock frame timing
+#include "track_mesh.h" // Submitted/culled geometry statistics
+#include "renderer.h"  // Render path selection and draw queue statistics
+#include "dynres.h"    // Optional dynamic resolution (dynres=<target ms>)
+#include "capture.h"   // Optional asynchronous recording (capture=<path>)
+#include "minimap.h"   // The one HUD element that needs no bitmap font
+#include "scenery.h"   // Trackside objects (scenery=<count>)
+#include "skidmarks.h" // Live tyre marks per frame
+#include "particles.h" // Smoke and sparks per frame
+#include "heatmap.h"   // Driving heatmap overlay (heatmap=<file.f1h>)
+#include <GL/glew.h>   // OpenGL (must come before other GL headers)
+#include <EGL/egl.h>   // Context creation without a window system
+#include <EGL/eglext.h> // EGL_PLATFORM_SURFACELESS_MESA
+#include <stdlib.h>    // For malloc, free, atoi, atof
+#include <string.h>    // For strncmp, strcmp
+#include <time.h>      // For clock (process CPU time)
+
+// --- Draw Call Counting ---
+// With OFFSCREEN_COUNT_DRAW_CALLS the linker routes every glBegin/glDrawArrays/glDrawElements
+// in the program through these wrappers (-Wl,--wrap=..., see Makefile), so the render code
+// itself stays untouched.
+#ifdef OFFSCREEN_COUNT_DRAW_CALLS
+static long drawCallCount = 0;
+
+void __real_glBegin(GLenum mode);
+void __real_glDrawArrays(GLenum mode, GLint first, GLsizei count);
+void __real_glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+
+void __wrap_glBegin(GLenum mode) { drawCallCount++; __real_glBegin(mode); }
+void __wrap_glDrawArrays(GLenum mode, GLint first, GLsizei count) { drawCallCount++; __real_glDrawArrays(mode, first, count); }
+void __wrap_glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    drawCallCount++;
+    __real_glDrawElements(mode, count, type, indices);
+}
+#define COUNTING_DRAW_CALLS 1
+#else
+static long drawCallCount = 0;
+#define COUNTING_DRAW_CALLS 0
+#endif
+
+// --- EGL Context ---
+static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+
+// Creates a pbuffer-backed desktop GL context and makes it current. Returns 1 on success.
+static int createOffscreenContext(int width, int height) {
+    eglDisplay = eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (eglDisplay == EGL_NO_DISPLAY) eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY); // Non-Mesa drivers
+    EGLint major, minor;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        fprintf(stderr, "Offscreen: no EGL display available (error 0x%x)\n", eglGetError());
+        return 0;
+    }
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(eglDisplay, configAttribs, &config, 1, &numConfigs) || numConfigs < 1) {
+        fprintf(stderr, "Offscreen: no pbuffer config with RGB8 + depth24\n");
+        return 0;
+    }
+
+    const EGLint surfaceAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+    EGLSurface surface = eglCreatePbufferSurface(eglDisplay, config, surfaceAttribs);
+    if (surface == EGL_NO_SURFACE) {
+        fprintf(stderr, "Offscreen: cannot create a %dx%d pbuffer (error 0x%x)\n", width, height, eglGetError());
+        return 0;
+    }
+
+    // Desktop GL compatibility context: the renderer uses the fixed-function pipeline
+    eglBindAPI(EGL_OPENGL_API);
+    EGLContext context = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, NULL);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(eglDisplay, surface, surface, context)) {
+        fprintf(stderr, "Offscreen: cannot create an OpenGL context (error 0x%x)\n", eglGetError());
+        return 0;
+    }
+
+    // GLEW built for GLX refuses to initialise without an X display; the function
+    // pointers can still be loaded from the current (EGL) context.
+    GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    if (err == GLEW_ERROR_NO_GLX_DISPLAY) err = glewContextInit();
+#endif
+    if (err != GLEW_OK) {
+        fprintf(stderr, "Offscreen: error initializing GLEW: %s\n", glewGetErrorString(err));
+        return 0;
+    }
+
+    printf("Offscreen: EGL %d.%d, %s, OpenGL %s, %dx%d\n", major, minor,
+           (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION), width, height);
+    return 1;
+}
+
+
+// --- Benchmark Run ---
+typedef struct {
+    TrackType tracks[NUM_TRACK_OPTIONS];
+    int numTracks;
+    int frames;
+    int width, height;
+    const char* pngPrefix; // NULL = no frame dumps
+    int pngEvery;
+    RenderPath pipeline;   // Requested render path (falls back to fixed-function)
+    double dynresTargetMs; // > 0: scale the scene resolution to this frame time
+    const char* capturePath; // NULL = no recording
+} OffscreenConfig;
+
+static const char* offscreenTrackNames[NUM_TRACK_OPTIONS] = { "rect", "round" };
+
+static int runOffscreenTrack(const OffscreenConfig* config, TrackType track, unsigned char* pixels) {
+    selectedTrackType = track;
+    initGame(); // Car at the start line, fresh lap timer
+    buildScenery(track); // As startGame() does
+    buildMinimap(track);
+    currentGameState = STATE_RACING;
+
+    double wallTotal = 0.0, wallMax = 0.0, cpuTotal = 0.0;
+    long drawCallsTotal = 0, trianglesTotal = 0, chunksDrawnTotal = 0, chunksCulledTotal = 0;
+    long lodGroupsTotal = 0, lodLevelTotal = 0;
+    long queuedTotal = 0, programChangesTotal = 0, bufferChangesTotal = 0;
+    long sceneryInstancesTotal = 0, sceneryCulledTotal = 0, sceneryDrawsTotal = 0;
+    long skidQuadsTotal = 0, particlesTotal = 0, particlesMax = 0;
+    double scaleTotal = 0.0;
+    float scaleMin = DYNRES_MAX_SCALE;
+    for (int frame = 0; frame < config->frames; ++frame) {
+        for (int p = 0; p < numPlayers; ++p) updateAIControls(&playerCars[p]);
+        stepGame();
+
+        // Time only the frame itself: submission, rasterisation (glFinish) and nothing else
+        clock_t cpuStart = clock();
+        double wallStart = getTimeSeconds();
+        drawCallCount = 0;
+        resetMeshStats();
+        resetSceneryStats();
+        beginDynamicResolution(config->width, config->height); // Clears; full size unless dynres= is given
+        renderRaceScene(dynRes.renderWidth, dynRes.renderHeight);
+        endDynamicResolution(config->width, config->height);
+        drawMinimap(config->width, config->height, playerCars, numPlayers, numPlayers > 1);
+        captureFrame(config->width, config->height);
+        glFinish();
+        double wall = getTimeSeconds() - wallStart;
+        scaleTotal += dynRes.scale;
+        if (dynRes.scale < scaleMin) scaleMin = dynRes.scale;
+        recordFrameTime(wall * 1000.0);
+        cpuTotal += (double)(clock() - cpuStart) / CLOCKS_PER_SEC;
+        wallTotal += wall;
+        if (wall > wallMax) wallMax = wall;
+        drawCallsTotal += drawCallCount;
+        trianglesTotal += meshStats.trianglesDrawn;
+        chunksDrawnTotal += meshStats.chunksDrawn;
+        chunksCulledTotal += meshStats.chunksCulled;
+        lodGroupsTotal += meshStats.lodGroupsDrawn;
+        lodLevelTotal += meshStats.lodLevelSum;
+        queuedTotal += renderStats.itemsSubmitted;
+        programChangesTotal += renderStats.pipelineChanges;
+        bufferChangesTotal += renderStats.bufferChanges;
+        sceneryInstancesTotal += sceneryStats.instancesDrawn;
+        sceneryCulledTotal += sceneryStats.chunksCulled;
+        sceneryDrawsTotal += sceneryStats.drawCalls;
+        skidQuadsTotal += skidMarkStats.quadsLive;
+        particlesTotal += particleStats.drawn;
+        if (particleStats.live > particlesMax) particlesMax = particleStats.live;
+
+        if (config->pngPrefix && frame % config->pngEvery == 0) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s_%s_%04d.png", config->pngPrefix, offscreenTrackNames[track], frame);
+            glReadPixels(0, 0, config->width, config->height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+            if (!writePNGFlipped(path, config->width, config->height, pixels)) return 0;
+        }
+    }
+
+    int frames = config->frames;
+    printf("Offscreen [%s]: %d frames, %.1f fps, wall %.3f ms/frame (max %.3f), CPU %.3f ms/frame",
+           offscreenTrackNames[track], frames, wallTotal > 0.0 ? frames / wallTotal : 0.0,
+           wallTotal * 1000.0 / frames, wallMax * 1000.0, cpuTotal * 1000.0 / frames);
+    if (COUNTING_DRAW_CALLS) printf(", %.1f draw calls/frame\n", (double)drawCallsTotal / frames);
+    else printf(", draw calls not counted (build with OFFSCREEN=1)\n");
+    printf("  track geometry: %.0f triangles/frame, %.1f chunks drawn, %.1f culled per frame\n",
+           (double)trianglesTotal / frames, (double)chunksDrawnTotal / frames, (double)chunksCulledTotal / frames);
+    if (lodGroupsTotal > 0) {
+        printf("  level of detail: %.1f groups drawn/frame, average level %.2f\n",
+               (double)lodGroupsTotal / frames, (double)lodLevelTotal / lodGroupsTotal);
+    }
+    if (sceneryObjectCount > 0) {
+        printf("  scenery: %.0f objects drawn/frame in %.1f draws, %.1f chunks culled\n",
+               (double)sceneryInstancesTotal / frames, (double)sceneryDrawsTotal / frames, (double)sceneryCulledTotal / frames);
+    }
+    printf("  skid marks: %ld quads laid, %.0f live/frame (ring of %d)\n",
+           skidMarkStats.quadsLaid, (double)skidQuadsTotal / frames, SKID_MAX_QUADS);
+    printf("  particles: %ld spawned (%ld dropped), %.0f drawn/frame, %ld live at most (pool of %d)\n",
+           particleStats.spawned, particleStats.dropped, (double)particlesTotal / frames, particlesMax, PARTICLE_MAX);
+    if (dynRes.enabled) {
+        printf("  dynamic resolution: scale %.2f average, %.2f min, %.2f at the end (last window %.2f ms/frame)\n",
+               scaleTotal / frames, scaleMin, dynRes.scale, dynRes.averageMs);
+    }
+    if (renderPath == RENDER_PATH_SHADER) {
+        printf("  shader path: %.1f draws queued/frame, %.1f program and %.1f vertex array binds/frame\n",
+               (double)queuedTotal / frames, (double)programChangesTotal / frames, (double)bufferChangesTotal / frames);
+    }
+    return 1;
+}
+
+int runOffscreenFromArgs(int argc, char** argv) {
+    OffscreenConfig config;
+    config.tracks[0] = TRACK_RECT;
+    config.tracks[1] = TRACK_ROUNDED;
+    config.numTracks = 2;
+    config.frames = OFFSCREEN_DEFAULT_FRAMES;
+    config.width = OFFSCREEN_DEFAULT_WIDTH;
+    config.height = OFFSCREEN_DEFAULT_HEIGHT;
+    config.pngPrefix = NULL;
+    config.pngEvery = OFFSCREEN_DEFAULT_PNG_EVERY;
+    config.pipeline = RENDER_PATH_SHADER;
+    config.dynresTargetMs = 0.0;
+    config.capturePath = NULL;
+
+    for (int i = 0; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "track=", 6) == 0) {
+            const char* value = arg + 6;
+            config.numTracks = 1;
+            if (strcmp(value, "rect") == 0) config.tracks[0] = TRACK_RECT;
+            else if (strcmp(value, "round") == 0) config.tracks[0] = TRACK_ROUNDED;
+            else if (strcmp(value, "both") == 0) config.numTracks = 2;
+            else { fprintf(stderr, "Offscreen: unknown track '%s' (rect|round|both)\n", value); return 1; }
+        } else if (strncmp(arg, "frames=", 7) == 0) {
+            config.frames = atoi(arg + 7);
+        } else if (strncmp(arg, "width=", 6) == 0) {
+            config.width = atoi(arg + 6);
+        } else if (strncmp(arg, "height=", 7) == 0) {
+            config.height = atoi(arg + 7);
+        } else if (strncmp(arg, "png=", 4) == 0) {
+            config.pngPrefix = arg + 4;
+        } else if (strncmp(arg, "every=", 6) == 0) {
+            config.pngEvery = atoi(arg + 6);
+        } else if (strncmp(arg, "dynres=", 7) == 0) {
+            config.dynresTargetMs = atof(arg + 7);
+        } else if (strncmp(arg, "scenery=", 8) == 0) {
+            sceneryObjectCount = atoi(arg + 8);
+        } else if (strncmp(arg, "heatmap=", 8) == 0) {
+            setHeatmapOverlayPath(arg + 8); // Drawn on the track it was collected on
+        } else if (strncmp(arg, "players=", 8) == 0) {
+            numPlayers = atoi(arg + 8); // Split-screen viewports, one autopilot car each
+            if (numPlayers < 1 || numPlayers > MAX_PLAYERS) {
+                fprintf(stderr, "Offscreen: players must be 1 to %d\n", MAX_PLAYERS);
+                return 1;
+            }
+        } else if (strncmp(arg, "capture=", 8) == 0) {
+            config.capturePath = arg + 8;
+        } else if (strncmp(arg, "pipeline=", 9) == 0) {
+            const char* value = arg + 9;
+            if (strcmp(value, "shader") == 0) config.pipeline = RENDER_PATH_SHADER;
+            else if (strcmp(value, "fixed") == 0) config.pipeline = RENDER_PATH_FIXED;
+            else { fprintf(stderr, "Offscreen: unknown pipeline '%s' (shader|fixed)\n", value); return 1; }
+        } else {
+            fprintf(stderr, "Offscreen: unknown option '%s'\n", arg);
+            return 1;
+        }
+    }
+    if (config.numTracks == 2) { config.tracks[0] = TRACK_RECT; config.tracks[1] = TRACK_ROUNDED; }
+    if (config.frames < 1) config.frames = 1;
+    if (config.width < 16) config.width = 16;
+    if (config.height < 16) config.height = 16;
+    if (config.pngEvery < 1) config.pngEvery = 1;
+
+    if (!createOffscreenContext(config.width, config.height)) return 1;
+    initRenderState();
+    selectRenderPath(config.pipeline);
+    if (config.dynresTargetMs > 0.0) initDynamicResolution(config.dynresTargetMs);
+    if (config.capturePath && !startCapture(config.capturePath)) return 1;
+    glViewport(0, 0, config.width, config.height);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1); // Tightly packed rows for the PNG writer
+
+    unsigned char* pixels = NULL;
+    if (config.pngPrefix) {
+        pixels = (unsigned char*)malloc((size_t)config.width * config.height * 3);
+        if (!pixels) { fprintf(stderr, "Offscreen: out of memory for frame dumps\n"); return 1; }
+    }
+
+    int ok = 1;
+    for (int t = 0; t < config.numTracks && ok; ++t) ok = runOffscreenTrack(&config, config.tracks[t], pixels);
+
+    free(pixels);
+    stopCapture();
+    shutdownDynamicResolution();
+    shutdownMinimap();
+    shutdownHeatmapOverlay();
+    freeScenery();
+    freeSkidMarks();
+    freeParticles();
+    shutdownRenderer();
+    eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglTerminate(eglDisplay);
+    return ok ? 0 : 1;
+}
+
+#else // !USE_EGL
+
+int runOffscreenFromArgs(int argc, char** argv) {
+    (void)argc; (void)argv;
+    fprintf(stderr, "Offscreen rendering is not available in this build (rebuild with OFFSCREEN=1, needs EGL)\n");
+    return 1;
+}
+
+#endif // USE_EGL
@@ -0,0 +1,22 @@
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+// --- Offscreen Render Benchmark ---
+// Renders the race scene without a window, through an EGL pbuffer on a surfaceless
+// display (e.g. Mesa llvmpipe on a headless CI box). The autopilot drives the car so the
+// chase camera follows the same path on every run (players=N: N cars, split-screen). Requires a build with USE_EGL
+// (see the Makefile's OFFSCREEN option); other builds print an error and return 1.
+
+#define OFFSCREEN_DEFAULT_WIDTH 1280
+#define OFFSCREEN_DEFAULT_HEIGHT 720
+#define OFFSCREEN_DEFAULT_FRAMES 600 // 10 s of driving per track at FRAME_RATE
+#define OFFSCREEN_DEFAULT_PNG_EVERY 60
+
+// Parses "track=rect|round|both frames=N width=W height=H png=PREFIX every=N",
+// renders each track and prints frames per second, CPU time per frame and draw calls.
+// With png=PREFIX, every Nth frame is written to PREFIX_<track>_<frame>.png. heatmap=FILE draws a
+// driving heatmap (heatmap.h) over its track.
+// Returns a process exit code.
+int runOffscreenFromArgs(int argc, char** argv);
+
+#endif // OFFSCREEN_H
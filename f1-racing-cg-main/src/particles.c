@@ -0,0 +1,327 @@
+#include "particles.h"  // ParticleStats and prototypes
+#include "skidmarks.h"  // getSkiddingWheels() (smoke comes from the same wheels as the marks)
+#include "renderer.h"   // ParticleInstance, instanced batch (shader path)
+#include <GL/glew.h>    // Client vertex arrays and the sprite texture (fixed-function path)
+#include <math.h>       // For sinf, cosf, sqrtf, fabsf
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Branch-free min/max (as in sensors.c), so the loops below vectorise
+#define PARTICLE_FMIN(a, b) ((a) < (b) ? (a) : (b))
+#define PARTICLE_FMAX(a, b) ((a) > (b) ? (a) : (b))
+
+#define PARTICLE_NEAR 0.1f          // Closer to the camera than this (or behind it) is not drawn
+#define PARTICLE_TEXTURE_SIZE 32    // Fixed-function sprite
+#define SMOKE_PER_WHEEL 1           // Per sliding wheel per tick
+#define SPARKS_PER_SPEED 1.5f       // Sparks per unit of speed lost in a wall contact
+#define SPARKS_MIN 4
+#define SPARKS_MAX 60
+
+ParticleStats particleStats = { 0, 0, 0, 0 };
+
+// --- Pool (structure of arrays) ---
+// Live particles are [0, numLive); the order is arbitrary (removal swaps with the last).
+static float posX[PARTICLE_MAX], posY[PARTICLE_MAX], posZ[PARTICLE_MAX];
+static float velX[PARTICLE_MAX], velY[PARTICLE_MAX], velZ[PARTICLE_MAX];
+static float age[PARTICLE_MAX], life[PARTICLE_MAX];
+static float size[PARTICLE_MAX], growth[PARTICLE_MAX]; // Edge length and its change per second
+static float gravity[PARTICLE_MAX];  // Downward acceleration (negative rises: smoke)
+static float drag[PARTICLE_MAX];     // Velocity lost per second, as a fraction
+static float bounce[PARTICLE_MAX];   // Vertical speed kept when hitting the ground
+static unsigned char baseColor[PARTICLE_MAX][4]; // Premultiplied RGBA at birth
+static int numLive = 0;
+
+// --- Per-Frame Batch ---
+static float depth[PARTICLE_MAX];          // Along the view direction
+static unsigned short sortKey[PARTICLE_MAX]; // Bucket, 0 = farthest
+static int sortOrder[PARTICLE_MAX];        // Pool indices, back to front
+static ParticleInstance batch[PARTICLE_MAX];
+static int bucketStart[PARTICLE_SORT_BUCKETS];
+
+// Fixed-function path: each instance expanded to a textured quad
+typedef struct {
+    float x, y, z;
+    float u, v;
+    unsigned char color[4];
+} SpriteVertex;
+
+static SpriteVertex spriteVertices[PARTICLE_MAX * 4];
+static GLuint spriteTexture = 0;
+
+// --- Random Numbers ---
+// xorshift32, as scenery.c: the same ticks give the same particles
+static unsigned int particleRandomState = 0x9E3779B9u;
+
+static float randomRange(float low, float high) {
+    particleRandomState ^= particleRandomState << 13;
+    particleRandomState ^= particleRandomState >> 17;
+    particleRandomState ^= particleRandomState << 5;
+    return low + (high - low) * (float)(particleRandomState >> 8) / 16777216.0f;
+}
+
+
+// --- Emission ---
+void clearParticles() {
+    numLive = 0;
+    particleStats.live = particleStats.drawn = 0;
+    particleStats.spawned = particleStats.dropped = 0;
+}
+
+// Returns the new particle's index, or -1 when the pool is full
+static int spawnParticle() {
+    if (numLive == PARTICLE_MAX) { particleStats.dropped++; return -1; }
+    particleStats.spawned++;
+    int i = numLive++;
+    age[i] = 0.0f;
+    return i;
+}
+
+static void setColor(int i, float r, float g, float b, float a) {
+    baseColor[i][0] = (unsigned char)(r * 255.0f);
+    baseColor[i][1] = (unsigned char)(g * 255.0f);
+    baseColor[i][2] = (unsigned char)(b * 255.0f);
+    baseColor[i][3] = (unsigned char)(a * 255.0f);
+}
+
+// Grey puffs that rise slowly, spread, and drift a little with the car
+void emitTireSmoke(float x, float z, float driftX, float driftZ, int count) {
+    for (int n = 0; n < count; ++n) {
+        int i = spawnParticle();
+        if (i < 0) return;
+        posX[i] = x + randomRange(-0.1f, 0.1f);
+        posY[i] = 0.15f;
+        posZ[i] = z + randomRange(-0.1f, 0.1f);
+        velX[i] = driftX + randomRange(-0.5f, 0.5f);
+        velY[i] = randomRange(0.4f, 1.0f);
+        velZ[i] = driftZ + randomRange(-0.5f, 0.5f);
+        life[i] = randomRange(1.5f, 2.5f);
+        size[i] = randomRange(0.4f, 0.6f);
+        growth[i] = randomRange(0.8f, 1.4f);
+        gravity[i] = -0.2f;
+        drag[i] = 1.2f;
+        bounce[i] = 0.0f;
+        float grey = randomRange(0.65f, 0.8f), opacity = 0.35f;
+        setColor(i, grey * opacity, grey * opacity, grey * opacity, opacity);
+    }
+}
+
+// Small, bright, additive (alpha 0), thrown back from the contact and bouncing on the ground
+void emitSparks(float x, float y, float z, float dirX, float dirZ, float speed, int count) {
+    for (int n = 0; n < count; ++n) {
+        int i = spawnParticle();
+        if (i < 0) return;
+        float spread = randomRange(-1.2f, 1.2f); // Radians around the rebound direction
+        float c = cosf(spread), s = sinf(spread);
+        float out = speed * randomRange(0.3f, 0.8f);
+        posX[i] = x;
+        posY[i] = y;
+        posZ[i] = z;
+        velX[i] = -(dirX * c - dirZ * s) * out;
+        velY[i] = randomRange(2.0f, 6.0f);
+        velZ[i] = -(dirX * s + dirZ * c) * out;
+        life[i] = randomRange(0.25f, 0.6f);
+        size[i] = randomRange(0.15f, 0.3f);
+        growth[i] = -0.2f;
+        gravity[i] = 20.0f;
+        drag[i] = 0.5f;
+        bounce[i] = 0.4f;
+        setColor(i, 1.0f, randomRange(0.6f, 0.85f), 0.25f, 0.0f);
+    }
+}
+
+void emitCarParticles(const Car* car, float speedBeforeTick, int hitWall) {
+    float angleRad = car->angle * (float)M_PI / 180.0f;
+    float forwardX = sinf(angleRad), forwardZ = cosf(angleRad); // Heading, as updateCar()
+
+    float wheel[4][2];
+    int sliding = getSkiddingWheels(car, wheel);
+    if (sliding) {
+        float driftX = forwardX * car->speed * 0.15f, driftZ = forwardZ * car->speed * 0.15f;
+        for (int w = 0; w < 4; ++w) {
+            if (sliding & (1 << w)) emitTireSmoke(wheel[w][0], wheel[w][1], driftX, driftZ, SMOKE_PER_WHEEL);
+        }
+    }
+
+    if (hitWall) {
+        float speed = fabsf(speedBeforeTick);
+        int count = (int)(speed * SPARKS_PER_SPEED);
+        if (count < SPARKS_MIN) count = SPARKS_MIN;
+        if (count > SPARKS_MAX) count = SPARKS_MAX;
+        float side = speedBeforeTick >= 0.0f ? 1.0f : -1.0f; // Reversing into a wall hits the tail
+        float halfLength = car->length * 0.5f * side;
+        emitSparks(car->x + forwardX * halfLength, 0.2f, car->z + forwardZ * halfLength,
+                   forwardX * side, forwardZ * side, speed + 2.0f, count);
+    }
+}
+
+
+// --- Update (once per simulation tick) ---
+void updateParticles(float deltaTime) {
+    int n = numLive;
+    // Integration: straight-line float arithmetic with selects, no branches or calls
+    for (int i = 0; i < n; ++i) {
+        float keep = PARTICLE_FMAX(1.0f - drag[i] * deltaTime, 0.0f);
+        float vy = (velY[i] - gravity[i] * deltaTime) * keep;
+        float vx = velX[i] * keep;
+        float vz = velZ[i] * keep;
+        float y = posY[i] + vy * deltaTime;
+        int below = y < 0.0f;
+        posY[i] = below ? 0.0f : y;
+        velY[i] = below ? -vy * bounce[i] : vy;
+        velX[i] = vx;
+        velZ[i] = vz;
+        posX[i] += vx * deltaTime;
+        posZ[i] += vz * deltaTime;
+        age[i] += deltaTime;
+        size[i] = PARTICLE_FMAX(size[i] + growth[i] * deltaTime, 0.01f);
+    }
+
+    // Removal: swap the last live particle into each dead slot (walking down, the last is always checked)
+    for (int i = n - 1; i >= 0; --i) {
+        if (age[i] < life[i]) continue;
+        int last = --n;
+        posX[i] = posX[last]; posY[i] = posY[last]; posZ[i] = posZ[last];
+        velX[i] = velX[last]; velY[i] = velY[last]; velZ[i] = velZ[last];
+        age[i] = age[last]; life[i] = life[last];
+        size[i] = size[last]; growth[i] = growth[last];
+        gravity[i] = gravity[last]; drag[i] = drag[last]; bounce[i] = bounce[last];
+        for (int k = 0; k < 4; ++k) baseColor[i][k] = baseColor[last][k];
+    }
+    numLive = n;
+    particleStats.live = n;
+}
+
+
+// --- Batch (once per frame) ---
+int buildParticleBatch(const float eye[3], const float right[3], const float up[3]) {
+    int n = numLive;
+    particleStats.drawn = 0;
+    if (n == 0) return 0;
+
+    // View direction = up x right (right = forward x worldUp, up = right x forward)
+    float fx = up[1] * right[2] - up[2] * right[1];
+    float fy = up[2] * right[0] - up[0] * right[2];
+    float fz = up[0] * right[1] - up[1] * right[0];
+
+    // Depths and their range (vectorised reductions)
+    float nearest = 1e30f, farthest = -1e30f;
+    for (int i = 0; i < n; ++i) {
+        float d = (posX[i] - eye[0]) * fx + (posY[i] - eye[1]) * fy + (posZ[i] - eye[2]) * fz;
+        depth[i] = d;
+        nearest = PARTICLE_FMIN(nearest, d);
+        farthest = PARTICLE_FMAX(farthest, d);
+    }
+    nearest = PARTICLE_FMAX(nearest, PARTICLE_NEAR);
+    if (farthest < PARTICLE_NEAR) return 0; // All behind the camera
+    float toBucket = (PARTICLE_SORT_BUCKETS - 1) / PARTICLE_FMAX(farthest - nearest, 1e-3f);
+
+    // Counting sort on quantised depth: histogram, prefix sum, scatter. Bucket 0 is the farthest.
+    for (int b = 0; b < PARTICLE_SORT_BUCKETS; ++b) bucketStart[b] = 0;
+    int visible = 0;
+    for (int i = 0; i < n; ++i) {
+        if (depth[i] < PARTICLE_NEAR) { sortKey[i] = 0xFFFF; continue; }
+        int key = (int)((farthest - depth[i]) * toBucket);
+        if (key > PARTICLE_SORT_BUCKETS - 1) key = PARTICLE_SORT_BUCKETS - 1; // Rounding at the near end
+        sortKey[i] = (unsigned short)key;
+        bucketStart[key]++;
+        visible++;
+    }
+    int offset = 0;
+    for (int b = 0; b < PARTICLE_SORT_BUCKETS; ++b) {
+        int count = bucketStart[b];
+        bucketStart[b] = offset;
+        offset += count;
+    }
+    for (int i = 0; i < n; ++i) {
+        if (sortKey[i] != 0xFFFF) sortOrder[bucketStart[sortKey[i]]++] = i;
+    }
+
+    // Instances in draw order, colour faded with age
+    for (int j = 0; j < visible; ++j) {
+        int i = sortOrder[j];
+        float fade = 1.0f - age[i] / life[i];
+        ParticleInstance* out = &batch[j];
+        out->x = posX[i]; out->y = posY[i]; out->z = posZ[i];
+        out->size = size[i];
+        for (int k = 0; k < 4; ++k) out->color[k] = (unsigned char)(baseColor[i][k] * fade);
+    }
+    particleStats.drawn = visible;
+    return visible;
+}
+
+// White disc fading to the edge, premultiplied (matches the shader path's fragment shader)
+static void createSpriteTexture() {
+    unsigned char texels[PARTICLE_TEXTURE_SIZE][PARTICLE_TEXTURE_SIZE][4];
+    for (int y = 0; y < PARTICLE_TEXTURE_SIZE; ++y) {
+        for (int x = 0; x < PARTICLE_TEXTURE_SIZE; ++x) {
+            float u = (x + 0.5f) / PARTICLE_TEXTURE_SIZE - 0.5f, v = (y + 0.5f) / PARTICLE_TEXTURE_SIZE - 0.5f;
+            float f = 1.0f - 2.0f * sqrtf(u * u + v * v);
+            f = f < 0.0f ? 0.0f : f;
+            unsigned char value = (unsigned char)(f * f * 255.0f);
+            for (int k = 0; k < 4; ++k) texels[y][x][k] = value;
+        }
+    }
+    glGenTextures(1, &spriteTexture);
+    glBindTexture(GL_TEXTURE_2D, spriteTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, PARTICLE_TEXTURE_SIZE, PARTICLE_TEXTURE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void renderParticles(const float eye[3], const float right[3], const float up[3]) {
+    int count = buildParticleBatch(eye, right, up);
+    if (count == 0) return;
+    if (renderPath == RENDER_PATH_SHADER) {
+        submitParticleBatch(batch, count, right, up); // One instanced draw, blended after everything else
+        return;
+    }
+
+    // Fixed-function path: expand each instance into a quad around its centre
+    const float corner[4][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+    for (int j = 0; j < count; ++j) {
+        const ParticleInstance* p = &batch[j];
+        for (int k = 0; k < 4; ++k) {
+            SpriteVertex* v = &spriteVertices[j * 4 + k];
+            float a = corner[k][0] * p->size, b = corner[k][1] * p->size;
+            v->x = p->x + right[0] * a + up[0] * b;
+            v->y = p->y + right[1] * a + up[1] * b;
+            v->z = p->z + right[2] * a + up[2] * b;
+            v->u = corner[k][0] + 0.5f;
+            v->v = corner[k][1] + 0.5f;
+            v->color[0] = p->color[0]; v->color[1] = p->color[1];
+            v->color[2] = p->color[2]; v->color[3] = p->color[3];
+        }
+    }
+    if (!spriteTexture) createSpriteTexture();
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_TEXTURE_BIT);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // Premultiplied (see ParticleInstance)
+    glDepthMask(GL_FALSE);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, spriteTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(SpriteVertex), &spriteVertices[0].x);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(SpriteVertex), &spriteVertices[0].u);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(SpriteVertex), spriteVertices[0].color);
+    glDrawArrays(GL_QUADS, 0, count * 4);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPopAttrib();
+}
+
+void freeParticles() {
+    clearParticles();
+    if (spriteTexture) glDeleteTextures(1, &spriteTexture);
+    spriteTexture = 0;
+}
@@ -0,0 +1,41 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "car.h" // Car (emitters follow the wheels and the nose)
+
+// --- Particles ---
+// Tyre smoke from sliding wheels and sparks from wall contacts. Particles live in a fixed pool
+// stored as one array per attribute (structure of arrays): the per-tick update is a branch-free
+// loop over plain float arrays that the compiler vectorises, dead particles are swapped with the
+// last live one, and nothing is allocated after startup (a full pool drops new particles).
+// Each frame the live particles are ordered back to front with a counting sort on quantised
+// depth and drawn as one batch of camera-facing quads (instanced on the shader path).
+
+#define PARTICLE_MAX 20480       // Pool size; the budget is 20k live particles in under 1 ms per frame
+#define PARTICLE_SORT_BUCKETS 1024 // Depth resolution of the back-to-front sort
+
+// --- Statistics ---
+typedef struct {
+    int live;             // In the pool after the last update
+    int drawn;            // In front of the camera at the last buildParticleBatch()
+    long spawned, dropped; // Since the last clearParticles(); dropped = pool was full
+} ParticleStats;
+
+extern ParticleStats particleStats;
+
+// --- Function Declarations ---
+void clearParticles(void);
+// Per simulation tick: smoke from the wheels that slide (see getSkiddingWheels), and a burst of
+// sparks at the nose (or tail, reversing) when the tick ended in a wall contact.
+void emitCarParticles(const Car* car, float speedBeforeTick, int hitWall);
+void emitTireSmoke(float x, float z, float driftX, float driftZ, int count);
+void emitSparks(float x, float y, float z, float dirX, float dirZ, float speed, int count);
+void updateParticles(float deltaTime); // Per simulation tick
+
+// Per frame: sorts and fills the batch (returns its size, no GL calls), then draws it.
+// right and up are the camera's unit axes; eye its position.
+int buildParticleBatch(const float eye[3], const float right[3], const float up[3]);
+void renderParticles(const float eye[3], const float right[3], const float up[3]);
+void freeParticles(void); // GL resources of the fixed-function path
+
+#endif // PARTICLES_H
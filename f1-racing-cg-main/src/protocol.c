@@ -0,0 +1,189 @@
+#include "protocol.h"
+#include "net.h"    // putU32, getU32
+#include <math.h>   // For floorf, fmodf
+#include <string.h> // For memset
+
+// --- Bit Packing ---
+// Fields are written least significant bit first into a 64-bit accumulator that is flushed a
+// byte at a time, so a field can straddle bytes and a car needn't start on a byte boundary.
+typedef struct {
+    unsigned char* p;
+    unsigned long long bits;
+    int count;             // Bits waiting in 'bits'
+} BitWriter;
+
+typedef struct {
+    const unsigned char* p;
+    const unsigned char* end;
+    unsigned long long bits;
+    int count;
+    int overrun;           // Read past the end of the packet
+} BitReader;
+
+static void putBits(BitWriter* w, unsigned int value, int width) {
+    w->bits |= (unsigned long long)(value & ((1u << width) - 1u)) << w->count;
+    w->count += width;
+    while (w->count >= 8) { *w->p++ = (unsigned char)w->bits; w->bits >>= 8; w->count -= 8; }
+}
+
+static void flushBits(BitWriter* w) {
+    if (w->count > 0) *w->p++ = (unsigned char)w->bits; // Padding bits are zero
+    w->bits = 0;
+    w->count = 0;
+}
+
+static unsigned int getBits(BitReader* r, int width) {
+    while (r->count < width) {
+        if (r->p >= r->end) { r->overrun = 1; return 0; }
+        r->bits |= (unsigned long long)*r->p++ << r->count;
+        r->count += 8;
+    }
+    unsigned int value = (unsigned int)(r->bits & ((1ull << width) - 1ull));
+    r->bits >>= width;
+    r->count -= width;
+    return value;
+}
+
+// Each of x, z, angle and speed is a 2-bit class followed by a signed delta of the class's
+// width; class 0 means unchanged. The widths fit what one snapshot interval (or a few, after
+// loss) usually moves a car: at 1/32 unit steps a car at top speed covers ~60 steps per snapshot.
+typedef struct { int widths[3]; } FieldClasses;
+enum { FIELD_X, FIELD_Z, FIELD_ANGLE, FIELD_SPEED, FIELD_COUNT };
+static const FieldClasses fieldClasses[FIELD_COUNT] = {
+    { { 6, 10, 20 } },   // x: ±31, ±511, anything on a track (±16 k units)
+    { { 6, 10, 20 } },   // z
+    { { 5, 8, 12 } },    // angle: ±2.6°, ±22°, a full turn
+    { { 4, 7, 12 } },    // speed: ±0.5, ±4, ±128 units/s
+};
+#define LAPS_BITS 16
+#define CONTROLS_BITS NUM_CAR_CONTROLS // One per CAR_CONTROL_*
+
+static void putDelta(BitWriter* w, int field, int delta) {
+    if (delta == 0) { putBits(w, 0, 2); return; }
+    for (int c = 0; c < 3; ++c) {
+        int width = fieldClasses[field].widths[c];
+        int limit = 1 << (width - 1);
+        if (delta >= -limit && delta < limit) {
+            putBits(w, (unsigned int)(c + 1), 2);
+            putBits(w, (unsigned int)delta, width); // Two's complement, sign-extended on read
+            return;
+        }
+    }
+    // Out of range for the widest class (a teleport): the encoder never sends a delta for it,
+    // see encodeSnapshot(), so this isn't reached.
+    putBits(w, 0, 2);
+}
+
+static int getDelta(BitReader* r, int field) {
+    int c = (int)getBits(r, 2);
+    if (c == 0) return 0;
+    int width = fieldClasses[field].widths[c - 1];
+    unsigned int raw = getBits(r, width);
+    unsigned int sign = 1u << (width - 1);
+    return (int)(raw ^ sign) - (int)sign;
+}
+
+static int fitsDelta(int field, int delta) {
+    int limit = 1 << (fieldClasses[field].widths[2] - 1);
+    return delta >= -limit && delta < limit;
+}
+
+
+// --- Quantisation ---
+void packCarState(const Car* car, int laps, NetCarState* state) {
+    state->x = (int)floorf(car->x * NET_POSITION_SCALE + 0.5f);
+    state->z = (int)floorf(car->z * NET_POSITION_SCALE + 0.5f);
+    state->angle = (int)floorf(fmodf(car->angle + 360.0f, 360.0f) * (NET_ANGLE_STEPS / 360.0f) + 0.5f) % NET_ANGLE_STEPS;
+    state->speed = (int)floorf(car->speed * NET_SPEED_SCALE + 0.5f);
+    state->laps = laps;
+    state->controls = getCarControlBits(car);
+}
+
+void unpackCarState(const NetCarState* state, Car* car) {
+    car->x = state->x / NET_POSITION_SCALE;
+    car->z = state->z / NET_POSITION_SCALE;
+    car->angle = state->angle * (360.0f / NET_ANGLE_STEPS);
+    car->speed = state->speed / NET_SPEED_SCALE;
+    setCarControlBits(car, (unsigned char)state->controls);
+}
+
+int getSnapshotSlot(long tick) {
+    return (int)((tick / PROTOCOL_SNAPSHOT_INTERVAL) & (PROTOCOL_SNAPSHOT_HISTORY - 1));
+}
+
+
+// --- Encoding ---
+// Angles wrap, so their delta is taken the short way round
+static int wrapAngleDelta(int delta) {
+    delta %= NET_ANGLE_STEPS;
+    if (delta >= NET_ANGLE_STEPS / 2) delta -= NET_ANGLE_STEPS;
+    else if (delta < -NET_ANGLE_STEPS / 2) delta += NET_ANGLE_STEPS;
+    return delta;
+}
+
+int encodeSnapshot(const NetSnapshot* snapshot, const NetSnapshot* base, unsigned char* packet) {
+    static const NetCarState zero; // Base for cars the base snapshot doesn't have
+    long age = base ? (snapshot->tick - base->tick) / PROTOCOL_SNAPSHOT_INTERVAL : 0;
+    if (age <= 0 || age >= PROTOCOL_SNAPSHOT_HISTORY) { base = NULL; age = 0; }
+    // A position the widest delta can't reach (only far outside any track) forces a full snapshot
+    for (int c = 0; base && c < PROTOCOL_MAX_CARS; ++c) {
+        if (!(snapshot->present & base->present & (1u << c))) continue;
+        if (!fitsDelta(FIELD_X, snapshot->cars[c].x - base->cars[c].x) ||
+            !fitsDelta(FIELD_Z, snapshot->cars[c].z - base->cars[c].z)) { base = NULL; age = 0; }
+    }
+
+    packet[0] = PACKET_SNAPSHOT;
+    putU32(packet + 1, (unsigned int)snapshot->tick);
+    packet[5] = (unsigned char)age;
+    packet[6] = (unsigned char)snapshot->present;
+    BitWriter w = { packet + PROTOCOL_SNAPSHOT_HEADER_BYTES, 0, 0 };
+    for (int c = 0; c < PROTOCOL_MAX_CARS; ++c) {
+        if (!(snapshot->present & (1u << c))) continue;
+        const NetCarState* s = &snapshot->cars[c];
+        const NetCarState* b = (base && (base->present & (1u << c))) ? &base->cars[c] : &zero;
+        putDelta(&w, FIELD_X, s->x - b->x);
+        putDelta(&w, FIELD_Z, s->z - b->z);
+        putDelta(&w, FIELD_ANGLE, wrapAngleDelta(s->angle - b->angle));
+        putDelta(&w, FIELD_SPEED, s->speed - b->speed);
+        putBits(&w, s->laps != b->laps, 1);
+        if (s->laps != b->laps) putBits(&w, (unsigned int)s->laps, LAPS_BITS);
+        putBits(&w, s->controls != b->controls, 1);
+        if (s->controls != b->controls) putBits(&w, (unsigned int)s->controls, CONTROLS_BITS);
+    }
+    flushBits(&w);
+    return (int)(w.p - packet);
+}
+
+int decodeSnapshot(const unsigned char* packet, int length, const NetSnapshot* history, NetSnapshot* snapshot) {
+    static const NetCarState zero;
+    if (length < PROTOCOL_SNAPSHOT_HEADER_BYTES || packet[0] != PACKET_SNAPSHOT) return 0;
+    long tick = (long)getU32(packet + 1);
+    int age = packet[5];
+    const NetSnapshot* base = NULL;
+    if (age > 0) {
+        long baseTick = tick - (long)age * PROTOCOL_SNAPSHOT_INTERVAL;
+        base = &history[getSnapshotSlot(baseTick)];
+        if (age >= PROTOCOL_SNAPSHOT_HISTORY || base->tick != baseTick) return 0; // Base already overwritten
+    }
+
+    NetSnapshot decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    decoded.tick = tick;
+    decoded.present = packet[6];
+    BitReader r = { packet + PROTOCOL_SNAPSHOT_HEADER_BYTES, packet + length, 0, 0, 0 };
+    for (int c = 0; c < PROTOCOL_MAX_CARS; ++c) {
+        if (!(decoded.present & (1u << c))) continue;
+        const NetCarState* b = (base && (base->present & (1u << c))) ? &base->cars[c] : &zero;
+        NetCarState* s = &decoded.cars[c];
+        s->x = b->x + getDelta(&r, FIELD_X);
+        s->z = b->z + getDelta(&r, FIELD_Z);
+        int angle = b->angle + getDelta(&r, FIELD_ANGLE);
+        s->angle = (angle % NET_ANGLE_STEPS + NET_ANGLE_STEPS) % NET_ANGLE_STEPS;
+        s->speed = b->speed + getDelta(&r, FIELD_SPEED);
+        s->laps = getBits(&r, 1) ? (int)getBits(&r, LAPS_BITS) : b->laps;
+        s->controls = getBits(&r, 1) ? (int)getBits(&r, CONTROLS_BITS) : b->controls;
+    }
+    if (r.overrun) return 0; // Truncated
+    *snapshot = decoded;
+    return 1;
+}
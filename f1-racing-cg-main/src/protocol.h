@@ -0,0 +1,75 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "car.h" // Car (packed into snapshots), control bits
+
+// --- Dedicated Server Protocol ---
+// Client/server races over UDP (see server/ and README): the server owns the simulation, clients
+// send their controls and receive snapshots of every car in their session. A snapshot is encoded
+// as a delta against the newest snapshot the client has acknowledged, so a car that keeps its
+// speed and line costs a few bytes, and a lost packet only means the next delta is against an
+// older base. Both sides keep the last PROTOCOL_SNAPSHOT_HISTORY snapshots as possible bases.
+// Spectators join the same way but get no car: they receive the snapshots of a running session.
+//
+// Packets (multi-byte fields little-endian):
+//   JOIN     (client):  type, version, track wish (TrackType, or PROTOCOL_ANY_TRACK), [flags]
+//   WELCOME  (server):  type, version, track, car slot (PROTOCOL_NO_CAR for spectators), session id(2)
+//   FULL     (server):  type (no free session or car; for spectators: no session to watch)
+//   INPUT    (client):  type, control bits, acknowledged snapshot tick(4) (PROTOCOL_NO_TICK = none)
+//   SNAPSHOT (server):  type, tick(4), base age(1), present car bits(1), bit-packed cars (below)
+//   LEAVE    (client):  type
+//
+// Each present car is a bit-packed delta against the same car in the base (or against zero if
+// the base doesn't have it): x, z, angle and speed each take a 2-bit size class (unchanged, or a
+// small / medium / large signed delta), then laps and controls a 1-bit "changed" flag each. A car
+// holding its line costs 2-3 bytes, one braking and turning 5-6; racing cars average under 5.
+
+#define PROTOCOL_VERSION 2            // 2: bit-packed snapshots, spectators
+#define PROTOCOL_DEFAULT_PORT 27016
+#define PROTOCOL_SNAPSHOT_INTERVAL 3  // Ticks between snapshots (20 per second at 60 Hz)
+#define PROTOCOL_SNAPSHOT_HISTORY 32  // Snapshots kept as delta bases on both sides (power of two)
+#define PROTOCOL_MAX_CARS 8           // Cars per session (one bit each in the present mask)
+#define PROTOCOL_ANY_TRACK 255
+#define PROTOCOL_NO_CAR 255
+#define PROTOCOL_NO_TICK 0xFFFFFFFFu
+#define PROTOCOL_JOIN_SPECTATE 1      // JOIN flag: watch a session instead of driving
+#define PROTOCOL_SNAPSHOT_HEADER_BYTES 7
+#define PROTOCOL_MAX_SNAPSHOT_BYTES (PROTOCOL_SNAPSHOT_HEADER_BYTES + PROTOCOL_MAX_CARS * 12) // Every field at its largest
+
+enum { PACKET_JOIN = 1, PACKET_WELCOME, PACKET_FULL, PACKET_INPUT, PACKET_SNAPSHOT, PACKET_LEAVE };
+
+// --- Quantised Car State ---
+// What a client needs to draw a car, in integer steps so deltas are exact on both sides.
+// Finer than anything visible once interpolated, coarse enough to keep the deltas short.
+#define NET_POSITION_SCALE 32.0f  // Steps per unit (3 cm)
+#define NET_SPEED_SCALE 16.0f     // Steps per unit/s
+#define NET_ANGLE_STEPS 4096      // Steps per full turn (0.09 degrees)
+
+typedef struct {
+    int x, z;          // Position in 1/32 units
+    int angle;         // 0..NET_ANGLE_STEPS-1
+    int speed;         // 1/16 units per second
+    int laps;          // Laps completed
+    int controls;      // Control bits (getCarControlBits), for brake lights and tyre effects
+} NetCarState;
+
+typedef struct {
+    long tick;                       // Server tick, -1 = empty slot
+    unsigned int present;            // Bit per car slot in use
+    NetCarState cars[PROTOCOL_MAX_CARS];
+} NetSnapshot;
+
+// --- Function Declarations ---
+void packCarState(const Car* car, int laps, NetCarState* state);
+void unpackCarState(const NetCarState* state, Car* car); // Pose, speed and controls; the rest is left alone
+
+// Writes a SNAPSHOT packet for 'snapshot' as a delta against 'base' (NULL = full snapshot; the
+// base must be an older snapshot the receiver has). Returns the packet length.
+int encodeSnapshot(const NetSnapshot* snapshot, const NetSnapshot* base, unsigned char* packet);
+// Reads a SNAPSHOT packet. 'history' is the receiver's ring of PROTOCOL_SNAPSHOT_HISTORY decoded
+// snapshots (slot = tick / PROTOCOL_SNAPSHOT_INTERVAL % PROTOCOL_SNAPSHOT_HISTORY), where the base
+// is looked up. Returns 1 on success, 0 if the packet is malformed or its base is gone.
+int decodeSnapshot(const unsigned char* packet, int length, const NetSnapshot* history, NetSnapshot* snapshot);
+int getSnapshotSlot(long tick);
+
+#endif // PROTOCOL_H
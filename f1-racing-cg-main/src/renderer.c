@@ -0,0 +1,675 @@
+#include "renderer.h" // RenderPath, pipelines and prototypes
+#include <GL/glew.h>  // OpenGL 3.3 entry points (shaders, VAOs, uniform buffers)
+#include <stdio.h>    // For printf, fprintf
+#include <stdlib.h>   // For realloc, free, qsort
+#include <stddef.h>   // For offsetof
+
+RenderPath renderPath = RENDER_PATH_FIXED;
+RenderStats renderStats = { 0, 0, 0, 0 };
+
+#define CAMERA_UBO_BINDING 0 // Uniform buffer binding point of the Camera block
+
+// --- Shaders ---
+// Both programs read the camera from the same std140 block, so one buffer update per frame
+// serves every pipeline.
+static const char* vertexColorVS =
+    "#version 330 core\n"
+    "layout(std140) uniform Camera { mat4 viewProjection; };\n"
+    "layout(location = 0) in vec3 position;\n"
+    "layout(location = 1) in vec4 color;\n"
+    "out vec4 vColor;\n"
+    "void main() {\n"
+    "    vColor = color;\n"
+    "    gl_Position = viewProjection * vec4(position, 1.0);\n"
+    "}\n";
+static const char* vertexColorFS =
+    "#version 330 core\n"
+    "in vec4 vColor;\n"
+    "out vec4 fragColor;\n"
+    "void main() { fragColor = vColor; }\n";
+
+static const char* solidVS =
+    "#version 330 core\n"
+    "layout(std140) uniform Camera { mat4 viewProjection; };\n"
+    "uniform mat4 model;\n"
+    "layout(location = 0) in vec3 position;\n"
+    "void main() { gl_Position = viewProjection * model * vec4(position, 1.0); }\n";
+static const char* solidFS =
+    "#version 330 core\n"
+    "uniform vec4 color;\n"
+    "out vec4 fragColor;\n"
+    "void main() { fragColor = color; }\n";
+
+// Position and colour per vertex, placement per instance (see MeshInstance)
+static const char* instancedVS =
+    "#version 330 core\n"
+    "layout(std140) uniform Camera { mat4 viewProjection; };\n"
+    "layout(location = 0) in vec3 position;\n"
+    "layout(location = 1) in vec4 color;\n"
+    "layout(location = 2) in vec4 instance; // x, z, heading, scale\n"
+    "out vec4 vColor;\n"
+    "void main() {\n"
+    "    vec3 p = position * instance.w;\n"
+    "    float c = cos(instance.z), s = sin(instance.z);\n"
+    "    vec3 world = vec3(instance.x + c * p.x + s * p.z, p.y, instance.y - s * p.x + c * p.z);\n"
+    "    vColor = color;\n"
+    "    gl_Position = viewProjection * vec4(world, 1.0);\n"
+    "}\n";
+
+// Quad corners around the particle centre, premultiplied colour faded towards the edge
+static const char* particleVS =
+    "#version 330 core\n"
+    "layout(std140) uniform Camera { mat4 viewProjection; };\n"
+    "uniform vec3 cameraRight, cameraUp;\n"
+    "layout(location = 0) in vec2 corner;   // -0.5 .. 0.5\n"
+    "layout(location = 2) in vec4 particle; // x, y, z, size\n"
+    "layout(location = 3) in vec4 color;\n"
+    "out vec4 vColor;\n"
+    "out vec2 vCorner;\n"
+    "void main() {\n"
+    "    vec3 world = particle.xyz + (cameraRight * corner.x + cameraUp * corner.y) * particle.w;\n"
+    "    vColor = color;\n"
+    "    vCorner = corner;\n"
+    "    gl_Position = viewProjection * vec4(world, 1.0);\n"
+    "}\n";
+static const char* particleFS =
+    "#version 330 core\n"
+    "in vec4 vColor;\n"
+    "in vec2 vCorner;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    float f = clamp(1.0 - 2.0 * length(vCorner), 0.0, 1.0);\n"
+    "    fragColor = vColor * (f * f);\n"
+    "}\n";
+
+// Ground rectangle from a unit quad, textured with the overlay (see submitGroundOverlay)
+static const char* overlayVS =
+    "#version 330 core\n"
+    "layout(std140) uniform Camera { mat4 viewProjection; };\n"
+    "uniform vec4 rect; // minX, minZ, maxX, maxZ\n"
+    "uniform float height;\n"
+    "layout(location = 0) in vec2 corner; // 0 .. 1\n"
+    "out vec2 vTexCoord;\n"
+    "void main() {\n"
+    "    vTexCoord = corner;\n"
+    "    gl_Position = viewProjection * vec4(mix(rect.x, rect.z, corner.x), height, mix(rect.y, rect.w, corner.y), 1.0);\n"
+    "}\n";
+static const char* overlayFS =
+    "#version 330 core\n"
+    "uniform sampler2D overlay;\n"
+    "in vec2 vTexCoord;\n"
+    "out vec4 fragColor;\n"
+    "void main() { fragColor = texture(overlay, vTexCoord); }\n";
+
+// --- Pipelines ---
+typedef struct {
+    GLuint program; // Line width is per draw (TrackMesh.lineWidth), everything else is shared state
+} Pipeline;
+
+static Pipeline pipelines[NUM_PIPELINES];
+static GLint solidModelLocation = -1, solidColorLocation = -1;
+static GLuint cameraBuffer = 0;
+static GLuint cubeArray = 0, cubeBuffer = 0; // Unit cube (36 vertices, positions only)
+static GLint particleRightLocation = -1, particleUpLocation = -1;
+static GLuint billboardArray = 0, billboardBuffer = 0; // Quad corners (strip), per-instance particles
+static GLuint particleBuffer = 0;                      // Streamed: orphaned and refilled each frame
+static float particleRight[3], particleUp[3];          // Camera axes of this frame's batch
+static GLint overlayRectLocation = -1, overlayHeightLocation = -1;
+static GLuint overlayArray = 0, overlayBuffer = 0;     // Unit quad corners (strip)
+static GLuint overlayTexture = 0;                      // This frame's overlay
+static float overlayRect[4], overlayHeight;
+
+typedef struct {
+    GLuint vertexArray, vertexBuffer; // Static model
+    GLuint instanceBuffer;            // Streamed: orphaned and refilled at each submission
+    int numVertices;
+} InstancedModel;
+
+static InstancedModel instancedModels[MAX_INSTANCED_MODELS];
+static int numInstancedModels = 0;
+
+typedef struct {
+    GLuint vertexArray, vertexBuffer; // Streamed: orphaned and refilled at each submission
+    GLuint indexBuffer;               // Static: 0 1 2 0 2 3 per quad
+    int maxQuads;
+} QuadMesh;
+
+static QuadMesh quadMeshes[MAX_QUAD_MESHES];
+static int numQuadMeshes = 0;
+
+// --- Draw Queue ---
+typedef struct {
+    int pipeline;
+    GLuint vertexArray;
+    GLenum mode;
+    int first, count;
+    float lineWidth;
+    int solid;           // Index into solidParams, -1 for mesh ranges
+    int instances;       // > 0: glDrawArraysInstanced with this many instances
+    int indexed;         // 1: glDrawElements (16-bit indices) from the vertex array's index buffer
+} DrawItem;
+
+typedef struct {
+    float model[16];
+    float color[4];
+} SolidParams;
+
+static DrawItem* drawItems = NULL;
+static int numDrawItems = 0, drawItemCapacity = 0;
+static SolidParams* solidParams = NULL;
+static int numSolids = 0, solidCapacity = 0;
+
+
+// --- Setup ---
+static GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        fprintf(stderr, "Renderer: shader compile error: %s\n", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+static GLuint linkProgram(const char* vsSource, const char* fsSource) {
+    GLuint vs = compileShader(GL_VERTEX_SHADER, vsSource);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, fsSource);
+    if (!vs || !fs) { glDeleteShader(vs); glDeleteShader(fs); return 0; }
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glLinkProgram(program);
+    glDeleteShader(vs); // Freed once the program is deleted
+    glDeleteShader(fs);
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetProgramInfoLog(program, sizeof(log), NULL, log);
+        fprintf(stderr, "Renderer: program link error: %s\n", log);
+        glDeleteProgram(program);
+        return 0;
+    }
+    GLuint block = glGetUniformBlockIndex(program, "Camera");
+    if (block != GL_INVALID_INDEX) glUniformBlockBinding(program, block, CAMERA_UBO_BINDING);
+    return program;
+}
+
+// Unit cube centred on the origin, counter-clockwise from outside (front faces survive culling).
+// Face with normal n spans axes u and v with u x v = n.
+static void createUnitCube() {
+    float vertices[36][3];
+    int count = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int sign = 1; sign >= -1; sign -= 2) {
+            float n[3] = { 0, 0, 0 }, u[3] = { 0, 0, 0 }, v[3] = { 0, 0, 0 };
+            n[axis] = 0.5f * sign;
+            u[(axis + 1) % 3] = 0.5f; // +X: (Y, Z), +Y: (Z, X), +Z: (X, Y)
+            v[(axis + 2) % 3] = 0.5f;
+            if (sign < 0) { float t[3] = { u[0], u[1], u[2] }; for (int i = 0; i < 3; ++i) { u[i] = v[i]; v[i] = t[i]; } }
+            const float corner[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+            const int order[6] = { 0, 1, 2, 0, 2, 3 };
+            for (int k = 0; k < 6; ++k) {
+                const float* c = corner[order[k]];
+                for (int i = 0; i < 3; ++i) vertices[count][i] = n[i] + c[0] * u[i] + c[1] * v[i];
+                count++;
+            }
+        }
+    }
+    glGenVertexArrays(1, &cubeArray);
+    glBindVertexArray(cubeArray);
+    glGenBuffers(1, &cubeBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, cubeBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (const void*)0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Four corners as a triangle strip; attributes 2 and 3 come from the particle buffer per instance
+static void createBillboard() {
+    const float corners[4][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { -0.5f, 0.5f }, { 0.5f, 0.5f } };
+    glGenVertexArrays(1, &billboardArray);
+    glBindVertexArray(billboardArray);
+    glGenBuffers(1, &billboardBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, billboardBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (const void*)0);
+    glGenBuffers(1, &particleBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, particleBuffer);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (const void*)offsetof(ParticleInstance, x));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ParticleInstance), (const void*)offsetof(ParticleInstance, color));
+    glVertexAttribDivisor(3, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Corners 0..1 as a triangle strip, mapped onto the overlay's rectangle by the vertex shader
+static void createOverlayQuad() {
+    const float corners[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f } };
+    glGenVertexArrays(1, &overlayArray);
+    glBindVertexArray(overlayArray);
+    glGenBuffers(1, &overlayBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, overlayBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (const void*)0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+static int initShaderRenderer() {
+    if (!GLEW_VERSION_3_3) {
+        fprintf(stderr, "Renderer: OpenGL 3.3 not available, using the fixed-function path\n");
+        return 0;
+    }
+    GLuint vertexColor = linkProgram(vertexColorVS, vertexColorFS);
+    GLuint solid = linkProgram(solidVS, solidFS);
+    GLuint instanced = linkProgram(instancedVS, vertexColorFS);
+    GLuint particles = linkProgram(particleVS, particleFS);
+    GLuint overlay = linkProgram(overlayVS, overlayFS);
+    if (!vertexColor || !solid || !instanced || !particles || !overlay) {
+        glDeleteProgram(vertexColor);
+        glDeleteProgram(solid);
+        glDeleteProgram(instanced);
+        glDeleteProgram(particles);
+        glDeleteProgram(overlay);
+        return 0;
+    }
+    pipelines[PIPELINE_VERTEX_COLOR].program = vertexColor;
+    pipelines[PIPELINE_LINES].program = vertexColor;
+    pipelines[PIPELINE_SOLID].program = solid;
+    pipelines[PIPELINE_INSTANCED].program = instanced;
+    pipelines[PIPELINE_OVERLAY].program = overlay;
+    pipelines[PIPELINE_DECAL].program = vertexColor;
+    pipelines[PIPELINE_PARTICLES].program = particles;
+    solidModelLocation = glGetUniformLocation(solid, "model");
+    solidColorLocation = glGetUniformLocation(solid, "color");
+    particleRightLocation = glGetUniformLocation(particles, "cameraRight");
+    particleUpLocation = glGetUniformLocation(particles, "cameraUp");
+    overlayRectLocation = glGetUniformLocation(overlay, "rect");
+    overlayHeightLocation = glGetUniformLocation(overlay, "height");
+    glUseProgram(overlay);
+    glUniform1i(glGetUniformLocation(overlay, "overlay"), 0); // Texture unit 0
+    glUseProgram(0);
+
+    glGenBuffers(1, &cameraBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, 16 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_UBO_BINDING, cameraBuffer);
+
+    createUnitCube();
+    createBillboard();
+    createOverlayQuad();
+    return 1;
+}
+
+RenderPath selectRenderPath(RenderPath requested) {
+    renderPath = RENDER_PATH_FIXED;
+    if (requested == RENDER_PATH_SHADER && initShaderRenderer()) renderPath = RENDER_PATH_SHADER;
+    printf("Status: Using the %s render path\n", renderPath == RENDER_PATH_SHADER ? "shader (GLSL 3.30)" : "fixed-function");
+    return renderPath;
+}
+
+void shutdownRenderer() {
+    if (renderPath != RENDER_PATH_SHADER) return;
+    glDeleteProgram(pipelines[PIPELINE_VERTEX_COLOR].program);
+    glDeleteProgram(pipelines[PIPELINE_SOLID].program);
+    glDeleteProgram(pipelines[PIPELINE_INSTANCED].program);
+    glDeleteProgram(pipelines[PIPELINE_PARTICLES].program);
+    glDeleteProgram(pipelines[PIPELINE_OVERLAY].program);
+    glDeleteBuffers(1, &cameraBuffer);
+    glDeleteBuffers(1, &cubeBuffer);
+    glDeleteVertexArrays(1, &cubeArray);
+    glDeleteBuffers(1, &billboardBuffer);
+    glDeleteBuffers(1, &particleBuffer);
+    glDeleteVertexArrays(1, &billboardArray);
+    glDeleteBuffers(1, &overlayBuffer);
+    glDeleteVertexArrays(1, &overlayArray);
+    for (int i = 0; i < numInstancedModels; ++i) {
+        glDeleteBuffers(1, &instancedModels[i].vertexBuffer);
+        glDeleteBuffers(1, &instancedModels[i].instanceBuffer);
+        glDeleteVertexArrays(1, &instancedModels[i].vertexArray);
+    }
+    numInstancedModels = 0;
+    for (int i = 0; i < numQuadMeshes; ++i) {
+        glDeleteBuffers(1, &quadMeshes[i].vertexBuffer);
+        glDeleteBuffers(1, &quadMeshes[i].indexBuffer);
+        glDeleteVertexArrays(1, &quadMeshes[i].vertexArray);
+    }
+    numQuadMeshes = 0;
+    free(drawItems); drawItems = NULL; numDrawItems = drawItemCapacity = 0;
+    free(solidParams); solidParams = NULL; numSolids = solidCapacity = 0;
+    renderPath = RENDER_PATH_FIXED;
+}
+
+
+// --- Mesh Upload ---
+// Interleaved MeshVertex arrays go to the GPU unchanged: position (3 floats) + colour (4 bytes).
+static void uploadVertices(GLuint* vertexArray, GLuint* buffer, const MeshVertex* vertices, int count) {
+    glGenVertexArrays(1, vertexArray);
+    glBindVertexArray(*vertexArray);
+    glGenBuffers(1, buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, *buffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)count * sizeof(MeshVertex), vertices, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (const void*)offsetof(MeshVertex, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(MeshVertex), (const void*)offsetof(MeshVertex, color));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+static void ensureMeshUploaded(TrackMesh* mesh) {
+    if (mesh->gpuVertexArrays[0] || mesh->gpuVertexArrays[1]) return;
+    if (mesh->numTriVertices > 0) uploadVertices(&mesh->gpuVertexArrays[0], &mesh->gpuBuffers[0], mesh->triVertices, mesh->numTriVertices);
+    if (mesh->numLineVertices > 0) uploadVertices(&mesh->gpuVertexArrays[1], &mesh->gpuBuffers[1], mesh->lineVertices, mesh->numLineVertices);
+}
+
+int createInstancedModel(const MeshVertex* vertices, int numVertices) {
+    if (renderPath != RENDER_PATH_SHADER || numInstancedModels == MAX_INSTANCED_MODELS) return -1;
+    InstancedModel* model = &instancedModels[numInstancedModels];
+    uploadVertices(&model->vertexArray, &model->vertexBuffer, vertices, numVertices); // Attributes 0, 1
+    model->numVertices = numVertices;
+    glBindVertexArray(model->vertexArray);
+    glGenBuffers(1, &model->instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, model->instanceBuffer);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(MeshInstance), (const void*)0);
+    glVertexAttribDivisor(2, 1); // Advances once per instance
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return numInstancedModels++;
+}
+
+int createQuadMesh(int maxQuads) {
+    if (renderPath != RENDER_PATH_SHADER || numQuadMeshes == MAX_QUAD_MESHES || maxQuads <= 0 || maxQuads > 16384) return -1;
+    unsigned short* indices = (unsigned short*)malloc((size_t)maxQuads * 6 * sizeof(unsigned short));
+    if (!indices) { fprintf(stderr, "Renderer: out of memory for quad indices\n"); return -1; }
+    for (int q = 0; q < maxQuads; ++q) {
+        const int order[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int k = 0; k < 6; ++k) indices[q * 6 + k] = (unsigned short)(q * 4 + order[k]);
+    }
+    QuadMesh* mesh = &quadMeshes[numQuadMeshes];
+    uploadVertices(&mesh->vertexArray, &mesh->vertexBuffer, NULL, maxQuads * 4); // Attributes 0, 1; contents streamed
+    mesh->maxQuads = maxQuads;
+    glBindVertexArray(mesh->vertexArray);
+    glGenBuffers(1, &mesh->indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer); // Element binding is vertex array state
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)maxQuads * 6 * sizeof(unsigned short), indices, GL_STATIC_DRAW);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    free(indices);
+    return numQuadMeshes++;
+}
+
+
+// --- Frame Submission ---
+static DrawItem* pushDrawItem() {
+    if (numDrawItems == drawItemCapacity) {
+        int newCapacity = drawItemCapacity > 0 ? drawItemCapacity * 2 : 256;
+        DrawItem* grown = (DrawItem*)realloc(drawItems, (size_t)newCapacity * sizeof(DrawItem));
+        if (!grown) { fprintf(stderr, "Renderer: out of memory for draw items\n"); return NULL; }
+        drawItems = grown;
+        drawItemCapacity = newCapacity;
+    }
+    renderStats.itemsSubmitted++;
+    return &drawItems[numDrawItems++];
+}
+
+void beginShaderFrame(const float viewProjection[16]) {
+    numDrawItems = 0;
+    numSolids = 0;
+    renderStats.itemsSubmitted = renderStats.drawCalls = 0;
+    renderStats.pipelineChanges = renderStats.bufferChanges = 0;
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, 16 * sizeof(float), viewProjection);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void submitMeshDraw(TrackMesh* mesh, int lines, int firstVertex, int numVertices) {
+    if (numVertices <= 0) return;
+    ensureMeshUploaded(mesh);
+    DrawItem* item = pushDrawItem();
+    if (!item) return;
+    item->pipeline = lines ? PIPELINE_LINES : PIPELINE_VERTEX_COLOR;
+    item->vertexArray = mesh->gpuVertexArrays[lines ? 1 : 0];
+    item->mode = lines ? GL_LINES : GL_TRIANGLES;
+    item->first = firstVertex;
+    item->count = numVertices;
+    item->lineWidth = lines ? mesh->lineWidth : 0.0f;
+    item->solid = -1;
+    item->instances = 0;
+    item->indexed = 0;
+}
+
+void submitSolidCube(const float model[16], float r, float g, float b) {
+    if (numSolids == solidCapacity) {
+        int newCapacity = solidCapacity > 0 ? solidCapacity * 2 : 32;
+        SolidParams* grown = (SolidParams*)realloc(solidParams, (size_t)newCapacity * sizeof(SolidParams));
+        if (!grown) { fprintf(stderr, "Renderer: out of memory for draw items\n"); return; }
+        solidParams = grown;
+        solidCapacity = newCapacity;
+    }
+    DrawItem* item = pushDrawItem();
+    if (!item) return;
+    SolidParams* params = &solidParams[numSolids];
+    for (int i = 0; i < 16; ++i) params->model[i] = model[i];
+    params->color[0] = r; params->color[1] = g; params->color[2] = b; params->color[3] = 1.0f;
+    item->pipeline = PIPELINE_SOLID;
+    item->vertexArray = cubeArray;
+    item->mode = GL_TRIANGLES;
+    item->first = 0;
+    item->count = 36;
+    item->lineWidth = 0.0f;
+    item->solid = numSolids++;
+    item->instances = 0;
+    item->indexed = 0;
+}
+
+void submitInstancedDraw(int model, const MeshInstance* instances, int numInstances) {
+    if (model < 0 || model >= numInstancedModels || numInstances <= 0) return;
+    InstancedModel* target = &instancedModels[model];
+    // Orphan the previous contents so the driver never waits for last frame's draw to finish
+    GLsizeiptr bytes = (GLsizeiptr)numInstances * sizeof(MeshInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, target->instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    DrawItem* item = pushDrawItem();
+    if (!item) return;
+    item->pipeline = PIPELINE_INSTANCED;
+    item->vertexArray = target->vertexArray;
+    item->mode = GL_TRIANGLES;
+    item->first = 0;
+    item->count = target->numVertices;
+    item->lineWidth = 0.0f;
+    item->solid = -1;
+    item->instances = numInstances;
+    item->indexed = 0;
+}
+
+void uploadQuadMesh(int mesh, const MeshVertex* vertices, int numQuads) {
+    if (mesh < 0 || mesh >= numQuadMeshes || numQuads <= 0) return;
+    QuadMesh* target = &quadMeshes[mesh];
+    if (numQuads > target->maxQuads) numQuads = target->maxQuads;
+    // Orphan at the full size (the driver can hand back a same-sized block) and fill the front
+    glBindBuffer(GL_ARRAY_BUFFER, target->vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)target->maxQuads * 4 * sizeof(MeshVertex), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)numQuads * 4 * sizeof(MeshVertex), vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void submitQuadMesh(int mesh, int numQuads) {
+    if (mesh < 0 || mesh >= numQuadMeshes || numQuads <= 0) return;
+    QuadMesh* target = &quadMeshes[mesh];
+    if (numQuads > target->maxQuads) numQuads = target->maxQuads;
+    DrawItem* item = pushDrawItem();
+    if (!item) return;
+    item->pipeline = PIPELINE_DECAL;
+    item->vertexArray = target->vertexArray;
+    item->mode = GL_TRIANGLES;
+    item->first = 0;
+    item->count = numQuads * 6;
+    item->lineWidth = 0.0f;
+    item->solid = -1;
+    item->instances = 0;
+    item->indexed = 1;
+}
+
+void submitParticleBatch(const ParticleInstance* particles, int numParticles, const float right[3], const float up[3]) {
+    if (numParticles <= 0) return;
+    GLsizeiptr bytes = (GLsizeiptr)numParticles * sizeof(ParticleInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, particleBuffer);
+    glBufferData(GL_ARRAY_BUFFER, bytes, NULL, GL_STREAM_DRAW); // Orphan, as submitInstancedDraw()
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, particles);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    for (int i = 0; i < 3; ++i) { particleRight[i] = right[i]; particleUp[i] = up[i]; }
+    DrawItem* item = pushDrawItem();
+    if (!item) return;
+    item->pipeline = PIPELINE_PARTICLES;
+    item->vertexArray = billboardArray;
+    item->mode = GL_TRIANGLE_STRIP;
+    item->first = 0;
+    item->count = 4;
+    item->lineWidth = 0.0f;
+    item->solid = -1;
+    item->instances = numParticles;
+    item->indexed = 0;
+}
+
+void submitGroundOverlay(unsigned int texture, const float rect[4], float y) {
+    if (!texture) return;
+    overlayTexture = texture;
+    for (int i = 0; i < 4; ++i) overlayRect[i] = rect[i];
+    overlayHeight = y;
+    DrawItem* item = pushDrawItem();
+    if (!item) return;
+    item->pipeline = PIPELINE_OVERLAY;
+    item->vertexArray = overlayArray;
+    item->mode = GL_TRIANGLE_STRIP;
+    item->first = 0;
+    item->count = 4;
+    item->lineWidth = 0.0f;
+    item->solid = -1;
+    item->instances = 0;
+    item->indexed = 0;
+}
+
+// Fixed state of the blended pipelines, sorted after the opaque ones: no depth writes, visible
+// from either side. Called on the change into 'pipeline' (-1 once the frame is done).
+static void applyBlendState(int pipeline, int previous) {
+    int blended = pipeline == PIPELINE_OVERLAY || pipeline == PIPELINE_DECAL || pipeline == PIPELINE_PARTICLES;
+    int wasBlended = previous == PIPELINE_OVERLAY || previous == PIPELINE_DECAL || previous == PIPELINE_PARTICLES;
+    int onGround = pipeline == PIPELINE_OVERLAY || pipeline == PIPELINE_DECAL;
+    int wasOnGround = previous == PIPELINE_OVERLAY || previous == PIPELINE_DECAL;
+    if (blended && !wasBlended) {
+        glEnable(GL_BLEND);
+        glDepthMask(GL_FALSE);
+        glDisable(GL_CULL_FACE);
+    }
+    if (onGround) {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glEnable(GL_POLYGON_OFFSET_FILL); // Pulled towards the camera so coplanar ground doesn't z-fight
+        glPolygonOffset(-1.0f, -1.0f);
+    } else if (wasOnGround) {
+        glDisable(GL_POLYGON_OFFSET_FILL);
+    }
+    if (pipeline == PIPELINE_OVERLAY) {
+        glUniform4fv(overlayRectLocation, 1, overlayRect);
+        glUniform1f(overlayHeightLocation, overlayHeight);
+        glBindTexture(GL_TEXTURE_2D, overlayTexture);
+    } else if (previous == PIPELINE_OVERLAY) {
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (pipeline == PIPELINE_PARTICLES) {
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // Premultiplied (see ParticleInstance)
+        glUniform3fv(particleRightLocation, 1, particleRight);
+        glUniform3fv(particleUpLocation, 1, particleUp);
+    }
+    if (!blended && wasBlended) { // Back to initRenderState()
+        glDisable(GL_BLEND);
+        glDepthMask(GL_TRUE);
+        glEnable(GL_CULL_FACE);
+    }
+}
+
+// Pipeline first (program and state changes are the most expensive), then vertex array, then
+// line width, then position in the buffer so neighbouring chunks end up next to each other.
+static int compareDrawItems(const void* a, const void* b) {
+    const DrawItem* ia = (const DrawItem*)a;
+    const DrawItem* ib = (const DrawItem*)b;
+    if (ia->pipeline != ib->pipeline) return ia->pipeline - ib->pipeline;
+    if (ia->vertexArray != ib->vertexArray) return ia->vertexArray < ib->vertexArray ? -1 : 1;
+    if (ia->lineWidth != ib->lineWidth) return ia->lineWidth < ib->lineWidth ? -1 : 1;
+    if (ia->first != ib->first) return ia->first - ib->first;
+    return ia->solid - ib->solid; // Stable order for the per-draw uniforms
+}
+
+void flushShaderFrame() {
+    qsort(drawItems, (size_t)numDrawItems, sizeof(DrawItem), compareDrawItems);
+
+    int currentPipeline = -1;
+    GLuint currentProgram = 0, currentArray = 0;
+    float currentLineWidth = 1.0f;
+    for (int i = 0; i < numDrawItems; ++i) {
+        DrawItem item = drawItems[i];
+        // Mesh ranges that continue each other in the same buffer become one draw
+        while (item.solid < 0 && item.instances == 0 && !item.indexed && i + 1 < numDrawItems) {
+            const DrawItem* next = &drawItems[i + 1];
+            if (next->solid >= 0 || next->instances > 0 || next->indexed || next->pipeline != item.pipeline || next->vertexArray != item.vertexArray ||
+                next->lineWidth != item.lineWidth || next->first != item.first + item.count) break;
+            item.count += next->count;
+            i++;
+        }
+
+        if (item.pipeline != currentPipeline) {
+            const Pipeline* pipeline = &pipelines[item.pipeline];
+            if (pipeline->program != currentProgram) {
+                glUseProgram(pipeline->program);
+                currentProgram = pipeline->program;
+                renderStats.pipelineChanges++;
+            }
+            applyBlendState(item.pipeline, currentPipeline); // After glUseProgram (particle and overlay uniforms)
+            currentPipeline = item.pipeline;
+        }
+        if (item.lineWidth > 0.0f && item.lineWidth != currentLineWidth) {
+            glLineWidth(item.lineWidth);
+            currentLineWidth = item.lineWidth;
+        }
+        if (item.vertexArray != currentArray) {
+            glBindVertexArray(item.vertexArray);
+            currentArray = item.vertexArray;
+            renderStats.bufferChanges++;
+        }
+        if (item.solid >= 0) {
+            const SolidParams* params = &solidParams[item.solid];
+            glUniformMatrix4fv(solidModelLocation, 1, GL_FALSE, params->model);
+            glUniform4fv(solidColorLocation, 1, params->color);
+        }
+        if (item.instances > 0) glDrawArraysInstanced(item.mode, item.first, item.count, item.instances);
+        else if (item.indexed) glDrawElements(item.mode, item.count, GL_UNSIGNED_SHORT, (const void*)(item.first * sizeof(unsigned short)));
+        else glDrawArrays(item.mode, item.first, item.count);
+        renderStats.drawCalls++;
+    }
+
+    // Leave the fixed-function state as the HUD and menu expect it
+    applyBlendState(-1, currentPipeline);
+    if (currentLineWidth != 1.0f) glLineWidth(1.0f);
+    glBindVertexArray(0);
+    glUseProgram(0);
+    numDrawItems = 0;
+    numSolids = 0;
+}
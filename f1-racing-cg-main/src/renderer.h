@@ -0,0 +1,91 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include "track_mesh.h" // TrackMesh (uploaded to vertex buffers on first use)
+
+// --- Render Paths ---
+// RENDER_PATH_SHADER: GLSL 3.30 core-profile pipeline. Camera matrices live in a uniform buffer,
+// geometry in vertex buffers/VAOs, and the frame's draws are collected, sorted by pipeline and
+// buffer, merged where ranges touch, and only then submitted.
+// RENDER_PATH_FIXED: the original fixed-function path (matrix stack, client vertex arrays),
+// used when OpenGL 3.3 is unavailable or when asked for with --fixed-function.
+typedef enum {
+    RENDER_PATH_FIXED,
+    RENDER_PATH_SHADER
+} RenderPath;
+
+extern RenderPath renderPath; // Active path, set by selectRenderPath()
+
+// Each pipeline is a program plus the fixed state it needs; submission is sorted by pipeline.
+typedef enum {
+    PIPELINE_VERTEX_COLOR, // Track triangles: per-vertex colour, world-space positions
+    PIPELINE_LINES,        // Track markings: same program, wide lines
+    PIPELINE_SOLID,        // Car parts: unit cube with a model matrix and a flat colour
+    PIPELINE_INSTANCED,    // Scenery: vertex-coloured model placed by a per-instance attribute
+    PIPELINE_OVERLAY,      // Ground overlay (heatmap): one textured quad, blended under the decals
+    PIPELINE_DECAL,        // Skid marks: vertex colour with alpha, blended over the opaque pipelines
+    PIPELINE_PARTICLES,    // Smoke and sparks: camera-facing quads, premultiplied alpha, drawn last
+    NUM_PIPELINES
+} PipelineId;
+
+// --- Per-Frame Statistics (shader path) ---
+typedef struct {
+    long itemsSubmitted;  // Draws requested this frame
+    long drawCalls;       // Draw calls issued after merging
+    long pipelineChanges; // glUseProgram calls
+    long bufferChanges;   // glBindVertexArray calls
+} RenderStats;
+
+extern RenderStats renderStats;
+
+// --- Instanced Models (shader path) ---
+// A model is a static vertex-coloured triangle list on the ground plane. Each instance places it
+// with a rotation around Y and a uniform scale: x' = x + c*px + s*pz, z' = z - s*px + c*pz (as
+// glTranslatef + glRotatef(heading) + glScalef).
+#define MAX_INSTANCED_MODELS 8
+
+typedef struct {
+    float x, z;    // Position on the ground
+    float heading; // Radians around +Y
+    float scale;
+} MeshInstance;    // 16 bytes, uploaded unchanged as one vec4 attribute
+
+// --- Streamed Quad Meshes (shader path) ---
+// Vertex-coloured quads (4 MeshVertex each, corners in order) rewritten every frame. The vertex
+// buffer is sized once for maxQuads and orphaned at each submission; a static index buffer turns
+// each quad into two triangles, so any number of quads up to maxQuads is one glDrawElements.
+#define MAX_QUAD_MESHES 4
+
+// --- Particle Billboards (shader path) ---
+// One instanced batch of camera-facing quads per frame. Colours are premultiplied by alpha and
+// blended with (ONE, ONE_MINUS_SRC_ALPHA): alpha 0 adds light (sparks), alpha > 0 covers (smoke),
+// so both kinds go in the same draw as long as the batch is sorted back to front.
+typedef struct {
+    float x, y, z, size;    // Centre and edge length, world units
+    unsigned char color[4]; // Premultiplied RGBA
+} ParticleInstance;         // 20 bytes
+
+// --- Function Declarations ---
+// Call once with a current context. Falls back to RENDER_PATH_FIXED if the shader path cannot be
+// set up; returns the path actually selected.
+RenderPath selectRenderPath(RenderPath requested);
+void shutdownRenderer(void);
+
+// Shader path frame: begin (camera), submit, flush (sort + draw). Submissions are only queued.
+void beginShaderFrame(const float viewProjection[16]);
+void submitMeshDraw(TrackMesh* mesh, int lines, int firstVertex, int numVertices);
+void submitSolidCube(const float model[16], float r, float g, float b);
+int createInstancedModel(const MeshVertex* vertices, int numVertices); // Model id, -1 if unavailable
+// Copies the instances into the model's streaming buffer (one submission per model per frame)
+void submitInstancedDraw(int model, const MeshInstance* instances, int numInstances);
+int createQuadMesh(int maxQuads); // Mesh id, -1 if unavailable (maxQuads <= 16384: 16-bit indices)
+void uploadQuadMesh(int mesh, const MeshVertex* vertices, int numQuads); // Orphans and refills the front
+void submitQuadMesh(int mesh, int numQuads); // First numQuads as uploaded, drawn with PIPELINE_DECAL
+// Copies the batch into the particle streaming buffer; right/up span the quads (camera axes)
+void submitParticleBatch(const ParticleInstance* particles, int numParticles, const float right[3], const float up[3]);
+// An RGBA texture stretched over the ground rectangle rect (minX, minZ, maxX, maxZ) at height y,
+// texture coordinates (0, 0) at (minX, minZ). One overlay per frame: the last submission wins.
+void submitGroundOverlay(unsigned int texture, const float rect[4], float y);
+void flushShaderFrame(void);
+
+#endif // RENDERER_H
@@ -0,0 +1,56 @@
+#include "ring.h"
+#include <stdlib.h> // For malloc, free
+#include <string.h> // For memcpy, memset
+
+// Index hand-over between the two threads (GCC/Clang builtins)
+#define LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+int initSpscRing(SpscRing* ring, unsigned int recordSize, unsigned int capacity) {
+    memset(ring, 0, sizeof(*ring));
+    unsigned int slots = 1;
+    while (slots < capacity) slots <<= 1;
+    ring->records = (unsigned char*)malloc((size_t)slots * recordSize);
+    if (!ring->records) return 0;
+    ring->recordSize = recordSize;
+    ring->capacity = slots;
+    return 1;
+}
+
+void freeSpscRing(SpscRing* ring) {
+    free(ring->records);
+    ring->records = NULL;
+}
+
+// --- Producer ---
+int pushSpscRing(SpscRing* ring, const void* record) {
+    unsigned int head = ring->head; // Only this thread writes it
+    if (head - ring->cachedTail == ring->capacity) {
+        ring->cachedTail = LOAD_ACQUIRE(&ring->tail); // Looks full: see how far the consumer got
+        if (head - ring->cachedTail == ring->capacity) {
+            __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+            return 0;
+        }
+    }
+    memcpy(ring->records + (size_t)(head & (ring->capacity - 1)) * ring->recordSize, record, ring->recordSize);
+    STORE_RELEASE(&ring->head, head + 1); // The record is written before the consumer can see it
+    ring->pushed++;
+    return 1;
+}
+
+// --- Consumer ---
+int popSpscRing(SpscRing* ring, void* record) {
+    unsigned int tail = ring->tail; // Only this thread writes it
+    if (tail == ring->cachedHead) {
+        ring->cachedHead = LOAD_ACQUIRE(&ring->head); // Looks empty: see what the producer added
+        if (tail == ring->cachedHead) return 0;
+    }
+    memcpy(record, ring->records + (size_t)(tail & (ring->capacity - 1)) * ring->recordSize, ring->recordSize);
+    STORE_RELEASE(&ring->tail, tail + 1); // The slot is copied out before the producer may reuse it
+    ring->popped++;
+    return 1;
+}
+
+long getSpscRingDropped(const SpscRing* ring) {
+    return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,43 @@
+#ifndef RING_H
+#define RING_H
+
+// --- Single-Producer/Single-Consumer Ring ---
+// A lock-free queue of fixed-size records between exactly two threads: one only pushes, the
+// other only pops. Neither side ever waits or allocates: a push into a full ring fails (and is
+// counted), a pop from an empty one returns 0. The storage is allocated once by initSpscRing().
+//
+// The indices run freely (wrapping at 2^32) and are masked into the slots, so a full ring still
+// uses every slot. Each side publishes its index with a release store after touching the slot
+// and reads the other side's with an acquire load; head and tail sit on separate cache lines,
+// and each side keeps a private copy of the other's index so it only reads the shared one when
+// the ring looks full (producer) or empty (consumer). The atomics are the GCC/Clang builtins, as
+// the __sync_fetch_and_add work counters in sweep.c and server.c.
+
+#define SPSC_CACHE_LINE 64
+
+typedef struct {
+    unsigned char* records;        // capacity x recordSize
+    unsigned int recordSize;
+    unsigned int capacity;         // Power of two
+    unsigned char pad0[SPSC_CACHE_LINE]; // A whole line between each side's fields, however the struct is aligned
+
+    // Producer's line
+    unsigned int head;             // Next slot to fill (published with a release store)
+    unsigned int cachedTail;       // Producer's last view of 'tail'
+    long pushed, dropped;          // Records queued / rejected because the ring was full
+    unsigned char pad1[SPSC_CACHE_LINE];
+
+    // Consumer's line
+    unsigned int tail;             // Next slot to read (published with a release store)
+    unsigned int cachedHead;       // Consumer's last view of 'head'
+    long popped;
+} SpscRing;
+
+// --- Function Declarations ---
+int initSpscRing(SpscRing* ring, unsigned int recordSize, unsigned int capacity); // Capacity rounded up to a power of two. Returns 1 on success.
+void freeSpscRing(SpscRing* ring);
+int pushSpscRing(SpscRing* ring, const void* record);  // Producer: 1 if queued, 0 if full (counted in 'dropped')
+int popSpscRing(SpscRing* ring, void* record);         // Consumer: 1 if a record was copied out, 0 if empty
+long getSpscRingDropped(const SpscRing* ring);         // Any thread (approximate while the producer runs)
+
+#endif // RING_H
@@ -0,0 +1,372 @@
+#include "scenery.h"    // SceneryType, SceneryStats and prototypes
+#include "track_rect.h"  // Track outlines the objects are placed around
+#include "track_round.h"
+#include "surface.h"    // TRACK_RUNOFF_WIDTH (guardrails stand off the road)
+#include "track_mesh.h" // MESH_CHUNK_SIZE, MeshVertex
+#include <GL/glew.h>    // Client vertex arrays (fixed-function path)
+#include <math.h>       // For floorf, sinf, cosf, atan2f, fabsf, fmaxf
+#include <stdio.h>      // For printf, fprintf
+#include <stdlib.h>     // For malloc, realloc, free, qsort
+
+SceneryStats sceneryStats = { 0, 0, 0, 0 };
+int sceneryObjectCount = SCENERY_DEFAULT_OBJECTS;
+
+// --- Models ---
+// Built once on the origin, object space: +Y up, local +X along the track, local +Z away from it.
+typedef struct {
+    MeshVertex* vertices;
+    int numVertices, capacity;
+    float radius, height; // Horizontal extent from the origin and top, at scale 1 (chunk bounds)
+    int gpuModel;         // createInstancedModel() id, -1 = fixed-function path
+} SceneryModel;
+
+static SceneryModel models[NUM_SCENERY_TYPES];
+static int modelsBuilt = 0;
+
+// --- Placed Objects ---
+typedef struct {
+    float boundsMin[3], boundsMax[3];
+    int first, count; // Range in SceneryLayer.instances
+} SceneryChunk;
+
+typedef struct {
+    MeshInstance* instances; // Sorted by chunk after buildScenery()
+    int count, capacity;
+    SceneryChunk* chunks;
+    int numChunks;
+    MeshVertex* baked;       // Fixed-function path: every instance's model, transformed (same order)
+} SceneryLayer;
+
+static SceneryLayer layers[NUM_SCENERY_TYPES];
+static MeshInstance* visibleInstances = NULL; // Per-frame gather buffer (shader path)
+static int visibleCapacity = 0;
+
+
+// --- Model Building ---
+static void addVertex(SceneryModel* model, float x, float y, float z, float r, float g, float b) {
+    if (model->numVertices == model->capacity) {
+        int newCapacity = model->capacity > 0 ? model->capacity * 2 : 64;
+        MeshVertex* grown = (MeshVertex*)realloc(model->vertices, (size_t)newCapacity * sizeof(MeshVertex));
+        if (!grown) { fprintf(stderr, "Scenery: out of memory for models\n"); return; }
+        model->vertices = grown;
+        model->capacity = newCapacity;
+    }
+    MeshVertex* v = &model->vertices[model->numVertices++];
+    v->x = x; v->y = y; v->z = z;
+    v->color[0] = (unsigned char)(r * 255.0f); v->color[1] = (unsigned char)(g * 255.0f);
+    v->color[2] = (unsigned char)(b * 255.0f); v->color[3] = 255;
+    float extent = sqrtf(x * x + z * z);
+    if (extent > model->radius) model->radius = extent;
+    if (y > model->height) model->height = y;
+}
+
+// Quad a-b-c-d, counter-clockwise seen from outside; 'shade' darkens the side faces (no lighting)
+static void addQuad(SceneryModel* model, const float a[3], const float b[3], const float c[3], const float d[3],
+                    float r, float g, float bl, float shade) {
+    const float* corners[6] = { a, b, c, a, c, d };
+    for (int i = 0; i < 6; ++i) addVertex(model, corners[i][0], corners[i][1], corners[i][2], r * shade, g * shade, bl * shade);
+}
+
+// Axis-aligned box without its bottom face
+static void addBox(SceneryModel* model, float x0, float x1, float y0, float y1, float z0, float z1, float r, float g, float b) {
+    float top[4][3] = { { x0, y1, z1 }, { x1, y1, z1 }, { x1, y1, z0 }, { x0, y1, z0 } };
+    float px[4][3] = { { x1, y0, z1 }, { x1, y0, z0 }, { x1, y1, z0 }, { x1, y1, z1 } };
+    float nx[4][3] = { { x0, y0, z0 }, { x0, y0, z1 }, { x0, y1, z1 }, { x0, y1, z0 } };
+    float pz[4][3] = { { x0, y0, z1 }, { x1, y0, z1 }, { x1, y1, z1 }, { x0, y1, z1 } };
+    float nz[4][3] = { { x1, y0, z0 }, { x0, y0, z0 }, { x0, y1, z0 }, { x1, y1, z0 } };
+    addQuad(model, top[0], top[1], top[2], top[3], r, g, b, 1.0f);
+    addQuad(model, px[0], px[1], px[2], px[3], r, g, b, 0.8f);
+    addQuad(model, nx[0], nx[1], nx[2], nx[3], r, g, b, 0.8f);
+    addQuad(model, pz[0], pz[1], pz[2], pz[3], r, g, b, 0.65f);
+    addQuad(model, nz[0], nz[1], nz[2], nz[3], r, g, b, 0.65f);
+}
+
+// Four-sided pyramid on a square base (base not drawn)
+static void addPyramid(SceneryModel* model, float halfBase, float y0, float y1, float r, float g, float b) {
+    const float corners[4][2] = { { -halfBase, halfBase }, { halfBase, halfBase }, { halfBase, -halfBase }, { -halfBase, -halfBase } };
+    const float shades[4] = { 0.65f, 0.8f, 0.65f, 0.8f }; // +Z, +X, -Z, -X faces
+    for (int i = 0; i < 4; ++i) {
+        const float* p = corners[i];
+        const float* q = corners[(i + 1) % 4];
+        float s = shades[i];
+        addVertex(model, p[0], y0, p[1], r * s, g * s, b * s);
+        addVertex(model, q[0], y0, q[1], r * s, g * s, b * s);
+        addVertex(model, 0.0f, y1, 0.0f, r, g, b); // Lighter tip
+    }
+}
+
+static void ensureSceneryModels() {
+    if (modelsBuilt) return;
+    SceneryModel* cone = &models[SCENERY_CONE];
+    addPyramid(cone, 0.25f, 0.0f, 0.8f, 1.0f, 0.5f, 0.0f);
+    SceneryModel* barrier = &models[SCENERY_BARRIER];
+    addBox(barrier, -1.0f, 1.0f, 0.0f, 0.8f, -0.2f, 0.2f, 0.9f, 0.9f, 0.9f);
+    SceneryModel* tree = &models[SCENERY_TREE];
+    addBox(tree, -0.2f, 0.2f, 0.0f, 1.2f, -0.2f, 0.2f, 0.45f, 0.3f, 0.15f); // Trunk
+    addPyramid(tree, 1.2f, 1.0f, 4.0f, 0.1f, 0.45f, 0.15f);                  // Canopy
+    SceneryModel* stand = &models[SCENERY_GRANDSTAND];
+    for (int step = 0; step < 3; ++step) { // Rising away from the track
+        float shade = 1.0f - 0.15f * step;
+        addBox(stand, -10.0f, 10.0f, 0.0f, 1.5f * (step + 1), 3.0f * step, 3.0f * (step + 1),
+               0.55f * shade, 0.6f * shade, 0.7f * shade);
+    }
+    addBox(stand, -10.0f, 10.0f, 6.0f, 6.3f, 6.0f, 9.0f, 0.2f, 0.3f, 0.8f); // Roof over the top step
+
+    for (int t = 0; t < NUM_SCENERY_TYPES; ++t) {
+        models[t].gpuModel = createInstancedModel(models[t].vertices, models[t].numVertices); // -1 on the fixed path
+    }
+    modelsBuilt = 1;
+}
+
+
+// --- Placement ---
+static unsigned int randomState = 1;
+
+static float randomFloat() { // Uniform in [0, 1), xorshift32
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return (randomState >> 8) * (1.0f / 16777216.0f);
+}
+
+static void addInstance(SceneryType type, float x, float z, float heading, float scale) {
+    SceneryLayer* layer = &layers[type];
+    if (layer->count == layer->capacity) {
+        int newCapacity = layer->capacity > 0 ? layer->capacity * 2 : 256;
+        MeshInstance* grown = (MeshInstance*)realloc(layer->instances, (size_t)newCapacity * sizeof(MeshInstance));
+        if (!grown) { fprintf(stderr, "Scenery: out of memory for instances\n"); return; }
+        layer->instances = grown;
+        layer->capacity = newCapacity;
+    }
+    MeshInstance* instance = &layer->instances[layer->count++];
+    instance->x = x;
+    instance->z = z;
+    instance->heading = heading;
+    instance->scale = scale;
+}
+
+// One straight of the track outline, seen from the origin
+typedef struct {
+    float nx, nz;        // Outward normal
+    float outerDistance; // Origin to the outer edge along the normal
+    float halfLength;    // Half the straight part (corners excluded)
+} Straight;
+
+// Rows of objects along all four straights, 'spacing' apart. Each row sits 'rowStep' further
+// out than the previous one (negative: into the infield). Returns the offset after the last row.
+static float placeAlongStraights(const Straight straights[4], SceneryType type, int count,
+                                 float spacing, float firstOffset, float rowStep, int randomHeading) {
+    int placed = 0, row = 0;
+    while (placed < count) {
+        int placedBefore = placed;
+        float offset = firstOffset + row * rowStep;
+        for (int s = 0; s < 4 && placed < count; ++s) {
+            const Straight* st = &straights[s];
+            float heading = atan2f(st->nx, st->nz); // Local +Z along the outward normal
+            int slots = (int)(2.0f * st->halfLength / spacing);
+            for (int i = 0; i < slots && placed < count; ++i, ++placed) {
+                float along = -st->halfLength + (i + 0.5f + 0.5f * (row & 1)) * spacing; // Stagger rows
+                float d = st->outerDistance + offset;
+                float x = st->nx * d - st->nz * along;
+                float z = st->nz * d + st->nx * along;
+                addInstance(type, x, z, randomHeading ? randomFloat() * 6.2831853f : heading, 1.0f);
+            }
+        }
+        row++;
+        if (placed == placedBefore) break; // Straights shorter than 'spacing'
+    }
+    return firstOffset + row * rowStep;
+}
+
+
+// --- Chunking ---
+static int instanceChunkKey(const MeshInstance* instance) {
+    int cx = (int)floorf(instance->x / MESH_CHUNK_SIZE) + 512;
+    int cz = (int)floorf(instance->z / MESH_CHUNK_SIZE) + 512;
+    return cz * 1024 + cx; // Row-major, so neighbouring visible chunks are often adjacent ranges
+}
+
+static int compareInstances(const void* a, const void* b) {
+    return instanceChunkKey((const MeshInstance*)a) - instanceChunkKey((const MeshInstance*)b);
+}
+
+static void finishLayer(SceneryType type) {
+    SceneryLayer* layer = &layers[type];
+    const SceneryModel* model = &models[type];
+    qsort(layer->instances, (size_t)layer->count, sizeof(MeshInstance), compareInstances);
+    layer->chunks = (SceneryChunk*)malloc((size_t)(layer->count > 0 ? layer->count : 1) * sizeof(SceneryChunk)); // Upper bound
+    layer->numChunks = 0;
+    for (int i = 0; i < layer->count; ++i) {
+        const MeshInstance* instance = &layer->instances[i];
+        float r = model->radius * instance->scale, top = model->height * instance->scale;
+        if (i == 0 || instanceChunkKey(instance) != instanceChunkKey(&layer->instances[i - 1])) {
+            SceneryChunk* chunk = &layer->chunks[layer->numChunks++];
+            chunk->first = i;
+            chunk->count = 0;
+            chunk->boundsMin[0] = instance->x - r; chunk->boundsMin[1] = 0.0f; chunk->boundsMin[2] = instance->z - r;
+            chunk->boundsMax[0] = instance->x + r; chunk->boundsMax[1] = top;  chunk->boundsMax[2] = instance->z + r;
+        }
+        SceneryChunk* chunk = &layer->chunks[layer->numChunks - 1];
+        chunk->count++;
+        chunk->boundsMin[0] = fminf(chunk->boundsMin[0], instance->x - r);
+        chunk->boundsMin[2] = fminf(chunk->boundsMin[2], instance->z - r);
+        chunk->boundsMax[0] = fmaxf(chunk->boundsMax[0], instance->x + r);
+        chunk->boundsMax[1] = fmaxf(chunk->boundsMax[1], top);
+        chunk->boundsMax[2] = fmaxf(chunk->boundsMax[2], instance->z + r);
+    }
+
+    // Without instancing, bake every object into world space once (same order as the instances)
+    if (model->gpuModel < 0 && layer->count > 0) {
+        layer->baked = (MeshVertex*)malloc((size_t)layer->count * model->numVertices * sizeof(MeshVertex));
+        if (!layer->baked) { fprintf(stderr, "Scenery: out of memory for baked vertices\n"); return; }
+        for (int i = 0; i < layer->count; ++i) {
+            const MeshInstance* instance = &layer->instances[i];
+            float c = cosf(instance->heading), s = sinf(instance->heading);
+            for (int v = 0; v < model->numVertices; ++v) {
+                MeshVertex out = model->vertices[v];
+                float px = out.x * instance->scale, pz = out.z * instance->scale;
+                out.x = instance->x + c * px + s * pz; // As the instanced vertex shader
+                out.y *= instance->scale;
+                out.z = instance->z - s * px + c * pz;
+                layer->baked[(size_t)i * model->numVertices + v] = out;
+            }
+        }
+    }
+}
+
+
+// --- Build ---
+void buildScenery(TrackType type) {
+    freeScenery();
+    if (sceneryObjectCount <= 0) return;
+    ensureSceneryModels();
+    randomState = 12345u + (unsigned int)type; // Same layout every race on a track
+
+    // Outer road edges: the rectangular track lies inside its main size, the rounded one is centred on it
+    float halfWidth = type == TRACK_RECT ? RECT_OUTER_X_POS : ROUND_TRACK_MAIN_WIDTH * 0.5f + ROUND_HALF_ROAD_WIDTH;
+    float halfLength = type == TRACK_RECT ? RECT_OUTER_Z_POS : ROUND_TRACK_MAIN_LENGTH * 0.5f + ROUND_HALF_ROAD_WIDTH;
+    float road = type == TRACK_RECT ? RECT_TRACK_ROAD_WIDTH : ROUND_TRACK_ROAD_WIDTH;
+    float straightX = type == TRACK_RECT ? RECT_INNER_X_POS : ROUND_STRAIGHT_X_LIMIT; // Where corners begin
+    float straightZ = type == TRACK_RECT ? RECT_INNER_Z_POS : ROUND_STRAIGHT_Z_LIMIT;
+    const Straight straights[4] = {
+        { 1.0f, 0.0f, halfWidth, straightZ }, { -1.0f, 0.0f, halfWidth, straightZ }, // Right (finish), left
+        { 0.0f, 1.0f, halfLength, straightX }, { 0.0f, -1.0f, halfLength, straightX } // Top, bottom
+    };
+
+    // Mix: a few percent cones and barriers, a grandstand per 2500 objects, trees for the rest
+    int total = sceneryObjectCount;
+    int cones = total * 4 / 100, barriers = total * 4 / 100;
+    int stands = total >= 500 ? 1 + total / 2500 : 0;
+    int trees = total - cones - barriers - stands;
+
+    // Cones in the infield inside the inner guardrail, barriers outside the outer one, stands behind
+    // them (the guardrails stand TRACK_RUNOFF_WIDTH off the road)
+    float coneEnd = placeAlongStraights(straights, SCENERY_CONE, cones, 3.0f, -(road + TRACK_RUNOFF_WIDTH + 1.5f), -1.5f, 1);
+    float barrierEnd = placeAlongStraights(straights, SCENERY_BARRIER, barriers, 2.2f, TRACK_RUNOFF_WIDTH + 2.0f, 1.0f, 0);
+    float standEnd = placeAlongStraights(straights, SCENERY_GRANDSTAND, stands, 22.0f, barrierEnd + 3.0f, 12.0f, 0);
+
+    // Trees anywhere on the ground outside the band used above
+    float clearOuter = (stands > 0 ? standEnd : barrierEnd) + 2.0f;
+    float clearInner = road - coneEnd + 3.0f; // coneEnd is negative (infield)
+    float groundSize = fmaxf(RECT_TRACK_MAIN_WIDTH, RECT_TRACK_MAIN_LENGTH) * 1.2f; // As the ground quad of both tracks
+    int placed = 0;
+    for (long attempt = 0; placed < trees && attempt < (long)trees * 20; ++attempt) {
+        float x = (randomFloat() * 2.0f - 1.0f) * groundSize;
+        float z = (randomFloat() * 2.0f - 1.0f) * groundSize;
+        int outside = fabsf(x) > halfWidth + clearOuter || fabsf(z) > halfLength + clearOuter;
+        int infield = fabsf(x) < halfWidth - clearInner && fabsf(z) < halfLength - clearInner;
+        if (!outside && !infield) continue;
+        addInstance(SCENERY_TREE, x, z, randomFloat() * 6.2831853f, 0.8f + 0.6f * randomFloat());
+        placed++;
+    }
+
+    int visibleNeeded = 0;
+    for (int t = 0; t < NUM_SCENERY_TYPES; ++t) {
+        finishLayer((SceneryType)t);
+        if (layers[t].count > visibleNeeded) visibleNeeded = layers[t].count;
+    }
+    if (visibleNeeded > visibleCapacity) {
+        free(visibleInstances);
+        visibleInstances = (MeshInstance*)malloc((size_t)visibleNeeded * sizeof(MeshInstance));
+        visibleCapacity = visibleInstances ? visibleNeeded : 0;
+    }
+    printf("Status: Scenery: %d cones, %d barriers, %d trees, %d grandstands (%s)\n",
+           layers[SCENERY_CONE].count, layers[SCENERY_BARRIER].count, layers[SCENERY_TREE].count,
+           layers[SCENERY_GRANDSTAND].count, models[0].gpuModel >= 0 ? "instanced" : "baked vertex arrays");
+}
+
+void freeScenery() {
+    for (int t = 0; t < NUM_SCENERY_TYPES; ++t) {
+        free(layers[t].instances);
+        free(layers[t].chunks);
+        free(layers[t].baked);
+        layers[t].instances = NULL; layers[t].chunks = NULL; layers[t].baked = NULL;
+        layers[t].count = layers[t].capacity = layers[t].numChunks = 0;
+    }
+}
+
+
+// --- Drawing ---
+void resetSceneryStats(void) {
+    sceneryStats.instancesDrawn = 0;
+    sceneryStats.chunksDrawn = sceneryStats.chunksCulled = 0;
+    sceneryStats.drawCalls = 0;
+}
+
+// Visible chunks of one type; touching ranges are merged. Instanced: the ranges are gathered
+// and drawn with one call. Baked: one glDrawArrays per range (vertex arrays already set).
+static void drawLayer(SceneryType type, const Frustum* frustum) {
+    const SceneryLayer* layer = &layers[type];
+    const SceneryModel* model = &models[type];
+    int instanced = model->gpuModel >= 0;
+    int numVisible = 0;
+    int rangeFirst = 0, rangeCount = 0;
+    for (int c = 0; c <= layer->numChunks; ++c) {
+        const SceneryChunk* chunk = c < layer->numChunks ? &layer->chunks[c] : NULL;
+        int visible = chunk && (!frustum || isBoxInFrustum(frustum, chunk->boundsMin, chunk->boundsMax));
+        if (chunk) { if (visible) sceneryStats.chunksDrawn++; else sceneryStats.chunksCulled++; }
+        if (visible && rangeCount > 0 && chunk->first == rangeFirst + rangeCount) {
+            rangeCount += chunk->count; // Continues the current range
+            continue;
+        }
+        if (rangeCount > 0) { // Flush the finished range
+            if (instanced) {
+                for (int i = 0; i < rangeCount && numVisible < visibleCapacity; ++i) visibleInstances[numVisible++] = layer->instances[rangeFirst + i];
+            } else {
+                glDrawArrays(GL_TRIANGLES, rangeFirst * model->numVertices, rangeCount * model->numVertices);
+                sceneryStats.drawCalls++;
+                numVisible += rangeCount;
+            }
+        }
+        rangeFirst = visible ? chunk->first : 0;
+        rangeCount = visible ? chunk->count : 0;
+    }
+    if (instanced && numVisible > 0) {
+        submitInstancedDraw(model->gpuModel, visibleInstances, numVisible); // One draw for the whole type
+        sceneryStats.drawCalls++;
+    }
+    sceneryStats.instancesDrawn += numVisible;
+}
+
+void renderScenery(const Frustum* frustum) {
+    int baked = 0;
+    for (int t = 0; t < NUM_SCENERY_TYPES; ++t) baked |= layers[t].baked != NULL;
+    if (baked) {
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+    }
+    for (int t = 0; t < NUM_SCENERY_TYPES; ++t) {
+        const SceneryLayer* layer = &layers[t];
+        if (layer->count == 0) continue;
+        if (models[t].gpuModel < 0) {
+            if (!layer->baked) continue;
+            glVertexPointer(3, GL_FLOAT, sizeof(MeshVertex), &layer->baked[0].x);
+            glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(MeshVertex), layer->baked[0].color);
+        }
+        drawLayer((SceneryType)t, frustum);
+    }
+    if (baked) {
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+    }
+}
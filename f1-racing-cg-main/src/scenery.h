@@ -0,0 +1,42 @@
+#ifndef SCENERY_H
+#define SCENERY_H
+
+#include "game.h"       // TrackType
+#include "frustum.h"    // Chunks are culled against a Frustum
+#include "renderer.h"   // MeshInstance
+
+// --- Trackside Scenery ---
+// Cones, barriers, trees and grandstands placed around the selected track (deterministically,
+// from the object count). Objects are stored as one instance array per type, sorted into the
+// same square chunks as the track mesh; each frame the visible chunks' instances are gathered
+// and drawn with a single instanced draw per type (shader path). The fixed-function path has
+// no instancing and draws the same ranges from pre-transformed vertex arrays instead.
+
+#define SCENERY_DEFAULT_OBJECTS 5000 // --scenery <count> / scenery=<count>; 0 turns it off
+
+typedef enum {
+    SCENERY_CONE,
+    SCENERY_BARRIER,
+    SCENERY_TREE,
+    SCENERY_GRANDSTAND,
+    NUM_SCENERY_TYPES
+} SceneryType;
+
+// --- Per-Frame Statistics ---
+// Accumulated by renderScenery() until reset (e.g. once per frame by a benchmark).
+typedef struct {
+    long instancesDrawn;
+    long chunksDrawn, chunksCulled; // Summed over types
+    long drawCalls;
+} SceneryStats;
+
+extern SceneryStats sceneryStats;
+extern int sceneryObjectCount; // Objects placed by the next buildScenery()
+
+// --- Function Declarations ---
+void buildScenery(TrackType type); // Places sceneryObjectCount objects; call with a current context
+void renderScenery(const Frustum* frustum);
+void freeScenery(void);
+void resetSceneryStats(void);
+
+#endif // SCENERY_H
@@ -0,0 +1,221 @@
+#include "sensors.h"  // castTrackRays() prototype and sensor defaults
+#include "track.h"    // Track dimensions, COLLISION_EPSILON and isPositionOnTrack()
+#include "game.h"     // selectedTrackType
+#include "surface.h"  // TRACK_RUNOFF_WIDTH, guardrail test for cars off the road
+
+#include <math.h>     // For sinf, cosf, sqrtf, fabsf
+
+// Define M_PI if not already defined by math.h
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+// Macro for converting degrees to radians
+#define DEG_TO_RAD(angle) ((angle) * M_PI / 180.0f)
+
+// Branch-free min/max. Written as plain compares (not fminf/fmaxf) so the compiler
+// can turn the per-ray loops below into packed SIMD min/max instructions.
+#define SENSOR_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define SENSOR_MAX(a, b) ((a) > (b) ? (a) : (b))
+
+
+// --- Straight Wall Helper ---
+// Intersects a ray with an axis-aligned wall line at 'wall' (x = wall or z = wall, depending
+// on which components are passed in). The wall only exists while the other coordinate of the
+// hit point stays within +/- 'halfSpan'. Returns the nearer of 'best' and the hit distance.
+static inline float nearerLineHit(float best, float wall, float origin_a, float inv_dir_a,
+                                  float origin_b, float dir_b, float halfSpan) {
+    float t = (wall - origin_a) * inv_dir_a;
+    float hit_b = origin_b + t * dir_b;
+    int valid = (t > 0.0f) & (fabsf(hit_b) <= halfSpan);
+    return (valid & (t < best)) ? t : best;
+}
+
+// --- Corner Arc Helper ---
+// Intersects a ray with the quarter circle of radius 'radius' around a corner centre.
+// (rel_x, rel_z) is the ray origin relative to the centre, 'b' and 'c0' are the shared
+// dot products (rel . dir and rel . rel). Only hits in the corner's own quadrant
+// (sign_x, sign_z pointing away from the track centre) count as walls.
+static inline float nearerArcHit(float best, float radius, float rel_x, float rel_z,
+                                 float dir_x, float dir_z, float b, float c0,
+                                 float sign_x, float sign_z) {
+    float disc = b * b - (c0 - radius * radius);
+    float root = sqrtf(SENSOR_MAX(disc, 0.0f));
+    // Near root first, then far root (the far one matters when starting inside the circle)
+    float t1 = -b - root;
+    float t2 = -b + root;
+    int valid1 = (disc >= 0.0f) & (t1 > 0.0f) &
+                 ((rel_x + t1 * dir_x) * sign_x >= 0.0f) & ((rel_z + t1 * dir_z) * sign_z >= 0.0f);
+    int valid2 = (disc >= 0.0f) & (t2 > 0.0f) &
+                 ((rel_x + t2 * dir_x) * sign_x >= 0.0f) & ((rel_z + t2 * dir_z) * sign_z >= 0.0f);
+    best = (valid1 & (t1 < best)) ? t1 : best;
+    best = (valid2 & (t2 < best)) ? t2 : best;
+    return best;
+}
+
+
+// --- Corner Helper ---
+// Tests both arcs (outer and inner wall) of one corner. They share the same centre,
+// so the dot products are computed once.
+static inline float nearerCornerHit(float best, float ox, float oz, float dir_x, float dir_z,
+                                    float center_x, float center_z, float sign_x, float sign_z,
+                                    float outer_r, float inner_r) {
+    float rel_x = ox - center_x;
+    float rel_z = oz - center_z;
+    float b = rel_x * dir_x + rel_z * dir_z;
+    float c0 = rel_x * rel_x + rel_z * rel_z;
+    best = nearerArcHit(best, outer_r, rel_x, rel_z, dir_x, dir_z, b, c0, sign_x, sign_z);
+    best = nearerArcHit(best, inner_r, rel_x, rel_z, dir_x, dir_z, b, c0, sign_x, sign_z);
+    return best;
+}
+
+
+// --- Rectangular Track Rays ---
+// The drivable area is the outer rectangle minus the inner (infield) rectangle, so a ray
+// from a point on track ends either where it leaves the outer box or where it enters the inner one.
+// 'margin' moves both walls outwards from the road edges (0 = the road, see castTrackRays()).
+static void castRectRayBlock(float ox, float oz, const float* dir_x, const float* dir_z,
+                             float maxDistance, float margin, float* out) {
+    // Same boundaries (and tolerance) as isPositionOnTrack() at margin 0, so 0 distance == at the
+    // road edge; at TRACK_RUNOFF_WIDTH they are the guardrails (surface.h)
+    const float edge = COLLISION_EPSILON + margin;
+    const float outer_x_min = RECT_OUTER_X_NEG - edge;
+    const float outer_x_max = RECT_OUTER_X_POS + edge;
+    const float outer_z_min = RECT_OUTER_Z_NEG - edge;
+    const float outer_z_max = RECT_OUTER_Z_POS + edge;
+    const float inner_x_min = RECT_INNER_X_NEG + edge;
+    const float inner_x_max = RECT_INNER_X_POS - edge;
+    const float inner_z_min = RECT_INNER_Z_NEG + edge;
+    const float inner_z_max = RECT_INNER_Z_POS - edge;
+
+    for (int i = 0; i < SENSOR_RAY_BLOCK; ++i) {
+        // Division by a zero component gives +/-inf, which the slab test handles naturally
+        float inv_x = 1.0f / dir_x[i];
+        float inv_z = 1.0f / dir_z[i];
+
+        // Outer box: the origin is inside, so the wall is the far slab on each axis
+        float ox1 = (outer_x_min - ox) * inv_x; float ox2 = (outer_x_max - ox) * inv_x;
+        float oz1 = (outer_z_min - oz) * inv_z; float oz2 = (outer_z_max - oz) * inv_z;
+        float t_outer = SENSOR_MIN(SENSOR_MAX(ox1, ox2), SENSOR_MAX(oz1, oz2));
+
+        // Inner box: standard slab entry test
+        float ix1 = (inner_x_min - ox) * inv_x; float ix2 = (inner_x_max - ox) * inv_x;
+        float iz1 = (inner_z_min - oz) * inv_z; float iz2 = (inner_z_max - oz) * inv_z;
+        float t_near = SENSOR_MAX(SENSOR_MIN(ix1, ix2), SENSOR_MIN(iz1, iz2));
+        float t_far  = SENSOR_MIN(SENSOR_MAX(ix1, ix2), SENSOR_MAX(iz1, iz2));
+        float t_inner = ((t_near <= t_far) & (t_near >= 0.0f)) ? t_near : maxDistance;
+
+        float t = SENSOR_MIN(t_outer, t_inner);
+        out[i] = SENSOR_MIN(t, maxDistance);
+    }
+}
+
+// --- Rounded Track Rays ---
+// Walls are 4 outer + 4 inner straight lines plus 4 outer + 4 inner quarter arcs.
+// Every ray is tested against all 16 primitives without early exits; the nearest hit wins.
+// 'margin' moves the walls outwards from the road edges, as for the rectangular track.
+static void castRoundRayBlock(float ox, float oz, const float* dir_x, const float* dir_z,
+                              float maxDistance, float margin, float* out) {
+    // Wall positions with the same tolerance as isPositionOnTrack() (at margin 0)
+    const float edge = COLLISION_EPSILON + margin;
+    const float outer_x = ROUND_TRACK_MAIN_WIDTH / 2.0f + ROUND_HALF_ROAD_WIDTH + edge;
+    const float inner_x = ROUND_TRACK_MAIN_WIDTH / 2.0f - ROUND_HALF_ROAD_WIDTH - edge;
+    const float outer_z = ROUND_TRACK_MAIN_LENGTH / 2.0f + ROUND_HALF_ROAD_WIDTH + edge;
+    const float inner_z = ROUND_TRACK_MAIN_LENGTH / 2.0f - ROUND_HALF_ROAD_WIDTH - edge;
+    const float outer_r = ROUND_OUTER_CORNER_RADIUS + edge;
+    const float inner_r = ROUND_INNER_CORNER_RADIUS - edge;
+
+    for (int i = 0; i < SENSOR_RAY_BLOCK; ++i) {
+        float dx = dir_x[i];
+        float dz = dir_z[i];
+        float inv_x = 1.0f / dx;
+        float inv_z = 1.0f / dz;
+        float best = maxDistance;
+
+        // Left/right straights (x = const, valid while |z| <= straight limit)
+        best = nearerLineHit(best,  outer_x, ox, inv_x, oz, dz, ROUND_STRAIGHT_Z_LIMIT);
+        best = nearerLineHit(best, -outer_x, ox, inv_x, oz, dz, ROUND_STRAIGHT_Z_LIMIT);
+        best = nearerLineHit(best,  inner_x, ox, inv_x, oz, dz, ROUND_STRAIGHT_Z_LIMIT);
+        best = nearerLineHit(best, -inner_x, ox, inv_x, oz, dz, ROUND_STRAIGHT_Z_LIMIT);
+        // Top/bottom straights (z = const, valid while |x| <= straight limit)
+        best = nearerLineHit(best,  outer_z, oz, inv_z, ox, dx, ROUND_STRAIGHT_X_LIMIT);
+        best = nearerLineHit(best, -outer_z, oz, inv_z, ox, dx, ROUND_STRAIGHT_X_LIMIT);
+        best = nearerLineHit(best,  inner_z, oz, inv_z, ox, dx, ROUND_STRAIGHT_X_LIMIT);
+        best = nearerLineHit(best, -inner_z, oz, inv_z, ox, dx, ROUND_STRAIGHT_X_LIMIT);
+
+        // Corner arcs (TR, TL, BL, BR), written out so the loop body stays branch-free
+        best = nearerCornerHit(best, ox, oz, dx, dz, ROUND_CORNER_CENTER_TR_X, ROUND_CORNER_CENTER_TR_Z,  1.0f,  1.0f, outer_r, inner_r);
+        best = nearerCornerHit(best, ox, oz, dx, dz, ROUND_CORNER_CENTER_TL_X, ROUND_CORNER_CENTER_TL_Z, -1.0f,  1.0f, outer_r, inner_r);
+        best = nearerCornerHit(best, ox, oz, dx, dz, ROUND_CORNER_CENTER_BL_X, ROUND_CORNER_CENTER_BL_Z, -1.0f, -1.0f, outer_r, inner_r);
+        best = nearerCornerHit(best, ox, oz, dx, dz, ROUND_CORNER_CENTER_BR_X, ROUND_CORNER_CENTER_BR_Z,  1.0f, -1.0f, outer_r, inner_r);
+
+        out[i] = best;
+    }
+}
+
+
+// --- Sensor Fan Helper ---
+void makeSensorFan(float fovDeg, int numRays, float* outAnglesDeg) {
+    if (numRays == 1) { outAnglesDeg[0] = 0.0f; return; }
+    for (int i = 0; i < numRays; ++i) {
+        // Left-most ray first (positive angles turn left, see updateCar())
+        outAnglesDeg[i] = fovDeg / 2.0f - fovDeg * (float)i / (float)(numRays - 1);
+    }
+}
+
+
+// --- Batched Raycast ---
+// Loops over blocks of rays on the outside so each ray's relative direction is computed once,
+// then over cars. Every block is padded to SENSOR_RAY_BLOCK rays so the innermost per-ray loops
+// have a fixed trip count and compile to straight-line SIMD code.
+void castTrackRays(const Car* cars, int numCars,
+                   const float* rayAnglesDeg, int numRays,
+                   float maxDistance, float* outDistances) {
+    for (int base = 0; base < numRays; base += SENSOR_RAY_BLOCK) {
+        int count = numRays - base;
+        if (count > SENSOR_RAY_BLOCK) count = SENSOR_RAY_BLOCK;
+
+        // Relative ray directions for this block (padding rays just repeat straight ahead)
+        float rel_sin[SENSOR_RAY_BLOCK], rel_cos[SENSOR_RAY_BLOCK];
+        for (int i = 0; i < SENSOR_RAY_BLOCK; ++i) {
+            float rel_rad = (i < count) ? DEG_TO_RAD(rayAnglesDeg[base + i]) : 0.0f;
+            rel_sin[i] = sinf(rel_rad);
+            rel_cos[i] = cosf(rel_rad);
+        }
+
+        for (int c = 0; c < numCars; ++c) {
+            const Car* car = &cars[c];
+            float* out = outDistances + (long)c * numRays + base;
+
+            // On the road the rays stop at its edges, so the autopilot keeps to the asphalt. A car
+            // that ran wide onto the run-off measures to the guardrails instead: they follow the
+            // road at TRACK_RUNOFF_WIDTH, so the fan still shows where it goes and the car steers
+            // back. Only at (or through) a guardrail is there no free distance at all.
+            float margin = 0.0f;
+            if (!isPositionOnTrack(car->x, car->z)) {
+                if (getSurfaceMaterial(car->x, car->z) == SURFACE_BARRIER) {
+                    for (int i = 0; i < count; ++i) out[i] = 0.0f;
+                    continue;
+                }
+                margin = TRACK_RUNOFF_WIDTH;
+            }
+
+            // World direction = heading rotated by the relative angle.
+            // Heading convention matches updateCar(): dx = sin(angle), dz = cos(angle).
+            float heading_rad = DEG_TO_RAD(car->angle);
+            float sin_h = sinf(heading_rad);
+            float cos_h = cosf(heading_rad);
+            float dir_x[SENSOR_RAY_BLOCK], dir_z[SENSOR_RAY_BLOCK], block_out[SENSOR_RAY_BLOCK];
+            for (int i = 0; i < SENSOR_RAY_BLOCK; ++i) {
+                dir_x[i] = sin_h * rel_cos[i] + cos_h * rel_sin[i];
+                dir_z[i] = cos_h * rel_cos[i] - sin_h * rel_sin[i];
+            }
+
+            if (selectedTrackType == TRACK_RECT) {
+                castRectRayBlock(car->x, car->z, dir_x, dir_z, maxDistance, margin, block_out);
+            } else { // TRACK_ROUNDED
+                castRoundRayBlock(car->x, car->z, dir_x, dir_z, maxDistance, margin, block_out);
+            }
+            for (int i = 0; i < count; ++i) out[i] = block_out[i];
+        }
+    }
+}
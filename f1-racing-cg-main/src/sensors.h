@@ -0,0 +1,25 @@
+#ifndef SENSORS_H
+#define SENSORS_H
+
+#include "car.h" // Car pose (x, z, angle) is the ray origin and heading
+
+// --- Sensor Defaults ---
+#define SENSOR_MAX_DISTANCE 100.0f // Distance reported when a ray hits nothing within range
+#define SENSOR_RAY_BLOCK 16        // Rays processed together per inner loop (keeps direction tables on the stack)
+
+// --- Function Declarations ---
+// Casts 'numRays' rays from the centre of every car against the road edges of the *selected*
+// track (the guardrails instead for a car out on the run-off) and writes the hit distances into a flat array:
+//     outDistances[carIndex * numRays + rayIndex]
+// Ray angles are in degrees relative to the car's heading, using the same convention
+// as car->angle (0 = straight ahead, positive = towards the left).
+// Distances are clamped to 'maxDistance'; a car whose centre is at a guardrail reports 0 on every ray.
+void castTrackRays(const Car* cars, int numCars,
+                   const float* rayAnglesDeg, int numRays,
+                   float maxDistance, float* outDistances);
+
+// Fills 'outAnglesDeg' with 'numRays' angles spread evenly over 'fovDeg' degrees,
+// centred on the car's heading. A single ray points straight ahead.
+void makeSensorFan(float fovDeg, int numRays, float* outAnglesDeg);
+
+#endif // SENSORS_H
@@ -0,0 +1,181 @@
+#include "skidmarks.h"  // SkidMarkStats and prototypes
+#include "game.h"       // FRAME_RATE (ages are counted in simulation ticks)
+#include "renderer.h"   // Streamed quad mesh (shader path), MeshVertex
+#include <GL/glew.h>    // Client vertex arrays (fixed-function path)
+#include <math.h>       // For fabsf, sinf, cosf
+
+#define SKID_FADE_TICKS ((long)(SKID_FADE_SECONDS * FRAME_RATE))
+#define SKID_MARK_Y 0.03f            // Just above the track surface and markings
+#define SKID_MARK_WIDTH 0.25f        // Across the trail, world units
+#define SKID_BRAKE_MIN_SPEED 12.0f   // Braking above this leaves marks from all four wheels
+#define SKID_TURN_SPEED_FRACTION 0.6f // Turning above this share of max_speed leaves rear-wheel marks
+#define SKID_BRAKE_ALPHA 150         // Starting opacity (0-255) of braking and turning marks
+#define SKID_TURN_ALPHA 100
+
+SkidMarkStats skidMarkStats = { 0, 0 };
+
+// --- Ring of Quads ---
+// Corners in MeshVertex order for the quad index pattern 0 1 2 0 2 3: start-left, start-right,
+// end-right, end-left. Alpha in the ring is the starting opacity; the fade is applied when staging.
+static MeshVertex ringVertices[SKID_MAX_QUADS * 4];
+static long ringTicks[SKID_MAX_QUADS]; // Tick each quad was laid
+static int ringStart = 0, ringCount = 0; // Oldest live quad, live quads (ring order = age order)
+
+static MeshVertex stagingVertices[SKID_MAX_QUADS * 4]; // Live quads, oldest first, faded
+static long stagedTick = -1; // Tick stagingVertices (and the GPU copy) were built for; -1 = stale
+static unsigned short quadIndices[SKID_MAX_QUADS * 6];  // Fixed-function path
+static int quadIndicesBuilt = 0;
+static int gpuMesh = -2; // createQuadMesh() id; -1 = fixed-function path, -2 = not created yet
+
+// --- Wheel Trails ---
+// The last edge laid by each wheel, so consecutive quads share corners and the trail has no gaps.
+typedef struct {
+    int active;                  // 0 = the next skidding tick only starts a trail
+    float leftX, leftZ, rightX, rightZ;
+} WheelTrail;
+
+static WheelTrail trails[SKID_MAX_CARS][4]; // Front-left, front-right, rear-left, rear-right
+
+
+void clearSkidMarks() {
+    ringStart = ringCount = 0;
+    stagedTick = -1;
+    for (int c = 0; c < SKID_MAX_CARS; ++c) {
+        for (int w = 0; w < 4; ++w) trails[c][w].active = 0;
+    }
+    skidMarkStats.quadsLaid = 0;
+    skidMarkStats.quadsLive = 0;
+}
+
+static void setCorner(MeshVertex* vertex, float x, float z, unsigned char alpha) {
+    vertex->x = x;
+    vertex->y = SKID_MARK_Y;
+    vertex->z = z;
+    vertex->color[0] = vertex->color[1] = vertex->color[2] = 20; // Rubber
+    vertex->color[3] = alpha;
+}
+
+// Writes the next quad over the oldest once the ring is full
+static void layQuad(const WheelTrail* from, float leftX, float leftZ, float rightX, float rightZ,
+                    unsigned char alpha, long tick) {
+    int slot = (ringStart + ringCount) % SKID_MAX_QUADS;
+    if (ringCount == SKID_MAX_QUADS) ringStart = (ringStart + 1) % SKID_MAX_QUADS; // Oldest is overwritten
+    else ringCount++;
+    MeshVertex* quad = &ringVertices[slot * 4];
+    setCorner(&quad[0], from->leftX, from->leftZ, alpha);
+    setCorner(&quad[1], from->rightX, from->rightZ, alpha);
+    setCorner(&quad[2], rightX, rightZ, alpha);
+    setCorner(&quad[3], leftX, leftZ, alpha);
+    ringTicks[slot] = tick;
+    skidMarkStats.quadsLaid++;
+}
+
+
+// --- Generation (once per simulation tick) ---
+int getSkiddingWheels(const Car* car, float wheelXZ[4][2]) {
+    float speed = fabsf(car->speed);
+    int braking = car->braking && speed > SKID_BRAKE_MIN_SPEED;
+    int turning = (car->turning_left != car->turning_right) && speed > car->max_speed * SKID_TURN_SPEED_FRACTION;
+
+    // Wheel centres as drawn by renderCar()
+    float wheelWidth = 0.15f * car->width;
+    float wheelDistX = (car->width / 2.0f) + wheelWidth * 0.5f;
+    float wheelDistZ = (car->length / 2.0f) * 0.7f;
+    calculateCarCorners(car->x, car->z, car->angle, 2.0f * wheelDistX, 2.0f * wheelDistZ,
+                        &wheelXZ[0][0], &wheelXZ[0][1], &wheelXZ[1][0], &wheelXZ[1][1],
+                        &wheelXZ[2][0], &wheelXZ[2][1], &wheelXZ[3][0], &wheelXZ[3][1]);
+    if (braking) return 0xF;
+    return turning ? 0xC : 0; // Hard turns slide the rear
+}
+
+void updateSkidMarks(int carIndex, const Car* car, long tick) {
+    if (carIndex < 0 || carIndex >= SKID_MAX_CARS) return;
+    float wheel[4][2];
+    int skidding = getSkiddingWheels(car, wheel);
+    unsigned char alpha = (skidding & 0x3) ? SKID_BRAKE_ALPHA : SKID_TURN_ALPHA; // Front wheels only slide under braking
+
+    // Across the car (its local +X), half a mark wide
+    float angleRad = car->angle * 3.14159265f / 180.0f;
+    float acrossX = cosf(angleRad) * SKID_MARK_WIDTH * 0.5f;
+    float acrossZ = -sinf(angleRad) * SKID_MARK_WIDTH * 0.5f;
+
+    for (int w = 0; w < 4; ++w) {
+        WheelTrail* trail = &trails[carIndex][w];
+        if (!(skidding & (1 << w))) { trail->active = 0; continue; }
+        float leftX = wheel[w][0] - acrossX, leftZ = wheel[w][1] - acrossZ;
+        float rightX = wheel[w][0] + acrossX, rightZ = wheel[w][1] + acrossZ;
+        if (trail->active) layQuad(trail, leftX, leftZ, rightX, rightZ, alpha, tick);
+        trail->active = 1;
+        trail->leftX = leftX; trail->leftZ = leftZ;
+        trail->rightX = rightX; trail->rightZ = rightZ;
+    }
+}
+
+
+// --- Drawing ---
+// Drops the quads that have faded out and copies the rest, oldest first, into the staging array
+// with the fade applied to alpha
+static void stageSkidMarks(long tick) {
+    // Quads that have faded out completely leave from the old end of the ring
+    while (ringCount > 0 && tick - ringTicks[ringStart] >= SKID_FADE_TICKS) {
+        ringStart = (ringStart + 1) % SKID_MAX_QUADS;
+        ringCount--;
+    }
+    skidMarkStats.quadsLive = ringCount;
+
+    for (int i = 0; i < ringCount; ++i) {
+        int slot = (ringStart + i) % SKID_MAX_QUADS;
+        float remaining = 1.0f - (float)(tick - ringTicks[slot]) / SKID_FADE_TICKS;
+        if (remaining > 1.0f) remaining = 1.0f; // Laid after the tick being drawn (e.g. a late frame)
+        const MeshVertex* source = &ringVertices[slot * 4];
+        MeshVertex* target = &stagingVertices[i * 4];
+        for (int k = 0; k < 4; ++k) {
+            target[k] = source[k];
+            target[k].color[3] = (unsigned char)(source[k].color[3] * remaining);
+        }
+    }
+    stagedTick = tick;
+}
+
+// The marks only change with the simulation tick, so the fade and the upload happen once per
+// tick; further views of the same tick (split-screen, frames between ticks) only draw.
+void renderSkidMarks(long tick) {
+    if (gpuMesh == -2) gpuMesh = createQuadMesh(SKID_MAX_QUADS); // -1 without the shader path
+    if (tick != stagedTick) {
+        stageSkidMarks(tick);
+        if (gpuMesh >= 0) uploadQuadMesh(gpuMesh, stagingVertices, ringCount);
+    }
+    if (ringCount == 0) return;
+    if (gpuMesh >= 0) {
+        submitQuadMesh(gpuMesh, ringCount); // One glDrawElements
+        return;
+    }
+
+    if (!quadIndicesBuilt) {
+        for (int q = 0; q < SKID_MAX_QUADS; ++q) {
+            const int order[6] = { 0, 1, 2, 0, 2, 3 };
+            for (int k = 0; k < 6; ++k) quadIndices[q * 6 + k] = (unsigned short)(q * 4 + order[k]);
+        }
+        quadIndicesBuilt = 1;
+    }
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_POLYGON_BIT);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);          // Marks never hide each other or what's drawn after them
+    glEnable(GL_POLYGON_OFFSET_FILL); // Pulled towards the camera, no z-fighting with the ground
+    glPolygonOffset(-1.0f, -1.0f);
+    glDisable(GL_CULL_FACE);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(MeshVertex), &stagingVertices[0].x);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(MeshVertex), stagingVertices[0].color);
+    glDrawElements(GL_TRIANGLES, ringCount * 6, GL_UNSIGNED_SHORT, quadIndices);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glPopAttrib();
+}
+
+void freeSkidMarks() {
+    clearSkidMarks();
+    gpuMesh = -2; // The renderer deletes its quad meshes in shutdownRenderer()
+}
@@ -0,0 +1,34 @@
+#ifndef SKIDMARKS_H
+#define SKIDMARKS_H
+
+#include "car.h" // Car (wheel positions, controls)
+
+// --- Skid Marks ---
+// Dark strips laid behind the wheels while a car brakes hard or turns hard at speed. Marks live
+// in a fixed ring of quads: the newest overwrites the oldest in place, and each fades out with
+// age, so memory is bounded however long a session lasts. Every frame the live quads are copied
+// (oldest first, with their faded alpha) into one staging array, streamed to one orphaned vertex
+// buffer and drawn with a single call (shader path; the fixed-function path draws the same array).
+
+#define SKID_MAX_QUADS 4096      // Ring capacity (16 bytes x 4 vertices each)
+#define SKID_MAX_CARS 4          // Cars with their own wheel trails (index passed to updateSkidMarks)
+#define SKID_FADE_SECONDS 20.0f  // Age at which a mark has faded out completely
+
+// --- Statistics ---
+typedef struct {
+    long quadsLaid; // Since the last clearSkidMarks()
+    int quadsLive;  // Quads drawn by the last renderSkidMarks()
+} SkidMarkStats;
+
+extern SkidMarkStats skidMarkStats;
+
+// --- Function Declarations ---
+// Wheels sliding this tick as a bitmask (1 << wheel; front-left, front-right, rear-left, rear-right)
+// and all four wheel centres. Shared with the tyre smoke (particles.c).
+int getSkiddingWheels(const Car* car, float wheelXZ[4][2]);
+void clearSkidMarks(void);                                  // Empties the ring and breaks every trail
+void updateSkidMarks(int carIndex, const Car* car, long tick); // After the car's simulation step
+void renderSkidMarks(long tick);                            // Within the race scene, after the opaque geometry
+void freeSkidMarks(void);
+
+#endif // SKIDMARKS_H
@@ -0,0 +1,50 @@
+#include "snapshot.h"
+#include <string.h> // For memcpy
+
+// --- Snapshot Ring ---
+// Slot tick % SNAPSHOT_FRAMES holds that tick's state; 'tick' says whether the slot is current
+// or left over from a tick SNAPSHOT_FRAMES (or more) earlier.
+typedef struct {
+    long tick;       // simTickCount the state belongs to, -1 = empty
+    RaceState state;
+} RaceSnapshot;
+
+static RaceSnapshot snapshots[SNAPSHOT_FRAMES];
+
+static RaceSnapshot* slotFor(long tick) {
+    return &snapshots[tick % SNAPSHOT_FRAMES];
+}
+
+void clearSnapshots(void) {
+    for (int i = 0; i < SNAPSHOT_FRAMES; ++i) snapshots[i].tick = -1;
+}
+
+void saveSnapshot(void) {
+    RaceSnapshot* slot = slotFor(simTickCount);
+    slot->tick = simTickCount;
+    memcpy(&slot->state, &raceState, sizeof(RaceState));
+}
+
+int hasSnapshot(long tick) {
+    return tick >= 0 && slotFor(tick)->tick == tick;
+}
+
+int restoreSnapshot(long tick) {
+    if (!hasSnapshot(tick)) return 0;
+    memcpy(&raceState, &slotFor(tick)->state, sizeof(RaceState));
+    simTickCount = tick;
+    return 1;
+}
+
+
+// --- Resimulation ---
+int resimulateFrom(long tick, SnapshotInputFunc applyInputs, void* user) {
+    long presentTick = simTickCount;
+    if (tick > presentTick || !restoreSnapshot(tick)) return -1;
+    while (simTickCount < presentTick) {
+        if (applyInputs) applyInputs(simTickCount, user);
+        simulateRaceTick(0); // Advances simTickCount
+        saveSnapshot();      // Replaces the mispredicted state of this tick
+    }
+    return (int)(presentTick - tick);
+}
@@ -0,0 +1,29 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "game.h" // RaceState, raceState, simTickCount
+
+// --- Rollback Snapshots ---
+// A preallocated ring of the last SNAPSHOT_FRAMES race states, one per simulated tick, for
+// prediction and rewind: run ahead on guessed controls, and when the real ones turn out
+// different, restore the tick they first differed on and resimulate up to the present.
+// Saving or restoring is one contiguous memcpy of raceState (all MAX_RACE_CARS cars with their
+// controls, lap timers and finish line states, about 2.7 KB), well under a microsecond.
+// Visual effects (skid marks, particles) are not part of the state.
+
+#define SNAPSHOT_FRAMES 128 // Ticks that can be rewound (about 2 seconds at 60 Hz)
+
+// Called before each resimulated tick to put the controls for 'tick' (the tick about to be
+// simulated) on the cars, e.g. from a buffer of confirmed and predicted inputs.
+typedef void (*SnapshotInputFunc)(long tick, void* user);
+
+// --- Function Declarations ---
+void clearSnapshots(void);           // Forgets every saved tick (initGame() does this on each start)
+void saveSnapshot(void);             // Saves raceState as tick simTickCount, replacing the oldest
+int hasSnapshot(long tick);          // 1 if 'tick' is still in the ring
+int restoreSnapshot(long tick);      // Puts raceState and simTickCount back to 'tick'. Returns 0 if it's gone
+// Restores 'tick' and simulates forward (no visual effects) to the current tick again, saving
+// each tick it passes. Returns the number of ticks resimulated, or -1 if 'tick' can't be restored.
+int resimulateFrom(long tick, SnapshotInputFunc applyInputs, void* user);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,201 @@
+// Track surface materials: the exact classification from the track geometry, and the baked tiled
+// maps updateCar() samples under each wheel. No GL: also linked into the dedicated server.
+#include "surface.h"
+#include "track.h"  // Track dimensions, COLLISION_EPSILON
+#include "timing.h" // sleepSeconds() while another thread bakes
+#include <math.h>   // For fabsf, sqrtf
+#include <stdio.h>  // For fprintf
+
+#define SURFACE_CELLS_X (SURFACE_TILES_X * SURFACE_TILE_CELLS)
+#define SURFACE_CELLS_Z (SURFACE_TILES_Z * SURFACE_TILE_CELLS)
+#define SURFACE_MAX_TILES 256   // Tile pool per track, as the index is one byte (the rounded track needs about 200)
+#define SURFACE_HASH_SLOTS 512  // Open addressing while baking: a power of two above SURFACE_MAX_TILES
+
+// Grip and drag per material. Asphalt has no drag, so a car on it is unchanged; the drag elsewhere
+// sets the top speed there (accel * grip / drag: about 10 units/s on grass, 2 on gravel).
+const SurfaceGrip surfaceGrip[NUM_SURFACES] = {
+    { 1.00f, 0.00f },  // SURFACE_ASPHALT
+    { 0.90f, 0.05f },  // SURFACE_KERB
+    { 0.50f, 0.35f },  // SURFACE_GRASS
+    { 0.30f, 1.20f },  // SURFACE_GRAVEL
+    { 0.00f, 0.00f },  // SURFACE_BARRIER (updateCar() never lets a wheel stay there)
+};
+
+// 8x8 cells, one row of 4-bit materials per word (cell x in bits 4x..4x+3)
+typedef struct {
+    unsigned int rows[SURFACE_TILE_CELLS];
+} SurfaceTile;
+
+// Tiles 0..NUM_SURFACES-1 are uniform tiles of that material
+typedef struct {
+    unsigned char index[SURFACE_TILES_Z * SURFACE_TILES_X]; // Tile per 1x1-unit square, row by row from z = 0
+    SurfaceTile tiles[SURFACE_MAX_TILES];
+    int numTiles;
+} SurfaceMap;
+
+static SurfaceMap surfaceMaps[2]; // Indexed by TrackType
+static volatile int surfaceMapsState = 0; // 0 = not baked, 1 = baking, 2 = ready
+
+// --- Classification ---
+// Signed distance from the road centre line (negative on the infield side) plus the offsets from
+// the corner centres (qx, qz > 0 means beyond the straights, in a corner). Plain comparisons
+// rather than fmaxf()/fminf(), which are library calls in a C99 build: isCarOnAsphalt() runs this
+// every tick.
+static float getCentreLineDistance(TrackType type, float x, float z, float* qx, float* qz) {
+    if (type == TRACK_RECT) {
+        // The centre line is a rectangle with square corners, like the road's edges
+        *qx = fabsf(x) - (RECT_OUTER_X_POS - RECT_HALF_ROAD_WIDTH);
+        *qz = fabsf(z) - (RECT_OUTER_Z_POS - RECT_HALF_ROAD_WIDTH);
+        return *qx > *qz ? *qx : *qz;
+    }
+    // Rounded rectangle: straights, then arcs of ROUND_CORNER_RADIUS around the corner centres
+    *qx = fabsf(x) - ROUND_STRAIGHT_X_LIMIT;
+    *qz = fabsf(z) - ROUND_STRAIGHT_Z_LIMIT;
+    float beyond = *qx > *qz ? *qx : *qz;
+    if (*qx > 0.0f && *qz > 0.0f) beyond = sqrtf(*qx * *qx + *qz * *qz); // In a corner
+    return beyond - ROUND_CORNER_RADIUS;
+}
+
+// Asphalt to the road edges, kerbs outside them, then run-off to the guardrails at
+// TRACK_RUNOFF_WIDTH (+ COLLISION_EPSILON, as isPositionOnTrack() allows at the road edges):
+// gravel on the outside of the corners and just before them, grass everywhere else.
+SurfaceMaterial classifySurface(TrackType type, float x, float z) {
+    float qx, qz;
+    float centre = getCentreLineDistance(type, x, z, &qx, &qz);
+    float halfRoad = (type == TRACK_RECT) ? RECT_HALF_ROAD_WIDTH : ROUND_HALF_ROAD_WIDTH;
+    float offRoad = fabsf(centre) - halfRoad; // Distance beyond the nearer road edge
+
+    if (offRoad <= 0.0f) return SURFACE_ASPHALT;
+    if (offRoad <= TRACK_KERB_WIDTH) return SURFACE_KERB;
+    if (offRoad > TRACK_RUNOFF_WIDTH + COLLISION_EPSILON) return SURFACE_BARRIER;
+    if (centre > 0.0f && qx > -SURFACE_GRAVEL_LEAD && qz > -SURFACE_GRAVEL_LEAD) return SURFACE_GRAVEL;
+    return SURFACE_GRASS;
+}
+
+// --- Baking ---
+static unsigned int hashTile(const SurfaceTile* tile) {
+    unsigned int hash = 2166136261u; // FNV-1a over the row words
+    for (int i = 0; i < SURFACE_TILE_CELLS; ++i) {
+        hash ^= tile->rows[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int tilesEqual(const SurfaceTile* a, const SurfaceTile* b) {
+    for (int i = 0; i < SURFACE_TILE_CELLS; ++i) {
+        if (a->rows[i] != b->rows[i]) return 0;
+    }
+    return 1;
+}
+
+// Each cell takes the material at its centre
+static void bakeSurfaceMap(SurfaceMap* map, TrackType type) {
+    static unsigned short hashSlots[SURFACE_HASH_SLOTS]; // Pool index + 1, 0 = empty (only the baking thread gets here)
+    for (int i = 0; i < SURFACE_HASH_SLOTS; ++i) hashSlots[i] = 0;
+
+    for (int m = 0; m < NUM_SURFACES; ++m) {
+        unsigned int row = 0;
+        for (int cx = 0; cx < SURFACE_TILE_CELLS; ++cx) row |= (unsigned int)m << (cx * 4);
+        for (int cz = 0; cz < SURFACE_TILE_CELLS; ++cz) map->tiles[m].rows[cz] = row;
+    }
+    map->numTiles = NUM_SURFACES;
+
+    int overflow = 0;
+    for (int tz = 0; tz < SURFACE_TILES_Z; ++tz) {
+        for (int tx = 0; tx < SURFACE_TILES_X; ++tx) {
+            SurfaceTile tile;
+            int uniform = 1;
+            unsigned int first = 0;
+            for (int cz = 0; cz < SURFACE_TILE_CELLS; ++cz) {
+                unsigned int row = 0;
+                float z = ((tz * SURFACE_TILE_CELLS + cz) + 0.5f) * SURFACE_CELL_SIZE;
+                for (int cx = 0; cx < SURFACE_TILE_CELLS; ++cx) {
+                    float x = ((tx * SURFACE_TILE_CELLS + cx) + 0.5f) * SURFACE_CELL_SIZE;
+                    unsigned int material = (unsigned int)classifySurface(type, x, z);
+                    if (cz == 0 && cx == 0) first = material;
+                    if (material != first) uniform = 0;
+                    row |= material << (cx * 4);
+                }
+                tile.rows[cz] = row;
+            }
+
+            int tileIndex = (int)first;
+            if (!uniform) {
+                unsigned int slot = hashTile(&tile) & (SURFACE_HASH_SLOTS - 1);
+                while (hashSlots[slot] && !tilesEqual(&map->tiles[hashSlots[slot] - 1], &tile)) {
+                    slot = (slot + 1) & (SURFACE_HASH_SLOTS - 1);
+                }
+                if (hashSlots[slot]) {
+                    tileIndex = hashSlots[slot] - 1;
+                } else if (map->numTiles < SURFACE_MAX_TILES) {
+                    tileIndex = map->numTiles++;
+                    map->tiles[tileIndex] = tile;
+                    hashSlots[slot] = (unsigned short)(tileIndex + 1);
+                } else {
+                    overflow++; // Pool full: keep the uniform tile of its first cell
+                }
+            }
+            map->index[tz * SURFACE_TILES_X + tx] = (unsigned char)tileIndex;
+        }
+    }
+    if (overflow > 0) {
+        fprintf(stderr, "Warning: Surface map for track type %d needs more than %d tiles (%d approximated)\n",
+                (int)type, SURFACE_MAX_TILES, overflow);
+    }
+}
+
+void bakeSurfaceMaps() {
+    if (__atomic_load_n(&surfaceMapsState, __ATOMIC_ACQUIRE) == 2) return;
+    if (__sync_bool_compare_and_swap(&surfaceMapsState, 0, 1)) {
+        bakeSurfaceMap(&surfaceMaps[TRACK_RECT], TRACK_RECT);
+        bakeSurfaceMap(&surfaceMaps[TRACK_ROUNDED], TRACK_ROUNDED);
+        __atomic_store_n(&surfaceMapsState, 2, __ATOMIC_RELEASE);
+        return;
+    }
+    // Another thread is baking (about 20 ms, once per process). The headless worker pools bake
+    // on their main thread before starting any workers, so this is only a fallback: sleep, don't spin.
+    while (__atomic_load_n(&surfaceMapsState, __ATOMIC_ACQUIRE) != 2) sleepSeconds(0.001);
+}
+
+// --- Lookup ---
+// The road's distance function changes by at most the distance moved, so every corner is at least
+// this far inside the edges; one more cell size keeps each corner's cell centre (what the map
+// holds) inside them too.
+int isCarOnAsphalt(float x, float z, float halfDiagonal) {
+    float qx, qz;
+    float centre = getCentreLineDistance(selectedTrackType, x, z, &qx, &qz);
+    float halfRoad = (selectedTrackType == TRACK_RECT) ? RECT_HALF_ROAD_WIDTH : ROUND_HALF_ROAD_WIDTH;
+    return fabsf(centre) <= halfRoad - halfDiagonal - SURFACE_CELL_SIZE;
+}
+
+// Without a branch: positions are folded into the quarter and the bounds are applied to the
+// integer cell (a power-of-two row keeps the index a shift). A cell beyond the map, or from a
+// NaN (which converts to INT_MIN), becomes its last cell, which is guardrail.
+static inline unsigned char lookupSurface(const SurfaceMap* map, float x, float z) {
+    unsigned int cx = (unsigned int)(int)(fabsf(x) * (1.0f / SURFACE_CELL_SIZE));
+    unsigned int cz = (unsigned int)(int)(fabsf(z) * (1.0f / SURFACE_CELL_SIZE));
+    cx = cx < SURFACE_CELLS_X - 1 ? cx : SURFACE_CELLS_X - 1;
+    cz = cz < SURFACE_CELLS_Z - 1 ? cz : SURFACE_CELLS_Z - 1;
+    const SurfaceTile* tile = &map->tiles[map->index[(cz >> 3) * SURFACE_TILES_X + (cx >> 3)]];
+    return (unsigned char)((tile->rows[cz & 7] >> ((cx & 7) * 4)) & 15u);
+}
+
+SurfaceMaterial getSurfaceMaterial(float x, float z) {
+    return (SurfaceMaterial)lookupSurface(&surfaceMaps[selectedTrackType], x, z);
+}
+
+// One call and one map for all four, so their loads overlap
+unsigned int getWheelSurfaces(const float xz[8]) {
+    const SurfaceMap* map = &surfaceMaps[selectedTrackType];
+    return (unsigned int)lookupSurface(map, xz[0], xz[1])
+         | (unsigned int)lookupSurface(map, xz[2], xz[3]) << 8
+         | (unsigned int)lookupSurface(map, xz[4], xz[5]) << 16
+         | (unsigned int)lookupSurface(map, xz[6], xz[7]) << 24;
+}
+
+long getSurfaceMapBytes(TrackType type, int* uniqueTiles) {
+    const SurfaceMap* map = &surfaceMaps[type];
+    if (uniqueTiles) *uniqueTiles = map->numTiles;
+    return (long)sizeof(map->index) + (long)map->numTiles * (long)sizeof(SurfaceTile);
+}
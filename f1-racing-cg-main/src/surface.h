@@ -0,0 +1,67 @@
+#ifndef SURFACE_H
+#define SURFACE_H
+
+#include "game.h" // TrackType, selectedTrackType
+
+// --- Track Surfaces ---
+// Every track is asphalt between its road edges, a kerb just outside each edge, then run-off
+// (grass, with gravel traps on the outside of the corners) up to the guardrails. updateCar()
+// looks up the material under each of the four wheels every tick: it scales the car's
+// acceleration and braking (grip) and adds a speed-proportional drag, and a wheel reaching the
+// guardrail is a wall contact as before. On asphalt the car behaves exactly as it always did.
+//
+// The materials are baked per track into a tiled map: one index byte per 1x1-unit tile, pointing
+// at a tile of 8x8 cells (0.125 units, 4 bits each = 32 bytes). Both tracks are symmetric about
+// both axes, so the map covers one quarter (|x|, |z|). Tiles are shared: the materials themselves
+// are the first NUM_SURFACES tiles (a tile wholly inside one material uses those), and mixed tiles
+// along the edges are stored once however often they repeat (straights repeat the same edge tile
+// all the way along). A map is at most 11 KB, so the lookups of a tick stay in L1; a lookup is two
+// loads with no branches. A car well inside the road edges, as on nearly every tick, needs none:
+// isCarOnAsphalt() tests its centre once against the road's distance function.
+
+#define TRACK_KERB_WIDTH 1.0f     // Kerb band outside each road edge
+#define TRACK_RUNOFF_WIDTH 4.0f   // Road edge to guardrail, kerb included (both sides of the road)
+#define SURFACE_GRAVEL_LEAD 8.0f  // Gravel starts this far before a corner, on its outside
+
+#define SURFACE_CELL_SIZE 0.125f  // World units per map cell
+#define SURFACE_TILE_CELLS 8      // Cells along each side of a tile
+#define SURFACE_TILES_X 64        // |x| < 64, |z| < 72: both tracks and their guardrails fit,
+#define SURFACE_TILES_Z 72        // beyond it is all guardrail (a power-of-two row keeps lookups short)
+
+typedef enum {              // In order from the road outwards (telemetry compares them)
+    SURFACE_ASPHALT,
+    SURFACE_KERB,
+    SURFACE_GRASS,
+    SURFACE_GRAVEL,
+    SURFACE_BARRIER,  // At or beyond the guardrails: never driven on
+    NUM_SURFACES
+} SurfaceMaterial;
+
+typedef struct {
+    float grip;  // Multiplies acceleration and braking
+    float drag;  // Speed lost per second, as a fraction of the speed (rolling resistance)
+} SurfaceGrip;
+
+extern const SurfaceGrip surfaceGrip[NUM_SURFACES];
+
+// --- Function Declarations ---
+// Builds both tracks' maps once per process; any thread may call it (initCar() does), later calls
+// return at once. Worker pools call it before starting their threads (a thread arriving while
+// another bakes sleeps until it is done).
+void bakeSurfaceMaps(void);
+// Material at (x, z) on the selected track from the baked map: O(1), a few hundred bytes touched
+SurfaceMaterial getSurfaceMaterial(float x, float z);
+// True when every point within halfDiagonal of (x, z) reads as asphalt on the map: one test for a
+// whole car that is well inside the road edges, as it is on nearly every tick
+int isCarOnAsphalt(float x, float z, float halfDiagonal);
+// Materials under a car's four corners (x, z pairs, as from calculateCarCorners()) in one call:
+// what updateCar() uses every tick. Corner i is in bits 8*i..8*i+7 of the result, which stays in a
+// register (four byte stores read back as one word would stall on store forwarding).
+unsigned int getWheelSurfaces(const float xz[8]);
+#define SURFACE_WHEELS_BARRIER 0x04040404u // Any corner on SURFACE_BARRIER, the only material with bit 2 set
+// The exact material from the track geometry, which the maps are baked from (and the track's
+// meshes follow). Much slower: for baking and one-off queries only.
+SurfaceMaterial classifySurface(TrackType type, float x, float z);
+long getSurfaceMapBytes(TrackType type, int* uniqueTiles); // Size of one baked map, for reports
+
+#endif // SURFACE_H
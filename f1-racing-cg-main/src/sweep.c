@@ -0,0 +1,289 @@
+#include "sweep.h"   // SweepConfig, SweepResult, prototypes
+#include "car.h"     // initCar(), updateCar()
+#include "lap.h"     // LapTimer for per-configuration lap times
+#include "ai.h"      // updateAIControls() drives the laps
+#include "thread.h"  // Worker threads
+#include "timing.h"  // Wall-clock time for the summary
+#include "heatmap.h" // heatmap=: where the cars went, per worker then merged
+#include <stdio.h>   // For printf, fprintf, fopen
+#include <stdlib.h>  // For malloc, free, atoi, strtod
+#include <string.h>  // For strcmp, strncmp, strchr, strlen
+
+#define SWEEP_MAX_THREADS 64 // Upper bound on worker threads
+
+// Short names accepted on the command line (SweepParam order)
+static const char* sweepParamNames[SWEEP_NUM_PARAMS] = { "accel", "brake", "friction", "turn", "maxspeed" };
+
+// --- Shared Work State ---
+// Workers pull configuration indices from 'nextIndex' until all are taken,
+// so slow configurations (DNFs running to the time limit) don't leave cores idle.
+typedef struct {
+    const SweepConfig* config;
+    SweepResult* results;
+    int totalConfigs;
+    volatile int nextIndex; // Only touched through __sync_fetch_and_add
+} SweepJob;
+
+// Each worker's own heatmap (heatmap=): filled without any sharing, summed after the join
+typedef struct {
+    SweepJob* job;
+    HeatmapGrid heatmap;
+    int hasHeatmap;
+} SweepWorker;
+
+
+// --- Parameter Value For One Configuration ---
+static float sweepRangeValue(const SweepRange* range, int step) {
+    if (range->steps <= 1) return range->min;
+    return range->min + (range->max - range->min) * (float)step / (float)(range->steps - 1);
+}
+
+// --- Run One Configuration ---
+// Drives the autopilot around the selected track with the given parameters until
+// 'laps' timed laps are done or the simulated time limit is reached. With a heatmap, every tick
+// adds the car's cell (NULL: nothing extra in the loop but one predictable branch).
+static void runSweepConfig(const SweepConfig* config, int index, SweepResult* result, HeatmapGrid* heatmap) {
+    Car car;
+    initCar(&car); // Start position for the selected track and default values for everything else
+
+    // Decode the mixed-radix index into one step per parameter
+    int remaining = index;
+    for (int p = 0; p < SWEEP_NUM_PARAMS; ++p) {
+        const SweepRange* range = &config->ranges[p];
+        int steps = range->steps > 0 ? range->steps : 1;
+        result->params[p] = sweepRangeValue(range, remaining % steps);
+        remaining /= steps;
+    }
+    car.acceleration_rate = result->params[SWEEP_PARAM_ACCELERATION];
+    car.braking_rate = result->params[SWEEP_PARAM_BRAKING];
+    car.friction = result->params[SWEEP_PARAM_FRICTION];
+    car.turn_speed = result->params[SWEEP_PARAM_TURN_SPEED];
+    car.max_speed = result->params[SWEEP_PARAM_MAX_SPEED];
+
+    // Simulated clock: one fixed step per tick, exactly like updateGame()
+    LapTimer timer;
+    initLapTimer(&timer, &car, 0);
+    long maxTicks = (long)(config->maxSimSeconds * FRAME_RATE);
+    long lapTimeSumMs = 0;
+    float topSpeed = 0.0f;
+    long tick = 0;
+    while (tick < maxTicks && timer.lapsCompleted < config->laps) {
+        updateAIControls(&car);
+        updateCar(&car, FRAME_TIME_SEC);
+        tick++;
+        if (heatmap) addHeatmapSample(heatmap, car.x, car.z, car.speed, car.hitWall);
+        if (car.speed > topSpeed) topSpeed = car.speed;
+        if (updateLapTimer(&timer, &car, tick)) {
+            lapTimeSumMs += timer.lastLapTimeMs;
+        }
+    }
+
+    result->lapsCompleted = timer.lapsCompleted;
+    result->bestLapSec = timer.lapsCompleted > 0 ? timer.bestLapTimeMs / 1000.0f : -1.0f;
+    result->meanLapSec = timer.lapsCompleted > 0 ? (float)lapTimeSumMs / timer.lapsCompleted / 1000.0f : -1.0f;
+    result->collisions = car.collisions;
+    result->topSpeed = topSpeed;
+    result->simSeconds = (float)tick / FRAME_RATE;
+}
+
+// --- Worker Thread ---
+static void sweepWorker(void* arg) {
+    SweepWorker* worker = (SweepWorker*)arg;
+    SweepJob* job = worker->job;
+    selectedTrackType = job->config->track; // Thread-local: each worker selects the track itself
+    for (;;) {
+        int index = __sync_fetch_and_add(&job->nextIndex, 1);
+        if (index >= job->totalConfigs) break;
+        runSweepConfig(job->config, index, &job->results[index], worker->hasHeatmap ? &worker->heatmap : NULL);
+    }
+}
+
+
+// --- Results Output ---
+static int writeSweepResults(const char* path, const SweepResult* results, int count) {
+    size_t len = strlen(path);
+    int binary = (len >= 4 && strcmp(path + len - 4, ".bin") == 0);
+    FILE* file = fopen(path, binary ? "wb" : "w");
+    if (!file) {
+        fprintf(stderr, "Sweep: cannot open '%s' for writing\n", path);
+        return 0;
+    }
+
+    if (binary) {
+        // Header: magic, version, record count, record size (all 32-bit)
+        int header[4] = { 0, 1, count, (int)sizeof(SweepResult) };
+        memcpy(&header[0], "F1SW", 4);
+        fwrite(header, sizeof(header), 1, file);
+        fwrite(results, sizeof(SweepResult), (size_t)count, file);
+    } else {
+        fprintf(file, "acceleration_rate,braking_rate,friction,turn_speed,max_speed,"
+                      "laps_completed,best_lap_s,mean_lap_s,collisions,top_speed,sim_s\n");
+        for (int i = 0; i < count; ++i) {
+            const SweepResult* r = &results[i];
+            fprintf(file, "%g,%g,%g,%g,%g,%d,%.3f,%.3f,%d,%.2f,%.2f\n",
+                    r->params[0], r->params[1], r->params[2], r->params[3], r->params[4],
+                    r->lapsCompleted, r->bestLapSec, r->meanLapSec, r->collisions, r->topSpeed, r->simSeconds);
+        }
+    }
+
+    fclose(file);
+    return 1;
+}
+
+
+// --- Sweep Runner ---
+int runSweep(const SweepConfig* config) {
+    int totalConfigs = 1;
+    for (int p = 0; p < SWEEP_NUM_PARAMS; ++p) {
+        totalConfigs *= config->ranges[p].steps > 0 ? config->ranges[p].steps : 1;
+    }
+
+    int numThreads = config->numThreads > 0 ? config->numThreads : getCpuCount();
+    if (numThreads > SWEEP_MAX_THREADS) numThreads = SWEEP_MAX_THREADS;
+    if (numThreads > totalConfigs) numThreads = totalConfigs;
+
+    SweepResult* results = (SweepResult*)calloc((size_t)totalConfigs, sizeof(SweepResult));
+    if (!results) {
+        fprintf(stderr, "Sweep: out of memory for %d results\n", totalConfigs);
+        return 1;
+    }
+
+    printf("Sweep: %d configurations on track type %d, %d laps each, %d threads\n",
+           totalConfigs, config->track, config->laps, numThreads);
+    double startTime = getTimeSeconds();
+
+    SweepJob job;
+    job.config = config;
+    job.results = results;
+    job.totalConfigs = totalConfigs;
+    job.nextIndex = 0;
+
+    // Each worker's grid is allocated up front; if one can't be, the sweep doesn't run
+    SweepWorker workers[SWEEP_MAX_THREADS];
+    int ok = 1;
+    for (int t = 0; t < numThreads; ++t) {
+        workers[t].job = &job;
+        workers[t].hasHeatmap = config->heatmapPrefix && initHeatmap(&workers[t].heatmap, config->track);
+        if (config->heatmapPrefix && !workers[t].hasHeatmap) ok = 0;
+    }
+
+    if (ok) {
+        Thread threads[SWEEP_MAX_THREADS];
+        int started = 0;
+        for (int t = 1; t < numThreads; ++t) { // The calling thread is worker 0
+            if (startThread(&threads[started], sweepWorker, &workers[t])) started++;
+        }
+        sweepWorker(&workers[0]);
+        for (int t = 0; t < started; ++t) joinThread(&threads[t]);
+
+        double elapsed = getTimeSeconds() - startTime;
+        printf("Sweep: finished in %.2f s (%.0f configurations/s)\n",
+               elapsed, elapsed > 0.0 ? totalConfigs / elapsed : 0.0);
+        if (config->heatmapPrefix) {
+            for (int t = 1; t < numThreads; ++t) mergeHeatmap(&workers[0].heatmap, &workers[t].heatmap);
+            ok = writeHeatmapFiles(&workers[0].heatmap, config->heatmapPrefix);
+        }
+    }
+    for (int t = 0; t < numThreads; ++t) {
+        if (workers[t].hasHeatmap) freeHeatmap(&workers[t].heatmap);
+    }
+    if (!ok) { free(results); return 1; }
+
+    // Report the fastest clean configuration as a quick pointer for balancing
+    int best = -1;
+    for (int i = 0; i < totalConfigs; ++i) {
+        const SweepResult* r = &results[i];
+        if (r->lapsCompleted < config->laps || r->collisions > 0) continue;
+        if (best < 0 || r->bestLapSec < results[best].bestLapSec) best = i;
+    }
+    if (best >= 0) {
+        const SweepResult* r = &results[best];
+        printf("Sweep: fastest clean run %.3f s (accel %g, brake %g, friction %g, turn %g, max speed %g)\n",
+               r->bestLapSec, r->params[0], r->params[1], r->params[2], r->params[3], r->params[4]);
+    } else {
+        printf("Sweep: no configuration completed all laps without a collision\n");
+    }
+
+    ok = writeSweepResults(config->outputPath, results, totalConfigs);
+    if (ok) printf("Sweep: results written to %s\n", config->outputPath);
+    free(results);
+    return ok ? 0 : 1;
+}
+
+
+// --- Command Line Parsing ---
+// Parses "min:max:steps" (or a single value) into a range. Returns 1 on success.
+static int parseSweepRange(const char* text, SweepRange* range) {
+    char* end;
+    range->min = (float)strtod(text, &end);
+    if (end == text) return 0;
+    if (*end == '\0') { range->max = range->min; range->steps = 1; return 1; }
+    if (*end != ':') return 0;
+    const char* next = end + 1;
+    range->max = (float)strtod(next, &end);
+    if (end == next || *end != ':') return 0;
+    range->steps = atoi(end + 1);
+    return range->steps >= 1;
+}
+
+int runSweepFromArgs(int argc, char** argv) {
+    // Defaults: every parameter fixed at the value initCar() uses (this first initCar() also bakes
+    // the surface maps, on this thread before any worker starts)
+    Car defaults;
+    initCar(&defaults);
+    SweepConfig config;
+    float defaultValues[SWEEP_NUM_PARAMS] = { defaults.acceleration_rate, defaults.braking_rate,
+                                              defaults.friction, defaults.turn_speed, defaults.max_speed };
+    for (int p = 0; p < SWEEP_NUM_PARAMS; ++p) {
+        config.ranges[p].min = config.ranges[p].max = defaultValues[p];
+        config.ranges[p].steps = 1;
+    }
+    config.track = TRACK_ROUNDED;
+    config.laps = SWEEP_DEFAULT_LAPS;
+    config.maxSimSeconds = SWEEP_DEFAULT_MAX_SECONDS;
+    config.numThreads = 0;
+    config.outputPath = SWEEP_DEFAULT_OUTPUT;
+    config.heatmapPrefix = NULL;
+
+    for (int i = 0; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = strchr(arg, '=');
+        if (!value) { fprintf(stderr, "Sweep: expected key=value, got '%s'\n", arg); return 1; }
+        size_t keyLen = (size_t)(value - arg);
+        value++;
+
+        int matched = 0;
+        for (int p = 0; p < SWEEP_NUM_PARAMS; ++p) {
+            if (strlen(sweepParamNames[p]) == keyLen && strncmp(arg, sweepParamNames[p], keyLen) == 0) {
+                if (!parseSweepRange(value, &config.ranges[p])) {
+                    fprintf(stderr, "Sweep: bad range '%s' (use min:max:steps)\n", value);
+                    return 1;
+                }
+                matched = 1;
+            }
+        }
+        if (matched) continue;
+
+        if (strncmp(arg, "track=", 6) == 0) {
+            if (strcmp(value, "rect") == 0) config.track = TRACK_RECT;
+            else if (strcmp(value, "round") == 0) config.track = TRACK_ROUNDED;
+            else { fprintf(stderr, "Sweep: unknown track '%s' (rect|round)\n", value); return 1; }
+        } else if (strncmp(arg, "laps=", 5) == 0) {
+            config.laps = atoi(value);
+        } else if (strncmp(arg, "time=", 5) == 0) {
+            config.maxSimSeconds = (float)strtod(value, NULL);
+        } else if (strncmp(arg, "threads=", 8) == 0) {
+            config.numThreads = atoi(value);
+        } else if (strncmp(arg, "out=", 4) == 0) {
+            config.outputPath = value;
+        } else if (strncmp(arg, "heatmap=", 8) == 0) {
+            config.heatmapPrefix = value;
+        } else {
+            fprintf(stderr, "Sweep: unknown option '%s'\n", arg);
+            return 1;
+        }
+    }
+
+    if (config.laps < 1) config.laps = 1;
+    return runSweep(&config);
+}
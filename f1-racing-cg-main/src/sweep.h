@@ -0,0 +1,59 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "game.h" // TrackType
+
+// --- Sweep Defaults ---
+#define SWEEP_DEFAULT_LAPS 3            // Timed laps driven per configuration
+#define SWEEP_DEFAULT_MAX_SECONDS 180.0f // Simulated time limit per configuration (DNF after this)
+#define SWEEP_DEFAULT_OUTPUT "sweep_results.csv"
+
+// --- Swept Car Parameters ---
+// Each one maps to the Car field of the same meaning (see initCar()).
+typedef enum {
+    SWEEP_PARAM_ACCELERATION, // acceleration_rate
+    SWEEP_PARAM_BRAKING,      // braking_rate
+    SWEEP_PARAM_FRICTION,     // friction
+    SWEEP_PARAM_TURN_SPEED,   // turn_speed
+    SWEEP_PARAM_MAX_SPEED,    // max_speed
+    SWEEP_NUM_PARAMS
+} SweepParam;
+
+// 'steps' values spaced evenly from min to max (inclusive). steps == 1 means just 'min'.
+typedef struct {
+    float min;
+    float max;
+    int steps;
+} SweepRange;
+
+typedef struct {
+    SweepRange ranges[SWEEP_NUM_PARAMS];
+    TrackType track;
+    int laps;                 // Timed laps per configuration
+    float maxSimSeconds;      // Simulated time limit per configuration
+    int numThreads;           // Worker threads (0 = one per CPU)
+    const char* outputPath;   // Ends in ".bin" -> binary records, otherwise CSV
+    const char* heatmapPrefix; // Non-NULL: a driving heatmap over every configuration (see heatmap.h)
+} SweepConfig;
+
+// One row of output. All fields are 4 bytes, so the binary file is just an array of these
+// after a small header ("F1SW", version, record count, record size; all 32-bit).
+typedef struct {
+    float params[SWEEP_NUM_PARAMS]; // Parameter values used (SweepParam order)
+    int lapsCompleted;              // Timed laps finished within the time limit
+    float bestLapSec;               // Fastest lap in seconds (-1 if none)
+    float meanLapSec;               // Mean lap time in seconds (-1 if none)
+    int collisions;                 // Wall contacts over the whole run (Car.collisions)
+    float topSpeed;                 // Highest forward speed reached (units/s)
+    float simSeconds;               // Simulated time used
+} SweepResult;
+
+// --- Function Declarations ---
+// Entry point for "--sweep key=value ..." (argv excludes the program name and "--sweep").
+// Keys: accel, brake, friction, turn, maxspeed as "min:max:steps" or a single value,
+// track=rect|round, laps=N, time=SECONDS, threads=N, out=PATH, heatmap=PREFIX. Returns a process exit code.
+int runSweepFromArgs(int argc, char** argv);
+// Runs every combination of the configured ranges in parallel and writes the results file.
+int runSweep(const SweepConfig* config);
+
+#endif // SWEEP_H
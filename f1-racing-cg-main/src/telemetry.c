@@ -0,0 +1,369 @@
+// Unix sockets and MSG_NOSIGNAL are POSIX, not C99
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "telemetry.h"
+#include "ring.h"    // Sim thread -> writer thread hand-off
+#include "thread.h"  // Writer thread
+#include "ai.h"      // Headless drives: the autopilot
+#include "timing.h"  // Headless drive timing, writer polling
+#include "surface.h" // Material channel
+#include <math.h>    // For atan2f
+#include <stdlib.h>  // For malloc, free, atof, atoi
+#include <string.h>  // For memcpy, memset, strcmp, strncmp
+#include <float.h>   // For FLT_MAX (empty min/max)
+
+#ifndef _WIN32
+#include <sys/socket.h> // Telemetry socket
+#include <sys/un.h>     // sockaddr_un
+#include <unistd.h>     // close
+#endif
+
+// The layout in telemetry.h is fixed: catch a struct or channel change that would break it
+typedef char TelemetryHeaderSizeCheck[sizeof(TelemetryFileHeader) == 64 ? 1 : -1];
+typedef char TelemetryChunkHeaderSizeCheck[sizeof(TelemetryChunkHeader) == 128 ? 1 : -1];
+typedef char TelemetrySampleSizeCheck[sizeof(TelemetrySample) == 32 ? 1 : -1];
+
+const int telemetryChannelSizes[TELEMETRY_NUM_CHANNELS] = TELEMETRY_CHANNEL_SIZES;
+const char* const telemetryChannelNames[TELEMETRY_NUM_CHANNELS] = TELEMETRY_CHANNEL_NAMES;
+
+int getTelemetryColumnOffset(TelemetryChannel channel) {
+    int offset = (int)sizeof(TelemetryChunkHeader);
+    for (int c = 0; c < (int)channel; ++c) offset += telemetryChannelSizes[c] * TELEMETRY_CHUNK_ROWS;
+    return offset;
+}
+
+
+// --- Sectors ---
+// Thirds of a lap by the angle around the track centre, starting at the finish line (on the
+// right straight, z = 0) in the driving direction. Both tracks are symmetric loops around the
+// origin, so this splits them into three stretches of about equal length.
+int getTrackSector(float x, float z) {
+    float angle = atan2f(z, x); // 0 at the finish line, growing as the car drives on
+    if (angle < 0.0f) angle += 2.0f * 3.14159265f;
+    int sector = 1 + (int)(angle * TELEMETRY_SECTORS / (2.0f * 3.14159265f));
+    return sector > TELEMETRY_SECTORS ? TELEMETRY_SECTORS : sector;
+}
+
+int getCarSurface(const Car* car) {
+    int best = car->wheelSurface[0];
+    for (int i = 1; i < 4; ++i) {
+        if (car->wheelSurface[i] < best) best = car->wheelSurface[i]; // Materials are in order, asphalt first
+    }
+    return best;
+}
+
+void sampleCarTelemetry(const Car* car, const LapTimer* timer, int carIndex, long tick, TelemetrySample* sample) {
+    memset(sample, 0, sizeof(*sample));
+    sample->tick = (int)tick;
+    sample->car = (unsigned char)carIndex;
+    sample->x = car->x;
+    sample->z = car->z;
+    sample->speed = car->speed;
+    sample->angle = car->angle;
+    sample->inputs = (unsigned char)getCarControlBits(car);
+    sample->surface = (unsigned char)(car->hitWall ? SURFACE_BARRIER : getCarSurface(car));
+    sample->lap = (unsigned short)(timer->lapsCompleted + 1);
+    sample->sector = (unsigned char)getTrackSector(car->x, car->z);
+}
+
+
+// --- Log Writer ---
+static int columnOffsets[TELEMETRY_NUM_CHANNELS]; // getTelemetryColumnOffset(), looked up once
+
+static void resetChunk(TelemetryLog* telemetry) {
+    memset(telemetry->chunk, 0, TELEMETRY_CHUNK_BYTES); // The last chunk is written zero-padded
+    for (int c = 0; c < TELEMETRY_NUM_CHANNELS; ++c) {
+        telemetry->header->min[c] = FLT_MAX;
+        telemetry->header->max[c] = -FLT_MAX;
+    }
+}
+
+int openTelemetryLog(TelemetryLog* telemetry, const char* path, TrackType track) {
+    memset(telemetry, 0, sizeof(*telemetry));
+    for (int c = 0; c < TELEMETRY_NUM_CHANNELS; ++c) columnOffsets[c] = getTelemetryColumnOffset((TelemetryChannel)c);
+    telemetry->chunk = (unsigned char*)malloc(TELEMETRY_CHUNK_BYTES);
+    telemetry->file = fopen(path, "wb");
+    if (!telemetry->chunk || !telemetry->file) {
+        fprintf(stderr, "Telemetry: cannot write '%s'\n", path);
+        if (telemetry->file) fclose(telemetry->file);
+        free(telemetry->chunk);
+        telemetry->file = NULL;
+        telemetry->chunk = NULL;
+        return 0;
+    }
+    TelemetryFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TELEMETRY_MAGIC, 4);
+    header.version = TELEMETRY_VERSION;
+    header.chunkRows = TELEMETRY_CHUNK_ROWS;
+    header.numChannels = TELEMETRY_NUM_CHANNELS;
+    header.frameRate = FRAME_RATE;
+    header.track = (unsigned int)track;
+    fwrite(&header, sizeof(header), 1, telemetry->file);
+    telemetry->header = (TelemetryChunkHeader*)telemetry->chunk;
+    resetChunk(telemetry);
+    return 1;
+}
+
+static void writeChunk(TelemetryLog* telemetry) {
+    fwrite(telemetry->chunk, TELEMETRY_CHUNK_BYTES, 1, telemetry->file);
+    resetChunk(telemetry);
+}
+
+// Stores a value in its column and widens the chunk's min/max
+#define PUT_VALUE(telemetry, channel, type, row, value) do { \
+        type v_ = (type)(value); \
+        memcpy((telemetry)->chunk + columnOffsets[channel] + (row) * sizeof(type), &v_, sizeof(type)); \
+        if ((float)v_ < (telemetry)->header->min[channel]) (telemetry)->header->min[channel] = (float)v_; \
+        if ((float)v_ > (telemetry)->header->max[channel]) (telemetry)->header->max[channel] = (float)v_; \
+    } while (0)
+
+void appendTelemetry(TelemetryLog* telemetry, const TelemetrySample* sample) {
+    if (!telemetry->file) return;
+    unsigned int row = telemetry->header->rows;
+    if (row == 0) telemetry->chunks++;
+    PUT_VALUE(telemetry, TELEMETRY_TICK, int, row, sample->tick);
+    PUT_VALUE(telemetry, TELEMETRY_CAR, unsigned char, row, sample->car);
+    PUT_VALUE(telemetry, TELEMETRY_X, float, row, sample->x);
+    PUT_VALUE(telemetry, TELEMETRY_Z, float, row, sample->z);
+    PUT_VALUE(telemetry, TELEMETRY_SPEED, float, row, sample->speed);
+    PUT_VALUE(telemetry, TELEMETRY_ANGLE, float, row, sample->angle);
+    PUT_VALUE(telemetry, TELEMETRY_INPUTS, unsigned char, row, sample->inputs);
+    PUT_VALUE(telemetry, TELEMETRY_SURFACE, unsigned char, row, sample->surface);
+    PUT_VALUE(telemetry, TELEMETRY_LAP, unsigned short, row, sample->lap);
+    PUT_VALUE(telemetry, TELEMETRY_SECTOR, unsigned char, row, sample->sector);
+    telemetry->header->rows = row + 1;
+    telemetry->rows++;
+    if (telemetry->header->rows == TELEMETRY_CHUNK_ROWS) writeChunk(telemetry);
+}
+
+void closeTelemetryLog(TelemetryLog* telemetry) {
+    if (!telemetry->file) return;
+    if (telemetry->header->rows > 0) writeChunk(telemetry);
+    fclose(telemetry->file);
+    free(telemetry->chunk);
+    telemetry->file = NULL;
+    telemetry->chunk = NULL;
+}
+
+
+// --- The Game's Log ---
+// Sim thread: samples the cars and pushes the records, nothing else. Writer thread: pops them in
+// batches and appends them to the columnar file or sends them to the socket, sleeping briefly
+// whenever the ring is empty (so the sim never has to signal it).
+#define TELEMETRY_WRITER_BATCH 256
+#define TELEMETRY_WRITER_IDLE_SEC 0.002
+
+static const char* raceTelemetryPath = NULL;
+static int recordingRace = 0;
+static SpscRing raceRing;
+static Thread raceWriter;
+static int raceWriterStopping = 0;      // Set (release) once the last record is pushed
+static TelemetryStats raceStats;
+
+// Sink (writer thread only while it runs)
+static TelemetryLog raceTelemetry;      // File sink
+#ifndef _WIN32
+static int raceSocket = -1;             // Socket sink
+#endif
+
+void setRaceTelemetryPath(const char* path) {
+    raceTelemetryPath = path;
+}
+
+static int isSocketPath(const char* path) {
+    return strncmp(path, "unix:", 5) == 0;
+}
+
+// Connects to the listening socket and sends the file header. Returns 1 on success.
+static int openTelemetrySocket(const char* name, TrackType track) {
+#ifdef _WIN32
+    (void)track;
+    fprintf(stderr, "Telemetry: unix sockets are not supported on this platform ('%s')\n", name);
+    return 0;
+#else
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(name) >= sizeof(address.sun_path)) { fprintf(stderr, "Telemetry: socket path too long\n"); return 0; }
+    memcpy(address.sun_path, name, strlen(name) + 1);
+    raceSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (raceSocket < 0 || connect(raceSocket, (const struct sockaddr*)&address, sizeof(address)) != 0) {
+        fprintf(stderr, "Telemetry: cannot connect to socket '%s'\n", name);
+        if (raceSocket >= 0) close(raceSocket);
+        raceSocket = -1;
+        return 0;
+    }
+    TelemetryFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TELEMETRY_MAGIC, 4);
+    header.version = TELEMETRY_VERSION;
+    header.chunkRows = 0; // Not chunked: records follow one after another
+    header.numChannels = TELEMETRY_NUM_CHANNELS;
+    header.frameRate = FRAME_RATE;
+    header.track = (unsigned int)track;
+    if (send(raceSocket, &header, sizeof(header), MSG_NOSIGNAL) != (long)sizeof(header)) {
+        close(raceSocket);
+        raceSocket = -1;
+        return 0;
+    }
+    return 1;
+#endif
+}
+
+// Closes whichever sink startRaceTelemetry() opened (the log file or the socket)
+static void closeTelemetrySink(void) {
+    closeTelemetryLog(&raceTelemetry);
+#ifndef _WIN32
+    if (raceSocket >= 0) close(raceSocket);
+    raceSocket = -1;
+#endif
+}
+
+// Writer thread: hands one batch to the sink
+static void writeTelemetryBatch(const TelemetrySample* batch, int count) {
+#ifndef _WIN32
+    if (raceSocket >= 0) {
+        const unsigned char* bytes = (const unsigned char*)batch;
+        size_t left = (size_t)count * sizeof(*batch);
+        while (left > 0) { // A stream socket may take part of it
+            long sent = (long)send(raceSocket, bytes, left, MSG_NOSIGNAL);
+            if (sent <= 0) {
+                fprintf(stderr, "Telemetry: socket closed, discarding the rest\n");
+                close(raceSocket);
+                raceSocket = -1;
+                raceStats.droppedSink += count;
+                return;
+            }
+            bytes += sent;
+            left -= (size_t)sent;
+        }
+        raceStats.written += count;
+        return;
+    }
+#endif
+    if (!raceTelemetry.file) { raceStats.droppedSink += count; return; }
+    for (int i = 0; i < count; ++i) appendTelemetry(&raceTelemetry, &batch[i]);
+    raceStats.written += count;
+}
+
+static void telemetryWriter(void* arg) {
+    (void)arg;
+    TelemetrySample batch[TELEMETRY_WRITER_BATCH];
+    for (;;) {
+        int stopping = __atomic_load_n(&raceWriterStopping, __ATOMIC_ACQUIRE); // Before popping: no pushes after it
+        int count = 0;
+        while (count < TELEMETRY_WRITER_BATCH && popSpscRing(&raceRing, &batch[count])) count++;
+        if (count > 0) writeTelemetryBatch(batch, count);
+        else if (stopping) break; // Drained
+        else sleepSeconds(TELEMETRY_WRITER_IDLE_SEC);
+    }
+}
+
+void startRaceTelemetry(TrackType track) {
+    if (!raceTelemetryPath) return;
+    stopRaceTelemetry(); // A new race starts the file again
+    memset(&raceStats, 0, sizeof(raceStats));
+    int opened = isSocketPath(raceTelemetryPath) ? openTelemetrySocket(raceTelemetryPath + 5, track)
+                                                 : openTelemetryLog(&raceTelemetry, raceTelemetryPath, track);
+    if (!opened) { raceTelemetryPath = NULL; return; }
+    if (!initSpscRing(&raceRing, sizeof(TelemetrySample), TELEMETRY_RING_RECORDS)) {
+        closeTelemetrySink();
+        raceTelemetryPath = NULL;
+        return;
+    }
+    raceWriterStopping = 0;
+    if (!startThread(&raceWriter, telemetryWriter, NULL)) {
+        fprintf(stderr, "Telemetry: cannot start the writer thread\n");
+        freeSpscRing(&raceRing);
+        closeTelemetrySink();
+        raceTelemetryPath = NULL;
+        return;
+    }
+    recordingRace = 1;
+}
+
+int isRecordingTelemetry(void) {
+    return recordingRace;
+}
+
+// Sim thread, every race tick: samples and pushes only (no I/O, no locks, no allocation)
+void recordRaceTelemetry(void) {
+    if (!recordingRace) return;
+    for (int p = 0; p < numPlayers; ++p) {
+        TelemetrySample sample;
+        sampleCarTelemetry(&playerCars[p], &playerLapTimers[p], p, simTickCount, &sample);
+        pushSpscRing(&raceRing, &sample); // Full: dropped and counted in the ring
+        raceStats.recorded++;
+    }
+}
+
+void getRaceTelemetryStats(TelemetryStats* stats) {
+    *stats = raceStats;
+    stats->droppedFull = recordingRace ? getSpscRingDropped(&raceRing) : raceStats.droppedFull;
+}
+
+void stopRaceTelemetry(void) {
+    if (!recordingRace) return;
+    __atomic_store_n(&raceWriterStopping, 1, __ATOMIC_RELEASE);
+    joinThread(&raceWriter); // Writes what is still in the ring first
+    raceStats.droppedFull = getSpscRingDropped(&raceRing);
+    freeSpscRing(&raceRing);
+    recordingRace = 0;
+    printf("Telemetry: %ld records written to %s", raceStats.written, raceTelemetryPath);
+    if (raceTelemetry.file) printf(" (%ld chunks)", raceTelemetry.chunks);
+    printf(", %ld dropped (ring full), %ld dropped (sink)\n", raceStats.droppedFull, raceStats.droppedSink);
+    closeTelemetrySink();
+}
+
+// Headless drive only: waits until the writer has room for another tick, so the offline log is
+// complete. The game never calls this; its ticks drop records instead of waiting.
+static void waitForTelemetryRoom(void) {
+    while (recordingRace && raceRing.head - __atomic_load_n(&raceRing.tail, __ATOMIC_ACQUIRE) + (unsigned int)numPlayers > raceRing.capacity) {
+        sleepSeconds(TELEMETRY_WRITER_IDLE_SEC / 2);
+    }
+}
+
+
+// --- Headless Drive ---
+int runTelemetryDriveFromArgs(int argc, char** argv) {
+    const char* outputPath = "telemetry.f1t";
+    double hours = 1.0;
+    TrackType track = TRACK_ROUNDED;
+    int cars = 1;
+    for (int i = 0; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "out=", 4) == 0) outputPath = arg + 4;
+        else if (strncmp(arg, "hours=", 6) == 0) hours = atof(arg + 6);
+        else if (strncmp(arg, "cars=", 5) == 0) cars = atoi(arg + 5);
+        else if (strncmp(arg, "track=", 6) == 0) {
+            if (strcmp(arg + 6, "rect") == 0) track = TRACK_RECT;
+            else if (strcmp(arg + 6, "round") == 0) track = TRACK_ROUNDED;
+            else { fprintf(stderr, "Telemetry: unknown track '%s' (rect|round)\n", arg + 6); return 1; }
+        }
+        else { fprintf(stderr, "Telemetry: unknown option '%s'\n", arg); return 1; }
+    }
+    if (cars < 1 || cars > MAX_PLAYERS) { fprintf(stderr, "Telemetry: cars must be 1..%d\n", MAX_PLAYERS); return 1; }
+
+    selectedTrackType = track;
+    numPlayers = cars;
+    initGame();
+    currentGameState = STATE_RACING;
+    setRaceTelemetryPath(outputPath);
+    startRaceTelemetry(track);
+    if (!isRecordingTelemetry()) return 1;
+    long ticks = (long)(hours * 3600.0 * FRAME_RATE);
+    double start = getTimeSeconds();
+    for (long t = 0; t < ticks; ++t) {
+        for (int p = 0; p < numPlayers; ++p) updateAIControls(&playerCars[p]);
+        waitForTelemetryRoom();
+        stepGame(); // Records the tick
+    }
+    double elapsed = getTimeSeconds() - start;
+    printf("Telemetry: %.1f simulated hours (%ld ticks, %d car(s)) in %.1f s, %d laps by car 1\n",
+           ticks / (3600.0 * FRAME_RATE), ticks, cars, elapsed, playerLapTimers[0].lapsCompleted);
+    stopRaceTelemetry();
+    return 0;
+}
@@ -0,0 +1,120 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "game.h"  // Car, LapTimer, TrackType, FRAME_RATE
+#include <stdio.h> // FILE
+
+// --- Telemetry Log ---
+// Per-tick channels of every car (one row per car per tick), written column by column in
+// fixed-size chunks so an offline query reads only the columns it needs and can skip whole
+// chunks by their min/max statistics (see tools/tlquery.c). A 10-hour single-car log is
+// about 56 MB and scans in well under a second.
+//
+// File layout (little-endian):
+//   TelemetryFileHeader (64 bytes)
+//   chunk 0, chunk 1, ... each TELEMETRY_CHUNK_BYTES:
+//     TelemetryChunkHeader (rows, and min/max of every channel over those rows, 128 bytes)
+//     one column per channel, TELEMETRY_CHUNK_ROWS values each (the last chunk is zero-padded)
+// Every column starts on a 64-byte boundary of the file.
+
+#define TELEMETRY_MAGIC "F1TL"
+#define TELEMETRY_VERSION 2 // 2: 'surface' replaced version 1's 'on_track' (wall contact only)
+#define TELEMETRY_CHUNK_ROWS 4096
+#define TELEMETRY_SECTORS 3
+
+// Channels, in column order
+typedef enum {
+    TELEMETRY_TICK,     // int32: simulation tick (FRAME_RATE per second)
+    TELEMETRY_CAR,      // uint8: player index
+    TELEMETRY_X,        // float: position
+    TELEMETRY_Z,        // float
+    TELEMETRY_SPEED,    // float: units per second (negative when reversing)
+    TELEMETRY_ANGLE,    // float: heading in degrees
+    TELEMETRY_INPUTS,   // uint8: control bits (getCarControlBits)
+    TELEMETRY_SURFACE,  // uint8: SurfaceMaterial the car is on (getCarSurface), SURFACE_BARRIER on
+                        // ticks it hit a guardrail (updateCar() undid its move)
+    TELEMETRY_LAP,      // uint16: lap being driven, 1 = first
+    TELEMETRY_SECTOR,   // uint8: 1..TELEMETRY_SECTORS (getTrackSector)
+    TELEMETRY_NUM_CHANNELS
+} TelemetryChannel;
+
+typedef struct {
+    char magic[4];                 // TELEMETRY_MAGIC
+    unsigned int version;
+    unsigned int chunkRows;        // TELEMETRY_CHUNK_ROWS
+    unsigned int numChannels;      // TELEMETRY_NUM_CHANNELS
+    unsigned int frameRate;        // Ticks per second
+    unsigned int track;            // TrackType
+    unsigned int reserved[10];
+} TelemetryFileHeader;
+
+typedef struct {
+    unsigned int rows;             // Rows used, 1..TELEMETRY_CHUNK_ROWS
+    unsigned int reserved;
+    float min[TELEMETRY_NUM_CHANNELS];
+    float max[TELEMETRY_NUM_CHANNELS];
+    unsigned char padding[128 - 8 - 2 * TELEMETRY_NUM_CHANNELS * sizeof(float)];
+} TelemetryChunkHeader;
+
+// One row, as captured. Also the fixed-size record the sim thread hands to the log's writer
+// thread, and what a telemetry socket receives (32 bytes, see setRaceTelemetryPath()).
+typedef struct {
+    int tick;
+    float x, z, speed, angle;
+    unsigned short lap;
+    unsigned char car, inputs, surface, sector;
+    unsigned char reserved[6];
+} TelemetrySample;
+
+#define TELEMETRY_CHANNEL_SIZES { 4, 1, 4, 4, 4, 4, 1, 1, 2, 1 } // Bytes per value, in channel order
+extern const int telemetryChannelSizes[TELEMETRY_NUM_CHANNELS]; // TELEMETRY_CHANNEL_SIZES
+#define TELEMETRY_CHANNEL_NAMES { "tick", "car", "x", "z", "speed", "angle", "inputs", "surface", "lap", "sector" }
+extern const char* const telemetryChannelNames[TELEMETRY_NUM_CHANNELS]; // TELEMETRY_CHANNEL_NAMES
+#define TELEMETRY_CHUNK_BYTES 106624 // Chunk header plus TELEMETRY_CHUNK_ROWS x 26 bytes of columns
+
+typedef struct {
+    FILE* file;
+    unsigned char* chunk;          // The chunk being filled, in file layout
+    TelemetryChunkHeader* header;  // At the start of 'chunk'
+    long rows, chunks;             // Written so far (including the chunk being filled)
+} TelemetryLog;
+
+// The macros above let a reader (tools/tlquery.c) use the layout without linking this module
+// --- Function Declarations ---
+int getTelemetryColumnOffset(TelemetryChannel channel);   // Bytes from the start of a chunk
+int getTrackSector(float x, float z);                      // 1..TELEMETRY_SECTORS on the selected track
+// The best material under any of the car's wheels: grass or gravel only once all four are past
+// the kerbs (a car with a wheel on the kerb is still within track limits)
+int getCarSurface(const Car* car);
+void sampleCarTelemetry(const Car* car, const LapTimer* timer, int carIndex, long tick, TelemetrySample* sample);
+int openTelemetryLog(TelemetryLog* telemetry, const char* path, TrackType track); // Returns 1 on success
+void appendTelemetry(TelemetryLog* telemetry, const TelemetrySample* sample);
+void closeTelemetryLog(TelemetryLog* telemetry);           // Writes the last (partial) chunk
+
+// The game's own log (--telemetry <file>): every player car on every race tick. Like --record,
+// the file holds the most recent race: each start from the menu begins it again.
+// The sim thread never writes, blocks or allocates for it: recordRaceTelemetry() pushes the
+// tick's records into a lock-free ring (ring.h) and a writer thread drains that to the sink.
+// If the writer falls behind and the ring is full, records are dropped and counted.
+// A path "unix:<socket>" streams to a listening local (AF_UNIX, stream) socket instead of a
+// file: the TelemetryFileHeader, then TelemetrySample records as they come (POSIX only).
+#define TELEMETRY_RING_RECORDS 8192 // About 34 s of a 4-car race
+
+typedef struct {
+    long recorded;      // Records the sim produced
+    long written;       // Written to the file / sent to the socket by the writer
+    long droppedFull;   // Ring full: the writer was behind
+    long droppedSink;   // The socket closed (or a write failed), records discarded after it
+} TelemetryStats;
+
+void setRaceTelemetryPath(const char* path);
+void startRaceTelemetry(TrackType track);                  // From startGame(); no-op without a path
+int isRecordingTelemetry(void);
+void recordRaceTelemetry(void);                            // After each simulated race tick (stepGame)
+void getRaceTelemetryStats(TelemetryStats* stats);         // droppedFull is live, the rest final after stopRaceTelemetry()
+void stopRaceTelemetry(void);                              // Drains the ring, joins the writer, prints the counts
+
+// Headless: the autopilot drives for a given time while every tick is logged. Exit code.
+int runTelemetryDriveFromArgs(int argc, char** argv);     // out=, hours=, track=, cars=
+
+#endif // TELEMETRY_H
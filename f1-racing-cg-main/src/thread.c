@@ -0,0 +1,139 @@
+// sysconf(_SC_NPROCESSORS_ONLN) is POSIX, not C99
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "thread.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h> // sysconf
+#endif
+
+// --- Platform Trampolines ---
+// Adapt the platform's entry point signature to ThreadFunc.
+#ifdef _WIN32
+static DWORD WINAPI threadTrampoline(LPVOID param) {
+    Thread* thread = (Thread*)param;
+    thread->func(thread->arg);
+    return 0;
+}
+#else
+static void* threadTrampoline(void* param) {
+    Thread* thread = (Thread*)param;
+    thread->func(thread->arg);
+    return NULL;
+}
+#endif
+
+// --- Thread Start ---
+// 'thread' must stay valid (not move) until joinThread() returns.
+int startThread(Thread* thread, ThreadFunc func, void* arg) {
+    thread->func = func;
+    thread->arg = arg;
+#ifdef _WIN32
+    thread->handle = CreateThread(NULL, 0, threadTrampoline, thread, 0, NULL);
+    return thread->handle != NULL;
+#else
+    return pthread_create(&thread->handle, NULL, threadTrampoline, thread) == 0;
+#endif
+}
+
+// --- Thread Join ---
+void joinThread(Thread* thread) {
+#ifdef _WIN32
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+}
+
+// --- CPU Count ---
+int getCpuCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+
+// --- Mutex ---
+void initMutex(Mutex* mutex) {
+#ifdef _WIN32
+    InitializeSRWLock((PSRWLOCK)&mutex->lock);
+#else
+    pthread_mutex_init(&mutex->lock, NULL);
+#endif
+}
+
+void destroyMutex(Mutex* mutex) {
+#ifdef _WIN32
+    (void)mutex; // SRW locks need no cleanup
+#else
+    pthread_mutex_destroy(&mutex->lock);
+#endif
+}
+
+void lockMutex(Mutex* mutex) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive((PSRWLOCK)&mutex->lock);
+#else
+    pthread_mutex_lock(&mutex->lock);
+#endif
+}
+
+void unlockMutex(Mutex* mutex) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive((PSRWLOCK)&mutex->lock);
+#else
+    pthread_mutex_unlock(&mutex->lock);
+#endif
+}
+
+
+// --- Condition Variable ---
+void initCondVar(CondVar* cond) {
+#ifdef _WIN32
+    InitializeConditionVariable((PCONDITION_VARIABLE)&cond->cond);
+#else
+    pthread_cond_init(&cond->cond, NULL);
+#endif
+}
+
+void destroyCondVar(CondVar* cond) {
+#ifdef _WIN32
+    (void)cond;
+#else
+    pthread_cond_destroy(&cond->cond);
+#endif
+}
+
+void waitCondVar(CondVar* cond, Mutex* mutex) {
+#ifdef _WIN32
+    SleepConditionVariableSRW((PCONDITION_VARIABLE)&cond->cond, (PSRWLOCK)&mutex->lock, INFINITE, 0);
+#else
+    pthread_cond_wait(&cond->cond, &mutex->lock);
+#endif
+}
+
+void signalCondVar(CondVar* cond) {
+#ifdef _WIN32
+    WakeConditionVariable((PCONDITION_VARIABLE)&cond->cond);
+#else
+    pthread_cond_signal(&cond->cond);
+#endif
+}
+
+void broadcastCondVar(CondVar* cond) {
+#ifdef _WIN32
+    WakeAllConditionVariable((PCONDITION_VARIABLE)&cond->cond);
+#else
+    pthread_cond_broadcast(&cond->cond);
+#endif
+}
@@ -0,0 +1,62 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+// --- Minimal Portable Threads ---
+// Thin wrapper over Win32 threads / pthreads, just enough for worker pools in headless modes
+// and background writers (mutex + condition variable for producer/consumer queues).
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+typedef void (*ThreadFunc)(void* arg); // Entry point signature for startThread()
+
+// Thread-local storage class for globals each worker needs its own copy of (e.g. the
+// selected track, so server workers can step sessions on different tracks at once).
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+typedef struct {
+#ifdef _WIN32
+    void* handle;      // HANDLE returned by CreateThread
+#else
+    pthread_t handle;
+#endif
+    ThreadFunc func;   // User entry point (called by the platform trampoline)
+    void* arg;         // Argument passed to 'func'
+} Thread;
+
+typedef struct {
+#ifdef _WIN32
+    void* lock;        // SRWLOCK (pointer-sized, no <windows.h> in this header)
+#else
+    pthread_mutex_t lock;
+#endif
+} Mutex;
+
+typedef struct {
+#ifdef _WIN32
+    void* cond;        // CONDITION_VARIABLE (pointer-sized)
+#else
+    pthread_cond_t cond;
+#endif
+} CondVar;
+
+// Function declarations
+int startThread(Thread* thread, ThreadFunc func, void* arg); // Returns 1 on success, 0 on failure
+void joinThread(Thread* thread);                             // Blocks until the thread has finished
+int getCpuCount(void);                                       // Number of online logical CPUs (at least 1)
+void initMutex(Mutex* mutex);
+void destroyMutex(Mutex* mutex);
+void lockMutex(Mutex* mutex);
+void unlockMutex(Mutex* mutex);
+void initCondVar(CondVar* cond);
+void destroyCondVar(CondVar* cond);
+void waitCondVar(CondVar* cond, Mutex* mutex); // 'mutex' must be locked; may wake spuriously
+void signalCondVar(CondVar* cond);             // Wakes one waiter
+void broadcastCondVar(CondVar* cond);          // Wakes every waiter
+
+#endif // THREAD_H
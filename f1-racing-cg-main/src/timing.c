@@ -0,0 +1,40 @@
+// clock_gettime() is POSIX, not C99; request it before any system header is included
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "timing.h"
+
+#ifdef _WIN32
+#include <windows.h> // QueryPerformanceCounter / QueryPerformanceFrequency
+#else
+#include <time.h>    // clock_gettime, CLOCK_MONOTONIC
+#endif
+
+// --- Monotonic Clock ---
+double getTimeSeconds(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency; // Ticks per second, queried once
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// --- Sleep ---
+void sleepSeconds(double seconds) {
+    if (seconds <= 0.0) return;
+#ifdef _WIN32
+    Sleep((DWORD)(seconds * 1000.0 + 0.5));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+#endif
+}
@@ -0,0 +1,10 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+// --- High Resolution Timing ---
+// Monotonic wall-clock time in seconds from an arbitrary origin. Only differences are meaningful.
+// Used for profiling and headless runs (GLUT_ELAPSED_TIME is millisecond-only and needs a window).
+double getTimeSeconds(void);
+void sleepSeconds(double seconds); // Yields the CPU for about 'seconds' (millisecond granularity on Windows)
+
+#endif // TIMING_H
@@ -428,89 +428,3 @@ void renderGuardrails() {
         }
     } // End TRACK_ROUNDED Guardrails
 }
-
-
-// --- Collision Detection (Conditional) ---
-// Checks if the given (x, z) position is within the track boundaries.
-// Returns 1 if on track, 0 if off track.
-int isPositionOnTrack(float x, float z) {
-    if (selectedTrackType == TRACK_RECT) {
-        // --- Rectangular Collision ---
-        // Define boundaries with collision tolerance
-        float outerXPosEps = RECT_OUTER_X_POS + COLLISION_EPSILON;
-        float outerXNegEps = RECT_OUTER_X_NEG - COLLISION_EPSILON;
-        float outerZPosEps = RECT_OUTER_Z_POS + COLLISION_EPSILON;
-        float outerZNegEps = RECT_OUTER_Z_NEG - COLLISION_EPSILON;
-        float innerXPosEps = RECT_INNER_X_POS - COLLISION_EPSILON;
-        float innerXNegEps = RECT_INNER_X_NEG + COLLISION_EPSILON;
-        float innerZPosEps = RECT_INNER_Z_POS - COLLISION_EPSILON;
-        float innerZNegEps = RECT_INNER_Z_NEG + COLLISION_EPSILON;
-
-        // Check if outside the outer rectangle
-        if (x > outerXPosEps || x < outerXNegEps || z > outerZPosEps || z < outerZNegEps) {
-            return 0; // Off track (outside)
-        }
-        // Check if inside the inner hole rectangle
-        if (x < innerXPosEps && x > innerXNegEps && z < innerZPosEps && z > innerZNegEps) {
-             return 0; // Off track (inside hole)
-        }
-        // If not outside outer and not inside inner, must be on track
-        return 1; // On track
-
-    } else { // TRACK_ROUNDED
-        // --- Rounded Corner Collision ---
-        float absX = fabsf(x);
-        float absZ = fabsf(z);
-        // Calculate squared radii with tolerance for efficient comparison
-        float innerRadiusSq = powf(fmaxf(0.0f, ROUND_INNER_CORNER_RADIUS - COLLISION_EPSILON), 2);
-        float outerRadiusSq = powf(ROUND_OUTER_CORNER_RADIUS + COLLISION_EPSILON, 2);
-        // Calculate half road width with tolerance
-        float halfRoadWidthWithEps = ROUND_HALF_ROAD_WIDTH + COLLISION_EPSILON;
-
-        // Check Straight Sections first (more common)
-        // Check if within X limits of horizontal straights AND Z is within road width
-        if (absX <= ROUND_STRAIGHT_X_LIMIT) {
-             if (absZ >= (ROUND_TRACK_MAIN_LENGTH / 2.0f - halfRoadWidthWithEps) &&
-                 absZ <= (ROUND_TRACK_MAIN_LENGTH / 2.0f + halfRoadWidthWithEps)) {
-                 return 1; // On top or bottom straight
-             }
-        }
-        // Check if within Z limits of vertical straights AND X is within road width
-        if (absZ <= ROUND_STRAIGHT_Z_LIMIT) {
-             if (absX >= (ROUND_TRACK_MAIN_WIDTH / 2.0f - halfRoadWidthWithEps) &&
-                 absX <= (ROUND_TRACK_MAIN_WIDTH / 2.0f + halfRoadWidthWithEps)) {
-                 return 1; // On left or right straight
-             }
-        }
-
-        // Check Corner Sections if not on a straight
-        float corner_center_x = 0.0f, corner_center_z = 0.0f;
-        int in_corner_zone = 0; // Flag to indicate if in a corner's bounding box
-
-        // Determine which corner zone the point might be in
-        if (x > ROUND_STRAIGHT_X_LIMIT && z > ROUND_STRAIGHT_Z_LIMIT) { // Top-Right Zone
-            corner_center_x = ROUND_CORNER_CENTER_TR_X; corner_center_z = ROUND_CORNER_CENTER_TR_Z; in_corner_zone = 1;
-        } else if (x < -ROUND_STRAIGHT_X_LIMIT && z > ROUND_STRAIGHT_Z_LIMIT) { // Top-Left Zone
-            corner_center_x = ROUND_CORNER_CENTER_TL_X; corner_center_z = ROUND_CORNER_CENTER_TL_Z; in_corner_zone = 1;
-        } else if (x < -ROUND_STRAIGHT_X_LIMIT && z < -ROUND_STRAIGHT_Z_LIMIT) { // Bottom-Left Zone
-            corner_center_x = ROUND_CORNER_CENTER_BL_X; corner_center_z = ROUND_CORNER_CENTER_BL_Z; in_corner_zone = 1;
-        } else if (x > ROUND_STRAIGHT_X_LIMIT && z < -ROUND_STRAIGHT_Z_LIMIT) { // Bottom-Right Zone
-            corner_center_x = ROUND_CORNER_CENTER_BR_X; corner_center_z = ROUND_CORNER_CENTER_BR_Z; in_corner_zone = 1;
-        }
-
-        // If potentially in a corner zone, check distance from corner center
-        if (in_corner_zone) {
-            float dx = x - corner_center_x;
-            float dz = z - corner_center_z;
-            float dist_sq = dx * dx + dz * dz; // Squared distance
-
-            // Check if distance is between inner and outer radii (using squared values)
-            if (dist_sq >= innerRadiusSq && dist_sq <= outerRadiusSq) {
-                return 1; // On track (in corner)
-            }
-        }
-
-        // If none of the conditions above were met, the point is off-track
-        return 0; // Off track
-    }
-}
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "track_mesh.h" // TrackMesh, MeshChunk and prototypes
+#include "renderer.h"   // Shader path submission
+#include <GL/glew.h>    // Vertex arrays (glVertexPointer, glDrawArrays)
+#include <math.h>       // For sqrtf, floorf, ceilf, fmaxf
+#include <stdio.h>      // For fprintf
+#include <stdlib.h>     // For malloc, realloc, free, qsort
+
+MeshStats meshStats = { 0, 0, 0, 0, 0, 0 };
+
+// --- Vertex Storage ---
+static void pushVertex(MeshVertex** array, int* count, int* capacity, const MeshVertex* v) {
+    if (*count == *capacity) {
+        int newCapacity = *capacity > 0 ? *capacity * 2 : 1024;
+        MeshVertex* grown = (MeshVertex*)realloc(*array, (size_t)newCapacity * sizeof(MeshVertex));
+        if (!grown) { fprintf(stderr, "Track mesh: out of memory\n"); return; }
+        *array = grown;
+        *capacity = newCapacity;
+    }
+    (*array)[(*count)++] = *v;
+}
+
+static MeshVertex midpoint(const MeshVertex* a, const MeshVertex* b) {
+    MeshVertex m;
+    m.x = (a->x + b->x) * 0.5f; m.y = (a->y + b->y) * 0.5f; m.z = (a->z + b->z) * 0.5f;
+    for (int i = 0; i < 4; ++i) m.color[i] = (unsigned char)((a->color[i] + b->color[i]) / 2);
+    return m;
+}
+
+static float distanceSq(const MeshVertex* a, const MeshVertex* b) {
+    float dx = a->x - b->x, dy = a->y - b->y, dz = a->z - b->z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+
+// --- Primitive Output ---
+// Triangles are split at the midpoint of their longest edge until every edge is at most
+// MESH_MAX_EDGE, keeping the winding. Both triangles of a quad share its diagonal, so they
+// split it at the same point and no cracks open up.
+static void emitTriangle(TrackMesh* mesh, const MeshVertex* a, const MeshVertex* b, const MeshVertex* c) {
+    float ab = distanceSq(a, b), bc = distanceSq(b, c), ca = distanceSq(c, a);
+    float limit = MESH_MAX_EDGE * MESH_MAX_EDGE;
+    if (ab <= limit && bc <= limit && ca <= limit) {
+        pushVertex(&mesh->triVertices, &mesh->numTriVertices, &mesh->triCapacity, a);
+        pushVertex(&mesh->triVertices, &mesh->numTriVertices, &mesh->triCapacity, b);
+        pushVertex(&mesh->triVertices, &mesh->numTriVertices, &mesh->triCapacity, c);
+        return;
+    }
+    // Rotate so the longest edge is a-b, then split it
+    if (bc >= ab && bc >= ca) { const MeshVertex* t = a; a = b; b = c; c = t; }
+    else if (ca >= ab && ca >= bc) { const MeshVertex* t = c; c = b; b = a; a = t; }
+    MeshVertex m = midpoint(a, b);
+    emitTriangle(mesh, a, &m, c);
+    emitTriangle(mesh, &m, b, c);
+}
+
+static void emitLine(TrackMesh* mesh, const MeshVertex* a, const MeshVertex* b) {
+    int pieces = (int)ceilf(sqrtf(distanceSq(a, b)) / MESH_MAX_EDGE);
+    if (pieces < 1) pieces = 1;
+    MeshVertex prev = *a;
+    for (int i = 1; i <= pieces; ++i) {
+        float t = (float)i / pieces;
+        MeshVertex next = *b;
+        next.x = a->x + (b->x - a->x) * t; next.y = a->y + (b->y - a->y) * t; next.z = a->z + (b->z - a->z) * t;
+        pushVertex(&mesh->lineVertices, &mesh->numLineVertices, &mesh->lineCapacity, &prev);
+        pushVertex(&mesh->lineVertices, &mesh->numLineVertices, &mesh->lineCapacity, &next);
+        prev = next;
+    }
+}
+
+
+// --- Builder ---
+void initTrackMesh(TrackMesh* mesh) {
+    mesh->triVertices = NULL; mesh->numTriVertices = 0; mesh->triCapacity = 0;
+    mesh->lineVertices = NULL; mesh->numLineVertices = 0; mesh->lineCapacity = 0;
+    mesh->chunks = NULL; mesh->numChunks = 0;
+    mesh->lineWidth = 1.0f;
+    mesh->built = 0;
+    mesh->gpuVertexArrays[0] = mesh->gpuVertexArrays[1] = 0;
+    mesh->gpuBuffers[0] = mesh->gpuBuffers[1] = 0;
+    mesh->primitive = MESH_TRIANGLES;
+    mesh->numPending = 0;
+    mesh->primitiveVertexCount = 0;
+    mesh->currentColor[0] = mesh->currentColor[1] = mesh->currentColor[2] = mesh->currentColor[3] = 255;
+}
+
+void meshColor3f(TrackMesh* mesh, float r, float g, float b) {
+    mesh->currentColor[0] = (unsigned char)(r * 255.0f + 0.5f);
+    mesh->currentColor[1] = (unsigned char)(g * 255.0f + 0.5f);
+    mesh->currentColor[2] = (unsigned char)(b * 255.0f + 0.5f);
+    mesh->currentColor[3] = 255;
+}
+
+void meshBegin(TrackMesh* mesh, MeshPrimitive primitive) {
+    mesh->primitive = primitive;
+    mesh->numPending = 0;
+    mesh->primitiveVertexCount = 0;
+}
+
+void meshVertex3f(TrackMesh* mesh, float x, float y, float z) {
+    MeshVertex v;
+    v.x = x; v.y = y; v.z = z;
+    for (int i = 0; i < 4; ++i) v.color[i] = mesh->currentColor[i];
+    int k = mesh->primitiveVertexCount++;
+    MeshVertex* p = mesh->pending;
+
+    switch (mesh->primitive) {
+        case MESH_TRIANGLES:
+            p[mesh->numPending++] = v;
+            if (mesh->numPending == 3) { emitTriangle(mesh, &p[0], &p[1], &p[2]); mesh->numPending = 0; }
+            break;
+        case MESH_QUADS:
+            p[mesh->numPending++] = v;
+            if (mesh->numPending == 4) {
+                emitTriangle(mesh, &p[0], &p[1], &p[2]);
+                emitTriangle(mesh, &p[0], &p[2], &p[3]);
+                mesh->numPending = 0;
+            }
+            break;
+        case MESH_QUAD_STRIP:
+            // p[0..1] is the previous vertex pair, p[2..3] the pair being completed
+            p[k < 2 ? k : 2 + (k % 2)] = v;
+            if (k >= 3 && k % 2 == 1) {
+                emitTriangle(mesh, &p[0], &p[1], &p[3]); // Same quad as GL: v0, v1, v3, v2
+                emitTriangle(mesh, &p[0], &p[3], &p[2]);
+                p[0] = p[2];
+                p[1] = p[3];
+            }
+            break;
+        case MESH_LINES:
+            p[mesh->numPending++] = v;
+            if (mesh->numPending == 2) { emitLine(mesh, &p[0], &p[1]); mesh->numPending = 0; }
+            break;
+        case MESH_LINE_STRIP:
+        case MESH_LINE_LOOP:
+            if (k == 0) mesh->loopStart = v;
+            else emitLine(mesh, &p[0], &v);
+            p[0] = v;
+            break;
+    }
+}
+
+void meshVertex3fv(TrackMesh* mesh, const float* v) {
+    meshVertex3f(mesh, v[0], v[1], v[2]);
+}
+
+void meshEnd(TrackMesh* mesh) {
+    if (mesh->primitive == MESH_LINE_LOOP && mesh->primitiveVertexCount > 2) {
+        emitLine(mesh, &mesh->pending[0], &mesh->loopStart); // Close the loop
+    }
+    mesh->numPending = 0;
+    mesh->primitiveVertexCount = 0;
+}
+
+
+// --- Chunking ---
+// Every triangle and line goes to the chunk of the grid cell containing its centroid.
+// Primitives are at most MESH_MAX_EDGE long, so a chunk's box exceeds its cell by at most that.
+typedef struct {
+    int key;    // Packed cell coordinates
+    int isLine;
+    int index;  // Primitive index (in triangles or lines)
+} ChunkItem;
+
+static int compareChunkItems(const void* a, const void* b) {
+    const ChunkItem* ia = (const ChunkItem*)a;
+    const ChunkItem* ib = (const ChunkItem*)b;
+    if (ia->key != ib->key) return ia->key < ib->key ? -1 : 1;
+    if (ia->isLine != ib->isLine) return ia->isLine - ib->isLine;
+    return ia->index - ib->index; // Keep build order inside a chunk
+}
+
+static int cellKey(float x, float z) {
+    int cx = (int)floorf(x / MESH_CHUNK_SIZE) + 1024;
+    int cz = (int)floorf(z / MESH_CHUNK_SIZE) + 1024;
+    return cx * 2048 + cz;
+}
+
+void finishTrackMesh(TrackMesh* mesh) {
+    int numTris = mesh->numTriVertices / 3;
+    int numLines = mesh->numLineVertices / 2;
+    int numItems = numTris + numLines;
+    ChunkItem* items = (ChunkItem*)malloc((size_t)(numItems > 0 ? numItems : 1) * sizeof(ChunkItem));
+    MeshVertex* tris = (MeshVertex*)malloc((size_t)(mesh->numTriVertices > 0 ? mesh->numTriVertices : 1) * sizeof(MeshVertex));
+    MeshVertex* lines = (MeshVertex*)malloc((size_t)(mesh->numLineVertices > 0 ? mesh->numLineVertices : 1) * sizeof(MeshVertex));
+    mesh->chunks = (MeshChunk*)malloc((size_t)(numItems > 0 ? numItems : 1) * sizeof(MeshChunk));
+    if (!items || !tris || !lines || !mesh->chunks) {
+        fprintf(stderr, "Track mesh: out of memory while chunking\n");
+        free(items); free(tris); free(lines);
+        return;
+    }
+
+    for (int t = 0; t < numTris; ++t) {
+        const MeshVertex* v = &mesh->triVertices[t * 3];
+        items[t].key = cellKey((v[0].x + v[1].x + v[2].x) / 3.0f, (v[0].z + v[1].z + v[2].z) / 3.0f);
+        items[t].isLine = 0;
+        items[t].index = t;
+    }
+    for (int l = 0; l < numLines; ++l) {
+        const MeshVertex* v = &mesh->lineVertices[l * 2];
+        ChunkItem* item = &items[numTris + l];
+        item->key = cellKey((v[0].x + v[1].x) * 0.5f, (v[0].z + v[1].z) * 0.5f);
+        item->isLine = 1;
+        item->index = l;
+    }
+    qsort(items, (size_t)numItems, sizeof(ChunkItem), compareChunkItems);
+
+    // Copy the primitives out in chunk order, one MeshChunk per distinct cell
+    int triOut = 0, lineOut = 0;
+    mesh->numChunks = 0;
+    for (int i = 0; i < numItems; ++i) {
+        if (i == 0 || items[i].key != items[i - 1].key) {
+            MeshChunk* chunk = &mesh->chunks[mesh->numChunks++];
+            chunk->firstTriVertex = triOut; chunk->numTriVertices = 0;
+            chunk->firstLineVertex = lineOut; chunk->numLineVertices = 0;
+            chunk->boundsMin[0] = chunk->boundsMin[1] = chunk->boundsMin[2] = 1e30f;
+            chunk->boundsMax[0] = chunk->boundsMax[1] = chunk->boundsMax[2] = -1e30f;
+        }
+        MeshChunk* chunk = &mesh->chunks[mesh->numChunks - 1];
+        int count = items[i].isLine ? 2 : 3;
+        const MeshVertex* src = items[i].isLine ? &mesh->lineVertices[items[i].index * 2] : &mesh->triVertices[items[i].index * 3];
+        MeshVertex* dst = items[i].isLine ? &lines[lineOut] : &tris[triOut];
+        for (int v = 0; v < count; ++v) {
+            dst[v] = src[v];
+            const float pos[3] = { src[v].x, src[v].y, src[v].z };
+            for (int a = 0; a < 3; ++a) {
+                if (pos[a] < chunk->boundsMin[a]) chunk->boundsMin[a] = pos[a];
+                if (pos[a] > chunk->boundsMax[a]) chunk->boundsMax[a] = pos[a];
+            }
+        }
+        if (items[i].isLine) { lineOut += 2; chunk->numLineVertices += 2; }
+        else { triOut += 3; chunk->numTriVertices += 3; }
+    }
+
+    free(items);
+    free(mesh->triVertices);
+    free(mesh->lineVertices);
+    mesh->triVertices = tris;   mesh->triCapacity = mesh->numTriVertices;
+    mesh->lineVertices = lines; mesh->lineCapacity = mesh->numLineVertices;
+    mesh->built = 1;
+}
+
+void freeTrackMesh(TrackMesh* mesh) {
+    free(mesh->triVertices);
+    free(mesh->lineVertices);
+    free(mesh->chunks);
+    if (mesh->gpuBuffers[0] || mesh->gpuBuffers[1]) {
+        glDeleteBuffers(2, mesh->gpuBuffers);          // Zero names are ignored
+        glDeleteVertexArrays(2, mesh->gpuVertexArrays);
+    }
+    initTrackMesh(mesh);
+}
+
+
+// --- Level of Detail Groups ---
+void initMeshLodGroup(MeshLodGroup* group) {
+    group->numLevels = 0;
+    for (int a = 0; a < 3; ++a) { group->boundsMin[a] = 1e30f; group->boundsMax[a] = -1e30f; }
+}
+
+TrackMesh* addMeshLodLevel(MeshLodGroup* group, float error) {
+    if (group->numLevels >= MESH_MAX_LODS) return NULL;
+    TrackMesh* level = &group->levels[group->numLevels];
+    group->errors[group->numLevels++] = error;
+    initTrackMesh(level);
+    return level;
+}
+
+void finishMeshLodGroup(MeshLodGroup* group) {
+    for (int l = 0; l < group->numLevels; ++l) {
+        TrackMesh* level = &group->levels[l];
+        finishTrackMesh(level);
+        for (int c = 0; c < level->numChunks; ++c) {
+            for (int a = 0; a < 3; ++a) {
+                if (level->chunks[c].boundsMin[a] < group->boundsMin[a]) group->boundsMin[a] = level->chunks[c].boundsMin[a];
+                if (level->chunks[c].boundsMax[a] > group->boundsMax[a]) group->boundsMax[a] = level->chunks[c].boundsMax[a];
+            }
+        }
+    }
+}
+
+int selectMeshLod(const MeshLodGroup* group, const Frustum* frustum) {
+    if (!frustum || group->numLevels < 2) return 0;
+    // Distance from the eye to the closest point of the group's box (0 inside it)
+    float distSq = 0.0f;
+    for (int a = 0; a < 3; ++a) {
+        float d = 0.0f;
+        if (frustum->eye[a] < group->boundsMin[a]) d = group->boundsMin[a] - frustum->eye[a];
+        else if (frustum->eye[a] > group->boundsMax[a]) d = frustum->eye[a] - group->boundsMax[a];
+        distSq += d * d;
+    }
+    float dist = fmaxf(sqrtf(distSq), 0.1f); // Near plane distance
+    int selected = 0;
+    for (int l = 1; l < group->numLevels; ++l) {
+        if (group->errors[l] * frustum->pixelScale / dist > MESH_LOD_PIXEL_ERROR) break;
+        selected = l;
+    }
+    return selected;
+}
+
+
+// --- Drawing ---
+void resetMeshStats(void) {
+    meshStats.chunksDrawn = meshStats.chunksCulled = 0;
+    meshStats.trianglesDrawn = meshStats.linesDrawn = 0;
+    meshStats.lodGroupsDrawn = meshStats.lodLevelSum = 0;
+}
+
+void drawTrackMesh(TrackMesh* mesh, const Frustum* frustum) {
+    if (!mesh->built) return;
+    int queued = renderPath == RENDER_PATH_SHADER; // Ranges go to the sorted draw queue instead
+    if (!queued) {
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+    }
+
+    // Triangles (also decides the per-chunk statistics)
+    if (!queued && mesh->numTriVertices > 0) {
+        glVertexPointer(3, GL_FLOAT, sizeof(MeshVertex), &mesh->triVertices[0].x);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(MeshVertex), mesh->triVertices[0].color);
+    }
+    for (int c = 0; c < mesh->numChunks; ++c) {
+        const MeshChunk* chunk = &mesh->chunks[c];
+        if (frustum && !isBoxInFrustum(frustum, chunk->boundsMin, chunk->boundsMax)) {
+            meshStats.chunksCulled++;
+            continue;
+        }
+        meshStats.chunksDrawn++;
+        if (chunk->numTriVertices > 0) {
+            if (queued) submitMeshDraw(mesh, 0, chunk->firstTriVertex, chunk->numTriVertices);
+            else glDrawArrays(GL_TRIANGLES, chunk->firstTriVertex, chunk->numTriVertices);
+            meshStats.trianglesDrawn += chunk->numTriVertices / 3;
+        }
+    }
+
+    // Lines (markings), drawn after the surfaces they sit on
+    if (mesh->numLineVertices > 0) {
+        if (!queued) {
+            glLineWidth(mesh->lineWidth);
+            glVertexPointer(3, GL_FLOAT, sizeof(MeshVertex), &mesh->lineVertices[0].x);
+            glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(MeshVertex), mesh->lineVertices[0].color);
+        }
+        for (int c = 0; c < mesh->numChunks; ++c) {
+            const MeshChunk* chunk = &mesh->chunks[c];
+            if (chunk->numLineVertices == 0) continue;
+            if (frustum && !isBoxInFrustum(frustum, chunk->boundsMin, chunk->boundsMax)) continue;
+            if (queued) submitMeshDraw(mesh, 1, chunk->firstLineVertex, chunk->numLineVertices);
+            else glDrawArrays(GL_LINES, chunk->firstLineVertex, chunk->numLineVertices);
+            meshStats.linesDrawn += chunk->numLineVertices / 2;
+        }
+        if (!queued) glLineWidth(1.0f); // Reset
+    }
+
+    if (!queued) {
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+    }
+}
+
+void drawMeshLodGroup(MeshLodGroup* group, const Frustum* frustum) {
+    if (group->numLevels == 0) return;
+    if (frustum && !isBoxInFrustum(frustum, group->boundsMin, group->boundsMax)) {
+        meshStats.chunksCulled += group->levels[0].numChunks;
+        return;
+    }
+    int level = selectMeshLod(group, frustum);
+    meshStats.lodGroupsDrawn++;
+    meshStats.lodLevelSum += level;
+    drawTrackMesh(&group->levels[level], frustum);
+}
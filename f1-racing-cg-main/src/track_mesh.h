@@ -0,0 +1,101 @@
+#ifndef TRACK_MESH_H
+#define TRACK_MESH_H
+
+#include "frustum.h" // Chunks are culled against a Frustum
+
+// --- Track Mesh ---
+// Static track geometry (ground, surface, markings, guardrails) is built once, with calls
+// that mirror glBegin/glColor/glVertex/glEnd, then split into square spatial chunks with
+// bounding boxes. Each frame only the chunks inside the view frustum are submitted,
+// as vertex arrays (one glDrawArrays per chunk and primitive type).
+
+#define MESH_CHUNK_SIZE 32.0f // Chunk edge length in world units (X and Z)
+#define MESH_MAX_EDGE 32.0f   // Longer triangle edges / line segments are split so they bin cleanly
+
+// Primitive types accepted by meshBegin(), converted to triangles or lines on the fly.
+typedef enum {
+    MESH_TRIANGLES,
+    MESH_QUADS,
+    MESH_QUAD_STRIP,
+    MESH_LINES,
+    MESH_LINE_STRIP,
+    MESH_LINE_LOOP
+} MeshPrimitive;
+
+typedef struct {
+    float x, y, z;
+    unsigned char color[4]; // RGBA, so the vertex is 16 bytes
+} MeshVertex;
+
+typedef struct {
+    float boundsMin[3], boundsMax[3];
+    int firstTriVertex, numTriVertices;   // Range in TrackMesh.triVertices
+    int firstLineVertex, numLineVertices; // Range in TrackMesh.lineVertices
+} MeshChunk;
+
+typedef struct {
+    MeshVertex* triVertices;  // GL_TRIANGLES, grouped by chunk after finishTrackMesh()
+    int numTriVertices, triCapacity;
+    MeshVertex* lineVertices; // GL_LINES, grouped by chunk
+    int numLineVertices, lineCapacity;
+    MeshChunk* chunks;
+    int numChunks;
+    float lineWidth;          // glLineWidth for the markings
+    int built;                // 1 once finishTrackMesh() has run
+    unsigned int gpuVertexArrays[2], gpuBuffers[2]; // Shader path: triangles, lines (0 = not uploaded)
+
+    // Builder state (between meshBegin and meshEnd)
+    MeshPrimitive primitive;
+    MeshVertex pending[4];    // Vertices waiting for a complete primitive
+    int numPending;
+    MeshVertex loopStart;     // First vertex of a line loop
+    int primitiveVertexCount;
+    unsigned char currentColor[4];
+} TrackMesh;
+
+// --- Per-Frame Statistics ---
+// Accumulated by drawTrackMesh() until reset (e.g. once per frame by a benchmark).
+typedef struct {
+    long chunksDrawn, chunksCulled;
+    long trianglesDrawn, linesDrawn;
+    long lodGroupsDrawn, lodLevelSum; // Average selected level = lodLevelSum / lodGroupsDrawn
+} MeshStats;
+
+extern MeshStats meshStats;
+
+// --- Level of Detail ---
+// A group holds the same piece of geometry (e.g. one rounded corner) tessellated at several
+// levels, finest first. Each frame the coarsest level whose deviation from the true shape
+// projects to at most MESH_LOD_PIXEL_ERROR pixels is drawn. Levels must share their boundary
+// vertices with the neighbouring geometry, so switching levels never opens cracks.
+#define MESH_MAX_LODS 4
+#define MESH_LOD_PIXEL_ERROR 1.0f
+
+typedef struct {
+    TrackMesh levels[MESH_MAX_LODS];
+    float errors[MESH_MAX_LODS];      // World-space deviation of each level (0 = exact)
+    int numLevels;
+    float boundsMin[3], boundsMax[3]; // Union of all levels, used for the distance to the camera
+} MeshLodGroup;
+
+// --- Function Declarations ---
+// Building
+void initTrackMesh(TrackMesh* mesh);
+void meshColor3f(TrackMesh* mesh, float r, float g, float b);
+void meshBegin(TrackMesh* mesh, MeshPrimitive primitive);
+void meshVertex3f(TrackMesh* mesh, float x, float y, float z);
+void meshVertex3fv(TrackMesh* mesh, const float* v);
+void meshEnd(TrackMesh* mesh);
+void finishTrackMesh(TrackMesh* mesh); // Splits the geometry into chunks; call once after building
+void freeTrackMesh(TrackMesh* mesh);
+void initMeshLodGroup(MeshLodGroup* group);
+TrackMesh* addMeshLodLevel(MeshLodGroup* group, float error); // Returns the level to build into (NULL if full)
+void finishMeshLodGroup(MeshLodGroup* group);                  // Chunks every level and computes the bounds
+
+// Drawing (immediately on the fixed-function path, queued on the shader path, see renderer.h)
+void drawTrackMesh(TrackMesh* mesh, const Frustum* frustum); // NULL frustum draws every chunk
+int selectMeshLod(const MeshLodGroup* group, const Frustum* frustum); // NULL frustum selects level 0
+void drawMeshLodGroup(MeshLodGroup* group, const Frustum* frustum);
+void resetMeshStats(void);
+
+#endif // TRACK_MESH_H
@@ -1,95 +1,159 @@
 #include "track_rect.h" // Specific header for this track
+#include "track_mesh.h" // Chunked, frustum-culled geometry
+#include "surface.h"    // Kerb and run-off widths (the meshes follow classifySurface())
 #include <GL/glew.h>
 #include <GL/freeglut.h>
 #include <math.h>
 #include <stdio.h>
 
-// --- Wall Drawing Helper --- (Specific to this file now)
-void drawWallRect(float x1, float z1, float x2, float z2, float height, float thickness) {
+// --- Track Meshes ---
+// Built on first use, then drawn chunk by chunk with frustum culling (see track_mesh.h).
+static TrackMesh rectTrackMesh;    // Ground, surface, markings, finish line
+static TrackMesh rectRailMesh;     // Guardrails
+static int rectMeshesInitialized = 0;
+
+// --- Wall Building Helper --- (Specific to this file now)
+static void buildWallRect(TrackMesh* mesh, float x1, float z1, float x2, float z2, float height, float thickness) {
     float dx=x2-x1; float dz=z2-z1; float len=sqrtf(dx*dx+dz*dz); if(len<0.001f) return;
     float nx=dx/len; float nz=dz/len; float px=-nz; float pz=nx; float half_thick=thickness/2.0f;
     float v[8][3]={ {x1-px*half_thick,0.0f,z1-pz*half_thick},{x1+px*half_thick,0.0f,z1+pz*half_thick},{x2+px*half_thick,0.0f,z2+pz*half_thick},{x2-px*half_thick,0.0f,z2-pz*half_thick}, {x1-px*half_thick,height,z1-pz*half_thick},{x1+px*half_thick,height,z1+pz*half_thick},{x2+px*half_thick,height,z2+pz*half_thick},{x2-px*half_thick,height,z2-pz*half_thick} };
-    glBegin(GL_QUADS);
-    glVertex3fv(v[4]);glVertex3fv(v[5]);glVertex3fv(v[6]);glVertex3fv(v[7]); // Top
-    glVertex3fv(v[0]);glVertex3fv(v[3]);glVertex3fv(v[7]);glVertex3fv(v[4]); // Front
-    glVertex3fv(v[1]);glVertex3fv(v[5]);glVertex3fv(v[6]);glVertex3fv(v[2]); // Back
-    glVertex3fv(v[0]);glVertex3fv(v[4]);glVertex3fv(v[5]);glVertex3fv(v[1]); // Left
-    glVertex3fv(v[3]);glVertex3fv(v[2]);glVertex3fv(v[6]);glVertex3fv(v[7]); // Right
-    glEnd();
+    meshBegin(mesh, MESH_QUADS);
+    meshVertex3fv(mesh, v[4]);meshVertex3fv(mesh, v[5]);meshVertex3fv(mesh, v[6]);meshVertex3fv(mesh, v[7]); // Top
+    meshVertex3fv(mesh, v[0]);meshVertex3fv(mesh, v[3]);meshVertex3fv(mesh, v[7]);meshVertex3fv(mesh, v[4]); // Front
+    meshVertex3fv(mesh, v[1]);meshVertex3fv(mesh, v[5]);meshVertex3fv(mesh, v[6]);meshVertex3fv(mesh, v[2]); // Back
+    meshVertex3fv(mesh, v[0]);meshVertex3fv(mesh, v[4]);meshVertex3fv(mesh, v[5]);meshVertex3fv(mesh, v[1]); // Left
+    meshVertex3fv(mesh, v[3]);meshVertex3fv(mesh, v[2]);meshVertex3fv(mesh, v[6]);meshVertex3fv(mesh, v[7]); // Right
+    meshEnd(mesh);
 }
 
-// --- Rectangular Track Rendering ---
-void renderRectTrack() {
+// --- Kerb Building Helper ---
+// Kerb band along the road edge (x1,z1)-(x2,z2), reaching (ox,oz) off the road, in red and white
+// blocks of about KERB_STRIPE_LENGTH
+#define KERB_STRIPE_LENGTH 2.0f
+static void buildKerbRect(TrackMesh* mesh, float x1, float z1, float x2, float z2, float ox, float oz, float y) {
+    if ((x2-x1)*oz - (z2-z1)*ox > 0.0f) { // Wind it to face up (culling) whichever side of the edge it is on
+        float t = x1; x1 = x2; x2 = t; t = z1; z1 = z2; z2 = t;
+    }
+    float dx=x2-x1; float dz=z2-z1; float len=sqrtf(dx*dx+dz*dz); if(len<0.001f) return;
+    int stripes = (int)ceilf(len / KERB_STRIPE_LENGTH);
+    meshBegin(mesh, MESH_QUADS);
+    for (int i = 0; i < stripes; ++i) {
+        float t0 = (float)i / stripes; float t1 = (float)(i + 1) / stripes;
+        if (i & 1) meshColor3f(mesh, 0.95f, 0.95f, 0.95f); else meshColor3f(mesh, 0.85f, 0.1f, 0.1f);
+        meshVertex3f(mesh, x1 + dx * t0, y, z1 + dz * t0); meshVertex3f(mesh, x1 + dx * t1, y, z1 + dz * t1);
+        meshVertex3f(mesh, x1 + dx * t1 + ox, y, z1 + dz * t1 + oz); meshVertex3f(mesh, x1 + dx * t0 + ox, y, z1 + dz * t0 + oz);
+    }
+    meshEnd(mesh);
+}
+
+// Axis-aligned ground rectangle between two opposite corners, facing up
+static void buildGroundRect(TrackMesh* mesh, float xa, float za, float xb, float zb, float y) {
+    float x0 = fminf(xa, xb), x1 = fmaxf(xa, xb), z0 = fminf(za, zb), z1 = fmaxf(za, zb);
+    meshVertex3f(mesh, x0, y, z0); meshVertex3f(mesh, x0, y, z1);
+    meshVertex3f(mesh, x1, y, z1); meshVertex3f(mesh, x1, y, z0);
+}
+
+// --- Rectangular Track Mesh ---
+static void buildRectTrackMesh(TrackMesh* mesh) {
     float surface_y = 0.0f;
     float line_y = 0.01f;
     float finish_y = 0.02f;
+    float verge_y = -0.01f; // Kerbs and gravel, just above the ground plane
 
     // --- Render Ground Plane ---
-    glColor3f(0.2f, 0.6f, 0.2f); // Grassy Green
-    glBegin(GL_QUADS);
+    meshColor3f(mesh, 0.2f, 0.6f, 0.2f); // Grassy Green
+    meshBegin(mesh, MESH_QUADS);
         float groundSize = fmaxf(RECT_TRACK_MAIN_WIDTH, RECT_TRACK_MAIN_LENGTH) * 1.2f;
-        glVertex3f(-groundSize, -0.02f, -groundSize); glVertex3f(-groundSize, -0.02f,  groundSize);
-        glVertex3f( groundSize, -0.02f,  groundSize); glVertex3f( groundSize, -0.02f, -groundSize);
-    glEnd();
+        meshVertex3f(mesh, -groundSize, -0.02f, -groundSize); meshVertex3f(mesh, -groundSize, -0.02f,  groundSize);
+        meshVertex3f(mesh,  groundSize, -0.02f,  groundSize); meshVertex3f(mesh,  groundSize, -0.02f, -groundSize);
+    meshEnd(mesh);
 
     // --- Render Track Surface ---
-    glColor3f(0.4f, 0.4f, 0.45f); // Asphalt Grey Color
+    meshColor3f(mesh, 0.4f, 0.4f, 0.45f); // Asphalt Grey Color
 
     // Top strip
-    glBegin(GL_QUADS);
-        glVertex3f(RECT_OUTER_X_NEG, surface_y, RECT_INNER_Z_POS); glVertex3f(RECT_OUTER_X_POS, surface_y, RECT_INNER_Z_POS);
-        glVertex3f(RECT_OUTER_X_POS, surface_y, RECT_OUTER_Z_POS); glVertex3f(RECT_OUTER_X_NEG, surface_y, RECT_OUTER_Z_POS);
-    glEnd();
+    meshBegin(mesh, MESH_QUADS);
+        meshVertex3f(mesh, RECT_OUTER_X_NEG, surface_y, RECT_INNER_Z_POS); meshVertex3f(mesh, RECT_OUTER_X_POS, surface_y, RECT_INNER_Z_POS);
+        meshVertex3f(mesh, RECT_OUTER_X_POS, surface_y, RECT_OUTER_Z_POS); meshVertex3f(mesh, RECT_OUTER_X_NEG, surface_y, RECT_OUTER_Z_POS);
+    meshEnd(mesh);
     // Bottom strip
-    glBegin(GL_QUADS);
-        glVertex3f(RECT_OUTER_X_NEG, surface_y, RECT_OUTER_Z_NEG); glVertex3f(RECT_OUTER_X_POS, surface_y, RECT_OUTER_Z_NEG);
-        glVertex3f(RECT_OUTER_X_POS, surface_y, RECT_INNER_Z_NEG); glVertex3f(RECT_OUTER_X_NEG, surface_y, RECT_INNER_Z_NEG);
-    glEnd();
+    meshBegin(mesh, MESH_QUADS);
+        meshVertex3f(mesh, RECT_OUTER_X_NEG, surface_y, RECT_OUTER_Z_NEG); meshVertex3f(mesh, RECT_OUTER_X_POS, surface_y, RECT_OUTER_Z_NEG);
+        meshVertex3f(mesh, RECT_OUTER_X_POS, surface_y, RECT_INNER_Z_NEG); meshVertex3f(mesh, RECT_OUTER_X_NEG, surface_y, RECT_INNER_Z_NEG);
+    meshEnd(mesh);
     // Left strip
-    glBegin(GL_QUADS);
-        glVertex3f(RECT_OUTER_X_NEG, surface_y, RECT_INNER_Z_NEG); glVertex3f(RECT_INNER_X_NEG, surface_y, RECT_INNER_Z_NEG);
-        glVertex3f(RECT_INNER_X_NEG, surface_y, RECT_INNER_Z_POS); glVertex3f(RECT_OUTER_X_NEG, surface_y, RECT_INNER_Z_POS);
-    glEnd();
+    meshBegin(mesh, MESH_QUADS);
+        meshVertex3f(mesh, RECT_OUTER_X_NEG, surface_y, RECT_INNER_Z_NEG); meshVertex3f(mesh, RECT_INNER_X_NEG, surface_y, RECT_INNER_Z_NEG);
+        meshVertex3f(mesh, RECT_INNER_X_NEG, surface_y, RECT_INNER_Z_POS); meshVertex3f(mesh, RECT_OUTER_X_NEG, surface_y, RECT_INNER_Z_POS);
+    meshEnd(mesh);
     // Right strip
-     glBegin(GL_QUADS);
-        glVertex3f(RECT_INNER_X_POS, surface_y, RECT_INNER_Z_NEG); glVertex3f(RECT_OUTER_X_POS, surface_y, RECT_INNER_Z_NEG);
-        glVertex3f(RECT_OUTER_X_POS, surface_y, RECT_INNER_Z_POS); glVertex3f(RECT_INNER_X_POS, surface_y, RECT_INNER_Z_POS);
-    glEnd();
+     meshBegin(mesh, MESH_QUADS);
+        meshVertex3f(mesh, RECT_INNER_X_POS, surface_y, RECT_INNER_Z_NEG); meshVertex3f(mesh, RECT_OUTER_X_POS, surface_y, RECT_INNER_Z_NEG);
+        meshVertex3f(mesh, RECT_OUTER_X_POS, surface_y, RECT_INNER_Z_POS); meshVertex3f(mesh, RECT_INNER_X_POS, surface_y, RECT_INNER_Z_POS);
+    meshEnd(mesh);
+
+    // --- Kerbs ---
+    // Outside the outer edge (the top and bottom bands also fill the corner squares) and inside the
+    // inner edge
+    const float k = TRACK_KERB_WIDTH;
+    buildKerbRect(mesh, RECT_OUTER_X_NEG - k, RECT_OUTER_Z_POS, RECT_OUTER_X_POS + k, RECT_OUTER_Z_POS, 0.0f,  k, verge_y); // Top
+    buildKerbRect(mesh, RECT_OUTER_X_NEG - k, RECT_OUTER_Z_NEG, RECT_OUTER_X_POS + k, RECT_OUTER_Z_NEG, 0.0f, -k, verge_y); // Bottom
+    buildKerbRect(mesh, RECT_OUTER_X_POS, RECT_OUTER_Z_NEG, RECT_OUTER_X_POS, RECT_OUTER_Z_POS,  k, 0.0f, verge_y); // Right
+    buildKerbRect(mesh, RECT_OUTER_X_NEG, RECT_OUTER_Z_NEG, RECT_OUTER_X_NEG, RECT_OUTER_Z_POS, -k, 0.0f, verge_y); // Left
+    buildKerbRect(mesh, RECT_INNER_X_NEG, RECT_INNER_Z_POS, RECT_INNER_X_POS, RECT_INNER_Z_POS, 0.0f, -k, verge_y); // Inner top
+    buildKerbRect(mesh, RECT_INNER_X_NEG, RECT_INNER_Z_NEG, RECT_INNER_X_POS, RECT_INNER_Z_NEG, 0.0f,  k, verge_y); // Inner bottom
+    buildKerbRect(mesh, RECT_INNER_X_POS, RECT_INNER_Z_NEG + k, RECT_INNER_X_POS, RECT_INNER_Z_POS - k, -k, 0.0f, verge_y); // Inner right
+    buildKerbRect(mesh, RECT_INNER_X_NEG, RECT_INNER_Z_NEG + k, RECT_INNER_X_NEG, RECT_INNER_Z_POS - k,  k, 0.0f, verge_y); // Inner left
+
+    // --- Gravel Traps ---
+    // Outside each corner, from the kerb to the guardrail, starting SURFACE_GRAVEL_LEAD before it
+    meshColor3f(mesh, 0.76f, 0.68f, 0.5f); // Sand
+    meshBegin(mesh, MESH_QUADS);
+    for (int corner = 0; corner < 4; ++corner) {
+        float sx = (corner == 0 || corner == 3) ? 1.0f : -1.0f; // TR, TL, BL, BR
+        float sz = (corner < 2) ? 1.0f : -1.0f;
+        float kerbX = RECT_OUTER_X_POS + k, railX = RECT_OUTER_X_POS + TRACK_RUNOFF_WIDTH;
+        float kerbZ = RECT_OUTER_Z_POS + k, railZ = RECT_OUTER_Z_POS + TRACK_RUNOFF_WIDTH;
+        float leadX = RECT_OUTER_X_POS - RECT_HALF_ROAD_WIDTH - SURFACE_GRAVEL_LEAD; // Centre line minus the lead
+        float leadZ = RECT_OUTER_Z_POS - RECT_HALF_ROAD_WIDTH - SURFACE_GRAVEL_LEAD;
+        // Beside the side straight (up to the corner square), then beside the end straight
+        buildGroundRect(mesh, sx * kerbX, sz * leadZ, sx * railX, sz * railZ, verge_y);
+        buildGroundRect(mesh, sx * leadX, sz * kerbZ, sx * kerbX, sz * railZ, verge_y);
+    }
+    meshEnd(mesh);
 
 
     // --- Render Track Markings ---
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glLineWidth(2.0f);
+    meshColor3f(mesh, 1.0f, 1.0f, 1.0f);
+    mesh->lineWidth = 2.0f;
 
     // Outer boundary
-    glBegin(GL_LINE_LOOP);
-        glVertex3f(RECT_OUTER_X_NEG, line_y, RECT_OUTER_Z_NEG); glVertex3f(RECT_OUTER_X_POS, line_y, RECT_OUTER_Z_NEG);
-        glVertex3f(RECT_OUTER_X_POS, line_y, RECT_OUTER_Z_POS); glVertex3f(RECT_OUTER_X_NEG, line_y, RECT_OUTER_Z_POS);
-    glEnd();
+    meshBegin(mesh, MESH_LINE_LOOP);
+        meshVertex3f(mesh, RECT_OUTER_X_NEG, line_y, RECT_OUTER_Z_NEG); meshVertex3f(mesh, RECT_OUTER_X_POS, line_y, RECT_OUTER_Z_NEG);
+        meshVertex3f(mesh, RECT_OUTER_X_POS, line_y, RECT_OUTER_Z_POS); meshVertex3f(mesh, RECT_OUTER_X_NEG, line_y, RECT_OUTER_Z_POS);
+    meshEnd(mesh);
     // Inner boundary
-    glBegin(GL_LINE_LOOP);
-        glVertex3f(RECT_INNER_X_NEG, line_y, RECT_INNER_Z_NEG); glVertex3f(RECT_INNER_X_POS, line_y, RECT_INNER_Z_NEG);
-        glVertex3f(RECT_INNER_X_POS, line_y, RECT_INNER_Z_POS); glVertex3f(RECT_INNER_X_NEG, line_y, RECT_INNER_Z_POS);
-    glEnd();
+    meshBegin(mesh, MESH_LINE_LOOP);
+        meshVertex3f(mesh, RECT_INNER_X_NEG, line_y, RECT_INNER_Z_NEG); meshVertex3f(mesh, RECT_INNER_X_POS, line_y, RECT_INNER_Z_NEG);
+        meshVertex3f(mesh, RECT_INNER_X_POS, line_y, RECT_INNER_Z_POS); meshVertex3f(mesh, RECT_INNER_X_NEG, line_y, RECT_INNER_Z_POS);
+    meshEnd(mesh);
 
     // --- Start/Finish line ---
-    glColor3f(0.9f, 0.9f, 0.9f);
-    glBegin(GL_QUADS);
-        glVertex3f(RECT_FINISH_LINE_X_START, finish_y, FINISH_LINE_Z + RECT_FINISH_LINE_THICKNESS / 2.0f);
-        glVertex3f(RECT_FINISH_LINE_X_END,   finish_y, FINISH_LINE_Z + RECT_FINISH_LINE_THICKNESS / 2.0f);
-        glVertex3f(RECT_FINISH_LINE_X_END,   finish_y, FINISH_LINE_Z - RECT_FINISH_LINE_THICKNESS / 2.0f);
-        glVertex3f(RECT_FINISH_LINE_X_START, finish_y, FINISH_LINE_Z - RECT_FINISH_LINE_THICKNESS / 2.0f);
-    glEnd();
-
-    glLineWidth(1.0f); // Reset
+    meshColor3f(mesh, 0.9f, 0.9f, 0.9f);
+    meshBegin(mesh, MESH_QUADS);
+        meshVertex3f(mesh, RECT_FINISH_LINE_X_START, finish_y, FINISH_LINE_Z + RECT_FINISH_LINE_THICKNESS / 2.0f);
+        meshVertex3f(mesh, RECT_FINISH_LINE_X_END,   finish_y, FINISH_LINE_Z + RECT_FINISH_LINE_THICKNESS / 2.0f);
+        meshVertex3f(mesh, RECT_FINISH_LINE_X_END,   finish_y, FINISH_LINE_Z - RECT_FINISH_LINE_THICKNESS / 2.0f);
+        meshVertex3f(mesh, RECT_FINISH_LINE_X_START, finish_y, FINISH_LINE_Z - RECT_FINISH_LINE_THICKNESS / 2.0f);
+    meshEnd(mesh);
 }
 
-// --- Rectangular Guardrail Rendering ---
-void renderRectGuardrails() {
+// --- Rectangular Guardrail Mesh ---
+static void buildRectRailMesh(TrackMesh* mesh) {
     float railHeight = 0.8f;
     float railThickness = 0.4f;
-    float margin = 0.15f; // How far outside the track lines
-    glColor3f(0.8f, 0.1f, 0.1f); // Red
+    float margin = TRACK_RUNOFF_WIDTH + 0.15f; // How far outside the track lines: beyond the run-off
+    meshColor3f(mesh, 0.8f, 0.1f, 0.1f); // Red
 
     // Outer Guardrail coordinates
     float ox1=RECT_OUTER_X_NEG-margin; float oz1=RECT_OUTER_Z_NEG-margin;
@@ -97,10 +161,10 @@ void renderRectGuardrails() {
     float ox3=RECT_OUTER_X_POS+margin; float oz3=RECT_OUTER_Z_POS+margin;
     float ox4=RECT_OUTER_X_NEG-margin; float oz4=RECT_OUTER_Z_POS+margin;
     // Draw outer walls
-    drawWallRect(ox1, oz1, ox2, oz2, railHeight, railThickness); // Bottom
-    drawWallRect(ox2, oz2, ox3, oz3, railHeight, railThickness); // Right
-    drawWallRect(ox3, oz3, ox4, oz4, railHeight, railThickness); // Top
-    drawWallRect(ox4, oz4, ox1, oz1, railHeight, railThickness); // Left
+    buildWallRect(mesh, ox1, oz1, ox2, oz2, railHeight, railThickness); // Bottom
+    buildWallRect(mesh, ox2, oz2, ox3, oz3, railHeight, railThickness); // Right
+    buildWallRect(mesh, ox3, oz3, ox4, oz4, railHeight, railThickness); // Top
+    buildWallRect(mesh, ox4, oz4, ox1, oz1, railHeight, railThickness); // Left
 
     // Inner Guardrail coordinates
     float ix1=RECT_INNER_X_NEG+margin; float iz1=RECT_INNER_Z_NEG+margin;
@@ -108,10 +172,32 @@ void renderRectGuardrails() {
     float ix3=RECT_INNER_X_POS-margin; float iz3=RECT_INNER_Z_POS-margin;
     float ix4=RECT_INNER_X_NEG+margin; float iz4=RECT_INNER_Z_POS-margin;
      // Draw inner walls
-    drawWallRect(ix1, iz1, ix2, iz2, railHeight, railThickness); // Bottom
-    drawWallRect(ix2, iz2, ix3, iz3, railHeight, railThickness); // Right
-    drawWallRect(ix3, iz3, ix4, iz4, railHeight, railThickness); // Top
-    drawWallRect(ix4, iz4, ix1, iz1, railHeight, railThickness); // Left
+    buildWallRect(mesh, ix1, iz1, ix2, iz2, railHeight, railThickness); // Bottom
+    buildWallRect(mesh, ix2, iz2, ix3, iz3, railHeight, railThickness); // Right
+    buildWallRect(mesh, ix3, iz3, ix4, iz4, railHeight, railThickness); // Top
+    buildWallRect(mesh, ix4, iz4, ix1, iz1, railHeight, railThickness); // Left
+}
+
+// --- Rectangular Track Rendering ---
+static void ensureRectMeshes() {
+    if (rectMeshesInitialized) return;
+    initTrackMesh(&rectTrackMesh);
+    buildRectTrackMesh(&rectTrackMesh);
+    finishTrackMesh(&rectTrackMesh);
+    initTrackMesh(&rectRailMesh);
+    buildRectRailMesh(&rectRailMesh);
+    finishTrackMesh(&rectRailMesh);
+    rectMeshesInitialized = 1;
+}
+
+void renderRectTrack() {
+    ensureRectMeshes();
+    drawTrackMesh(&rectTrackMesh, &viewFrustum); // Only chunks inside the camera's view
+}
+
+void renderRectGuardrails() {
+    ensureRectMeshes();
+    drawTrackMesh(&rectRailMesh, &viewFrustum);
 }
 
 // --- Rectangular Collision Detection ---
@@ -1,4 +1,6 @@
 #include "track_round.h" // Specific header for this track
+#include "track_mesh.h"  // Chunked, frustum-culled geometry
+#include "surface.h"     // Kerb and run-off widths (the meshes follow classifySurface())
 #include <GL/glew.h>
 #include <GL/freeglut.h>
 #include <math.h>
@@ -9,156 +11,306 @@
 #define DEG_TO_RAD(angle) ((angle) * M_PI / 180.0f)
 #endif
 
+// --- Track Meshes ---
+// Built on first use, then drawn chunk by chunk with frustum culling (see track_mesh.h).
+static TrackMesh roundTrackMesh;   // Ground, straight surfaces and markings, finish line
+static TrackMesh roundRailMesh;    // Straight guardrails
+static MeshLodGroup roundCornerTrackLods[4]; // Corner surface and markings, TR, TL, BL, BR
+static MeshLodGroup roundCornerRailLods[4];  // Curved guardrails, same order
+static int roundMeshesInitialized = 0;
+
 // --- Rounded Corner Helpers (Local to this file) ---
-void renderCornerLineSegmentRound(float center_x, float center_z, float radius, float start_angle_deg, int num_segments, float y_level) {
+static void buildCornerLineSegmentRound(TrackMesh* mesh, float center_x, float center_z, float radius, float start_angle_deg, int num_segments, float y_level) {
     float angle_step = DEG_TO_RAD(90.0f) / num_segments;
     float start_rad = DEG_TO_RAD(start_angle_deg);
     for (int i = 0; i <= num_segments; ++i) {
         float current_angle = start_rad + i * angle_step;
-        glVertex3f(center_x + radius * cosf(current_angle), y_level, center_z + radius * sinf(current_angle));
+        meshVertex3f(mesh, center_x + radius * cosf(current_angle), y_level, center_z + radius * sinf(current_angle));
     }
 }
 
-void renderCornerSurfaceSegmentRound(float center_x, float center_z, float inner_rad, float outer_rad, float start_angle_deg, int num_segments, float surface_y) {
+static void buildCornerSurfaceSegmentRound(TrackMesh* mesh, float center_x, float center_z, float inner_rad, float outer_rad, float start_angle_deg, int num_segments, float surface_y) {
      float angle_step = DEG_TO_RAD(90.0f) / num_segments;
      float start_rad = DEG_TO_RAD(start_angle_deg);
      for (int i = 0; i <= num_segments; ++i) {
          float current_angle = start_rad + i * angle_step;
          float cos_a = cosf(current_angle); float sin_a = sinf(current_angle);
-         glVertex3f(center_x + inner_rad * cos_a, surface_y, center_z + inner_rad * sin_a);
-         glVertex3f(center_x + outer_rad * cos_a, surface_y, center_z + outer_rad * sin_a);
+         meshVertex3f(mesh, center_x + inner_rad * cos_a, surface_y, center_z + inner_rad * sin_a);
+         meshVertex3f(mesh, center_x + outer_rad * cos_a, surface_y, center_z + outer_rad * sin_a);
      }
 }
 
-// --- Wall Drawing Helper (Also needed here for guardrails) ---
-void drawWallRound(float x1, float z1, float x2, float z2, float height, float thickness) {
+// Kerb around one corner: one red or white block per segment
+static void buildCornerKerbRound(TrackMesh* mesh, float center_x, float center_z, float inner_rad, float outer_rad, float start_angle_deg, int num_segments, float y_level) {
+    float angle_step = DEG_TO_RAD(90.0f) / num_segments;
+    float start_rad = DEG_TO_RAD(start_angle_deg);
+    meshBegin(mesh, MESH_QUADS);
+    for (int i = 0; i < num_segments; ++i) {
+        float a0 = start_rad + i * angle_step; float a1 = a0 + angle_step;
+        if (i & 1) meshColor3f(mesh, 0.95f, 0.95f, 0.95f); else meshColor3f(mesh, 0.85f, 0.1f, 0.1f);
+        meshVertex3f(mesh, center_x + inner_rad * cosf(a0), y_level, center_z + inner_rad * sinf(a0)); // Facing up
+        meshVertex3f(mesh, center_x + inner_rad * cosf(a1), y_level, center_z + inner_rad * sinf(a1));
+        meshVertex3f(mesh, center_x + outer_rad * cosf(a1), y_level, center_z + outer_rad * sinf(a1));
+        meshVertex3f(mesh, center_x + outer_rad * cosf(a0), y_level, center_z + outer_rad * sinf(a0));
+    }
+    meshEnd(mesh);
+}
+
+// --- Kerb Building Helper (Straights) ---
+// Kerb band along the road edge (x1,z1)-(x2,z2), reaching (ox,oz) off the road, in red and white
+// blocks of about KERB_STRIPE_LENGTH
+#define KERB_STRIPE_LENGTH 2.0f
+static void buildKerbRound(TrackMesh* mesh, float x1, float z1, float x2, float z2, float ox, float oz, float y) {
+    if ((x2-x1)*oz - (z2-z1)*ox > 0.0f) { // Wind it to face up (culling) whichever side of the edge it is on
+        float t = x1; x1 = x2; x2 = t; t = z1; z1 = z2; z2 = t;
+    }
+    float dx=x2-x1; float dz=z2-z1; float len=sqrtf(dx*dx+dz*dz); if(len<0.001f) return;
+    int stripes = (int)ceilf(len / KERB_STRIPE_LENGTH);
+    meshBegin(mesh, MESH_QUADS);
+    for (int i = 0; i < stripes; ++i) {
+        float t0 = (float)i / stripes; float t1 = (float)(i + 1) / stripes;
+        if (i & 1) meshColor3f(mesh, 0.95f, 0.95f, 0.95f); else meshColor3f(mesh, 0.85f, 0.1f, 0.1f);
+        meshVertex3f(mesh, x1 + dx * t0, y, z1 + dz * t0); meshVertex3f(mesh, x1 + dx * t1, y, z1 + dz * t1);
+        meshVertex3f(mesh, x1 + dx * t1 + ox, y, z1 + dz * t1 + oz); meshVertex3f(mesh, x1 + dx * t0 + ox, y, z1 + dz * t0 + oz);
+    }
+    meshEnd(mesh);
+}
+
+// Axis-aligned ground rectangle between two opposite corners, facing up
+static void buildGroundRound(TrackMesh* mesh, float xa, float za, float xb, float zb, float y) {
+    float x0 = fminf(xa, xb), x1 = fmaxf(xa, xb), z0 = fminf(za, zb), z1 = fmaxf(za, zb);
+    meshVertex3f(mesh, x0, y, z0); meshVertex3f(mesh, x0, y, z1);
+    meshVertex3f(mesh, x1, y, z1); meshVertex3f(mesh, x1, y, z0);
+}
+
+// --- Wall Building Helper (Also needed here for guardrails) ---
+static void buildWallRound(TrackMesh* mesh, float x1, float z1, float x2, float z2, float height, float thickness) {
     float dx=x2-x1; float dz=z2-z1; float len=sqrtf(dx*dx+dz*dz); if(len<0.001f) return;
     float nx=dx/len; float nz=dz/len; float px=-nz; float pz=nx; float half_thick=thickness/2.0f;
     float v[8][3]={ {x1-px*half_thick,0.0f,z1-pz*half_thick},{x1+px*half_thick,0.0f,z1+pz*half_thick},{x2+px*half_thick,0.0f,z2+pz*half_thick},{x2-px*half_thick,0.0f,z2-pz*half_thick}, {x1-px*half_thick,height,z1-pz*half_thick},{x1+px*half_thick,height,z1+pz*half_thick},{x2+px*half_thick,height,z2+pz*half_thick},{x2-px*half_thick,height,z2-pz*half_thick} };
-    glBegin(GL_QUADS);
-    glVertex3fv(v[4]);glVertex3fv(v[5]);glVertex3fv(v[6]);glVertex3fv(v[7]); // Top
-    glVertex3fv(v[0]);glVertex3fv(v[3]);glVertex3fv(v[7]);glVertex3fv(v[4]); // Front
-    glVertex3fv(v[1]);glVertex3fv(v[5]);glVertex3fv(v[6]);glVertex3fv(v[2]); // Back
-    glVertex3fv(v[0]);glVertex3fv(v[4]);glVertex3fv(v[5]);glVertex3fv(v[1]); // Left
-    glVertex3fv(v[3]);glVertex3fv(v[2]);glVertex3fv(v[6]);glVertex3fv(v[7]); // Right
-    glEnd();
+    meshBegin(mesh, MESH_QUADS);
+    meshVertex3fv(mesh, v[4]);meshVertex3fv(mesh, v[5]);meshVertex3fv(mesh, v[6]);meshVertex3fv(mesh, v[7]); // Top
+    meshVertex3fv(mesh, v[0]);meshVertex3fv(mesh, v[3]);meshVertex3fv(mesh, v[7]);meshVertex3fv(mesh, v[4]); // Front
+    meshVertex3fv(mesh, v[1]);meshVertex3fv(mesh, v[5]);meshVertex3fv(mesh, v[6]);meshVertex3fv(mesh, v[2]); // Back
+    meshVertex3fv(mesh, v[0]);meshVertex3fv(mesh, v[4]);meshVertex3fv(mesh, v[5]);meshVertex3fv(mesh, v[1]); // Left
+    meshVertex3fv(mesh, v[3]);meshVertex3fv(mesh, v[2]);meshVertex3fv(mesh, v[6]);meshVertex3fv(mesh, v[7]); // Right
+    meshEnd(mesh);
 }
 
-// --- Rounded Track Rendering ---
-void renderRoundTrack() {
+// --- Corner Geometry ---
+static void getRoundCorner(int corner, float* center_x, float* center_z, float* start_angle_deg) {
+    if (corner == 0) { *center_x = ROUND_CORNER_CENTER_TR_X; *center_z = ROUND_CORNER_CENTER_TR_Z; *start_angle_deg = 0.0f; }
+    else if (corner == 1) { *center_x = ROUND_CORNER_CENTER_TL_X; *center_z = ROUND_CORNER_CENTER_TL_Z; *start_angle_deg = 90.0f; }
+    else if (corner == 2) { *center_x = ROUND_CORNER_CENTER_BL_X; *center_z = ROUND_CORNER_CENTER_BL_Z; *start_angle_deg = 180.0f; }
+    else { *center_x = ROUND_CORNER_CENTER_BR_X; *center_z = ROUND_CORNER_CENTER_BR_Z; *start_angle_deg = 270.0f; }
+}
+
+// Surface, kerbs, gravel trap and both boundary lines of one corner, with num_segments segments.
+// Every level starts and ends on the same vertices as the adjoining straights.
+static void buildRoundCornerTrack(TrackMesh* mesh, int corner, int num_segments) {
+    float center_x, center_z, start_angle_deg;
+    getRoundCorner(corner, &center_x, &center_z, &start_angle_deg);
+    float surface_y = 0.0f;
+    float line_y = 0.01f;
+    float verge_y = -0.01f; // Kerbs and gravel, just above the ground plane
+
+    meshColor3f(mesh, 0.4f, 0.4f, 0.45f);
+    meshBegin(mesh, MESH_QUAD_STRIP);
+        buildCornerSurfaceSegmentRound(mesh, center_x, center_z, ROUND_INNER_CORNER_RADIUS, ROUND_OUTER_CORNER_RADIUS, start_angle_deg, num_segments, surface_y);
+    meshEnd(mesh);
+
+    buildCornerKerbRound(mesh, center_x, center_z, ROUND_OUTER_CORNER_RADIUS, ROUND_OUTER_CORNER_RADIUS + TRACK_KERB_WIDTH, start_angle_deg, num_segments, verge_y);
+    buildCornerKerbRound(mesh, center_x, center_z, ROUND_INNER_CORNER_RADIUS - TRACK_KERB_WIDTH, ROUND_INNER_CORNER_RADIUS, start_angle_deg, num_segments, verge_y);
+
+    // Gravel on the outside, from the kerb to the guardrail, running SURFACE_GRAVEL_LEAD into both
+    // straights (the same at every level)
+    float kerbRadius = ROUND_OUTER_CORNER_RADIUS + TRACK_KERB_WIDTH;
+    float railRadius = ROUND_OUTER_CORNER_RADIUS + TRACK_RUNOFF_WIDTH;
+    float sx = center_x > 0.0f ? 1.0f : -1.0f;
+    float sz = center_z > 0.0f ? 1.0f : -1.0f;
+    meshColor3f(mesh, 0.76f, 0.68f, 0.5f); // Sand
+    meshBegin(mesh, MESH_QUAD_STRIP); // Outer radius first: facing up
+        buildCornerSurfaceSegmentRound(mesh, center_x, center_z, railRadius, kerbRadius, start_angle_deg, num_segments, verge_y);
+    meshEnd(mesh);
+    meshBegin(mesh, MESH_QUADS);
+        buildGroundRound(mesh, center_x + sx * kerbRadius, center_z - sz * SURFACE_GRAVEL_LEAD, center_x + sx * railRadius, center_z, verge_y);
+        buildGroundRound(mesh, center_x - sx * SURFACE_GRAVEL_LEAD, center_z + sz * kerbRadius, center_x, center_z + sz * railRadius, verge_y);
+    meshEnd(mesh);
+
+    meshColor3f(mesh, 1.0f, 1.0f, 1.0f);
+    mesh->lineWidth = 2.0f;
+    meshBegin(mesh, MESH_LINE_STRIP);
+        buildCornerLineSegmentRound(mesh, center_x, center_z, ROUND_OUTER_CORNER_RADIUS, start_angle_deg, num_segments, line_y);
+    meshEnd(mesh);
+    meshBegin(mesh, MESH_LINE_STRIP);
+        buildCornerLineSegmentRound(mesh, center_x, center_z, ROUND_INNER_CORNER_RADIUS, start_angle_deg, num_segments, line_y);
+    meshEnd(mesh);
+}
+
+// Curved guardrails of one corner as num_segments wall pieces per rail.
+static void buildRoundCornerRails(TrackMesh* mesh, int corner, int num_segments) {
+    float center_x, center_z, start_angle_deg;
+    getRoundCorner(corner, &center_x, &center_z, &start_angle_deg);
+    float railHeight = 0.8f;
+    float railThickness = 0.4f;
+    float margin = TRACK_RUNOFF_WIDTH + 0.15f; // Beyond the run-off
+    float outerRailCenterRadius = ROUND_OUTER_CORNER_RADIUS + margin;
+    float innerRailCenterRadius = fmaxf(0.1f + railThickness/2.0f, ROUND_INNER_CORNER_RADIUS - margin);
+    meshColor3f(mesh, 0.8f, 0.1f, 0.1f);
+
+    float angle_step = DEG_TO_RAD(90.0f) / num_segments;
+    float start_rad = DEG_TO_RAD(start_angle_deg);
+    // Angle 0 and 90 land exactly on the ends of the straight rails
+    float prev_x_out = center_x + outerRailCenterRadius * cosf(start_rad);
+    float prev_z_out = center_z + outerRailCenterRadius * sinf(start_rad);
+    float prev_x_in = center_x + innerRailCenterRadius * cosf(start_rad);
+    float prev_z_in = center_z + innerRailCenterRadius * sinf(start_rad);
+    for (int i = 1; i <= num_segments; ++i) {
+         float current_angle = start_rad + i * angle_step;
+         // Outer wall segment
+         float current_x_out = center_x + outerRailCenterRadius * cosf(current_angle);
+         float current_z_out = center_z + outerRailCenterRadius * sinf(current_angle);
+         buildWallRound(mesh, prev_x_out, prev_z_out, current_x_out, current_z_out, railHeight, railThickness);
+         prev_x_out = current_x_out;
+         prev_z_out = current_z_out;
+         // Inner wall segment
+         float current_x_in = center_x + innerRailCenterRadius * cosf(current_angle);
+         float current_z_in = center_z + innerRailCenterRadius * sinf(current_angle);
+         buildWallRound(mesh, prev_x_in, prev_z_in, current_x_in, current_z_in, railHeight, railThickness);
+         prev_x_in = current_x_in;
+         prev_z_in = current_z_in;
+    }
+}
+
+// Builds CORNER_LOD_LEVELS tessellations of every corner, halving the segment count per level.
+// The error of a level is the sagitta of one segment on the widest radius (the outer rail).
+static void buildRoundCornerLods(void) {
+    float maxRadius = ROUND_OUTER_CORNER_RADIUS + TRACK_RUNOFF_WIDTH + 0.15f; // Outer rail centre line
+    for (int corner = 0; corner < 4; ++corner) {
+        initMeshLodGroup(&roundCornerTrackLods[corner]);
+        initMeshLodGroup(&roundCornerRailLods[corner]);
+        for (int level = 0; level < CORNER_LOD_LEVELS; ++level) {
+            int segments = CORNER_SEGMENTS >> level;
+            if (segments < 2) segments = 2;
+            float error = maxRadius * (1.0f - cosf(DEG_TO_RAD(45.0f) / segments));
+            if (level == 0) error = 0.0f; // Reference level
+            TrackMesh* trackLevel = addMeshLodLevel(&roundCornerTrackLods[corner], error);
+            TrackMesh* railLevel = addMeshLodLevel(&roundCornerRailLods[corner], error);
+            if (trackLevel) buildRoundCornerTrack(trackLevel, corner, segments);
+            if (railLevel) buildRoundCornerRails(railLevel, corner, segments);
+        }
+        finishMeshLodGroup(&roundCornerTrackLods[corner]);
+        finishMeshLodGroup(&roundCornerRailLods[corner]);
+    }
+}
+
+
+// --- Rounded Track Mesh (Straights) ---
+static void buildRoundTrackMesh(TrackMesh* mesh) {
     float surface_y = 0.0f;
     float line_y = 0.01f;
     float finish_y = 0.02f;
     int straight_segments = 10; // Number of quads per straight section
 
     // --- Render Ground Plane ---
-    glColor3f(0.2f, 0.6f, 0.2f); // Grassy Green
-    glBegin(GL_QUADS);
+    meshColor3f(mesh, 0.2f, 0.6f, 0.2f); // Grassy Green
+    meshBegin(mesh, MESH_QUADS);
         float groundSize = fmaxf(ROUND_TRACK_MAIN_WIDTH, ROUND_TRACK_MAIN_LENGTH) * 1.2f;
-        glVertex3f(-groundSize, -0.02f, -groundSize); glVertex3f(-groundSize, -0.02f,  groundSize);
-        glVertex3f( groundSize, -0.02f,  groundSize); glVertex3f( groundSize, -0.02f, -groundSize);
-    glEnd();
+        meshVertex3f(mesh, -groundSize, -0.02f, -groundSize); meshVertex3f(mesh, -groundSize, -0.02f,  groundSize);
+        meshVertex3f(mesh,  groundSize, -0.02f,  groundSize); meshVertex3f(mesh,  groundSize, -0.02f, -groundSize);
+    meshEnd(mesh);
 
     // --- Render Track Surface (Asphalt Grey) ---
-    glColor3f(0.4f, 0.4f, 0.45f);
-    glBegin(GL_QUAD_STRIP);
-
-        // 1. Right Straight (Start point: Bottom Right Straight Start)
+    // One strip per straight; the corners in between come from the LOD groups
+    meshColor3f(mesh, 0.4f, 0.4f, 0.45f);
+    // 1. Right Straight
+    meshBegin(mesh, MESH_QUAD_STRIP);
         for(int i = 0; i <= straight_segments; ++i) {
             float t = (float)i / straight_segments;
             float z = -ROUND_STRAIGHT_Z_LIMIT + (ROUND_STRAIGHT_Z_LIMIT - (-ROUND_STRAIGHT_Z_LIMIT)) * t;
             float inner_x = ROUND_TRACK_MAIN_WIDTH / 2.0f - ROUND_HALF_ROAD_WIDTH;
             float outer_x = ROUND_TRACK_MAIN_WIDTH / 2.0f + ROUND_HALF_ROAD_WIDTH;
-            glVertex3f(inner_x, surface_y, z); glVertex3f(outer_x, surface_y, z);
+            meshVertex3f(mesh, inner_x, surface_y, z); meshVertex3f(mesh, outer_x, surface_y, z);
         }
-        // 2. Top Right Corner
-        renderCornerSurfaceSegmentRound(ROUND_CORNER_CENTER_TR_X, ROUND_CORNER_CENTER_TR_Z, ROUND_INNER_CORNER_RADIUS, ROUND_OUTER_CORNER_RADIUS, 0.0f, CORNER_SEGMENTS, surface_y);
-        // 3. Top Straight
+    meshEnd(mesh);
+    // 3. Top Straight
+    meshBegin(mesh, MESH_QUAD_STRIP);
          for(int i = 0; i <= straight_segments; ++i) {
             float t = (float)i / straight_segments;
             float x = ROUND_STRAIGHT_X_LIMIT - (ROUND_STRAIGHT_X_LIMIT - (-ROUND_STRAIGHT_X_LIMIT)) * t;
             float inner_z = ROUND_TRACK_MAIN_LENGTH / 2.0f - ROUND_HALF_ROAD_WIDTH;
             float outer_z = ROUND_TRACK_MAIN_LENGTH / 2.0f + ROUND_HALF_ROAD_WIDTH;
-             glVertex3f(x, surface_y, inner_z); glVertex3f(x, surface_y, outer_z);
+             meshVertex3f(mesh, x, surface_y, inner_z); meshVertex3f(mesh, x, surface_y, outer_z);
          }
-        // 4. Top Left Corner
-        renderCornerSurfaceSegmentRound(ROUND_CORNER_CENTER_TL_X, ROUND_CORNER_CENTER_TL_Z, ROUND_INNER_CORNER_RADIUS, ROUND_OUTER_CORNER_RADIUS, 90.0f, CORNER_SEGMENTS, surface_y);
-        // 5. Left Straight
+    meshEnd(mesh);
+    // 5. Left Straight
+    meshBegin(mesh, MESH_QUAD_STRIP);
         for(int i = 0; i <= straight_segments; ++i) {
             float t = (float)i / straight_segments;
             float z = ROUND_STRAIGHT_Z_LIMIT - (ROUND_STRAIGHT_Z_LIMIT - (-ROUND_STRAIGHT_Z_LIMIT)) * t;
             float inner_x = -ROUND_TRACK_MAIN_WIDTH / 2.0f - ROUND_HALF_ROAD_WIDTH;
             float outer_x = -ROUND_TRACK_MAIN_WIDTH / 2.0f + ROUND_HALF_ROAD_WIDTH;
-             glVertex3f(inner_x, surface_y, z); glVertex3f(outer_x, surface_y, z); // Swapped order? Check winding. Let's keep consistent: Inner first.
-             // Test: Should be Inner (-width - half_road), Outer (-width + half_road)
-             //glVertex3f(-ROUND_TRACK_MAIN_WIDTH / 2.0f - ROUND_HALF_ROAD_WIDTH, surface_y, z);
-             //glVertex3f(-ROUND_TRACK_MAIN_WIDTH / 2.0f + ROUND_HALF_ROAD_WIDTH, surface_y, z);
-
+             meshVertex3f(mesh, inner_x, surface_y, z); meshVertex3f(mesh, outer_x, surface_y, z);
          }
-        // 6. Bottom Left Corner
-        renderCornerSurfaceSegmentRound(ROUND_CORNER_CENTER_BL_X, ROUND_CORNER_CENTER_BL_Z, ROUND_INNER_CORNER_RADIUS, ROUND_OUTER_CORNER_RADIUS, 180.0f, CORNER_SEGMENTS, surface_y);
-        // 7. Bottom Straight
+    meshEnd(mesh);
+    // 7. Bottom Straight
+    meshBegin(mesh, MESH_QUAD_STRIP);
          for(int i = 0; i <= straight_segments; ++i) {
             float t = (float)i / straight_segments;
             float x = -ROUND_STRAIGHT_X_LIMIT + (ROUND_STRAIGHT_X_LIMIT - (-ROUND_STRAIGHT_X_LIMIT)) * t;
             float inner_z = -ROUND_TRACK_MAIN_LENGTH / 2.0f - ROUND_HALF_ROAD_WIDTH;
             float outer_z = -ROUND_TRACK_MAIN_LENGTH / 2.0f + ROUND_HALF_ROAD_WIDTH;
-             glVertex3f(x, surface_y, inner_z); glVertex3f(x, surface_y, outer_z);
+             meshVertex3f(mesh, x, surface_y, inner_z); meshVertex3f(mesh, x, surface_y, outer_z);
          }
-        // 8. Bottom Right Corner
-        renderCornerSurfaceSegmentRound(ROUND_CORNER_CENTER_BR_X, ROUND_CORNER_CENTER_BR_Z, ROUND_INNER_CORNER_RADIUS, ROUND_OUTER_CORNER_RADIUS, 270.0f, CORNER_SEGMENTS, surface_y);
-        // 9. Close Loop by repeating the first vertex pair of the Right Straight
-         float z_start_right_straight = -ROUND_STRAIGHT_Z_LIMIT;
-         float inner_x_start_right = ROUND_TRACK_MAIN_WIDTH / 2.0f - ROUND_HALF_ROAD_WIDTH;
-         float outer_x_start_right = ROUND_TRACK_MAIN_WIDTH / 2.0f + ROUND_HALF_ROAD_WIDTH;
-         glVertex3f(inner_x_start_right, surface_y, z_start_right_straight);
-         glVertex3f(outer_x_start_right, surface_y, z_start_right_straight);
-    glEnd();
-
-    // --- Render Track Markings ---
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glLineWidth(2.0f);
-     // Outer boundary
-    glBegin(GL_LINE_STRIP);
-        glVertex3f( ROUND_TRACK_MAIN_WIDTH / 2.0f + ROUND_HALF_ROAD_WIDTH, line_y, ROUND_STRAIGHT_Z_LIMIT);
-        renderCornerLineSegmentRound(ROUND_CORNER_CENTER_TR_X, ROUND_CORNER_CENTER_TR_Z, ROUND_OUTER_CORNER_RADIUS, 0.0f, CORNER_SEGMENTS, line_y);
-        renderCornerLineSegmentRound(ROUND_CORNER_CENTER_TL_X, ROUND_CORNER_CENTER_TL_Z, ROUND_OUTER_CORNER_RADIUS, 90.0f, CORNER_SEGMENTS, line_y);
-        renderCornerLineSegmentRound(ROUND_CORNER_CENTER_BL_X, ROUND_CORNER_CENTER_BL_Z, ROUND_OUTER_CORNER_RADIUS, 180.0f, CORNER_SEGMENTS, line_y);
-        renderCornerLineSegmentRound(ROUND_CORNER_CENTER_BR_X, ROUND_CORNER_CENTER_BR_Z, ROUND_OUTER_CORNER_RADIUS, 270.0f, CORNER_SEGMENTS, line_y);
-        glVertex3f(ROUND_TRACK_MAIN_WIDTH / 2.0f + ROUND_HALF_ROAD_WIDTH, line_y, ROUND_STRAIGHT_Z_LIMIT);
-    glEnd();
-     // Inner boundary
-    glBegin(GL_LINE_STRIP);
-        glVertex3f(ROUND_TRACK_MAIN_WIDTH / 2.0f - ROUND_HALF_ROAD_WIDTH, line_y, ROUND_STRAIGHT_Z_LIMIT);
-        renderCornerLineSegmentRound(ROUND_CORNER_CENTER_TR_X, ROUND_CORNER_CENTER_TR_Z, ROUND_INNER_CORNER_RADIUS, 0.0f, CORNER_SEGMENTS, line_y);
-        renderCornerLineSegmentRound(ROUND_CORNER_CENTER_TL_X, ROUND_CORNER_CENTER_TL_Z, ROUND_INNER_CORNER_RADIUS, 90.0f, CORNER_SEGMENTS, line_y);
-        renderCornerLineSegmentRound(ROUND_CORNER_CENTER_BL_X, ROUND_CORNER_CENTER_BL_Z, ROUND_INNER_CORNER_RADIUS, 180.0f, CORNER_SEGMENTS, line_y);
-        renderCornerLineSegmentRound(ROUND_CORNER_CENTER_BR_X, ROUND_CORNER_CENTER_BR_Z, ROUND_INNER_CORNER_RADIUS, 270.0f, CORNER_SEGMENTS, line_y);
-        glVertex3f(ROUND_TRACK_MAIN_WIDTH / 2.0f - ROUND_HALF_ROAD_WIDTH, line_y, ROUND_STRAIGHT_Z_LIMIT);
-    glEnd();
+    meshEnd(mesh);
+
+    // --- Kerbs (straights) ---
+    // Outside the outer edge and inside the inner edge; the corner LOD groups continue them
+    float verge_y = -0.01f;
+    for (int side = 0; side < 2; ++side) {
+        float half = side == 0 ? ROUND_HALF_ROAD_WIDTH : -ROUND_HALF_ROAD_WIDTH; // Outer, then inner
+        float k = side == 0 ? TRACK_KERB_WIDTH : -TRACK_KERB_WIDTH;             // Away from the road
+        float xEdge = ROUND_TRACK_MAIN_WIDTH / 2.0f + half;
+        float zEdge = ROUND_TRACK_MAIN_LENGTH / 2.0f + half;
+        buildKerbRound(mesh,  xEdge, -ROUND_STRAIGHT_Z_LIMIT,  xEdge, ROUND_STRAIGHT_Z_LIMIT,  k, 0.0f, verge_y); // Right
+        buildKerbRound(mesh, -xEdge, -ROUND_STRAIGHT_Z_LIMIT, -xEdge, ROUND_STRAIGHT_Z_LIMIT, -k, 0.0f, verge_y); // Left
+        buildKerbRound(mesh, -ROUND_STRAIGHT_X_LIMIT,  zEdge, ROUND_STRAIGHT_X_LIMIT,  zEdge, 0.0f,  k, verge_y); // Top
+        buildKerbRound(mesh, -ROUND_STRAIGHT_X_LIMIT, -zEdge, ROUND_STRAIGHT_X_LIMIT, -zEdge, 0.0f, -k, verge_y); // Bottom
+    }
+
+    // --- Render Track Markings (straight boundary lines) ---
+    meshColor3f(mesh, 1.0f, 1.0f, 1.0f);
+    mesh->lineWidth = 2.0f;
+    meshBegin(mesh, MESH_LINES);
+    for (int side = 0; side < 2; ++side) {
+        float half = side == 0 ? ROUND_HALF_ROAD_WIDTH : -ROUND_HALF_ROAD_WIDTH; // Outer, then inner
+        float xLine = ROUND_TRACK_MAIN_WIDTH / 2.0f + half;
+        float zLine = ROUND_TRACK_MAIN_LENGTH / 2.0f + half;
+        meshVertex3f(mesh,  xLine, line_y, -ROUND_STRAIGHT_Z_LIMIT); meshVertex3f(mesh,  xLine, line_y, ROUND_STRAIGHT_Z_LIMIT); // Right
+        meshVertex3f(mesh, -xLine, line_y, -ROUND_STRAIGHT_Z_LIMIT); meshVertex3f(mesh, -xLine, line_y, ROUND_STRAIGHT_Z_LIMIT); // Left
+        meshVertex3f(mesh, -ROUND_STRAIGHT_X_LIMIT, line_y,  zLine); meshVertex3f(mesh, ROUND_STRAIGHT_X_LIMIT, line_y,  zLine); // Top
+        meshVertex3f(mesh, -ROUND_STRAIGHT_X_LIMIT, line_y, -zLine); meshVertex3f(mesh, ROUND_STRAIGHT_X_LIMIT, line_y, -zLine); // Bottom
+    }
+    meshEnd(mesh);
 
     // --- Finish line ---
-    glColor3f(0.9f, 0.9f, 0.9f);
-    glBegin(GL_QUADS);
+    meshColor3f(mesh, 0.9f, 0.9f, 0.9f);
+    meshBegin(mesh, MESH_QUADS);
         float finishLineXStart = ROUND_FINISH_LINE_X_START;
         float finishLineXEnd = ROUND_FINISH_LINE_X_END;
         float finishLineZPos = FINISH_LINE_Z + ROUND_FINISH_LINE_THICKNESS / 2.0f;
         float finishLineZNeg = FINISH_LINE_Z - ROUND_FINISH_LINE_THICKNESS / 2.0f;
-        glVertex3f(finishLineXStart, finish_y, finishLineZPos); glVertex3f(finishLineXEnd, finish_y, finishLineZPos);
-        glVertex3f(finishLineXEnd, finish_y, finishLineZNeg); glVertex3f(finishLineXStart, finish_y, finishLineZNeg);
-    glEnd();
-
-    glLineWidth(1.0f);
+        meshVertex3f(mesh, finishLineXStart, finish_y, finishLineZPos); meshVertex3f(mesh, finishLineXEnd, finish_y, finishLineZPos);
+        meshVertex3f(mesh, finishLineXEnd, finish_y, finishLineZNeg); meshVertex3f(mesh, finishLineXStart, finish_y, finishLineZNeg);
+    meshEnd(mesh);
 }
 
-// --- Rounded Guardrail Rendering ---
-void renderRoundGuardrails() {
+// --- Rounded Guardrail Mesh (Straights) ---
+static void buildRoundRailMesh(TrackMesh* mesh) {
     float railHeight = 0.8f;
     float railThickness = 0.4f;
-    float margin = 0.15f;
-    float base_y = 0.0f;
-    float top_y = railHeight;
-    glColor3f(0.8f, 0.1f, 0.1f);
+    float margin = TRACK_RUNOFF_WIDTH + 0.15f; // Beyond the run-off
+    meshColor3f(mesh, 0.8f, 0.1f, 0.1f);
 
     // --- Draw Straight Sections using drawWallRound ---
     float outerRailYPos = ROUND_TRACK_MAIN_LENGTH / 2.0f + ROUND_HALF_ROAD_WIDTH + margin;
@@ -170,66 +322,40 @@ void renderRoundGuardrails() {
     float innerRailXPos = ROUND_TRACK_MAIN_WIDTH / 2.0f - ROUND_HALF_ROAD_WIDTH - margin;
     float innerRailXNeg = -innerRailXPos;
 
-    drawWallRound(-ROUND_STRAIGHT_X_LIMIT, outerRailYPos,  ROUND_STRAIGHT_X_LIMIT, outerRailYPos, railHeight, railThickness); // Top Outer
-    drawWallRound(-ROUND_STRAIGHT_X_LIMIT, outerRailYNeg,  ROUND_STRAIGHT_X_LIMIT, outerRailYNeg, railHeight, railThickness); // Bottom Outer
-    drawWallRound( outerRailXPos, -ROUND_STRAIGHT_Z_LIMIT, outerRailXPos,  ROUND_STRAIGHT_Z_LIMIT, railHeight, railThickness); // Right Outer
-    drawWallRound( outerRailXNeg, -ROUND_STRAIGHT_Z_LIMIT, outerRailXNeg,  ROUND_STRAIGHT_Z_LIMIT, railHeight, railThickness); // Left Outer
-    drawWallRound(-ROUND_STRAIGHT_X_LIMIT, innerRailYPos,  ROUND_STRAIGHT_X_LIMIT, innerRailYPos, railHeight, railThickness); // Top Inner
-    drawWallRound(-ROUND_STRAIGHT_X_LIMIT, innerRailYNeg,  ROUND_STRAIGHT_X_LIMIT, innerRailYNeg, railHeight, railThickness); // Bottom Inner
-    drawWallRound( innerRailXPos, -ROUND_STRAIGHT_Z_LIMIT, innerRailXPos,  ROUND_STRAIGHT_Z_LIMIT, railHeight, railThickness); // Right Inner
-    drawWallRound( innerRailXNeg, -ROUND_STRAIGHT_Z_LIMIT, innerRailXNeg,  ROUND_STRAIGHT_Z_LIMIT, railHeight, railThickness); // Left Inner
+    buildWallRound(mesh, -ROUND_STRAIGHT_X_LIMIT, outerRailYPos,  ROUND_STRAIGHT_X_LIMIT, outerRailYPos, railHeight, railThickness); // Top Outer
+    buildWallRound(mesh, -ROUND_STRAIGHT_X_LIMIT, outerRailYNeg,  ROUND_STRAIGHT_X_LIMIT, outerRailYNeg, railHeight, railThickness); // Bottom Outer
+    buildWallRound(mesh,  outerRailXPos, -ROUND_STRAIGHT_Z_LIMIT, outerRailXPos,  ROUND_STRAIGHT_Z_LIMIT, railHeight, railThickness); // Right Outer
+    buildWallRound(mesh,  outerRailXNeg, -ROUND_STRAIGHT_Z_LIMIT, outerRailXNeg,  ROUND_STRAIGHT_Z_LIMIT, railHeight, railThickness); // Left Outer
+    buildWallRound(mesh, -ROUND_STRAIGHT_X_LIMIT, innerRailYPos,  ROUND_STRAIGHT_X_LIMIT, innerRailYPos, railHeight, railThickness); // Top Inner
+    buildWallRound(mesh, -ROUND_STRAIGHT_X_LIMIT, innerRailYNeg,  ROUND_STRAIGHT_X_LIMIT, innerRailYNeg, railHeight, railThickness); // Bottom Inner
+    buildWallRound(mesh,  innerRailXPos, -ROUND_STRAIGHT_Z_LIMIT, innerRailXPos,  ROUND_STRAIGHT_Z_LIMIT, railHeight, railThickness); // Right Inner
+    buildWallRound(mesh,  innerRailXNeg, -ROUND_STRAIGHT_Z_LIMIT, innerRailXNeg,  ROUND_STRAIGHT_Z_LIMIT, railHeight, railThickness); // Left Inner
+}
 
 
-    // --- Draw Curved Sections as Segmented Walls ---
-    float outerRailCenterRadius = ROUND_OUTER_CORNER_RADIUS + margin;
-    float innerRailCenterRadius = fmaxf(0.1f + railThickness/2.0f, ROUND_INNER_CORNER_RADIUS - margin);
+// --- Rounded Track Rendering ---
+static void ensureRoundMeshes() {
+    if (roundMeshesInitialized) return;
+    initTrackMesh(&roundTrackMesh);
+    buildRoundTrackMesh(&roundTrackMesh);
+    finishTrackMesh(&roundTrackMesh);
+    initTrackMesh(&roundRailMesh);
+    buildRoundRailMesh(&roundRailMesh);
+    finishTrackMesh(&roundRailMesh);
+    buildRoundCornerLods();
+    roundMeshesInitialized = 1;
+}
 
-    // Outer Curved Rails
-    float prev_x_out = ROUND_TRACK_MAIN_WIDTH / 2.0f + ROUND_HALF_ROAD_WIDTH + margin; // Start at end of right straight
-    float prev_z_out = ROUND_STRAIGHT_Z_LIMIT;
-    // Inner Curved Rails
-    float prev_x_in = ROUND_TRACK_MAIN_WIDTH / 2.0f - ROUND_HALF_ROAD_WIDTH - margin; // Start at end of right straight
-    float prev_z_in = ROUND_STRAIGHT_Z_LIMIT;
-
-    for (int corner = 0; corner < 4; ++ corner) {
-        float center_x, center_z, start_angle_deg;
-        // Determine corner center and start angle
-        if (corner == 0) { center_x = ROUND_CORNER_CENTER_TR_X; center_z = ROUND_CORNER_CENTER_TR_Z; start_angle_deg = 0.0f; }
-        else if (corner == 1) { center_x = ROUND_CORNER_CENTER_TL_X; center_z = ROUND_CORNER_CENTER_TL_Z; start_angle_deg = 90.0f; }
-        else if (corner == 2) { center_x = ROUND_CORNER_CENTER_BL_X; center_z = ROUND_CORNER_CENTER_BL_Z; start_angle_deg = 180.0f; }
-        else { center_x = ROUND_CORNER_CENTER_BR_X; center_z = ROUND_CORNER_CENTER_BR_Z; start_angle_deg = 270.0f; }
-
-        float angle_step = DEG_TO_RAD(90.0f) / CORNER_SEGMENTS;
-        float start_rad = DEG_TO_RAD(start_angle_deg);
-
-        // Draw segments for this corner
-        for (int i = 1; i <= CORNER_SEGMENTS; ++i) {
-             float current_angle = start_rad + i * angle_step;
-             // Outer wall segment
-             float current_x_out = center_x + outerRailCenterRadius * cosf(current_angle);
-             float current_z_out = center_z + outerRailCenterRadius * sinf(current_angle);
-             drawWallRound(prev_x_out, prev_z_out, current_x_out, current_z_out, railHeight, railThickness);
-             prev_x_out = current_x_out;
-             prev_z_out = current_z_out;
-             // Inner wall segment
-             float current_x_in = center_x + innerRailCenterRadius * cosf(current_angle);
-             float current_z_in = center_z + innerRailCenterRadius * sinf(current_angle);
-             drawWallRound(prev_x_in, prev_z_in, current_x_in, current_z_in, railHeight, railThickness);
-             prev_x_in = current_x_in;
-             prev_z_in = current_z_in;
-        }
-        // Update previous points to the start of the *next* straight section after the corner
-        if (corner == 0) { // After TR corner -> Top Straight start
-             prev_x_out = -ROUND_STRAIGHT_X_LIMIT; prev_z_out = outerRailYPos;
-             prev_x_in = -ROUND_STRAIGHT_X_LIMIT; prev_z_in = innerRailYPos;
-        } else if (corner == 1) { // After TL corner -> Left Straight start
-             prev_x_out = outerRailXNeg; prev_z_out = ROUND_STRAIGHT_Z_LIMIT;
-             prev_x_in = innerRailXNeg; prev_z_in = ROUND_STRAIGHT_Z_LIMIT;
-        } else if (corner == 2) { // After BL corner -> Bottom Straight start
-             prev_x_out = ROUND_STRAIGHT_X_LIMIT; prev_z_out = outerRailYNeg;
-             prev_x_in = ROUND_STRAIGHT_X_LIMIT; prev_z_in = innerRailYNeg;
-        } // After BR corner, prev points automatically match start of Right Straight
-    }
+void renderRoundTrack() {
+    ensureRoundMeshes();
+    drawTrackMesh(&roundTrackMesh, &viewFrustum); // Only chunks inside the camera's view
+    for (int corner = 0; corner < 4; ++corner) drawMeshLodGroup(&roundCornerTrackLods[corner], &viewFrustum);
+}
+
+void renderRoundGuardrails() {
+    ensureRoundMeshes();
+    drawTrackMesh(&roundRailMesh, &viewFrustum);
+    for (int corner = 0; corner < 4; ++corner) drawMeshLodGroup(&roundCornerRailLods[corner], &viewFrustum);
 }
 
 
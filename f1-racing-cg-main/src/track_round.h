@@ -30,7 +30,8 @@
 #define ROUND_FINISH_LINE_THICKNESS 2.0f
 
 // --- Common Values ---
-#define CORNER_SEGMENTS 20      // Segments per 90-degree corner
+#define CORNER_SEGMENTS 20      // Segments per 90-degree corner (finest level of detail)
+#define CORNER_LOD_LEVELS 4     // Each level halves the segments (20, 10, 5, 2)
 #define FINISH_LINE_Z 0.0f
 #define COLLISION_EPSILON 0.2f
 
@@ -0,0 +1,414 @@
+// --- Telemetry Query Tool ---
+// Built by "make tlquery" (see Makefile and README). Answers questions about a telemetry log
+// written by --telemetry or --telemetry-drive (layout in src/telemetry.h) without loading it:
+// the file is memory-mapped, only the columns a query needs are touched, and whole chunks are
+// skipped (or answered) from their min/max statistics. The per-row scans are branch-free loops
+// over the columns that GCC vectorises at -O3.
+//
+//   tlquery.exe FILE [query=summary|maxspeed|braking|offtrack|walls|heatmap] [car=N] [sector=N] [lap=N] [out=PREFIX]
+//
+//   summary   rows, cars, laps and duration, from the chunk statistics only
+//   maxspeed  top speed on every lap
+//   braking   time spent braking (per lap and in total), e.g. "query=braking sector=2"
+//   offtrack  time off the track: all four wheels past the kerbs (grass, gravel) or against a wall
+//   walls     time against a wall (guardrail contact)
+//   heatmap   where the cars went, as the sweep's heatmap files (PREFIX.png, PREFIX_speed.png and
+//             PREFIX.f1h for the game's --heatmap, see src/heatmap.h); out= is required
+// car= (1-based, as in the HUD) and sector= / lap= restrict the rows a query looks at.
+
+// mmap() and friends are POSIX, not C99
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "telemetry.h" // File layout, channels
+#include "timing.h"    // Scan timing
+#include "heatmap.h"   // query=heatmap: the same grid and files as --sweep heatmap=
+#include "surface.h"   // SurfaceMaterial values of the 'surface' channel
+#include <stdio.h>     // For printf, fprintf
+#include <stdlib.h>    // For calloc, free, atoi
+#include <string.h>    // For memcmp, strcmp, strncmp
+#include <float.h>     // For FLT_MAX
+
+#ifdef _WIN32
+#include <windows.h>   // CreateFileMapping / MapViewOfFile
+#else
+#include <sys/mman.h>  // mmap
+#include <sys/stat.h>  // fstat
+#include <fcntl.h>     // open
+#include <unistd.h>    // close
+#endif
+
+// --- Mapping ---
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file, mapping;
+#else
+    int fd;
+#endif
+} MappedFile;
+
+static int mapFile(MappedFile* map, const char* path) {
+    memset(map, 0, sizeof(*map));
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    map->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (map->file == INVALID_HANDLE_VALUE) return 0;
+    if (!GetFileSizeEx(map->file, &size) || size.QuadPart == 0) { CloseHandle(map->file); return 0; }
+    map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!map->mapping) { CloseHandle(map->file); return 0; }
+    map->data = (const unsigned char*)MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!map->data) { CloseHandle(map->mapping); CloseHandle(map->file); return 0; }
+    map->size = (size_t)size.QuadPart;
+#else
+    struct stat info;
+    map->fd = open(path, O_RDONLY);
+    if (map->fd < 0) return 0;
+    if (fstat(map->fd, &info) != 0 || info.st_size == 0) { close(map->fd); return 0; }
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, map->fd, 0);
+    if (data == MAP_FAILED) { close(map->fd); return 0; }
+    map->data = (const unsigned char*)data;
+    map->size = (size_t)info.st_size;
+#endif
+    return 1;
+}
+
+static void unmapFile(MappedFile* map) {
+#ifdef _WIN32
+    UnmapViewOfFile(map->data);
+    CloseHandle(map->mapping);
+    CloseHandle(map->file);
+#else
+    munmap((void*)map->data, map->size);
+    close(map->fd);
+#endif
+}
+
+
+// --- Chunks ---
+typedef struct {
+    const TelemetryChunkHeader* header;
+    const int* tick;
+    const unsigned char* car;
+    const float* x;
+    const float* z;
+    const float* speed;
+    const unsigned char* inputs;
+    const unsigned char* surface;
+    const unsigned short* lap;
+    const unsigned char* sector;
+} ChunkColumns;
+
+static const int channelSizes[TELEMETRY_NUM_CHANNELS] = TELEMETRY_CHANNEL_SIZES;
+static const char* const channelNames[TELEMETRY_NUM_CHANNELS] = TELEMETRY_CHANNEL_NAMES;
+static int columnOffsets[TELEMETRY_NUM_CHANNELS]; // As getTelemetryColumnOffset()
+
+static void computeColumnOffsets(void) {
+    int offset = (int)sizeof(TelemetryChunkHeader);
+    for (int ch = 0; ch < TELEMETRY_NUM_CHANNELS; ++ch) {
+        columnOffsets[ch] = offset;
+        offset += channelSizes[ch] * TELEMETRY_CHUNK_ROWS;
+    }
+}
+
+static void getChunkColumns(const unsigned char* chunk, ChunkColumns* columns) {
+    columns->header = (const TelemetryChunkHeader*)chunk;
+    columns->tick = (const int*)(chunk + columnOffsets[TELEMETRY_TICK]);
+    columns->car = chunk + columnOffsets[TELEMETRY_CAR];
+    columns->x = (const float*)(chunk + columnOffsets[TELEMETRY_X]);
+    columns->z = (const float*)(chunk + columnOffsets[TELEMETRY_Z]);
+    columns->speed = (const float*)(chunk + columnOffsets[TELEMETRY_SPEED]);
+    columns->inputs = chunk + columnOffsets[TELEMETRY_INPUTS];
+    columns->surface = chunk + columnOffsets[TELEMETRY_SURFACE];
+    columns->lap = (const unsigned short*)(chunk + columnOffsets[TELEMETRY_LAP]);
+    columns->sector = chunk + columnOffsets[TELEMETRY_SECTOR];
+}
+
+// Does [min, max] of a channel miss the filter range [lo, hi]?
+static int excludes(const TelemetryChunkHeader* header, TelemetryChannel channel, int lo, int hi) {
+    return header->max[channel] < (float)lo || header->min[channel] > (float)hi;
+}
+
+static int isConstant(const TelemetryChunkHeader* header, TelemetryChannel channel) {
+    return header->min[channel] == header->max[channel];
+}
+
+typedef struct {
+    int carLo, carHi;       // Filters as inclusive ranges (everything when not given)
+    int sectorLo, sectorHi;
+    int lapLo, lapHi;
+    long scanned, skipped, fromStats; // Chunks
+} Query;
+
+
+// --- Scans ---
+// Each one walks all rows of a chunk (the zero padding after 'rows' is never matched: the
+// padding's lap is 0), with the filters as masks. Columns and filters are copied to locals so
+// GCC sees that nothing in the loop can change them.
+
+#define UNMATCHED_SPEED 1e30f // Subtracted from the speed of rows outside the filters
+
+// Top speed of the matching rows, or below -UNMATCHED_SPEED / 2 if none match. The filters
+// scale a subtraction instead of picking between values: GCC won't if-convert a select fed by
+// a load, and the max reduction vectorises only with -ffinite-math-only -fno-signed-zeros.
+static float scanMaxSpeed(const ChunkColumns* c, const Query* q, int lap) {
+    const unsigned short* laps = c->lap;
+    const unsigned char* cars = c->car;
+    const unsigned char* sectors = c->sector;
+    const float* speeds = c->speed;
+    int carLo = q->carLo, carHi = q->carHi, sectorLo = q->sectorLo, sectorHi = q->sectorHi;
+    float top = -FLT_MAX;
+    for (int i = 0; i < TELEMETRY_CHUNK_ROWS; ++i) {
+        int match = (laps[i] == lap) & (cars[i] >= carLo) & (cars[i] <= carHi)
+                  & (sectors[i] >= sectorLo) & (sectors[i] <= sectorHi);
+        float speed = speeds[i] - (float)(1 - match) * UNMATCHED_SPEED;
+        top = speed > top ? speed : top;
+    }
+    return top;
+}
+
+// Rows with lo <= (column & mask) <= hi; the rows inside the filters at all are added to *rows
+// in the same pass
+static int scanCount(const ChunkColumns* c, const Query* q, int lap, const unsigned char* column, unsigned char mask,
+                     unsigned char lo, unsigned char hi, long* rows) {
+    const unsigned short* laps = c->lap;
+    const unsigned char* cars = c->car;
+    const unsigned char* sectors = c->sector;
+    int carLo = q->carLo, carHi = q->carHi, sectorLo = q->sectorLo, sectorHi = q->sectorHi;
+    int count = 0, matched = 0;
+    for (int i = 0; i < TELEMETRY_CHUNK_ROWS; ++i) {
+        int match = (laps[i] == lap) & (cars[i] >= carLo) & (cars[i] <= carHi)
+                  & (sectors[i] >= sectorLo) & (sectors[i] <= sectorHi);
+        matched += match;
+        count += match & ((column[i] & mask) >= lo) & ((column[i] & mask) <= hi);
+    }
+    *rows += matched;
+    return count;
+}
+
+
+// --- Queries ---
+static long numChunks;
+static const unsigned char* firstChunk;
+static unsigned int frameRate;
+
+static const TelemetryChunkHeader* getChunkHeader(long chunk) {
+    return (const TelemetryChunkHeader*)(firstChunk + (size_t)chunk * TELEMETRY_CHUNK_BYTES);
+}
+
+static void runSummary(void) {
+    long rows = 0;
+    float stats[2][TELEMETRY_NUM_CHANNELS];
+    for (int ch = 0; ch < TELEMETRY_NUM_CHANNELS; ++ch) { stats[0][ch] = FLT_MAX; stats[1][ch] = -FLT_MAX; }
+    for (long k = 0; k < numChunks; ++k) {
+        const TelemetryChunkHeader* header = getChunkHeader(k);
+        rows += header->rows;
+        for (int ch = 0; ch < TELEMETRY_NUM_CHANNELS; ++ch) {
+            if (header->min[ch] < stats[0][ch]) stats[0][ch] = header->min[ch];
+            if (header->max[ch] > stats[1][ch]) stats[1][ch] = header->max[ch];
+        }
+    }
+    double seconds = (stats[1][TELEMETRY_TICK] - stats[0][TELEMETRY_TICK] + 1) / (double)frameRate;
+    printf("%ld rows in %ld chunks: cars %d-%d, laps %d-%d, %.2f hours\n", rows, numChunks,
+           (int)stats[0][TELEMETRY_CAR] + 1, (int)stats[1][TELEMETRY_CAR] + 1,
+           (int)stats[0][TELEMETRY_LAP], (int)stats[1][TELEMETRY_LAP], seconds / 3600.0);
+    for (int ch = 0; ch < TELEMETRY_NUM_CHANNELS; ++ch) {
+        printf("  %-9s %12.2f .. %.2f\n", channelNames[ch], stats[0][ch], stats[1][ch]);
+    }
+}
+
+typedef enum { QUERY_MAX_SPEED, QUERY_BRAKING, QUERY_OFF_TRACK, QUERY_WALLS } LapQuery;
+
+// Per-lap answers: lap L of the filtered rows goes to results[L]. The count queries also count
+// the rows each lap has in rows[L], so a lap without any is left out rather than shown as 0 s
+// (maxspeed leaves results[L] at -FLT_MAX instead).
+static void runLapQuery(LapQuery type, Query* q, double* results, long* rows, int maxLap) {
+    unsigned char brakeBit = (unsigned char)(1 << CAR_CONTROL_BRAKE);
+    for (long k = 0; k < numChunks; ++k) {
+        const TelemetryChunkHeader* header = getChunkHeader(k);
+        int skip = excludes(header, TELEMETRY_CAR, q->carLo, q->carHi)
+                 | excludes(header, TELEMETRY_SECTOR, q->sectorLo, q->sectorHi)
+                 | excludes(header, TELEMETRY_LAP, q->lapLo, q->lapHi);
+        if (skip) { // One test: a chain of "|| ... continue" makes GCC guess the scans below are cold
+            q->skipped++;
+            continue;
+        }
+        int lapLo = (int)header->min[TELEMETRY_LAP] > q->lapLo ? (int)header->min[TELEMETRY_LAP] : q->lapLo;
+        int lapHi = (int)header->max[TELEMETRY_LAP] < q->lapHi ? (int)header->max[TELEMETRY_LAP] : q->lapHi;
+        if (lapHi > maxLap) lapHi = maxLap;
+
+        // One car on one lap, all of it inside the filters: the top speed is the chunk's. The
+        // chunk's own lap range decides, not lapLo/lapHi, which the lap= filter has narrowed.
+        if (type == QUERY_MAX_SPEED && isConstant(header, TELEMETRY_LAP) && isConstant(header, TELEMETRY_CAR)
+            && isConstant(header, TELEMETRY_SECTOR)) {
+            if (header->max[TELEMETRY_SPEED] > results[lapLo]) results[lapLo] = header->max[TELEMETRY_SPEED];
+            q->fromStats++;
+            continue;
+        }
+        // A chunk whose statistics show the count is zero on every row still has rows to count,
+        // unless they are all on one lap and inside the filters
+        int none = (type == QUERY_BRAKING && header->max[TELEMETRY_INPUTS] < brakeBit)           // Never braked
+                 | (type == QUERY_OFF_TRACK && header->max[TELEMETRY_SURFACE] < SURFACE_GRASS)   // Never off the track
+                 | (type == QUERY_WALLS && header->max[TELEMETRY_SURFACE] < SURFACE_BARRIER);    // Never hit a wall
+        if (none && isConstant(header, TELEMETRY_LAP) && header->min[TELEMETRY_CAR] >= q->carLo
+            && header->max[TELEMETRY_CAR] <= q->carHi && header->min[TELEMETRY_SECTOR] >= q->sectorLo
+            && header->max[TELEMETRY_SECTOR] <= q->sectorHi) {
+            rows[lapLo] += header->rows;
+            q->fromStats++;
+            continue;
+        }
+
+        ChunkColumns columns;
+        getChunkColumns((const unsigned char*)header, &columns);
+        for (int lap = lapLo; lap <= lapHi; ++lap) { // One pass per lap the chunk covers (a handful)
+            if (type == QUERY_MAX_SPEED) {
+                float top = scanMaxSpeed(&columns, q, lap);
+                if (top > -UNMATCHED_SPEED / 2 && top > results[lap]) results[lap] = top;
+            }
+            else if (type == QUERY_BRAKING) results[lap] += scanCount(&columns, q, lap, columns.inputs, brakeBit, brakeBit, brakeBit, &rows[lap]);
+            else if (type == QUERY_OFF_TRACK) results[lap] += scanCount(&columns, q, lap, columns.surface, 0xFF, SURFACE_GRASS, SURFACE_BARRIER, &rows[lap]);
+            else results[lap] += scanCount(&columns, q, lap, columns.surface, 0xFF, SURFACE_BARRIER, SURFACE_BARRIER, &rows[lap]);
+        }
+        q->scanned++;
+    }
+}
+
+static void printLapQuery(LapQuery type, const Query* q, const double* results, const long* rows, int maxLap) {
+    double total = 0.0, best = -FLT_MAX;
+    int laps = 0, bestLap = 0;
+    for (int lap = q->lapLo; lap <= maxLap && lap <= q->lapHi; ++lap) {
+        if (type == QUERY_MAX_SPEED ? results[lap] == -FLT_MAX : rows[lap] == 0) continue; // No rows on this lap
+        double value = type == QUERY_MAX_SPEED ? results[lap] : results[lap] / frameRate; // Counts are ticks
+        if (laps < 20) printf("  lap %4d: %9.2f %s\n", lap, value, type == QUERY_MAX_SPEED ? "units/s" : "s");
+        else if (laps == 20) printf("  ...\n");
+        if (value > best) { best = value; bestLap = lap; }
+        total += value;
+        laps++;
+    }
+    if (laps == 0) { printf("No rows match\n"); return; }
+    if (type == QUERY_MAX_SPEED) printf("%d laps: top speed %.2f units/s on lap %d, average lap top %.2f\n", laps, best, bestLap, total / laps);
+    else printf("%d laps: %.2f s in total, %.2f s per lap, most on lap %d (%.2f s)\n", laps, total, total / laps, bestLap, best);
+}
+
+// Every matching row into a heatmap grid. Not a vectorised scan: each row lands in a different
+// cell, so this is one pass over the x, z and speed columns with the filters as branches.
+static int runHeatmap(Query* q, TrackType track, const char* prefix) {
+    HeatmapGrid grid;
+    if (!initHeatmap(&grid, track)) return 0;
+    for (long k = 0; k < numChunks; ++k) {
+        const TelemetryChunkHeader* header = getChunkHeader(k);
+        if (excludes(header, TELEMETRY_CAR, q->carLo, q->carHi)
+            || excludes(header, TELEMETRY_SECTOR, q->sectorLo, q->sectorHi)
+            || excludes(header, TELEMETRY_LAP, q->lapLo, q->lapHi)) {
+            q->skipped++;
+            continue;
+        }
+        ChunkColumns c;
+        getChunkColumns((const unsigned char*)header, &c);
+        for (unsigned int i = 0; i < header->rows; ++i) {
+            if (c.car[i] < q->carLo || c.car[i] > q->carHi || c.sector[i] < q->sectorLo || c.sector[i] > q->sectorHi
+                || c.lap[i] < q->lapLo || c.lap[i] > q->lapHi) continue;
+            addHeatmapSample(&grid, c.x[i], c.z[i], c.speed[i], c.surface[i] == SURFACE_BARRIER);
+        }
+        q->scanned++;
+    }
+    int ok = grid.samples > 0 && writeHeatmapFiles(&grid, prefix); // Prints the sample counts
+    if (grid.samples == 0) printf("No rows match\n");
+    freeHeatmap(&grid);
+    return ok;
+}
+
+
+// --- Main ---
+static int parseFilter(const char* value, int offset, int* lo, int* hi) {
+    int n = atoi(value);
+    if (n < 1) return 0;
+    *lo = *hi = n - offset;
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: tlquery FILE [query=summary|maxspeed|braking|offtrack|walls|heatmap] [car=N] [sector=N] [lap=N] [out=PREFIX]\n");
+        return 1;
+    }
+    const char* query = "summary";
+    const char* outPrefix = NULL; // query=heatmap
+    Query q;
+    memset(&q, 0, sizeof(q));
+    q.carLo = 0;    q.carHi = 255;
+    q.sectorLo = 1; q.sectorHi = TELEMETRY_SECTORS;
+    q.lapLo = 1;    q.lapHi = 65535;
+    for (int i = 2; i < argc; ++i) {
+        const char* arg = argv[i];
+        int ok = 1;
+        if (strncmp(arg, "query=", 6) == 0) query = arg + 6;
+        else if (strncmp(arg, "car=", 4) == 0) ok = parseFilter(arg + 4, 1, &q.carLo, &q.carHi);
+        else if (strncmp(arg, "sector=", 7) == 0) ok = parseFilter(arg + 7, 0, &q.sectorLo, &q.sectorHi) && q.sectorLo <= TELEMETRY_SECTORS;
+        else if (strncmp(arg, "lap=", 4) == 0) ok = parseFilter(arg + 4, 0, &q.lapLo, &q.lapHi);
+        else if (strncmp(arg, "out=", 4) == 0) outPrefix = arg + 4;
+        else ok = 0;
+        if (!ok) { fprintf(stderr, "tlquery: bad option '%s'\n", arg); return 1; }
+    }
+
+    MappedFile map;
+    if (!mapFile(&map, argv[1])) { fprintf(stderr, "tlquery: cannot map '%s'\n", argv[1]); return 1; }
+    const TelemetryFileHeader* header = (const TelemetryFileHeader*)map.data;
+    if (map.size < sizeof(*header) || memcmp(header->magic, TELEMETRY_MAGIC, 4) != 0
+        || header->version != TELEMETRY_VERSION || header->chunkRows != TELEMETRY_CHUNK_ROWS
+        || header->numChannels != TELEMETRY_NUM_CHANNELS) {
+        fprintf(stderr, "tlquery: '%s' is not a version %d telemetry log\n", argv[1], TELEMETRY_VERSION);
+        unmapFile(&map);
+        return 1;
+    }
+    computeColumnOffsets();
+    firstChunk = map.data + sizeof(*header);
+    numChunks = (long)((map.size - sizeof(*header)) / TELEMETRY_CHUNK_BYTES);
+    frameRate = header->frameRate ? header->frameRate : FRAME_RATE;
+    size_t partial = (map.size - sizeof(*header)) % TELEMETRY_CHUNK_BYTES;
+    if (partial > 0) { // The log was cut short (a crash, or copied while being written)
+        fprintf(stderr, "tlquery: '%s' ends in a partial chunk (%lu bytes), ignored\n", argv[1], (unsigned long)partial);
+    }
+    if (numChunks == 0) {
+        fprintf(stderr, "tlquery: '%s' has no chunks\n", argv[1]);
+        unmapFile(&map);
+        return 1;
+    }
+
+    double start = getTimeSeconds();
+    int status = 0;
+    if (strcmp(query, "summary") == 0) runSummary();
+    else if (strcmp(query, "heatmap") == 0) {
+        if (!outPrefix) { fprintf(stderr, "tlquery: query=heatmap needs out=PREFIX\n"); unmapFile(&map); return 1; }
+        status = runHeatmap(&q, header->track == TRACK_RECT ? TRACK_RECT : TRACK_ROUNDED, outPrefix) ? 0 : 1;
+        printf("Chunks: %ld scanned, %ld skipped\n", q.scanned, q.skipped);
+    } else {
+        LapQuery type;
+        if (strcmp(query, "maxspeed") == 0) type = QUERY_MAX_SPEED;
+        else if (strcmp(query, "braking") == 0) type = QUERY_BRAKING;
+        else if (strcmp(query, "offtrack") == 0) type = QUERY_OFF_TRACK;
+        else if (strcmp(query, "walls") == 0) type = QUERY_WALLS;
+        else { fprintf(stderr, "tlquery: unknown query '%s'\n", query); unmapFile(&map); return 1; }
+
+        int maxLap = 0;
+        for (long k = 0; k < numChunks; ++k) {
+            int lap = (int)getChunkHeader(k)->max[TELEMETRY_LAP];
+            if (lap > maxLap) maxLap = lap;
+        }
+        double* results = (double*)calloc((size_t)maxLap + 1, sizeof(double));
+        long* rows = (long*)calloc((size_t)maxLap + 1, sizeof(long));
+        if (!results || !rows) { free(results); free(rows); unmapFile(&map); return 1; }
+        if (type == QUERY_MAX_SPEED) for (int lap = 0; lap <= maxLap; ++lap) results[lap] = -FLT_MAX;
+        runLapQuery(type, &q, results, rows, maxLap);
+        printLapQuery(type, &q, results, rows, maxLap);
+        printf("Chunks: %ld scanned, %ld skipped, %ld answered from min/max\n", q.scanned, q.skipped, q.fromStats);
+        free(results);
+        free(rows);
+    }
+    double elapsed = getTimeSeconds() - start;
+    printf("%ld chunks (%.1f MB) in %.1f ms\n", numChunks, map.size / 1048576.0, elapsed * 1000.0);
+    unmapFile(&map);
+    return status;
+}